@@ -0,0 +1,109 @@
+#ifndef BENCHMARK_H_INCLUDED
+#define BENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A self contained harness for the math micro benchmarks.
+//
+// A benchmark is a function doing a known number of operations over a known
+// number of bytes. It is called until warm, which also gives how many calls
+// make up a sample of at least the sample time, and is then timed over a
+// number of samples. The median and the median absolute deviation of the
+// samples are reported, as a sample cut short by an interrupt or a frequency
+// change moves them much less than the mean and the standard deviation.
+
+namespace Benchmark
+{
+
+struct Options
+{
+    Options();
+
+    double warmup_seconds;
+    double sample_seconds;
+    size_t samples;
+
+    // Only the benchmarks with this in their name or type are run
+    std::string filter;
+
+    // Where the results are written as JSON. "-" is the standard output.
+    std::string json_file;
+};
+
+// --warmup <seconds> --sample-time <seconds> --samples <count>
+// --filter <text> --json <file>
+Options parse_options(int argc, char ** argv);
+
+struct Result
+{
+    std::string name;
+    std::string type;
+    size_t operations;
+    size_t bytes;
+
+    double nanoseconds_per_operation;
+    double fastest_nanoseconds_per_operation;
+
+    // Median absolute deviation, relative to the median
+    double deviation;
+
+    // Ticks of the time stamp counter. It runs at a fixed reference rate, so
+    // these are only core cycles when the core runs at that rate. Zero where
+    // there is no such counter.
+    double cycles_per_operation;
+
+    double bytes_per_second;
+};
+
+// Ticks of the time stamp counter, or zero where there is none
+uint64_t read_cycle_counter();
+
+// Makes the compiler assume the value is read, so the work producing it is
+// not optimized away
+template<typename T>
+void keep(const T & value);
+
+class Runner
+{
+public:
+    explicit Runner(const Options & options);
+
+    // Written to the JSON output, to tell apart runs from different builds
+    void add_context(const std::string & key, const std::string & value);
+
+    // Times function, which does the given number of operations touching the
+    // given number of bytes each time it is called
+    template<typename Function>
+    void run(const std::string & name, const std::string & type,
+             const size_t & operations, const size_t & bytes, Function function);
+
+    const std::vector<Result> & get_results() const;
+
+    // Writes the JSON output, if asked for. Returns the exit code.
+    int finish() const;
+private:
+    FILE * table() const;
+    bool selected(const std::string & name, const std::string & type) const;
+    void add_result(const std::string & name, const std::string & type,
+                    const size_t & operations, const size_t & bytes,
+                    std::vector<double> nanoseconds, std::vector<double> cycles);
+    void write_json(FILE * file) const;
+
+    Options options;
+    std::vector<std::pair<std::string, std::string> > context;
+    std::vector<Result> results;
+};
+
+#define INCLUDED_FROM_BENCHMARK_H
+#include "benchmark_tmpl.h"
+#undef INCLUDED_FROM_BENCHMARK_H
+
+}
+
+#endif
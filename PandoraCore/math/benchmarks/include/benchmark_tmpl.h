@@ -0,0 +1,66 @@
+#ifndef INCLUDED_FROM_BENCHMARK_H
+#error "benchmark_tmpl.h should only be included from benchmark.h"
+#else
+
+#if defined(__GNUC__)
+template<typename T>
+inline void keep(const T & value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+#else
+extern const void * volatile kept;
+
+template<typename T>
+inline void keep(const T & value)
+{
+    kept = &value;
+}
+#endif
+
+template<typename Function>
+void Runner::run(const std::string & name, const std::string & type,
+                 const size_t & operations, const size_t & bytes, Function function)
+{
+    typedef std::chrono::steady_clock clock;
+    typedef std::chrono::duration<double> seconds;
+
+    if (!selected(name, type)) {
+        return;
+    }
+
+    // Warm the caches, the branch predictors and the clock frequency, and
+    // count the calls fitting in the warm up time
+    size_t calls = 0;
+    const auto warmup_start = clock::now();
+    double warmup = 0;
+    do {
+        function();
+        ++calls;
+        warmup = seconds(clock::now() - warmup_start).count();
+    } while (warmup < options.warmup_seconds);
+
+    const double seconds_per_call = warmup / calls;
+    const size_t calls_per_sample = seconds_per_call < options.sample_seconds ?
+                                    size_t(options.sample_seconds / seconds_per_call) + 1 : 1;
+
+    std::vector<double> nanoseconds;
+    std::vector<double> cycles;
+    for (size_t sample = 0; sample < options.samples; ++sample) {
+        const auto start = clock::now();
+        const uint64_t start_cycles = read_cycle_counter();
+        for (size_t call = 0; call < calls_per_sample; ++call) {
+            function();
+        }
+        const uint64_t stop_cycles = read_cycle_counter();
+        const auto stop = clock::now();
+
+        const double sample_operations = double(calls_per_sample) * operations;
+        nanoseconds.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / sample_operations);
+        cycles.push_back(double(stop_cycles - start_cycles) / sample_operations);
+    }
+
+    add_result(name, type, operations, bytes, nanoseconds, cycles);
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Benchmark
+{
+
+#if !defined(__GNUC__)
+const void * volatile kept = nullptr;
+#endif
+
+namespace
+{
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+std::string escape_json(const std::string & text)
+{
+    std::string escaped;
+    for (const char & character : text) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+
+void usage(const char * program)
+{
+    fprintf(stderr, "Usage: %s [--warmup seconds] [--sample-time seconds] [--samples count]\n"
+                    "       [--filter text] [--json file|-]\n", program);
+    exit(1);
+}
+
+}
+
+Options::Options()
+    : warmup_seconds(0.05), sample_seconds(0.01), samples(15), filter(), json_file()
+{ }
+
+Options parse_options(int argc, char ** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 == argc) {
+            usage(argv[0]);
+        }
+        const char * value = argv[++i];
+        if (!strcmp(argv[i - 1], "--warmup")) {
+            options.warmup_seconds = atof(value);
+        } else if (!strcmp(argv[i - 1], "--sample-time")) {
+            options.sample_seconds = atof(value);
+        } else if (!strcmp(argv[i - 1], "--samples")) {
+            options.samples = std::max(1, atoi(value));
+        } else if (!strcmp(argv[i - 1], "--filter")) {
+            options.filter = value;
+        } else if (!strcmp(argv[i - 1], "--json")) {
+            options.json_file = value;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    return options;
+}
+
+uint64_t read_cycle_counter()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+Runner::Runner(const Options & options)
+    : options(options), context(), results()
+{
+    fprintf(table(), "%-32s %-12s %12s %8s %12s %12s\n", "benchmark", "type", "ns/op", "+-", "cycles/op", "MB/s");
+}
+
+void Runner::add_context(const std::string & key, const std::string & value)
+{
+    context.push_back(std::make_pair(key, value));
+}
+
+const std::vector<Result> & Runner::get_results() const
+{
+    return results;
+}
+
+int Runner::finish() const
+{
+    if (options.json_file.empty()) {
+        return 0;
+    }
+    if (options.json_file == "-") {
+        write_json(stdout);
+        return 0;
+    }
+
+    FILE * file = fopen(options.json_file.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "Can not open %s for writing\n", options.json_file.c_str());
+        return 1;
+    }
+    write_json(file);
+    fclose(file);
+    return 0;
+}
+
+// The table goes to the standard error when the JSON goes to the standard
+// output
+FILE * Runner::table() const
+{
+    return options.json_file == "-" ? stderr : stdout;
+}
+
+bool Runner::selected(const std::string & name, const std::string & type) const
+{
+    return options.filter.empty() ||
+           name.find(options.filter) != std::string::npos ||
+           type.find(options.filter) != std::string::npos;
+}
+
+void Runner::add_result(const std::string & name, const std::string & type,
+                        const size_t & operations, const size_t & bytes,
+                        std::vector<double> nanoseconds, std::vector<double> cycles)
+{
+    Result result;
+    result.name = name;
+    result.type = type;
+    result.operations = operations;
+    result.bytes = bytes;
+    result.nanoseconds_per_operation = median(nanoseconds);
+    result.fastest_nanoseconds_per_operation = *std::min_element(nanoseconds.begin(), nanoseconds.end());
+    result.cycles_per_operation = median(cycles);
+    result.bytes_per_second = bytes / (result.nanoseconds_per_operation * operations) * 1e9;
+
+    for (auto & value : nanoseconds) {
+        value = std::abs(value - result.nanoseconds_per_operation);
+    }
+    result.deviation = median(nanoseconds) / result.nanoseconds_per_operation;
+
+    fprintf(table(), "%-32s %-12s %12.3f %7.1f%% %12.2f %12.1f\n", name.c_str(), type.c_str(),
+            result.nanoseconds_per_operation, result.deviation * 100, result.cycles_per_operation,
+            result.bytes_per_second / 1e6);
+    fflush(table());
+
+    results.push_back(result);
+}
+
+void Runner::write_json(FILE * file) const
+{
+    fprintf(file, "{\n  \"context\": {\n");
+    fprintf(file, "    \"samples\": %zu,\n    \"sample_seconds\": %g,\n    \"warmup_seconds\": %g",
+            options.samples, options.sample_seconds, options.warmup_seconds);
+    for (const auto & entry : context) {
+        fprintf(file, ",\n    \"%s\": \"%s\"", escape_json(entry.first).c_str(), escape_json(entry.second).c_str());
+    }
+    fprintf(file, "\n  },\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result & result = results[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"type\": \"%s\", \"operations\": %zu, \"bytes\": %zu, "
+                      "\"ns_per_op\": %.6g, \"fastest_ns_per_op\": %.6g, \"deviation\": %.6g, "
+                      "\"cycles_per_op\": %.6g, \"bytes_per_second\": %.6g}",
+                i ? "," : "", escape_json(result.name).c_str(), escape_json(result.type).c_str(),
+                result.operations, result.bytes, result.nanoseconds_per_operation,
+                result.fastest_nanoseconds_per_operation, result.deviation,
+                result.cycles_per_operation, result.bytes_per_second);
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+}
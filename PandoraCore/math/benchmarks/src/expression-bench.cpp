@@ -0,0 +1,75 @@
+#include "benchmark.h"
+
+#include <vector3.h>
+#include <vector4.h>
+#include <matrix4.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Compares a fused expression, lazy(a) + lazy(b)*s - c, with the plain
+// operators, which give a value per operation, and with the compound
+// operators, one full pass (and one temporary) per operation.
+
+namespace
+{
+
+const size_t count = 1024;
+
+template<typename Type>
+std::vector<Type> create_random_values()
+{
+    std::vector<Type> values(count);
+    for (auto & value : values) {
+        for (auto & element : value) {
+            element = 1 + rand() / (double) RAND_MAX;
+        }
+    }
+    return values;
+}
+
+template<typename Type, typename Real>
+void run(Benchmark::Runner & runner, const char * type)
+{
+    const auto a = create_random_values<Type>();
+    const auto b = create_random_values<Type>();
+    const auto c = create_random_values<Type>();
+    std::vector<Type> result(count);
+    const Real scalar = Real(0.5);
+    const size_t bytes = 4 * count * sizeof(Type);
+
+    runner.run("fused", type, count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = Math::lazy(a[i]) + Math::lazy(b[i])*scalar - c[i];
+        }
+    });
+    runner.run("operators", type, count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = a[i] + b[i]*scalar - c[i];
+        }
+    });
+    runner.run("eager", type, count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            Type scaled = b[i];
+            scaled *= scalar;
+            Type sum = a[i];
+            sum += scaled;
+            sum -= c[i];
+            result[i] = sum;
+        }
+    });
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    Benchmark::Runner runner(Benchmark::parse_options(argc, argv));
+
+    run<Math::Vec3d, double>(runner, "Vec3d");
+    run<Math::Vec4f, float>(runner, "Vec4f");
+    run<Math::Matrix4d, double>(runner, "Matrix4d");
+
+    return runner.finish();
+}
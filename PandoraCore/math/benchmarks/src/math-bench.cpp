@@ -0,0 +1,858 @@
+#include "benchmark.h"
+
+#include <vector2.h>
+#include <vector3.h>
+#include <vector4.h>
+#include <matrix2.h>
+#include <matrix3.h>
+#include <matrix4.h>
+#include <quaternion.h>
+#include <dual_quaternion.h>
+#include <half.h>
+#include <transform.h>
+#include <vector_soa.h>
+#include <batch_transform.h>
+#include <bounding_volume.h>
+#include <frustum.h>
+
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Times the public functions of the math library for float and double. Each
+// benchmark calls a function over arrays of count values, and reports the
+// time of one call, or of one element for the batch functions.
+//
+//   mathbench --filter Matrix4d --json results.json
+
+namespace
+{
+
+const size_t count = 1024;
+const size_t influences = 4;
+
+template<typename Real>
+struct TypeName;
+
+template<>
+struct TypeName<float>
+{
+    static std::string suffix() { return "f"; }
+};
+
+template<>
+struct TypeName<double>
+{
+    static std::string suffix() { return "d"; }
+};
+
+template<typename Real>
+Real create_random_scalar()
+{
+    return Real(1 + rand() / (double) RAND_MAX);
+}
+
+template<typename Type>
+std::vector<Type> create_random_values()
+{
+    typedef typename std::remove_reference<decltype(*Type().begin())>::type Real;
+
+    std::vector<Type> values(count);
+    for (auto & value : values) {
+        for (auto & element : value) {
+            element = create_random_scalar<Real>();
+        }
+    }
+    return values;
+}
+
+// Kept away from singular, so the inverses and solutions stay finite
+template<typename Real, size_t dim>
+std::vector<Math::Matrix<Real, dim> > create_random_matrices()
+{
+    auto matrices = create_random_values<Math::Matrix<Real, dim> >();
+    for (auto & matrix : matrices) {
+        for (size_t i = 0; i < dim; ++i) {
+            matrix(i,i) += 2 * dim;
+        }
+    }
+    return matrices;
+}
+
+template<typename Real>
+std::vector<Math::Quaternion<Real> > create_random_rotations()
+{
+    std::vector<Math::Quaternion<Real> > rotations(count);
+    for (auto & rotation : rotations) {
+        rotation = Math::Quaternion<Real>(create_random_scalar<Real>() - Real(1.5), create_random_scalar<Real>(),
+                                          create_random_scalar<Real>() - Real(1.5), create_random_scalar<Real>());
+        quaternion_normalize(rotation);
+    }
+    return rotations;
+}
+
+template<typename Real>
+std::vector<Math::DualQuaternion<Real> > create_random_rigid_transforms()
+{
+    const auto rotations = create_random_rotations<Real>();
+    const auto translations = create_random_values<Math::Vector<Real, 3> >();
+
+    std::vector<Math::DualQuaternion<Real> > transforms(count);
+    for (size_t i = 0; i < count; ++i) {
+        transforms[i] = Math::DualQuaternion<Real>(rotations[i], translations[i]);
+    }
+    return transforms;
+}
+
+template<typename Real>
+std::vector<Math::Transform<Real> > create_random_transforms()
+{
+    const auto rotations = create_random_rotations<Real>();
+    const auto translations = create_random_values<Math::Vector<Real, 3> >();
+
+    std::vector<Math::Transform<Real> > transforms(count);
+    for (size_t i = 0; i < count; ++i) {
+        transforms[i] = Math::Transform<Real>(translations[i], rotations[i], create_random_scalar<Real>());
+    }
+    return transforms;
+}
+
+// Times result[i] = operation(input[i]), counting the bytes read and written
+template<typename Input, typename Operation>
+void time_unary(Benchmark::Runner & runner, const std::string & name, const std::string & type,
+                const std::vector<Input> & input, Operation operation)
+{
+    typedef decltype(operation(input[0])) Output;
+
+    std::vector<Output> result(input.size());
+    runner.run(name, type, input.size(), input.size() * (sizeof(Input) + sizeof(Output)), [&]() {
+        for (size_t i = 0; i < input.size(); ++i) {
+            result[i] = operation(input[i]);
+        }
+        Benchmark::keep(result[0]);
+    });
+}
+
+// Times result[i] = operation(left[i], right[i])
+template<typename Left, typename Right, typename Operation>
+void time_binary(Benchmark::Runner & runner, const std::string & name, const std::string & type,
+                 const std::vector<Left> & left, const std::vector<Right> & right, Operation operation)
+{
+    typedef decltype(operation(left[0], right[0])) Output;
+
+    std::vector<Output> result(left.size());
+    runner.run(name, type, left.size(), left.size() * (sizeof(Left) + sizeof(Right) + sizeof(Output)), [&]() {
+        for (size_t i = 0; i < left.size(); ++i) {
+            result[i] = operation(left[i], right[i]);
+        }
+        Benchmark::keep(result[0]);
+    });
+}
+
+template<typename Real, size_t dim>
+void run_vectors(Benchmark::Runner & runner)
+{
+    typedef Math::Vector<Real, dim> Vector;
+
+    const std::string type = "Vec" + std::to_string(dim) + TypeName<Real>::suffix();
+    const auto left = create_random_values<Vector>();
+    const auto right = create_random_values<Vector>();
+    const Real scalar = Real(0.5);
+
+    time_binary(runner, "operator+", type, left, right, [](const Vector & a, const Vector & b) {
+        return Vector(a + b);
+    });
+    time_binary(runner, "operator-", type, left, right, [](const Vector & a, const Vector & b) {
+        return Vector(a - b);
+    });
+    time_binary(runner, "operator*", type, left, right, [](const Vector & a, const Vector & b) {
+        return Vector(a * b);
+    });
+    time_unary(runner, "operator*(scalar)", type, left, [&](const Vector & a) {
+        return Vector(a * scalar);
+    });
+    time_unary(runner, "operator/(scalar)", type, left, [&](const Vector & a) {
+        return Vector(a / scalar);
+    });
+    time_binary(runner, "operator+=", type, left, right, [](const Vector & a, const Vector & b) {
+        Vector sum = a;
+        sum += b;
+        return sum;
+    });
+    time_binary(runner, "operator==", type, left, right, [](const Vector & a, const Vector & b) {
+        return int(a == b);
+    });
+    time_binary(runner, "dot_product", type, left, right, [](const Vector & a, const Vector & b) {
+        return Math::dot_product(a, b);
+    });
+    time_unary(runner, "vector_length", type, left, [](const Vector & a) {
+        return Math::vector_length(a);
+    });
+    time_unary(runner, "vector_length_squared", type, left, [](const Vector & a) {
+        return Math::vector_length_squared(a);
+    });
+    time_unary(runner, "normalize_vector", type, left, [](Vector a) {
+        return Math::normalize_vector(a);
+    });
+    time_unary(runner, "normalize_vector_fast", type, left, [](Vector a) {
+        return Math::normalize_vector_fast(a);
+    });
+}
+
+template<typename Real>
+void run_vector2(Benchmark::Runner & runner)
+{
+    typedef Math::Vector<Real, 2> Vector;
+
+    const std::string type = "Vec2" + TypeName<Real>::suffix();
+    const auto vectors = create_random_values<Vector>();
+
+    time_unary(runner, "perp_vector", type, vectors, [](const Vector & a) {
+        return Math::perp_vector(a);
+    });
+    time_unary(runner, "generate_orthonormal_basis", type, vectors, [](Vector a) {
+        Vector b = Math::perp_vector(a);
+        Math::generate_orthonormal_basis(a, b);
+        return b;
+    });
+}
+
+template<typename Real>
+void run_vector3(Benchmark::Runner & runner)
+{
+    typedef Math::Vector<Real, 3> Vector;
+
+    const std::string type = "Vec3" + TypeName<Real>::suffix();
+    const auto left = create_random_values<Vector>();
+    const auto right = create_random_values<Vector>();
+
+    time_binary(runner, "cross_product", type, left, right, [](const Vector & a, const Vector & b) {
+        return Math::cross_product(a, b);
+    });
+    time_binary(runner, "generate_orthonormal_basis", type, left, right, [](Vector a, Vector b) {
+        Vector c = Math::cross_product(a, b);
+        Math::generate_orthonormal_basis(a, b, c);
+        return c;
+    });
+}
+
+template<typename Real, size_t dim>
+void run_matrices(Benchmark::Runner & runner)
+{
+    typedef Math::Matrix<Real, dim> Matrix;
+    typedef Math::Vector<Real, dim> Vector;
+
+    const std::string type = "Matrix" + std::to_string(dim) + TypeName<Real>::suffix();
+    const auto left = create_random_matrices<Real, dim>();
+    const auto right = create_random_matrices<Real, dim>();
+    const auto vectors = create_random_values<Vector>();
+    std::vector<Math::LUDecomposition<Real, dim> > decompositions;
+    for (const auto & matrix : left) {
+        decompositions.push_back(Math::matrix_lu_decompose(matrix));
+    }
+
+    time_binary(runner, "operator*", type, left, right, [](const Matrix & a, const Matrix & b) {
+        return Matrix(a * b);
+    });
+    time_binary(runner, "operator*(vector)", type, left, vectors, [](const Matrix & a, const Vector & b) {
+        return Vector(a * b);
+    });
+    time_binary(runner, "operator*(matrix)", type, vectors, left, [](const Vector & a, const Matrix & b) {
+        return Vector(a * b);
+    });
+    time_binary(runner, "operator+", type, left, right, [](const Matrix & a, const Matrix & b) {
+        return Matrix(a + b);
+    });
+    time_unary(runner, "operator*(scalar)", type, left, [](const Matrix & a) {
+        return Matrix(a * Real(0.5));
+    });
+    time_unary(runner, "matrix_transpose", type, left, [](const Matrix & a) {
+        return Math::matrix_transpose(a);
+    });
+    time_unary(runner, "matrix_determinant", type, left, [](const Matrix & a) {
+        return Math::matrix_determinant(a);
+    });
+    time_unary(runner, "matrix_trace", type, left, [](const Matrix & a) {
+        return Math::matrix_trace(a);
+    });
+    time_unary(runner, "matrix_adjugate", type, left, [](const Matrix & a) {
+        return Math::matrix_adjugate(a);
+    });
+    time_unary(runner, "matrix_inverse", type, left, [](const Matrix & a) {
+        return Math::matrix_inverse(a);
+    });
+    time_unary(runner, "matrix_lu_decompose", type, left, [](const Matrix & a) {
+        return Math::matrix_lu_decompose(a);
+    });
+    time_binary(runner, "lu_solve", type, decompositions, vectors,
+                [](const Math::LUDecomposition<Real, dim> & a, const Vector & b) {
+        return Math::lu_solve(a, b);
+    });
+    time_binary(runner, "matrix_solve", type, left, vectors, [](const Matrix & a, const Vector & b) {
+        return Math::matrix_solve(a, b);
+    });
+}
+
+template<typename Real>
+void run_matrix4(Benchmark::Runner & runner)
+{
+    typedef Math::Matrix<Real, 4> Matrix;
+
+    const std::string type = "Matrix4" + TypeName<Real>::suffix();
+    const auto affine = create_random_matrices<Real, 4>();
+    std::vector<Matrix> rigid;
+    for (const auto & transform : create_random_rigid_transforms<Real>()) {
+        rigid.push_back(Math::dual_quaternion_to_matrix(transform));
+    }
+
+    time_unary(runner, "matrix_is_affine", type, affine, [](const Matrix & a) {
+        return int(Math::matrix_is_affine(a));
+    });
+    time_unary(runner, "matrix_is_rigid", type, rigid, [](const Matrix & a) {
+        return int(Math::matrix_is_rigid(a));
+    });
+    time_unary(runner, "matrix_inverse_affine", type, rigid, [](const Matrix & a) {
+        return Math::matrix_inverse_affine(a);
+    });
+    time_unary(runner, "matrix_inverse_rigid", type, rigid, [](const Matrix & a) {
+        return Math::matrix_inverse_rigid(a);
+    });
+}
+
+template<typename Real>
+void run_quaternions(Benchmark::Runner & runner)
+{
+    typedef Math::Quaternion<Real> Quaternion;
+    typedef Math::Vector<Real, 3> Vector;
+
+    const std::string type = "Quaternion" + TypeName<Real>::suffix();
+    const auto left = create_random_rotations<Real>();
+    const auto right = create_random_rotations<Real>();
+    const auto vectors = create_random_values<Vector>();
+    std::vector<Math::Matrix<Real, 4> > matrices;
+    for (const auto & rotation : left) {
+        matrices.push_back(Math::quaternion_to_matrix(rotation));
+    }
+    const Real t = Real(0.3);
+
+    time_binary(runner, "operator*", type, left, right, [](const Quaternion & a, const Quaternion & b) {
+        return a * b;
+    });
+    time_binary(runner, "operator+", type, left, right, [](const Quaternion & a, const Quaternion & b) {
+        return a + b;
+    });
+    time_unary(runner, "operator*(scalar)", type, left, [](const Quaternion & a) {
+        return a * Real(0.5);
+    });
+    time_binary(runner, "quaternion_rotate", type, left, vectors, [](const Quaternion & a, const Vector & b) {
+        return Math::quaternion_rotate(a, b);
+    });
+    time_unary(runner, "quaternion_to_matrix", type, left, [](const Quaternion & a) {
+        return Math::quaternion_to_matrix(a);
+    });
+    time_unary(runner, "Quaternion(matrix)", type, matrices, [](const Math::Matrix<Real, 4> & a) {
+        return Quaternion(a);
+    });
+    time_unary(runner, "quaternion_norm", type, left, [](const Quaternion & a) {
+        return Math::quaternion_norm(a);
+    });
+    time_unary(runner, "quaternion_normalize", type, left, [](Quaternion a) {
+        Math::quaternion_normalize(a);
+        return a;
+    });
+    time_unary(runner, "quaternion_normalize_fast", type, left, [](Quaternion a) {
+        Math::quaternion_normalize_fast(a);
+        return a;
+    });
+    time_unary(runner, "quaternion_conjugate", type, left, [](const Quaternion & a) {
+        return Math::quaternion_conjugate(a);
+    });
+    time_unary(runner, "quaternion_inverse", type, left, [](const Quaternion & a) {
+        return Math::quaternion_inverse(a);
+    });
+    time_binary(runner, "quaternion_dot", type, left, right, [](const Quaternion & a, const Quaternion & b) {
+        return Math::quaternion_dot(a, b);
+    });
+    time_binary(runner, "quaternion_nlerp", type, left, right, [&](const Quaternion & a, const Quaternion & b) {
+        return Math::quaternion_nlerp(a, b, t);
+    });
+    time_binary(runner, "quaternion_fast_slerp", type, left, right, [&](const Quaternion & a, const Quaternion & b) {
+        return Math::quaternion_fast_slerp(a, b, t);
+    });
+    time_binary(runner, "quaternion_slerp", type, left, right, [&](const Quaternion & a, const Quaternion & b) {
+        return Math::quaternion_slerp(a, b, t);
+    });
+}
+
+template<typename Real>
+void run_dual_quaternions(Benchmark::Runner & runner)
+{
+    typedef Math::DualQuaternion<Real> DualQuaternion;
+    typedef Math::Vector<Real, 3> Vector;
+
+    const std::string type = "DualQuaternion" + TypeName<Real>::suffix();
+    const auto left = create_random_rigid_transforms<Real>();
+    const auto right = create_random_rigid_transforms<Real>();
+    const auto points = create_random_values<Vector>();
+    std::vector<Math::Matrix<Real, 4> > matrices;
+    for (const auto & transform : left) {
+        matrices.push_back(Math::dual_quaternion_to_matrix(transform));
+    }
+    const Real weights[influences] = { Real(0.4), Real(0.3), Real(0.2), Real(0.1) };
+
+    time_binary(runner, "operator*", type, left, right, [](const DualQuaternion & a, const DualQuaternion & b) {
+        return a * b;
+    });
+    time_unary(runner, "dual_quaternion_conjugate", type, left, [](const DualQuaternion & a) {
+        return Math::dual_quaternion_conjugate(a);
+    });
+    time_unary(runner, "dual_quaternion_inverse", type, left, [](const DualQuaternion & a) {
+        return Math::dual_quaternion_inverse(a);
+    });
+    time_unary(runner, "dual_quaternion_normalize", type, left, [](DualQuaternion a) {
+        Math::dual_quaternion_normalize(a);
+        return a;
+    });
+    time_unary(runner, "dual_quaternion_translation", type, left, [](const DualQuaternion & a) {
+        return Math::dual_quaternion_translation(a);
+    });
+    time_binary(runner, "dual_quaternion_transform_point", type, left, points,
+                [](const DualQuaternion & a, const Vector & b) {
+        return Math::dual_quaternion_transform_point(a, b);
+    });
+    time_unary(runner, "dual_quaternion_to_matrix", type, left, [](const DualQuaternion & a) {
+        return Math::dual_quaternion_to_matrix(a);
+    });
+    time_unary(runner, "DualQuaternion(matrix)", type, matrices, [](const Math::Matrix<Real, 4> & a) {
+        return DualQuaternion(a);
+    });
+
+    // Blends the four transforms starting at each one
+    std::vector<DualQuaternion> blended(count - influences);
+    runner.run("dual_quaternion_blend", type, blended.size(),
+               blended.size() * (influences * sizeof(DualQuaternion) + sizeof(DualQuaternion)), [&]() {
+        for (size_t i = 0; i < blended.size(); ++i) {
+            blended[i] = Math::dual_quaternion_blend(&left[i], weights, influences);
+        }
+        Benchmark::keep(blended[0]);
+    });
+}
+
+template<typename Real>
+void run_transforms(Benchmark::Runner & runner)
+{
+    typedef Math::Transform<Real> Transform;
+    typedef Math::Vector<Real, 3> Vector;
+
+    const std::string type = "Transform" + TypeName<Real>::suffix();
+    const auto left = create_random_transforms<Real>();
+    const auto right = create_random_transforms<Real>();
+    const auto points = create_random_values<Vector>();
+
+    time_binary(runner, "operator*", type, left, right, [](const Transform & a, const Transform & b) {
+        return a * b;
+    });
+    time_unary(runner, "transform_inverse", type, left, [](const Transform & a) {
+        return Math::transform_inverse(a);
+    });
+    time_binary(runner, "transform_point", type, left, points, [](const Transform & a, const Vector & b) {
+        return Math::transform_point(a, b);
+    });
+    time_binary(runner, "transform_direction", type, left, points, [](const Transform & a, const Vector & b) {
+        return Math::transform_direction(a, b);
+    });
+
+    // Changing the scale marks the matrix as stale, so it is built every call
+    time_unary(runner, "get_matrix", type, left, [](Transform a) {
+        a.set_scale(a.get_scale());
+        return a.get_matrix();
+    });
+}
+
+// The batch functions, timed per element
+template<typename Real>
+void run_batches(Benchmark::Runner & runner)
+{
+    typedef Math::Vector<Real, 3> Vector3;
+    typedef Math::Vector<Real, 4> Vector4;
+    typedef Math::VectorSoA<Real, 3> SoA3;
+    typedef Math::VectorSoA<Real, 4> SoA4;
+
+    const std::string type = "Batch" + TypeName<Real>::suffix();
+    const auto matrix = create_random_matrices<Real, 4>()[0];
+    const auto rotations = create_random_rotations<Real>();
+    const auto other_rotations = create_random_rotations<Real>();
+    const auto transforms = create_random_rigid_transforms<Real>();
+    const auto vectors3 = create_random_values<Vector3>();
+    const auto vectors4 = create_random_values<Vector4>();
+    const SoA3 soa3(vectors3.data(), count);
+    const SoA3 other_soa3(create_random_values<Vector3>().data(), count);
+    const SoA4 soa4(vectors4.data(), count);
+
+    std::vector<Real> t(count);
+    std::vector<Real> weights(count * influences);
+    std::vector<size_t> indices(count * influences);
+    for (size_t i = 0; i < count; ++i) {
+        t[i] = create_random_scalar<Real>() - 1;
+        for (size_t j = 0; j < influences; ++j) {
+            indices[i * influences + j] = rand() % count;
+            weights[i * influences + j] = Real(1) / influences;
+        }
+    }
+
+    std::vector<Vector3> result3(count);
+    std::vector<Vector4> result4(count);
+    std::vector<Math::Quaternion<Real> > quaternions(count);
+    std::vector<Math::DualQuaternion<Real> > blended(count);
+    std::vector<Real> scalars(count);
+    SoA3 soa_result3(count);
+    SoA4 soa_result4(count);
+
+    const size_t bytes3 = count * 2 * sizeof(Vector3);
+    const size_t soa_bytes3 = count * 2 * 3 * sizeof(Real);
+    const size_t soa_bytes4 = count * 2 * 4 * sizeof(Real);
+    const size_t quaternion_bytes = count * sizeof(Math::Quaternion<Real>);
+    const size_t dual_quaternion_bytes = count * sizeof(Math::DualQuaternion<Real>);
+
+    runner.run("transform_points", type, count, bytes3, [&]() {
+        Math::transform_points(matrix, vectors3.data(), count, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+    runner.run("transform_points(soa)", type, count, soa_bytes3, [&]() {
+        Math::transform_points(matrix, soa3, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("transform_directions", type, count, bytes3, [&]() {
+        Math::transform_directions(matrix, vectors3.data(), count, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+    runner.run("transform_directions(soa)", type, count, soa_bytes3, [&]() {
+        Math::transform_directions(matrix, soa3, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("transform_homogeneous", type, count, count * 2 * sizeof(Vector4), [&]() {
+        Math::transform_homogeneous(matrix, vectors4.data(), count, result4.data());
+        Benchmark::keep(result4[0]);
+    });
+    runner.run("transform_homogeneous(soa)", type, count, soa_bytes4, [&]() {
+        Math::transform_homogeneous(matrix, soa4, soa_result4);
+        Benchmark::keep(*soa_result4.component(0));
+    });
+
+    runner.run("quaternion_rotate", type, count, bytes3, [&]() {
+        Math::quaternion_rotate(rotations[0], vectors3.data(), count, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+    runner.run("quaternion_rotate(soa)", type, count, soa_bytes3, [&]() {
+        Math::quaternion_rotate(rotations[0], soa3, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("quaternion_rotate(each)", type, count, bytes3 + quaternion_bytes, [&]() {
+        Math::quaternion_rotate(rotations.data(), vectors3.data(), count, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+    runner.run("quaternion_rotate(each,soa)", type, count, soa_bytes3 + quaternion_bytes, [&]() {
+        Math::quaternion_rotate(rotations.data(), soa3, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+
+    const size_t interpolation_bytes = 3 * quaternion_bytes + count * sizeof(Real);
+    runner.run("quaternion_nlerp", type, count, interpolation_bytes, [&]() {
+        Math::quaternion_nlerp(rotations.data(), other_rotations.data(), t.data(), count, quaternions.data());
+        Benchmark::keep(quaternions[0]);
+    });
+    runner.run("quaternion_fast_slerp", type, count, interpolation_bytes, [&]() {
+        Math::quaternion_fast_slerp(rotations.data(), other_rotations.data(), t.data(), count, quaternions.data());
+        Benchmark::keep(quaternions[0]);
+    });
+    runner.run("quaternion_slerp", type, count, interpolation_bytes, [&]() {
+        Math::quaternion_slerp(rotations.data(), other_rotations.data(), t.data(), count, quaternions.data());
+        Benchmark::keep(quaternions[0]);
+    });
+
+    // In place, so every call after the first normalizes unit values
+    result3 = vectors3;
+    runner.run("normalize_vector_fast", type, count, bytes3, [&]() {
+        Math::normalize_vector_fast(result3.data(), count);
+        Benchmark::keep(result3[0]);
+    });
+    quaternions = rotations;
+    runner.run("quaternion_normalize_fast", type, count, 2 * quaternion_bytes, [&]() {
+        Math::quaternion_normalize_fast(quaternions.data(), count);
+        Benchmark::keep(quaternions[0]);
+    });
+
+    runner.run("dual_quaternion_blend", type, count,
+               influences * (dual_quaternion_bytes + count * (sizeof(size_t) + sizeof(Real))) + dual_quaternion_bytes, [&]() {
+        Math::dual_quaternion_blend(transforms.data(), indices.data(), weights.data(), influences, count,
+                                    blended.data());
+        Benchmark::keep(blended[0]);
+    });
+    runner.run("dual_quaternion_transform_points", type, count, bytes3 + dual_quaternion_bytes, [&]() {
+        Math::dual_quaternion_transform_points(transforms.data(), vectors3.data(), count, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+    runner.run("dual_quaternion_transform_points(soa)", type, count, soa_bytes3 + dual_quaternion_bytes, [&]() {
+        Math::dual_quaternion_transform_points(transforms.data(), soa3, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+
+    runner.run("aos_to_soa", type, count, bytes3, [&]() {
+        Math::aos_to_soa(vectors3.data(), count, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("soa_to_aos", type, count, bytes3, [&]() {
+        Math::soa_to_aos(soa3, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+
+    soa_result3 = soa3;
+    runner.run("operator+=(soa)", type, count, count * 3 * 3 * sizeof(Real), [&]() {
+        soa_result3 += other_soa3;
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("operator*=(soa)", type, count, soa_bytes3, [&]() {
+        soa_result3 *= Real(1);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("axpy(soa)", type, count, count * 3 * 3 * sizeof(Real), [&]() {
+        Math::axpy(soa_result3, Real(0), other_soa3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("dot_product(soa)", type, count, soa_bytes3 + count * sizeof(Real), [&]() {
+        Math::dot_product(soa3, other_soa3, scalars.data());
+        Benchmark::keep(scalars[0]);
+    });
+    runner.run("cross_product(soa)", type, count, count * 3 * 3 * sizeof(Real), [&]() {
+        Math::cross_product(soa3, other_soa3, soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("vector_length(soa)", type, count, count * 4 * sizeof(Real), [&]() {
+        Math::vector_length(soa3, scalars.data());
+        Benchmark::keep(scalars[0]);
+    });
+    runner.run("normalize_vector(soa)", type, count, soa_bytes3, [&]() {
+        Math::normalize_vector(soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+    runner.run("normalize_vector_fast(soa)", type, count, soa_bytes3, [&]() {
+        Math::normalize_vector_fast(soa_result3);
+        Benchmark::keep(*soa_result3.component(0));
+    });
+}
+
+// The single ray tests loop over the same boxes and rays as the batches, for
+// comparison
+template<typename Real>
+void run_bounding_volumes(Benchmark::Runner & runner)
+{
+    typedef Math::Vector<Real, 3> Vector3;
+    typedef Math::VectorSoA<Real, 3> SoA3;
+
+    const std::string type = "Bounds" + TypeName<Real>::suffix();
+    const auto points = create_random_values<Vector3>();
+    const SoA3 soa_points(points.data(), count);
+
+    // Boxes of size up to one at the points, and rays from close to the
+    // origin towards the points
+    std::vector<Math::AABB<Real> > boxes;
+    std::vector<Math::Ray<Real> > rays;
+    SoA3 minimums;
+    SoA3 maximums;
+    SoA3 origins;
+    SoA3 directions;
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3 size(create_random_scalar<Real>() - 1, create_random_scalar<Real>() - 1,
+                           create_random_scalar<Real>() - 1);
+        boxes.push_back(Math::AABB<Real>(points[i], Vector3(points[i] + size)));
+        minimums.push_back(boxes.back().get_min());
+        maximums.push_back(boxes.back().get_max());
+
+        const Vector3 origin(size * Real(-2));
+        rays.push_back(Math::Ray<Real>(origin, Vector3(points[(i * 7) % count] - origin)));
+        origins.push_back(origin);
+        directions.push_back(rays.back().get_direction());
+    }
+    const Math::AABB<Real> box(Vector3(Real(1.25), Real(1.25), Real(1.25)), Vector3(Real(1.75), Real(1.75), Real(1.75)));
+    std::vector<Real> distances(count);
+
+    runner.run("aabb(points)", type, count, count * sizeof(Vector3), [&]() {
+        Benchmark::keep(Math::AABB<Real>(points.data(), count));
+    });
+    runner.run("aabb(soa)", type, count, count * 3 * sizeof(Real), [&]() {
+        Benchmark::keep(Math::AABB<Real>(soa_points));
+    });
+    runner.run("sphere(points)", type, count, count * sizeof(Vector3), [&]() {
+        Benchmark::keep(Math::Sphere<Real>(points.data(), count));
+    });
+    runner.run("sphere(soa)", type, count, count * 3 * sizeof(Real), [&]() {
+        Benchmark::keep(Math::Sphere<Real>(soa_points));
+    });
+    runner.run("aabb_intersects_ray(boxes)", type, count, count * 2 * sizeof(Vector3), [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            Math::aabb_intersects_ray(boxes[i], rays[0], distances[i]);
+        }
+        Benchmark::keep(distances[0]);
+    });
+    runner.run("aabb_intersect_ray", type, count, count * 7 * sizeof(Real), [&]() {
+        Math::aabb_intersect_ray(minimums, maximums, rays[0], distances.data());
+        Benchmark::keep(distances[0]);
+    });
+    runner.run("aabb_intersects_ray(rays)", type, count, count * 3 * sizeof(Vector3), [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            Math::aabb_intersects_ray(box, rays[i], distances[i]);
+        }
+        Benchmark::keep(distances[0]);
+    });
+    runner.run("aabb_intersect_rays", type, count, count * 7 * sizeof(Real), [&]() {
+        Math::aabb_intersect_rays(box, origins, directions, distances.data());
+        Benchmark::keep(distances[0]);
+    });
+}
+
+// A camera looking into the corner of the points, so about half the volumes
+// are culled. The single tests loop over the same volumes as the batches.
+template<typename Real>
+void run_frustum(Benchmark::Runner & runner)
+{
+    typedef Math::Vector<Real, 3> Vector3;
+    typedef Math::VectorSoA<Real, 3> SoA3;
+
+    const std::string type = "Frustum" + TypeName<Real>::suffix();
+    const auto points = create_random_values<Vector3>();
+    const SoA3 soa_points(points.data(), count);
+    const Math::Matrix<Real, 4> view_projection =
+        Math::matrix_perspective(Real(0.6), Real(1), Real(0.1), Real(10)) *
+        Math::matrix_look_at(Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(0, 1, 0));
+    const Math::Frustum<Real> frustum(view_projection);
+
+    std::vector<Math::Sphere<Real> > spheres;
+    std::vector<Math::AABB<Real> > boxes;
+    std::vector<Real> radii;
+    SoA3 maximums;
+    for (size_t i = 0; i < count; ++i) {
+        const Real size = (create_random_scalar<Real>() - 1) / 4;
+        spheres.push_back(Math::Sphere<Real>(points[i], size));
+        boxes.push_back(Math::AABB<Real>(points[i], Vector3(points[i] + Vector3(size, size, size))));
+        radii.push_back(size);
+        maximums.push_back(boxes.back().get_max());
+    }
+    std::vector<size_t> visible(count);
+    SoA3 projected;
+    std::vector<Real> w(count);
+
+    runner.run("frustum_intersects(spheres)", type, count, count * sizeof(Math::Sphere<Real>), [&]() {
+        size_t found = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (Math::frustum_intersects(frustum, spheres[i])) {
+                visible[found++] = i;
+            }
+        }
+        Benchmark::keep(found);
+    });
+    runner.run("frustum_cull(spheres)", type, count, count * sizeof(Math::Sphere<Real>), [&]() {
+        Benchmark::keep(Math::frustum_cull(frustum, spheres.data(), count, visible.data()));
+    });
+    runner.run("frustum_cull(soa spheres)", type, count, count * 4 * sizeof(Real), [&]() {
+        Benchmark::keep(Math::frustum_cull(frustum, soa_points, radii.data(), visible.data()));
+    });
+    runner.run("frustum_intersects(boxes)", type, count, count * sizeof(Math::AABB<Real>), [&]() {
+        size_t found = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (Math::frustum_intersects(frustum, boxes[i])) {
+                visible[found++] = i;
+            }
+        }
+        Benchmark::keep(found);
+    });
+    runner.run("frustum_cull(boxes)", type, count, count * sizeof(Math::AABB<Real>), [&]() {
+        Benchmark::keep(Math::frustum_cull(frustum, boxes.data(), count, visible.data()));
+    });
+    runner.run("frustum_cull(soa boxes)", type, count, count * 6 * sizeof(Real), [&]() {
+        Benchmark::keep(Math::frustum_cull(frustum, soa_points, maximums, visible.data()));
+    });
+    runner.run("transform_points(soa)", type, count, count * 6 * sizeof(Real), [&]() {
+        Math::transform_points(view_projection, soa_points, projected);
+        Benchmark::keep(projected.component(0)[0]);
+    });
+    runner.run("project_points", type, count, count * 7 * sizeof(Real), [&]() {
+        Math::project_points(view_projection, soa_points, projected, w.data());
+        Benchmark::keep(projected.component(0)[0]);
+    });
+}
+
+// Half precision only converts to and from float
+void run_halves(Benchmark::Runner & runner)
+{
+    const std::string type = "half";
+    const auto vectors3 = create_random_values<Math::Vec3f>();
+    const auto vectors4 = create_random_values<Math::Vec4f>();
+    std::vector<Math::Vec3h> halves3(count);
+    std::vector<Math::Vec4h> halves4(count);
+    Math::float_to_half(vectors3.data(), count, halves3.data());
+    Math::float_to_half(vectors4.data(), count, halves4.data());
+    std::vector<Math::Vec3f> result3(count);
+    std::vector<Math::Vec4f> result4(count);
+
+    runner.run("float_to_half(Vec3f)", type, count, count * (sizeof(Math::Vec3f) + sizeof(Math::Vec3h)), [&]() {
+        Math::float_to_half(vectors3.data(), count, halves3.data());
+        Benchmark::keep(halves3[0]);
+    });
+    runner.run("half_to_float(Vec3f)", type, count, count * (sizeof(Math::Vec3f) + sizeof(Math::Vec3h)), [&]() {
+        Math::half_to_float(halves3.data(), count, result3.data());
+        Benchmark::keep(result3[0]);
+    });
+    runner.run("float_to_half(Vec4f)", type, count, count * (sizeof(Math::Vec4f) + sizeof(Math::Vec4h)), [&]() {
+        Math::float_to_half(vectors4.data(), count, halves4.data());
+        Benchmark::keep(halves4[0]);
+    });
+    runner.run("half_to_float(Vec4f)", type, count, count * (sizeof(Math::Vec4f) + sizeof(Math::Vec4h)), [&]() {
+        Math::half_to_float(halves4.data(), count, result4.data());
+        Benchmark::keep(result4[0]);
+    });
+}
+
+template<typename Real>
+void run(Benchmark::Runner & runner)
+{
+    run_vectors<Real, 2>(runner);
+    run_vectors<Real, 3>(runner);
+    run_vectors<Real, 4>(runner);
+    run_vector2<Real>(runner);
+    run_vector3<Real>(runner);
+
+    run_matrices<Real, 2>(runner);
+    run_matrices<Real, 3>(runner);
+    run_matrices<Real, 4>(runner);
+    run_matrix4<Real>(runner);
+
+    run_quaternions<Real>(runner);
+    run_dual_quaternions<Real>(runner);
+    run_transforms<Real>(runner);
+    run_batches<Real>(runner);
+    run_bounding_volumes<Real>(runner);
+    run_frustum<Real>(runner);
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    Benchmark::Runner runner(Benchmark::parse_options(argc, argv));
+#ifdef MATH_USE_F16C
+    runner.add_context("simd", "avx+f16c");
+#elif defined(MATH_USE_AVX)
+    runner.add_context("simd", "avx");
+#elif defined(MATH_USE_SSE2)
+    runner.add_context("simd", "sse2");
+#else
+    runner.add_context("simd", "generic");
+#endif
+
+    run<float>(runner);
+    run<double>(runner);
+    run_halves(runner);
+
+    return runner.finish();
+}
@@ -0,0 +1,142 @@
+#include "benchmark.h"
+
+#include <vector3.h>
+#include <vector4.h>
+
+#include <type_traits>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Compares the (possibly SIMD specialized) vector operators with the generic
+// element loops from vector_tmpl.h, over the same data. Build with
+// -DPANDORA_ENABLE_SIMD=OFF to time the generic template through the
+// operators as well.
+
+namespace
+{
+
+const size_t count = 1024;
+
+template<typename VectorType>
+std::vector<VectorType> create_random_vectors()
+{
+    std::vector<VectorType> vectors(count);
+    for (auto & vector : vectors) {
+        for (auto & element : vector) {
+            element = 1 + rand() / (double) RAND_MAX;
+        }
+    }
+    return vectors;
+}
+
+template<typename VectorType>
+void generic_add(VectorType & to, const VectorType & from)
+{
+    auto source = from.begin();
+    for (auto & element : to) {
+        element += *source++;
+    }
+}
+
+template<typename VectorType, typename Real>
+void generic_scale(VectorType & to, const Real & scalar)
+{
+    for (auto & element : to) {
+        element *= scalar;
+    }
+}
+
+template<typename VectorType>
+double generic_dot(const VectorType & left, const VectorType & right)
+{
+    auto other = right.begin();
+    auto result = *left.begin() * 0;
+    for (auto element : left) {
+        result += element * *other++;
+    }
+    return result;
+}
+
+template<typename VectorType>
+void run(Benchmark::Runner & runner, const char * type)
+{
+    typedef typename std::remove_reference<decltype(*VectorType().begin())>::type Real;
+
+    auto left = create_random_vectors<VectorType>();
+    const auto right = create_random_vectors<VectorType>();
+    const Real scalar = Real(1.0000001);
+    const size_t bytes = count * sizeof(VectorType);
+
+    runner.run("add", type, count, 3 * bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            left[i] += right[i];
+        }
+    });
+    runner.run("add/gen", type, count, 3 * bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            generic_add(left[i], right[i]);
+        }
+    });
+
+    runner.run("scale", type, count, 2 * bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            left[i] *= scalar;
+        }
+    });
+    runner.run("scale/gen", type, count, 2 * bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            generic_scale(left[i], scalar);
+        }
+    });
+
+    runner.run("dot", type, count, 2 * bytes, [&]() {
+        Real sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += Math::dot_product(left[i], right[i]);
+        }
+        Benchmark::keep(sum);
+    });
+    runner.run("dot/gen", type, count, 2 * bytes, [&]() {
+        Real sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += generic_dot(left[i], right[i]);
+        }
+        Benchmark::keep(sum);
+    });
+
+    runner.run("length", type, count, bytes, [&]() {
+        Real sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += Math::vector_length(left[i]);
+        }
+        Benchmark::keep(sum);
+    });
+
+    runner.run("normalize", type, count, 2 * bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            Math::normalize_vector(left[i]);
+        }
+    });
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    Benchmark::Runner runner(Benchmark::parse_options(argc, argv));
+#ifdef MATH_USE_AVX
+    runner.add_context("simd", "avx");
+#elif defined(MATH_USE_SSE2)
+    runner.add_context("simd", "sse2");
+#else
+    runner.add_context("simd", "generic");
+#endif
+
+    run<Math::Vec3f>(runner, "Vec3f");
+    run<Math::Vec4f>(runner, "Vec4f");
+    run<Math::Vec3d>(runner, "Vec3d");
+    run<Math::Vec4d>(runner, "Vec4d");
+
+    return runner.finish();
+}
@@ -0,0 +1,80 @@
+#ifndef MATH_ALIGNED_ALLOCATOR_H_INCLUDED
+#define MATH_ALIGNED_ALLOCATOR_H_INCLUDED
+
+#include "config.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace Math
+{
+
+// Standard allocator handing out memory aligned to the given number of bytes,
+// so containers of scalars can be streamed with aligned SIMD loads.
+template<typename T, size_t alignment>
+struct AlignedAllocator
+{
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, alignment> other;
+    };
+
+    AlignedAllocator() {}
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, alignment> &) {}
+
+    T * allocate(const size_t & count);
+    void deallocate(T * pointer, const size_t & count);
+};
+
+template<typename T, size_t alignment>
+T * AlignedAllocator<T, alignment>::allocate(const size_t & count)
+{
+    void * memory = nullptr;
+#ifdef _WIN32
+    memory = _aligned_malloc(count * sizeof(T), alignment);
+#else
+    if (posix_memalign(&memory, alignment, count * sizeof(T)) != 0) {
+        memory = nullptr;
+    }
+#endif
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T *>(memory);
+}
+
+template<typename T, size_t alignment>
+void AlignedAllocator<T, alignment>::deallocate(T * pointer, const size_t &)
+{
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+
+template<typename T, typename U, size_t alignment>
+bool operator==(const AlignedAllocator<T, alignment> &, const AlignedAllocator<U, alignment> &)
+{
+    return true;
+}
+
+template<typename T, typename U, size_t alignment>
+bool operator!=(const AlignedAllocator<T, alignment> &, const AlignedAllocator<U, alignment> &)
+{
+    return false;
+}
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef MATH_BATCH_TRANSFORM_H_INCLUDED
+#define MATH_BATCH_TRANSFORM_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "vector3.h"
+#include "vector4.h"
+#include "matrix4.h"
+#include "quaternion.h"
+#include "dual_quaternion.h"
+#include "vector_soa.h"
+#include "parallel.h"
+
+namespace Math
+{
+
+// One matrix applied to a whole batch of vectors, as arrays of vectors or in
+// the batch layout. The matrix is read into registers once per batch, and
+// the vectors are streamed through it, optionally spread over threads (see
+// parallel_for). The results may be written over the input.
+//
+// Every element is summed in the same order as Matrix * Vector, so a batch
+// gives bit for bit the same results as transforming each vector by itself.
+
+// The points as (x, y, z, 1). Unless the matrix is affine the results are
+// divided by their w.
+template<typename Real>
+void transform_points(const Matrix<Real, 4> & matrix, const Vector<Real, 3> * points, const size_t & count,
+                      Vector<Real, 3> * result, const size_t & threads = 1);
+
+template<typename Real>
+void transform_points(const Matrix<Real, 4> & matrix, const VectorSoA<Real, 3> & points,
+                      VectorSoA<Real, 3> & result, const size_t & threads = 1);
+
+// The directions as (x, y, z, 0), so only the upper 3x3 block applies
+template<typename Real>
+void transform_directions(const Matrix<Real, 4> & matrix, const Vector<Real, 3> * directions, const size_t & count,
+                          Vector<Real, 3> * result, const size_t & threads = 1);
+
+template<typename Real>
+void transform_directions(const Matrix<Real, 4> & matrix, const VectorSoA<Real, 3> & directions,
+                          VectorSoA<Real, 3> & result, const size_t & threads = 1);
+
+template<typename Real>
+void transform_homogeneous(const Matrix<Real, 4> & matrix, const Vector<Real, 4> * vectors, const size_t & count,
+                           Vector<Real, 4> * result, const size_t & threads = 1);
+
+template<typename Real>
+void transform_homogeneous(const Matrix<Real, 4> & matrix, const VectorSoA<Real, 4> & vectors,
+                           VectorSoA<Real, 4> & result, const size_t & threads = 1);
+
+// Rotates the vectors by one unit quaternion, or each vector by its own,
+// giving the same as quaternion_rotate on every vector
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> & quaternion, const Vector<Real, 3> * vectors, const size_t & count,
+                       Vector<Real, 3> * result, const size_t & threads = 1);
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> * quaternions, const Vector<Real, 3> * vectors, const size_t & count,
+                       Vector<Real, 3> * result, const size_t & threads = 1);
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> & quaternion, const VectorSoA<Real, 3> & vectors,
+                       VectorSoA<Real, 3> & result, const size_t & threads = 1);
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> * quaternions, const VectorSoA<Real, 3> & vectors,
+                       VectorSoA<Real, 3> & result, const size_t & threads = 1);
+
+// Interpolates each pair from[i], to[i] by t[i], giving the same as the
+// quaternion_nlerp, quaternion_fast_slerp and quaternion_slerp of the pair
+template<typename Real>
+void quaternion_nlerp(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                      const size_t & count, Quaternion<Real> * result, const size_t & threads = 1);
+
+template<typename Real>
+void quaternion_fast_slerp(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                           const size_t & count, Quaternion<Real> * result, const size_t & threads = 1);
+
+template<typename Real>
+void quaternion_slerp(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                      const size_t & count, Quaternion<Real> * result, const size_t & threads = 1);
+
+// Normalizes every vector or quaternion of the array, giving the same as
+// normalize_vector_fast and quaternion_normalize_fast. Zero vectors are left
+// with non finite components.
+template<typename Real, size_t dim>
+void normalize_vector_fast(Vector<Real, dim> * vectors, const size_t & count, const size_t & threads = 1);
+
+template<typename Real>
+void quaternion_normalize_fast(Quaternion<Real> * quaternions, const size_t & count, const size_t & threads = 1);
+
+// Skinning: blends the transforms influencing each vertex, giving the same
+// as dual_quaternion_blend on them. The indices into transforms and the
+// weights of vertex i start at i * influences.
+template<typename Real>
+void dual_quaternion_blend(const DualQuaternion<Real> * transforms, const size_t * indices, const Real * weights,
+                           const size_t & influences, const size_t & count, DualQuaternion<Real> * result,
+                           const size_t & threads = 1);
+
+// Moves each point by its own unit dual quaternion, giving the same as
+// dual_quaternion_transform_point
+template<typename Real>
+void dual_quaternion_transform_points(const DualQuaternion<Real> * transforms, const Vector<Real, 3> * points,
+                                      const size_t & count, Vector<Real, 3> * result, const size_t & threads = 1);
+
+template<typename Real>
+void dual_quaternion_transform_points(const DualQuaternion<Real> * transforms, const VectorSoA<Real, 3> & points,
+                                      VectorSoA<Real, 3> & result, const size_t & threads = 1);
+
+#define INCLUDED_FROM_BATCH_TRANSFORM_H
+#include "batch_transform_tmpl.h"
+#undef INCLUDED_FROM_BATCH_TRANSFORM_H
+
+}
+
+#endif
@@ -0,0 +1,912 @@
+#ifndef INCLUDED_FROM_BATCH_TRANSFORM_H
+#error "batch_transform_tmpl.h should only be included from batch_transform.h"
+#else
+
+// Kernels over the vectors [begin, end) of an array. The generic versions
+// work a scalar at a time, float and double get register versions below.
+
+template<typename Real>
+void transform_points_range(const Matrix<Real, 4> & matrix, const bool & affine,
+                            const Vector<Real, 3> * points, Vector<Real, 3> * result,
+                            const size_t & begin, const size_t & end)
+{
+    const Real * m = matrix.begin();
+    for (size_t i = begin; i < end; ++i) {
+        const Real * point = points[i].begin();
+        const Real x = point[0];
+        const Real y = point[1];
+        const Real z = point[2];
+
+        Real transformed[3] = {m[0]*x + m[1]*y + m[2]*z + m[3],
+                               m[4]*x + m[5]*y + m[6]*z + m[7],
+                               m[8]*x + m[9]*y + m[10]*z + m[11]};
+        if (!affine) {
+            const Real w = m[12]*x + m[13]*y + m[14]*z + m[15];
+            for (auto & element : transformed) {
+                element /= w;
+            }
+        }
+        std::copy(transformed, transformed + 3, result[i].begin());
+    }
+}
+
+template<typename Real>
+void transform_directions_range(const Matrix<Real, 4> & matrix,
+                                const Vector<Real, 3> * directions, Vector<Real, 3> * result,
+                                const size_t & begin, const size_t & end)
+{
+    const Real * m = matrix.begin();
+    for (size_t i = begin; i < end; ++i) {
+        const Real * direction = directions[i].begin();
+        const Real x = direction[0];
+        const Real y = direction[1];
+        const Real z = direction[2];
+
+        const Real transformed[3] = {m[0]*x + m[1]*y + m[2]*z,
+                                     m[4]*x + m[5]*y + m[6]*z,
+                                     m[8]*x + m[9]*y + m[10]*z};
+        std::copy(transformed, transformed + 3, result[i].begin());
+    }
+}
+
+template<typename Real>
+void transform_homogeneous_range(const Matrix<Real, 4> & matrix,
+                                 const Vector<Real, 4> * vectors, Vector<Real, 4> * result,
+                                 const size_t & begin, const size_t & end)
+{
+    const Real * m = matrix.begin();
+    for (size_t i = begin; i < end; ++i) {
+        const Real * vector = vectors[i].begin();
+        const Real x = vector[0];
+        const Real y = vector[1];
+        const Real z = vector[2];
+        const Real w = vector[3];
+
+        const Real transformed[4] = {m[0]*x + m[1]*y + m[2]*z + m[3]*w,
+                                     m[4]*x + m[5]*y + m[6]*z + m[7]*w,
+                                     m[8]*x + m[9]*y + m[10]*z + m[11]*w,
+                                     m[12]*x + m[13]*y + m[14]*z + m[15]*w};
+        std::copy(transformed, transformed + 4, result[i].begin());
+    }
+}
+
+template<typename Real>
+void rotate_vectors_range(const Quaternion<Real> & quaternion,
+                          const Vector<Real, 3> * vectors, Vector<Real, 3> * result,
+                          const size_t & begin, const size_t & end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        result[i] = quaternion_rotate(quaternion, vectors[i]);
+    }
+}
+
+template<typename Real>
+void rotate_vectors_range(const Quaternion<Real> * quaternions,
+                          const Vector<Real, 3> * vectors, Vector<Real, 3> * result,
+                          const size_t & begin, const size_t & end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        result[i] = quaternion_rotate(quaternions[i], vectors[i]);
+    }
+}
+
+#ifdef MATH_USE_SSE2
+
+// A vector at a time, as the columns of the matrix scaled by its elements
+// and summed. Three dimensional vectors are padded to four lanes, the
+// padding lane of the results is cleared by selecting zero through the keep
+// mask. Multiplying by zero would turn an infinite or NaN lane into NaN.
+template<typename Real>
+struct MatrixColumns
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    explicit MatrixColumns(const Matrix<Real, 4> & matrix)
+        : transposed(matrix_transpose(matrix)),
+          c0(reg::loadu(transposed.begin())),
+          c1(reg::loadu(transposed.begin() + 4)),
+          c2(reg::loadu(transposed.begin() + 8)),
+          c3(reg::loadu(transposed.begin() + 12)),
+          keep(Simd::equal(reg::loadu(keep_elements), reg::broadcast(1))),
+          zero(reg::broadcast(0))
+    { }
+
+    reg clear_padding(const reg & transformed) const
+    {
+        return Simd::select(keep, transformed, zero);
+    }
+
+    static constexpr Real keep_elements[4] = {1, 1, 1, 0};
+
+    const Matrix<Real, 4> transposed;
+    const reg c0;
+    const reg c1;
+    const reg c2;
+    const reg c3;
+    const reg keep;
+    const reg zero;
+};
+
+template<typename Real>
+constexpr Real MatrixColumns<Real>::keep_elements[4];
+
+template<typename Real>
+void simd_transform_points_range(const Matrix<Real, 4> & matrix, const bool & affine,
+                                 const Vector<Real, 3> * points, Vector<Real, 3> * result,
+                                 const size_t & begin, const size_t & end)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const MatrixColumns<Real> columns(matrix);
+
+    for (size_t i = begin; i < end; ++i) {
+        const Real * point = points[i].begin();
+        const reg transformed = columns.c0 * reg::broadcast(point[0]) +
+                                columns.c1 * reg::broadcast(point[1]) +
+                                columns.c2 * reg::broadcast(point[2]) +
+                                columns.c3;
+        if (affine) {
+            columns.clear_padding(transformed).storeu(result[i].begin());
+        } else {
+            columns.clear_padding(transformed / Simd::shuffle<3, 3, 3, 3>(transformed)).storeu(result[i].begin());
+        }
+    }
+}
+
+template<typename Real>
+void simd_transform_directions_range(const Matrix<Real, 4> & matrix,
+                                     const Vector<Real, 3> * directions, Vector<Real, 3> * result,
+                                     const size_t & begin, const size_t & end)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const MatrixColumns<Real> columns(matrix);
+
+    for (size_t i = begin; i < end; ++i) {
+        const Real * direction = directions[i].begin();
+        columns.clear_padding(columns.c0 * reg::broadcast(direction[0]) +
+                              columns.c1 * reg::broadcast(direction[1]) +
+                              columns.c2 * reg::broadcast(direction[2])).storeu(result[i].begin());
+    }
+}
+
+template<typename Real>
+void simd_transform_homogeneous_range(const Matrix<Real, 4> & matrix,
+                                      const Vector<Real, 4> * vectors, Vector<Real, 4> * result,
+                                      const size_t & begin, const size_t & end)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const MatrixColumns<Real> columns(matrix);
+
+    for (size_t i = begin; i < end; ++i) {
+        const Real * vector = vectors[i].begin();
+        (columns.c0 * reg::broadcast(vector[0]) +
+         columns.c1 * reg::broadcast(vector[1]) +
+         columns.c2 * reg::broadcast(vector[2]) +
+         columns.c3 * reg::broadcast(vector[3])).storeu(result[i].begin());
+    }
+}
+
+template<typename Real>
+void simd_rotate_vector(const Simd::Register<Real, 4> & w, const Simd::Register<Real, 4> & imag,
+                        const Vector<Real, 3> & vector, Vector<Real, 3> & result)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    const reg v = reg::loadu(vector.begin());
+    const reg t = reg::broadcast(2) * simd_cross_product(imag, v);
+    ((v + w * t) + simd_cross_product(imag, t)).storeu(result.begin());
+}
+
+template<typename Real>
+void simd_rotate_vectors_range(const Quaternion<Real> & quaternion,
+                               const Vector<Real, 3> * vectors, Vector<Real, 3> * result,
+                               const size_t & begin, const size_t & end)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const reg w = reg::broadcast(quaternion.w());
+    const reg imag = reg::loadu(quaternion.imag.begin());
+
+    for (size_t i = begin; i < end; ++i) {
+        simd_rotate_vector(w, imag, vectors[i], result[i]);
+    }
+}
+
+template<typename Real>
+void simd_rotate_vectors_range(const Quaternion<Real> * quaternions,
+                               const Vector<Real, 3> * vectors, Vector<Real, 3> * result,
+                               const size_t & begin, const size_t & end)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    for (size_t i = begin; i < end; ++i) {
+        simd_rotate_vector(reg::broadcast(quaternions[i].w()), reg::loadu(quaternions[i].imag.begin()),
+                           vectors[i], result[i]);
+    }
+}
+
+template<>
+inline void transform_points_range(const Matrix<float, 4> & matrix, const bool & affine,
+                                   const Vector<float, 3> * points, Vector<float, 3> * result,
+                                   const size_t & begin, const size_t & end)
+{
+    simd_transform_points_range(matrix, affine, points, result, begin, end);
+}
+
+template<>
+inline void transform_points_range(const Matrix<double, 4> & matrix, const bool & affine,
+                                   const Vector<double, 3> * points, Vector<double, 3> * result,
+                                   const size_t & begin, const size_t & end)
+{
+    simd_transform_points_range(matrix, affine, points, result, begin, end);
+}
+
+template<>
+inline void transform_directions_range(const Matrix<float, 4> & matrix,
+                                       const Vector<float, 3> * directions, Vector<float, 3> * result,
+                                       const size_t & begin, const size_t & end)
+{
+    simd_transform_directions_range(matrix, directions, result, begin, end);
+}
+
+template<>
+inline void transform_directions_range(const Matrix<double, 4> & matrix,
+                                       const Vector<double, 3> * directions, Vector<double, 3> * result,
+                                       const size_t & begin, const size_t & end)
+{
+    simd_transform_directions_range(matrix, directions, result, begin, end);
+}
+
+template<>
+inline void transform_homogeneous_range(const Matrix<float, 4> & matrix,
+                                        const Vector<float, 4> * vectors, Vector<float, 4> * result,
+                                        const size_t & begin, const size_t & end)
+{
+    simd_transform_homogeneous_range(matrix, vectors, result, begin, end);
+}
+
+template<>
+inline void transform_homogeneous_range(const Matrix<double, 4> & matrix,
+                                        const Vector<double, 4> * vectors, Vector<double, 4> * result,
+                                        const size_t & begin, const size_t & end)
+{
+    simd_transform_homogeneous_range(matrix, vectors, result, begin, end);
+}
+
+template<>
+inline void rotate_vectors_range(const Quaternion<float> & quaternion,
+                                 const Vector<float, 3> * vectors, Vector<float, 3> * result,
+                                 const size_t & begin, const size_t & end)
+{
+    simd_rotate_vectors_range(quaternion, vectors, result, begin, end);
+}
+
+template<>
+inline void rotate_vectors_range(const Quaternion<float> * quaternions,
+                                 const Vector<float, 3> * vectors, Vector<float, 3> * result,
+                                 const size_t & begin, const size_t & end)
+{
+    simd_rotate_vectors_range(quaternions, vectors, result, begin, end);
+}
+
+template<>
+inline void rotate_vectors_range(const Quaternion<double> & quaternion,
+                                 const Vector<double, 3> * vectors, Vector<double, 3> * result,
+                                 const size_t & begin, const size_t & end)
+{
+    simd_rotate_vectors_range(quaternion, vectors, result, begin, end);
+}
+
+template<>
+inline void rotate_vectors_range(const Quaternion<double> * quaternions,
+                                 const Vector<double, 3> * vectors, Vector<double, 3> * result,
+                                 const size_t & begin, const size_t & end)
+{
+    simd_rotate_vectors_range(quaternions, vectors, result, begin, end);
+}
+
+#endif
+
+// Kernels over the vectors [begin, end) of a batch, a register of vectors at
+// a time. The rest of the range goes through the same code with scalar
+// registers.
+template<typename reg, typename Real>
+reg transform_row(const Real * row, const reg & x, const reg & y, const reg & z)
+{
+    return reg::broadcast(row[0]) * x + reg::broadcast(row[1]) * y + reg::broadcast(row[2]) * z;
+}
+
+template<typename reg, typename Real>
+void transform_points_block(const Matrix<Real, 4> & matrix, const bool & affine,
+                            const Real * const input[3], Real * const output[3], const size_t & i)
+{
+    const Real * m = matrix.begin();
+    const reg x = reg::loadu(input[0] + i);
+    const reg y = reg::loadu(input[1] + i);
+    const reg z = reg::loadu(input[2] + i);
+
+    reg transformed[3] = {transform_row(m, x, y, z) + reg::broadcast(m[3]),
+                          transform_row(m + 4, x, y, z) + reg::broadcast(m[7]),
+                          transform_row(m + 8, x, y, z) + reg::broadcast(m[11])};
+    if (!affine) {
+        const reg w = transform_row(m + 12, x, y, z) + reg::broadcast(m[15]);
+        for (auto & element : transformed) {
+            element = element / w;
+        }
+    }
+    for (size_t c = 0; c < 3; ++c) {
+        transformed[c].storeu(output[c] + i);
+    }
+}
+
+template<typename reg, typename Real>
+void transform_directions_block(const Matrix<Real, 4> & matrix,
+                                const Real * const input[3], Real * const output[3], const size_t & i)
+{
+    const Real * m = matrix.begin();
+    const reg x = reg::loadu(input[0] + i);
+    const reg y = reg::loadu(input[1] + i);
+    const reg z = reg::loadu(input[2] + i);
+
+    const reg transformed[3] = {transform_row(m, x, y, z),
+                                transform_row(m + 4, x, y, z),
+                                transform_row(m + 8, x, y, z)};
+    for (size_t c = 0; c < 3; ++c) {
+        transformed[c].storeu(output[c] + i);
+    }
+}
+
+template<typename reg, typename Real>
+void transform_homogeneous_block(const Matrix<Real, 4> & matrix,
+                                 const Real * const input[4], Real * const output[4], const size_t & i)
+{
+    const Real * m = matrix.begin();
+    const reg x = reg::loadu(input[0] + i);
+    const reg y = reg::loadu(input[1] + i);
+    const reg z = reg::loadu(input[2] + i);
+    const reg w = reg::loadu(input[3] + i);
+
+    const reg transformed[4] = {transform_row(m, x, y, z) + reg::broadcast(m[3]) * w,
+                                transform_row(m + 4, x, y, z) + reg::broadcast(m[7]) * w,
+                                transform_row(m + 8, x, y, z) + reg::broadcast(m[11]) * w,
+                                transform_row(m + 12, x, y, z) + reg::broadcast(m[15]) * w};
+    for (size_t c = 0; c < 4; ++c) {
+        transformed[c].storeu(output[c] + i);
+    }
+}
+
+// Rotates a register of vectors, each lane by the quaternion in the same
+// lane of w and imag
+template<typename reg>
+void rotate_lanes(const reg & w, const reg imag[3], reg vector[3])
+{
+    const reg two = reg::broadcast(2);
+    const reg t[3] = {two * (imag[1] * vector[2] - imag[2] * vector[1]),
+                      two * (imag[2] * vector[0] - imag[0] * vector[2]),
+                      two * (imag[0] * vector[1] - imag[1] * vector[0])};
+
+    vector[0] = (vector[0] + w * t[0]) + (imag[1] * t[2] - imag[2] * t[1]);
+    vector[1] = (vector[1] + w * t[1]) + (imag[2] * t[0] - imag[0] * t[2]);
+    vector[2] = (vector[2] + w * t[2]) + (imag[0] * t[1] - imag[1] * t[0]);
+}
+
+template<typename reg, typename Real>
+void rotate_vectors_block(const Quaternion<Real> & quaternion,
+                          const Real * const input[3], Real * const output[3], const size_t & i)
+{
+    const reg imag[3] = {reg::broadcast(quaternion.x()), reg::broadcast(quaternion.y()),
+                         reg::broadcast(quaternion.z())};
+    reg vector[3] = {reg::loadu(input[0] + i), reg::loadu(input[1] + i), reg::loadu(input[2] + i)};
+
+    rotate_lanes(reg::broadcast(quaternion.w()), imag, vector);
+    for (size_t c = 0; c < 3; ++c) {
+        vector[c].storeu(output[c] + i);
+    }
+}
+
+// Quaternions are stored one after the other, so a register of them is
+// moved in and out of lanes a component at a time, in the order w, x, y, z
+template<typename reg, typename Real>
+void load_quaternions(const Quaternion<Real> * quaternions, reg components[4])
+{
+    const size_t stride = sizeof(Quaternion<Real>) / sizeof(Real);
+    components[0] = reg::gather(&quaternions->real, stride);
+    for (size_t c = 1; c < 4; ++c) {
+        components[c] = reg::gather(quaternions->imag.begin() + c - 1, stride);
+    }
+}
+
+template<typename reg, typename Real>
+void store_quaternions(const reg components[4], Quaternion<Real> * quaternions)
+{
+    Real lanes[4][reg::size];
+    for (size_t c = 0; c < 4; ++c) {
+        components[c].storeu(lanes[c]);
+    }
+    for (size_t lane = 0; lane < reg::size; ++lane) {
+        quaternions[lane].w() = lanes[0][lane];
+        quaternions[lane].x() = lanes[1][lane];
+        quaternions[lane].y() = lanes[2][lane];
+        quaternions[lane].z() = lanes[3][lane];
+    }
+}
+
+template<typename reg, typename Real>
+void rotate_vectors_block(const Quaternion<Real> * quaternions,
+                          const Real * const input[3], Real * const output[3], const size_t & i)
+{
+    reg quaternion[4] = {reg::broadcast(0), reg::broadcast(0), reg::broadcast(0), reg::broadcast(0)};
+    load_quaternions(quaternions + i, quaternion);
+    reg vector[3] = {reg::loadu(input[0] + i), reg::loadu(input[1] + i), reg::loadu(input[2] + i)};
+
+    rotate_lanes(quaternion[0], quaternion + 1, vector);
+    for (size_t c = 0; c < 3; ++c) {
+        vector[c].storeu(output[c] + i);
+    }
+}
+
+template<typename reg>
+reg quaternion_dot_lanes(const reg left[4], const reg right[4])
+{
+    return left[0] * right[0] + ((left[1] * right[1] + left[2] * right[2]) + left[3] * right[3]);
+}
+
+template<typename reg, typename Real>
+void nlerp_block(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                 Quaternion<Real> * result, const size_t & i)
+{
+    const reg zero = reg::broadcast(0);
+    const reg one = reg::broadcast(1);
+    reg from_lanes[4] = {zero, zero, zero, zero};
+    reg to_lanes[4] = {zero, zero, zero, zero};
+    load_quaternions(from + i, from_lanes);
+    load_quaternions(to + i, to_lanes);
+
+    const reg t_lanes = reg::loadu(t + i);
+    const reg from_scale = one - t_lanes;
+    const reg to_scale = copysign(one, quaternion_dot_lanes(from_lanes, to_lanes)) * t_lanes;
+
+    reg interpolated[4] = {zero, zero, zero, zero};
+    for (size_t c = 0; c < 4; ++c) {
+        interpolated[c] = from_lanes[c] * from_scale + to_lanes[c] * to_scale;
+    }
+
+    const reg scale = one / sqrt(((interpolated[1] * interpolated[1] + interpolated[2] * interpolated[2]) +
+                                  interpolated[3] * interpolated[3]) + interpolated[0] * interpolated[0]);
+    for (auto & component : interpolated) {
+        component = component * scale;
+    }
+    store_quaternions(interpolated, result + i);
+}
+
+template<typename reg, typename Real>
+void fast_slerp_block(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                      Quaternion<Real> * result, const size_t & i)
+{
+    const reg zero = reg::broadcast(0);
+    const reg one = reg::broadcast(1);
+    reg from_lanes[4] = {zero, zero, zero, zero};
+    reg to_lanes[4] = {zero, zero, zero, zero};
+    load_quaternions(from + i, from_lanes);
+    load_quaternions(to + i, to_lanes);
+
+    const reg t_lanes = reg::loadu(t + i);
+    const reg cos = quaternion_dot_lanes(from_lanes, to_lanes);
+    const reg cos_minus_one = abs(cos) - one;
+    const reg from_scale = fast_slerp_weight<Real>(one - t_lanes, cos_minus_one);
+    const reg to_scale = copysign(one, cos) * fast_slerp_weight<Real>(t_lanes, cos_minus_one);
+
+    reg interpolated[4] = {zero, zero, zero, zero};
+    for (size_t c = 0; c < 4; ++c) {
+        interpolated[c] = from_lanes[c] * from_scale + to_lanes[c] * to_scale;
+    }
+    store_quaternions(interpolated, result + i);
+}
+
+template<typename Real>
+void transform_points(const Matrix<Real, 4> & matrix, const Vector<Real, 3> * points, const size_t & count,
+                      Vector<Real, 3> * result, const size_t & threads)
+{
+    const bool affine = matrix_is_affine(matrix);
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        transform_points_range(matrix, affine, points, result, begin, end);
+    });
+}
+
+template<typename Real>
+void transform_points(const Matrix<Real, 4> & matrix, const VectorSoA<Real, 3> & points,
+                      VectorSoA<Real, 3> & result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    result.resize(points.size());
+    const Real * const input[3] = {points.component(0), points.component(1), points.component(2)};
+    Real * const output[3] = {result.component(0), result.component(1), result.component(2)};
+
+    const bool affine = matrix_is_affine(matrix);
+    parallel_for(points.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            transform_points_block<reg>(matrix, affine, input, output, i);
+        }
+        for (; i < end; ++i) {
+            transform_points_block<scalar>(matrix, affine, input, output, i);
+        }
+    });
+}
+
+template<typename Real>
+void transform_directions(const Matrix<Real, 4> & matrix, const Vector<Real, 3> * directions, const size_t & count,
+                          Vector<Real, 3> * result, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        transform_directions_range(matrix, directions, result, begin, end);
+    });
+}
+
+template<typename Real>
+void transform_directions(const Matrix<Real, 4> & matrix, const VectorSoA<Real, 3> & directions,
+                          VectorSoA<Real, 3> & result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    result.resize(directions.size());
+    const Real * const input[3] = {directions.component(0), directions.component(1), directions.component(2)};
+    Real * const output[3] = {result.component(0), result.component(1), result.component(2)};
+
+    parallel_for(directions.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            transform_directions_block<reg>(matrix, input, output, i);
+        }
+        for (; i < end; ++i) {
+            transform_directions_block<scalar>(matrix, input, output, i);
+        }
+    });
+}
+
+template<typename Real>
+void transform_homogeneous(const Matrix<Real, 4> & matrix, const Vector<Real, 4> * vectors, const size_t & count,
+                           Vector<Real, 4> * result, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        transform_homogeneous_range(matrix, vectors, result, begin, end);
+    });
+}
+
+template<typename Real>
+void transform_homogeneous(const Matrix<Real, 4> & matrix, const VectorSoA<Real, 4> & vectors,
+                           VectorSoA<Real, 4> & result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    result.resize(vectors.size());
+    const Real * const input[4] = {vectors.component(0), vectors.component(1),
+                                   vectors.component(2), vectors.component(3)};
+    Real * const output[4] = {result.component(0), result.component(1),
+                              result.component(2), result.component(3)};
+
+    parallel_for(vectors.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            transform_homogeneous_block<reg>(matrix, input, output, i);
+        }
+        for (; i < end; ++i) {
+            transform_homogeneous_block<scalar>(matrix, input, output, i);
+        }
+    });
+}
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> & quaternion, const Vector<Real, 3> * vectors, const size_t & count,
+                       Vector<Real, 3> * result, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        rotate_vectors_range(quaternion, vectors, result, begin, end);
+    });
+}
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> * quaternions, const Vector<Real, 3> * vectors, const size_t & count,
+                       Vector<Real, 3> * result, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        rotate_vectors_range(quaternions, vectors, result, begin, end);
+    });
+}
+
+// The single quaternion and the array of them differ only in how a block
+// reads its quaternions
+template<typename Real, typename Quaternions>
+void rotate_vectors(const Quaternions & quaternions, const VectorSoA<Real, 3> & vectors,
+                    VectorSoA<Real, 3> & result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    result.resize(vectors.size());
+    const Real * const input[3] = {vectors.component(0), vectors.component(1), vectors.component(2)};
+    Real * const output[3] = {result.component(0), result.component(1), result.component(2)};
+
+    parallel_for(vectors.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            rotate_vectors_block<reg>(quaternions, input, output, i);
+        }
+        for (; i < end; ++i) {
+            rotate_vectors_block<scalar>(quaternions, input, output, i);
+        }
+    });
+}
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> & quaternion, const VectorSoA<Real, 3> & vectors,
+                       VectorSoA<Real, 3> & result, const size_t & threads)
+{
+    rotate_vectors(quaternion, vectors, result, threads);
+}
+
+template<typename Real>
+void quaternion_rotate(const Quaternion<Real> * quaternions, const VectorSoA<Real, 3> & vectors,
+                       VectorSoA<Real, 3> & result, const size_t & threads)
+{
+    rotate_vectors(quaternions, vectors, result, threads);
+}
+
+template<typename Real>
+void quaternion_nlerp(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                      const size_t & count, Quaternion<Real> * result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            nlerp_block<reg>(from, to, t, result, i);
+        }
+        for (; i < end; ++i) {
+            nlerp_block<scalar>(from, to, t, result, i);
+        }
+    });
+}
+
+template<typename Real>
+void quaternion_fast_slerp(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                           const size_t & count, Quaternion<Real> * result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            fast_slerp_block<reg>(from, to, t, result, i);
+        }
+        for (; i < end; ++i) {
+            fast_slerp_block<scalar>(from, to, t, result, i);
+        }
+    });
+}
+
+// acos and sin have no register versions, so these go a pair at a time
+template<typename Real>
+void quaternion_slerp(const Quaternion<Real> * from, const Quaternion<Real> * to, const Real * t,
+                      const size_t & count, Quaternion<Real> * result, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = quaternion_slerp(from[i], to[i], t[i]);
+        }
+    });
+}
+
+// The squared lengths of a register of vectors are summed lane by lane, the
+// scales are then applied a vector at a time
+template<typename reg, typename Real, size_t dim>
+void normalize_vectors_block(Vector<Real, dim> * vectors)
+{
+    const size_t stride = sizeof(Vector<Real, dim>) / sizeof(Real);
+
+    reg sum = reg::gather(vectors->begin(), stride) * reg::gather(vectors->begin(), stride);
+    for (size_t c = 1; c < dim; ++c) {
+        const reg value = reg::gather(vectors->begin() + c, stride);
+        sum = sum + value * value;
+    }
+
+    Real scales[reg::size];
+    rsqrt(sum).storeu(scales);
+    for (size_t lane = 0; lane < reg::size; ++lane) {
+        vectors[lane] *= scales[lane];
+    }
+}
+
+template<typename Real, size_t dim>
+void normalize_vector_fast(Vector<Real, dim> * vectors, const size_t & count, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            normalize_vectors_block<reg>(vectors + i);
+        }
+        for (; i < end; ++i) {
+            normalize_vectors_block<scalar>(vectors + i);
+        }
+    });
+}
+
+// There is too little arithmetic to pay for moving quaternions in and out of
+// lanes, so these go one at a time
+template<typename Real>
+void quaternion_normalize_fast(Quaternion<Real> * quaternions, const size_t & count, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        for (size_t i = begin; i < end; ++i) {
+            quaternion_normalize_fast(quaternions[i]);
+        }
+    });
+}
+
+// Dual quaternions are packed, eight scalars apart. A register of them is
+// gathered a component at a time, from the array or through indices into it.
+template<typename Real>
+struct DualQuaternionLanes
+{
+    static const size_t stride = sizeof(DualQuaternion<Real>) / sizeof(Real);
+};
+
+template<typename Real>
+const size_t DualQuaternionLanes<Real>::stride;
+
+template<typename reg, typename Real>
+void store_dual_quaternions(const reg components[8], DualQuaternion<Real> * transforms)
+{
+    Real lanes[8][reg::size];
+    for (size_t c = 0; c < 8; ++c) {
+        components[c].storeu(lanes[c]);
+    }
+    for (size_t lane = 0; lane < reg::size; ++lane) {
+        Real * transform = transforms[lane].begin();
+        for (size_t c = 0; c < 8; ++c) {
+            transform[c] = lanes[c][lane];
+        }
+    }
+}
+
+// The lane by lane dual_quaternion_normalize
+template<typename reg>
+void normalize_dual_quaternion_lanes(reg transform[8])
+{
+    reg * real = transform;
+    reg * dual = transform + 4;
+
+    const reg scale = reg::broadcast(1) / sqrt(((real[1] * real[1] + real[2] * real[2]) + real[3] * real[3]) +
+                                               real[0] * real[0]);
+    for (size_t c = 0; c < 4; ++c) {
+        real[c] = real[c] * scale;
+    }
+
+    const reg along = quaternion_dot_lanes(real, dual);
+    for (size_t c = 0; c < 4; ++c) {
+        dual[c] = (dual[c] - real[c] * along) * scale;
+    }
+}
+
+template<typename reg, typename Real>
+void blend_block(const DualQuaternion<Real> * transforms, const size_t * indices, const Real * weights,
+                 const size_t & influences, DualQuaternion<Real> * result, const size_t & i)
+{
+    const reg zero = reg::broadcast(0);
+    const reg one = reg::broadcast(1);
+    const Real * components = transforms->begin();
+
+    reg pivot[4] = {zero, zero, zero, zero};
+    reg blended[8] = {zero, zero, zero, zero, zero, zero, zero, zero};
+    for (size_t k = 0; k < influences; ++k) {
+        size_t offsets[reg::size];
+        for (size_t lane = 0; lane < reg::size; ++lane) {
+            offsets[lane] = indices[(i + lane) * influences + k] * DualQuaternionLanes<Real>::stride;
+        }
+
+        reg transform[8] = {zero, zero, zero, zero, zero, zero, zero, zero};
+        for (size_t c = 0; c < 8; ++c) {
+            transform[c] = reg::gather(components + c, offsets);
+        }
+        if (k == 0) {
+            std::copy(transform, transform + 4, pivot);
+        }
+
+        const reg scale = copysign(one, quaternion_dot_lanes(transform, pivot)) *
+                          reg::gather(weights + i * influences + k, influences);
+        for (size_t c = 0; c < 8; ++c) {
+            blended[c] = blended[c] + transform[c] * scale;
+        }
+    }
+
+    normalize_dual_quaternion_lanes(blended);
+    store_dual_quaternions(blended, result + i);
+}
+
+template<typename reg, typename Real>
+void dual_transform_points_block(const DualQuaternion<Real> * transforms,
+                                 const Real * const input[3], Real * const output[3], const size_t & i)
+{
+    const reg zero = reg::broadcast(0);
+    const reg two = reg::broadcast(2);
+
+    reg transform[8] = {zero, zero, zero, zero, zero, zero, zero, zero};
+    for (size_t c = 0; c < 8; ++c) {
+        transform[c] = reg::gather(transforms[i].begin() + c, DualQuaternionLanes<Real>::stride);
+    }
+    const reg * r = transform;
+    const reg * d = transform + 4;
+    const reg translation[3] = {two * ((r[0] * d[1] - d[0] * r[1]) + (r[2] * d[3] - r[3] * d[2])),
+                                two * ((r[0] * d[2] - d[0] * r[2]) + (r[3] * d[1] - r[1] * d[3])),
+                                two * ((r[0] * d[3] - d[0] * r[3]) + (r[1] * d[2] - r[2] * d[1]))};
+
+    reg point[3] = {reg::loadu(input[0] + i), reg::loadu(input[1] + i), reg::loadu(input[2] + i)};
+    rotate_lanes(r[0], r + 1, point);
+    for (size_t c = 0; c < 3; ++c) {
+        (point[c] + translation[c]).storeu(output[c] + i);
+    }
+}
+
+template<typename Real>
+void dual_quaternion_blend(const DualQuaternion<Real> * transforms, const size_t * indices, const Real * weights,
+                           const size_t & influences, const size_t & count, DualQuaternion<Real> * result,
+                           const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    assert(influences > 0 && "Can not blend zero transforms");
+
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            blend_block<reg>(transforms, indices, weights, influences, result, i);
+        }
+        for (; i < end; ++i) {
+            blend_block<scalar>(transforms, indices, weights, influences, result, i);
+        }
+    });
+}
+
+template<typename Real>
+void dual_quaternion_transform_points(const DualQuaternion<Real> * transforms, const Vector<Real, 3> * points,
+                                      const size_t & count, Vector<Real, 3> * result, const size_t & threads)
+{
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = dual_quaternion_transform_point(transforms[i], points[i]);
+        }
+    });
+}
+
+template<typename Real>
+void dual_quaternion_transform_points(const DualQuaternion<Real> * transforms, const VectorSoA<Real, 3> & points,
+                                      VectorSoA<Real, 3> & result, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    result.resize(points.size());
+    const Real * const input[3] = {points.component(0), points.component(1), points.component(2)};
+    Real * const output[3] = {result.component(0), result.component(1), result.component(2)};
+
+    parallel_for(points.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            dual_transform_points_block<reg>(transforms, input, output, i);
+        }
+        for (; i < end; ++i) {
+            dual_transform_points_block<scalar>(transforms, input, output, i);
+        }
+    });
+}
+
+#endif
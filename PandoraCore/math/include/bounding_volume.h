@@ -0,0 +1,157 @@
+#ifndef MATH_BOUNDING_VOLUME_H_INCLUDED
+#define MATH_BOUNDING_VOLUME_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "vector3.h"
+#include "vector_soa.h"
+#include "parallel.h"
+
+#include <limits>
+
+namespace Math
+{
+
+// An axis aligned box, from its smallest to its largest corner. The default
+// box is empty, with the corners at +infinity and -infinity, so merging or
+// expanding anything into it gives that thing.
+template<typename Real>
+class AABB
+{
+public:
+    explicit AABB();
+    explicit AABB(const Vector<Real, 3> & minimum, const Vector<Real, 3> & maximum);
+
+    // The smallest box holding all the points
+    explicit AABB(const Vector<Real, 3> * points, const size_t & count);
+    explicit AABB(const VectorSoA<Real, 3> & points);
+
+    const Vector<Real, 3> & get_min() const;
+    const Vector<Real, 3> & get_max() const;
+
+    bool is_empty() const;
+    Vector<Real, 3> get_center() const;
+    Vector<Real, 3> get_half_size() const;
+private:
+    Vector<Real, 3> minimum;
+    Vector<Real, 3> maximum;
+};
+
+typedef AABB<float>  AABBf;
+typedef AABB<double> AABBd;
+
+// A ball around a center. The default sphere is empty, with a negative
+// radius.
+template<typename Real>
+class Sphere
+{
+public:
+    explicit Sphere();
+    explicit Sphere(const Vector<Real, 3> & center, const Real & radius);
+
+    // A sphere holding all the points, around the center of their box. It is
+    // not the smallest one, but never has more than sqrt(3) times its radius.
+    explicit Sphere(const Vector<Real, 3> * points, const size_t & count);
+    explicit Sphere(const VectorSoA<Real, 3> & points);
+
+    const Vector<Real, 3> & get_center() const;
+    const Real & get_radius() const;
+
+    bool is_empty() const;
+private:
+    Vector<Real, 3> center;
+    Real radius;
+};
+
+typedef Sphere<float>  Spheref;
+typedef Sphere<double> Sphered;
+
+// The points origin + t * direction for t >= 0. The direction does not have
+// to be of unit length, distances along the ray are in units of its length.
+// The inverse of the direction is kept for the slab tests, with a zero
+// component giving an infinity.
+template<typename Real>
+class Ray
+{
+public:
+    explicit Ray(const Vector<Real, 3> & origin, const Vector<Real, 3> & direction);
+
+    const Vector<Real, 3> & get_origin() const;
+    const Vector<Real, 3> & get_direction() const;
+    const Vector<Real, 3> & get_inverse_direction() const;
+private:
+    Vector<Real, 3> origin;
+    Vector<Real, 3> direction;
+    Vector<Real, 3> inverse_direction;
+};
+
+typedef Ray<float>  Rayf;
+typedef Ray<double> Rayd;
+
+// The smallest box holding both boxes, or the box and the point
+template<typename Real>
+AABB<Real> aabb_merge(const AABB<Real> & left, const AABB<Real> & right);
+
+template<typename Real>
+AABB<Real> aabb_expand(const AABB<Real> & box, const Vector<Real, 3> & point);
+
+// Moves every face of the box out by margin
+template<typename Real>
+AABB<Real> aabb_expand(const AABB<Real> & box, const Real & margin);
+
+// Touching counts as overlapping, and nothing overlaps an empty box
+template<typename Real>
+bool aabb_contains(const AABB<Real> & box, const Vector<Real, 3> & point);
+
+template<typename Real>
+bool aabb_overlaps(const AABB<Real> & left, const AABB<Real> & right);
+
+template<typename Real>
+bool aabb_overlaps(const AABB<Real> & box, const Sphere<Real> & sphere);
+
+// The smallest sphere holding both spheres, or the sphere and the point
+template<typename Real>
+Sphere<Real> sphere_merge(const Sphere<Real> & left, const Sphere<Real> & right);
+
+template<typename Real>
+Sphere<Real> sphere_expand(const Sphere<Real> & sphere, const Vector<Real, 3> & point);
+
+template<typename Real>
+bool sphere_contains(const Sphere<Real> & sphere, const Vector<Real, 3> & point);
+
+template<typename Real>
+bool sphere_overlaps(const Sphere<Real> & left, const Sphere<Real> & right);
+
+// Slab test: the ray is clipped against the three pairs of planes with
+// min/max only, so there are no branches on the direction. On a hit distance
+// is where the ray enters the box, zero when it starts inside. Touching the
+// box counts as a hit, and an empty box is never hit. A ray lying exactly in
+// the plane of a face has 0 * infinity for that face, and may go either way.
+template<typename Real>
+bool aabb_intersects_ray(const AABB<Real> & box, const Ray<Real> & ray, Real & distance);
+
+template<typename Real>
+bool aabb_intersects_ray(const AABB<Real> & box, const Ray<Real> & ray);
+
+// Batched slab tests, a register of boxes or rays at a time, optionally
+// spread over threads (see parallel_for). distances[i] is what
+// aabb_intersects_ray gives for box or ray i, bit for bit, and +infinity
+// where it misses.
+
+// One ray against the boxes from minimums[i] to maximums[i]
+template<typename Real>
+void aabb_intersect_ray(const VectorSoA<Real, 3> & minimums, const VectorSoA<Real, 3> & maximums,
+                        const Ray<Real> & ray, Real * distances, const size_t & threads = 1);
+
+// The rays from origins[i] along directions[i] against one box
+template<typename Real>
+void aabb_intersect_rays(const AABB<Real> & box, const VectorSoA<Real, 3> & origins,
+                         const VectorSoA<Real, 3> & directions, Real * distances, const size_t & threads = 1);
+
+#define INCLUDED_FROM_BOUNDING_VOLUME_H
+#include "bounding_volume_tmpl.h"
+#undef INCLUDED_FROM_BOUNDING_VOLUME_H
+
+}
+
+#endif
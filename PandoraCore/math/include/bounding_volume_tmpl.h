@@ -0,0 +1,535 @@
+#ifndef INCLUDED_FROM_BOUNDING_VOLUME_H
+#error "bounding_volume_tmpl.h can only be included from bounding_volume.h"
+#else
+
+// The corners of the box around [0, count) points, count > 0. The generic
+// version works a scalar at a time, float and double get a register version
+// below.
+template<typename Real>
+void points_bounds(const Vector<Real, 3> * points, const size_t & count,
+                   Vector<Real, 3> & minimum, Vector<Real, 3> & maximum)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    minimum = points[0];
+    maximum = points[0];
+    for (size_t i = 1; i < count; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            minimum[c] = Simd::min(scalar(minimum[c]), scalar(points[i][c])).value;
+            maximum[c] = Simd::max(scalar(maximum[c]), scalar(points[i][c])).value;
+        }
+    }
+}
+
+#ifdef MATH_USE_SSE2
+
+// A point per register, padding lane included, which stays zero. Two pairs
+// of running corners take every other point, so the min and max of one
+// point do not wait for the previous one.
+template<typename Real>
+void simd_points_bounds(const Vector<Real, 3> * points, const size_t & count,
+                        Vector<Real, 3> & minimum, Vector<Real, 3> & maximum)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    reg low[2] = {reg::loadu(points[0].begin()), reg::loadu(points[0].begin())};
+    reg high[2] = {low[0], low[0]};
+
+    size_t i = 1;
+    for (; i + 2 <= count; i += 2) {
+        for (size_t j = 0; j < 2; ++j) {
+            const reg point = reg::loadu(points[i + j].begin());
+            low[j] = Simd::min(low[j], point);
+            high[j] = Simd::max(high[j], point);
+        }
+    }
+    if (i < count) {
+        const reg point = reg::loadu(points[i].begin());
+        low[0] = Simd::min(low[0], point);
+        high[0] = Simd::max(high[0], point);
+    }
+    Simd::min(low[0], low[1]).storeu(minimum.begin());
+    Simd::max(high[0], high[1]).storeu(maximum.begin());
+}
+
+template<>
+inline void points_bounds(const Vector<float, 3> * points, const size_t & count,
+                          Vector<float, 3> & minimum, Vector<float, 3> & maximum)
+{
+    simd_points_bounds(points, count, minimum, maximum);
+}
+
+template<>
+inline void points_bounds(const Vector<double, 3> * points, const size_t & count,
+                          Vector<double, 3> & minimum, Vector<double, 3> & maximum)
+{
+    simd_points_bounds(points, count, minimum, maximum);
+}
+
+#endif
+
+// The smallest and largest of count > 0 values, a register at a time and
+// then across the lanes
+template<typename Real>
+void values_bounds(const Real * values, const size_t & count, Real & minimum, Real & maximum)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    scalar low(values[0]);
+    scalar high(values[0]);
+
+    size_t i = 0;
+    if (count >= reg::size) {
+        reg lows = reg::loadu(values);
+        reg highs = lows;
+        for (i = reg::size; i + reg::size <= count; i += reg::size) {
+            const reg block = reg::loadu(values + i);
+            lows = Simd::min(lows, block);
+            highs = Simd::max(highs, block);
+        }
+
+        Real lanes[2][reg::size];
+        lows.storeu(lanes[0]);
+        highs.storeu(lanes[1]);
+        for (size_t j = 0; j < reg::size; ++j) {
+            low = Simd::min(low, scalar(lanes[0][j]));
+            high = Simd::max(high, scalar(lanes[1][j]));
+        }
+    }
+    for (; i < count; ++i) {
+        low = Simd::min(low, scalar(values[i]));
+        high = Simd::max(high, scalar(values[i]));
+    }
+    minimum = low.value;
+    maximum = high.value;
+}
+
+// The largest squared distance from center to [0, count) points
+template<typename Real>
+Real points_radius_squared(const Vector<Real, 3> * points, const size_t & count, const Vector<Real, 3> & center)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    scalar radius_squared(0);
+    for (size_t i = 0; i < count; ++i) {
+        const Real offset[3] = {points[i][0] - center[0], points[i][1] - center[1], points[i][2] - center[2]};
+        radius_squared = Simd::max(radius_squared,
+                                   scalar((offset[0] * offset[0] + offset[1] * offset[1]) + offset[2] * offset[2]));
+    }
+    return radius_squared.value;
+}
+
+template<typename Real>
+Real points_radius_squared(const VectorSoA<Real, 3> & points, const Vector<Real, 3> & center)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    const Real * const input[3] = {points.component(0), points.component(1), points.component(2)};
+    scalar radius_squared(0);
+
+    size_t i = 0;
+    if (points.size() >= reg::size) {
+        const reg middle[3] = {reg::broadcast(center[0]), reg::broadcast(center[1]), reg::broadcast(center[2])};
+        reg largest = reg::broadcast(0);
+        for (; i + reg::size <= points.size(); i += reg::size) {
+            const reg offset[3] = {reg::loadu(input[0] + i) - middle[0],
+                                   reg::loadu(input[1] + i) - middle[1],
+                                   reg::loadu(input[2] + i) - middle[2]};
+            largest = Simd::max(largest, (offset[0] * offset[0] + offset[1] * offset[1]) + offset[2] * offset[2]);
+        }
+
+        Real lanes[reg::size];
+        largest.storeu(lanes);
+        for (size_t j = 0; j < reg::size; ++j) {
+            radius_squared = Simd::max(radius_squared, scalar(lanes[j]));
+        }
+    }
+    for (; i < points.size(); ++i) {
+        const Real offset[3] = {input[0][i] - center[0], input[1][i] - center[1], input[2][i] - center[2]};
+        radius_squared = Simd::max(radius_squared,
+                                   scalar((offset[0] * offset[0] + offset[1] * offset[1]) + offset[2] * offset[2]));
+    }
+    return radius_squared.value;
+}
+
+template<typename Real>
+AABB<Real>::AABB()
+    : minimum(std::numeric_limits<Real>::infinity(), std::numeric_limits<Real>::infinity(),
+              std::numeric_limits<Real>::infinity()),
+      maximum(-std::numeric_limits<Real>::infinity(), -std::numeric_limits<Real>::infinity(),
+              -std::numeric_limits<Real>::infinity())
+{ }
+
+template<typename Real>
+AABB<Real>::AABB(const Vector<Real, 3> & minimum, const Vector<Real, 3> & maximum)
+    : minimum(minimum), maximum(maximum)
+{ }
+
+template<typename Real>
+AABB<Real>::AABB(const Vector<Real, 3> * points, const size_t & count)
+    : AABB()
+{
+    if (count > 0) {
+        points_bounds(points, count, minimum, maximum);
+    }
+}
+
+template<typename Real>
+AABB<Real>::AABB(const VectorSoA<Real, 3> & points)
+    : AABB()
+{
+    if (points.size() > 0) {
+        for (size_t c = 0; c < 3; ++c) {
+            values_bounds(points.component(c), points.size(), minimum[c], maximum[c]);
+        }
+    }
+}
+
+template<typename Real>
+const Vector<Real, 3> & AABB<Real>::get_min() const
+{
+    return minimum;
+}
+
+template<typename Real>
+const Vector<Real, 3> & AABB<Real>::get_max() const
+{
+    return maximum;
+}
+
+template<typename Real>
+bool AABB<Real>::is_empty() const
+{
+    return !(minimum[0] <= maximum[0] && minimum[1] <= maximum[1] && minimum[2] <= maximum[2]);
+}
+
+template<typename Real>
+Vector<Real, 3> AABB<Real>::get_center() const
+{
+    return Vector<Real, 3>((minimum + maximum) * Real(0.5));
+}
+
+template<typename Real>
+Vector<Real, 3> AABB<Real>::get_half_size() const
+{
+    return Vector<Real, 3>((maximum - minimum) * Real(0.5));
+}
+
+template<typename Real>
+Sphere<Real>::Sphere()
+    : center(), radius(-1)
+{ }
+
+template<typename Real>
+Sphere<Real>::Sphere(const Vector<Real, 3> & center, const Real & radius)
+    : center(center), radius(radius)
+{ }
+
+template<typename Real>
+Sphere<Real>::Sphere(const Vector<Real, 3> * points, const size_t & count)
+    : Sphere()
+{
+    if (count > 0) {
+        center = AABB<Real>(points, count).get_center();
+        radius = std::sqrt(points_radius_squared(points, count, center));
+    }
+}
+
+template<typename Real>
+Sphere<Real>::Sphere(const VectorSoA<Real, 3> & points)
+    : Sphere()
+{
+    if (points.size() > 0) {
+        center = AABB<Real>(points).get_center();
+        radius = std::sqrt(points_radius_squared(points, center));
+    }
+}
+
+template<typename Real>
+const Vector<Real, 3> & Sphere<Real>::get_center() const
+{
+    return center;
+}
+
+template<typename Real>
+const Real & Sphere<Real>::get_radius() const
+{
+    return radius;
+}
+
+template<typename Real>
+bool Sphere<Real>::is_empty() const
+{
+    return !(radius >= 0);
+}
+
+template<typename Real>
+Ray<Real>::Ray(const Vector<Real, 3> & origin, const Vector<Real, 3> & direction)
+    : origin(origin), direction(direction),
+      inverse_direction(1 / direction[0], 1 / direction[1], 1 / direction[2])
+{ }
+
+template<typename Real>
+const Vector<Real, 3> & Ray<Real>::get_origin() const
+{
+    return origin;
+}
+
+template<typename Real>
+const Vector<Real, 3> & Ray<Real>::get_direction() const
+{
+    return direction;
+}
+
+template<typename Real>
+const Vector<Real, 3> & Ray<Real>::get_inverse_direction() const
+{
+    return inverse_direction;
+}
+
+template<typename Real>
+AABB<Real> aabb_merge(const AABB<Real> & left, const AABB<Real> & right)
+{
+    Vector<Real, 3> minimum;
+    Vector<Real, 3> maximum;
+    for (size_t c = 0; c < 3; ++c) {
+        minimum[c] = std::min(left.get_min()[c], right.get_min()[c]);
+        maximum[c] = std::max(left.get_max()[c], right.get_max()[c]);
+    }
+    return AABB<Real>(minimum, maximum);
+}
+
+template<typename Real>
+AABB<Real> aabb_expand(const AABB<Real> & box, const Vector<Real, 3> & point)
+{
+    return aabb_merge(box, AABB<Real>(point, point));
+}
+
+template<typename Real>
+AABB<Real> aabb_expand(const AABB<Real> & box, const Real & margin)
+{
+    const Vector<Real, 3> offset(margin, margin, margin);
+    return AABB<Real>(Vector<Real, 3>(box.get_min() - offset), Vector<Real, 3>(box.get_max() + offset));
+}
+
+template<typename Real>
+bool aabb_contains(const AABB<Real> & box, const Vector<Real, 3> & point)
+{
+    const Vector<Real, 3> & minimum = box.get_min();
+    const Vector<Real, 3> & maximum = box.get_max();
+    return minimum[0] <= point[0] && point[0] <= maximum[0] &&
+           minimum[1] <= point[1] && point[1] <= maximum[1] &&
+           minimum[2] <= point[2] && point[2] <= maximum[2];
+}
+
+template<typename Real>
+bool aabb_overlaps(const AABB<Real> & left, const AABB<Real> & right)
+{
+    return !left.is_empty() && !right.is_empty() &&
+           left.get_min()[0] <= right.get_max()[0] && right.get_min()[0] <= left.get_max()[0] &&
+           left.get_min()[1] <= right.get_max()[1] && right.get_min()[1] <= left.get_max()[1] &&
+           left.get_min()[2] <= right.get_max()[2] && right.get_min()[2] <= left.get_max()[2];
+}
+
+// The distance from the center to the closest point of the box
+template<typename Real>
+bool aabb_overlaps(const AABB<Real> & box, const Sphere<Real> & sphere)
+{
+    if (box.is_empty() || sphere.is_empty()) {
+        return false;
+    }
+
+    Real distance_squared = 0;
+    for (size_t c = 0; c < 3; ++c) {
+        const Real closest = std::min(std::max(sphere.get_center()[c], box.get_min()[c]), box.get_max()[c]);
+        const Real offset = sphere.get_center()[c] - closest;
+        distance_squared += offset * offset;
+    }
+    return distance_squared <= sphere.get_radius() * sphere.get_radius();
+}
+
+template<typename Real>
+Sphere<Real> sphere_merge(const Sphere<Real> & left, const Sphere<Real> & right)
+{
+    if (left.is_empty()) {
+        return right;
+    }
+    if (right.is_empty()) {
+        return left;
+    }
+
+    const Vector<Real, 3> offset(right.get_center() - left.get_center());
+    const Real distance = vector_length(offset);
+    if (distance + right.get_radius() <= left.get_radius()) {
+        return left;
+    }
+    if (distance + left.get_radius() <= right.get_radius()) {
+        return right;
+    }
+
+    // From the far side of left to the far side of right, which are apart
+    // so distance is not zero here
+    const Real radius = (distance + left.get_radius() + right.get_radius()) / 2;
+    const Vector<Real, 3> center(left.get_center() + offset * ((radius - left.get_radius()) / distance));
+    return Sphere<Real>(center, radius);
+}
+
+template<typename Real>
+Sphere<Real> sphere_expand(const Sphere<Real> & sphere, const Vector<Real, 3> & point)
+{
+    return sphere_merge(sphere, Sphere<Real>(point, 0));
+}
+
+template<typename Real>
+bool sphere_contains(const Sphere<Real> & sphere, const Vector<Real, 3> & point)
+{
+    const Vector<Real, 3> offset(point - sphere.get_center());
+    return dot_product(offset, offset) <= sphere.get_radius() * sphere.get_radius() && !sphere.is_empty();
+}
+
+template<typename Real>
+bool sphere_overlaps(const Sphere<Real> & left, const Sphere<Real> & right)
+{
+    const Vector<Real, 3> offset(right.get_center() - left.get_center());
+    const Real radius = left.get_radius() + right.get_radius();
+    return dot_product(offset, offset) <= radius * radius && !left.is_empty() && !right.is_empty();
+}
+
+// The slab test of a register of rays against a register of boxes, given by
+// their components. The ray is inside all three slabs from entering to
+// leaving, and gap is positive for an empty box. Every version of the test
+// goes through here, the single one with scalar registers, so they all give
+// the same distances.
+template<typename reg, typename Real>
+inline void slab_distances(const reg origin[3], const reg inverse_direction[3],
+                    const reg minimum[3], const reg maximum[3], Real * distances)
+{
+    const Real infinity = std::numeric_limits<Real>::infinity();
+    reg entering = reg::broadcast(0);
+    reg leaving = reg::broadcast(infinity);
+    reg gap = reg::broadcast(-infinity);
+
+    for (size_t c = 0; c < 3; ++c) {
+        const reg to_minimum = (minimum[c] - origin[c]) * inverse_direction[c];
+        const reg to_maximum = (maximum[c] - origin[c]) * inverse_direction[c];
+        entering = Simd::max(Simd::min(to_minimum, to_maximum), entering);
+        leaving = Simd::min(Simd::max(to_minimum, to_maximum), leaving);
+        gap = Simd::max(minimum[c] - maximum[c], gap);
+    }
+
+    Real lanes[3][reg::size];
+    entering.storeu(lanes[0]);
+    leaving.storeu(lanes[1]);
+    gap.storeu(lanes[2]);
+    for (size_t j = 0; j < reg::size; ++j) {
+        distances[j] = lanes[0][j] <= lanes[1][j] && lanes[2][j] <= 0 ? lanes[0][j] : infinity;
+    }
+}
+
+template<typename Real>
+bool aabb_intersects_ray(const AABB<Real> & box, const Ray<Real> & ray, Real & distance)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    const Vector<Real, 3> & from = ray.get_origin();
+    const Vector<Real, 3> & inverse = ray.get_inverse_direction();
+    const Vector<Real, 3> & low = box.get_min();
+    const Vector<Real, 3> & high = box.get_max();
+
+    const scalar origin[3] = {scalar(from[0]), scalar(from[1]), scalar(from[2])};
+    const scalar inverse_direction[3] = {scalar(inverse[0]), scalar(inverse[1]), scalar(inverse[2])};
+    const scalar minimum[3] = {scalar(low[0]), scalar(low[1]), scalar(low[2])};
+    const scalar maximum[3] = {scalar(high[0]), scalar(high[1]), scalar(high[2])};
+
+    slab_distances(origin, inverse_direction, minimum, maximum, &distance);
+    return distance < std::numeric_limits<Real>::infinity();
+}
+
+template<typename Real>
+bool aabb_intersects_ray(const AABB<Real> & box, const Ray<Real> & ray)
+{
+    Real distance;
+    return aabb_intersects_ray(box, ray, distance);
+}
+
+// Kernels over the boxes or rays [i, i + reg::size) of a batch
+template<typename reg, typename Real>
+void intersect_ray_block(const Ray<Real> & ray, const Real * const minimums[3], const Real * const maximums[3],
+                         Real * distances, const size_t & i)
+{
+    const Vector<Real, 3> & from = ray.get_origin();
+    const Vector<Real, 3> & inverse = ray.get_inverse_direction();
+
+    const reg origin[3] = {reg::broadcast(from[0]), reg::broadcast(from[1]), reg::broadcast(from[2])};
+    const reg inverse_direction[3] = {reg::broadcast(inverse[0]), reg::broadcast(inverse[1]),
+                                      reg::broadcast(inverse[2])};
+    const reg minimum[3] = {reg::loadu(minimums[0] + i), reg::loadu(minimums[1] + i), reg::loadu(minimums[2] + i)};
+    const reg maximum[3] = {reg::loadu(maximums[0] + i), reg::loadu(maximums[1] + i), reg::loadu(maximums[2] + i)};
+
+    slab_distances(origin, inverse_direction, minimum, maximum, distances + i);
+}
+
+template<typename reg, typename Real>
+void intersect_rays_block(const AABB<Real> & box, const Real * const origins[3], const Real * const directions[3],
+                          Real * distances, const size_t & i)
+{
+    const Vector<Real, 3> & low = box.get_min();
+    const Vector<Real, 3> & high = box.get_max();
+
+    const reg one = reg::broadcast(1);
+    const reg origin[3] = {reg::loadu(origins[0] + i), reg::loadu(origins[1] + i), reg::loadu(origins[2] + i)};
+    const reg inverse_direction[3] = {one / reg::loadu(directions[0] + i), one / reg::loadu(directions[1] + i),
+                                      one / reg::loadu(directions[2] + i)};
+    const reg minimum[3] = {reg::broadcast(low[0]), reg::broadcast(low[1]), reg::broadcast(low[2])};
+    const reg maximum[3] = {reg::broadcast(high[0]), reg::broadcast(high[1]), reg::broadcast(high[2])};
+
+    slab_distances(origin, inverse_direction, minimum, maximum, distances + i);
+}
+
+template<typename Real>
+void aabb_intersect_ray(const VectorSoA<Real, 3> & minimums, const VectorSoA<Real, 3> & maximums,
+                        const Ray<Real> & ray, Real * distances, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    assert(minimums.size() == maximums.size() && "Can not test boxes with unequal numbers of corners");
+    const Real * const low[3] = {minimums.component(0), minimums.component(1), minimums.component(2)};
+    const Real * const high[3] = {maximums.component(0), maximums.component(1), maximums.component(2)};
+
+    parallel_for(minimums.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            intersect_ray_block<reg>(ray, low, high, distances, i);
+        }
+        for (; i < end; ++i) {
+            intersect_ray_block<scalar>(ray, low, high, distances, i);
+        }
+    });
+}
+
+template<typename Real>
+void aabb_intersect_rays(const AABB<Real> & box, const VectorSoA<Real, 3> & origins,
+                         const VectorSoA<Real, 3> & directions, Real * distances, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    assert(origins.size() == directions.size() && "Can not test rays with unequal numbers of origins and directions");
+    const Real * const from[3] = {origins.component(0), origins.component(1), origins.component(2)};
+    const Real * const along[3] = {directions.component(0), directions.component(1), directions.component(2)};
+
+    parallel_for(origins.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            intersect_rays_block<reg>(box, from, along, distances, i);
+        }
+        for (; i < end; ++i) {
+            intersect_rays_block<scalar>(box, from, along, distances, i);
+        }
+    });
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef MATH_DUAL_QUATERNION_H_INCLUDED
+#define MATH_DUAL_QUATERNION_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "vector3.h"
+#include "matrix4.h"
+#include "quaternion.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace Math
+{
+
+// A rigid transform as real + dual e, with e^2 = 0. A unit real part is the
+// rotation, the dual part is half the translation times the rotation, so the
+// transform rotates first and then translates.
+//
+// The eight scalars are packed, in the order w, x, y, z of the real part and
+// then of the dual part, so a transform takes half the memory of a matrix.
+// Quaternion pads its imaginary part, the parts are therefore handed out by
+// value.
+template<typename Real>
+struct DualQuaternion
+{
+public:
+    constexpr explicit DualQuaternion();
+
+    constexpr explicit DualQuaternion(const Quaternion<Real> & real, const Quaternion<Real> & dual);
+
+    explicit DualQuaternion(const Quaternion<Real> & rotation, const Vector<Real, 3> & translation);
+
+    // The matrix must be a rigid transform
+    explicit DualQuaternion(const Matrix<Real, 4> & matrix);
+
+    constexpr Quaternion<Real> get_real() const;
+    constexpr Quaternion<Real> get_dual() const;
+
+    const Real* begin() const;
+    const Real* end() const;
+    Real* begin();
+    Real* end();
+
+    Real & operator[](const size_t & i);
+    constexpr Real operator[](const size_t & i) const;
+private:
+    alignas(Simd::VectorStorage<Real, 4>::alignment)
+    Real data[8];
+};
+
+typedef DualQuaternion<float>  DualQuaternionf;
+typedef DualQuaternion<double> DualQuaterniond;
+
+template<typename Real>
+DualQuaternion<Real> & operator+=(DualQuaternion<Real> & to, const DualQuaternion<Real> & other);
+
+template<typename Real>
+DualQuaternion<Real> & operator*=(DualQuaternion<Real> & to, const Real & scalar);
+
+template<typename Real>
+DualQuaternion<Real> operator+(const DualQuaternion<Real> & left, const DualQuaternion<Real> & right);
+
+template<typename Real>
+DualQuaternion<Real> operator*(const DualQuaternion<Real> & transform, const Real & scalar);
+
+template<typename Real>
+DualQuaternion<Real> operator*(const Real & scalar, const DualQuaternion<Real> & transform);
+
+// Composition. Like matrices, left * right applies right first.
+template<typename Real>
+DualQuaternion<Real> operator*(const DualQuaternion<Real> & left, const DualQuaternion<Real> & right);
+
+// Conjugates both parts. For a unit dual quaternion this is the inverse.
+template<typename Real>
+DualQuaternion<Real> dual_quaternion_conjugate(const DualQuaternion<Real> & transform);
+
+template<typename Real>
+DualQuaternion<Real> dual_quaternion_inverse(const DualQuaternion<Real> & transform);
+
+// Scales to a unit real part and removes the component of the dual part
+// along it, so the result is a rigid transform
+template<typename Real>
+void dual_quaternion_normalize(DualQuaternion<Real> & transform);
+
+// The parts of a unit dual quaternion as a rotation and a translation
+template<typename Real>
+Vector<Real, 3> dual_quaternion_translation(const DualQuaternion<Real> & transform);
+
+template<typename Real>
+Vector<Real, 3> dual_quaternion_transform_point(const DualQuaternion<Real> & transform, const Vector<Real, 3> & point);
+
+template<typename Real>
+Matrix<Real, 4> dual_quaternion_to_matrix(const DualQuaternion<Real> & transform);
+
+// Dual quaternion linear blending: the weighted sum of the transforms,
+// normalized. Transforms whose rotation is on the other side of the first
+// one are negated, so the blend goes the shorter way.
+template<typename Real>
+DualQuaternion<Real> dual_quaternion_blend(const DualQuaternion<Real> * transforms, const Real * weights,
+                                           const size_t & count);
+
+#define INCLUDED_FROM_DUAL_QUATERNION_H
+#include "dual_quaternion_tmpl.h"
+#undef INCLUDED_FROM_DUAL_QUATERNION_H
+
+}
+
+#endif
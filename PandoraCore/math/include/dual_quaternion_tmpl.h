@@ -0,0 +1,240 @@
+#ifndef INCLUDED_FROM_DUAL_QUATERNION_H
+#error "dual_quaternion_tmpl.h can only be included from dual_quaternion.h"
+#else
+
+// The rotation of a rigid matrix, from the largest of the four squared
+// components so the division is well conditioned for any angle
+template<typename Real>
+Quaternion<Real> rotation_from_rigid_matrix(const Matrix<Real, 4> & matrix)
+{
+    assert(matrix_is_rigid(matrix) && "Matrix is not a rigid transform");
+
+    const Real trace = matrix(0,0) + matrix(1,1) + matrix(2,2);
+    if (trace > 0) {
+        const Real s = 2 * std::sqrt(trace + 1);
+        return Quaternion<Real>(s / 4,
+                                (matrix(2,1) - matrix(1,2)) / s,
+                                (matrix(0,2) - matrix(2,0)) / s,
+                                (matrix(1,0) - matrix(0,1)) / s);
+    }
+    if (matrix(0,0) > matrix(1,1) && matrix(0,0) > matrix(2,2)) {
+        const Real s = 2 * std::sqrt(1 + matrix(0,0) - matrix(1,1) - matrix(2,2));
+        return Quaternion<Real>((matrix(2,1) - matrix(1,2)) / s,
+                                s / 4,
+                                (matrix(0,1) + matrix(1,0)) / s,
+                                (matrix(0,2) + matrix(2,0)) / s);
+    }
+    if (matrix(1,1) > matrix(2,2)) {
+        const Real s = 2 * std::sqrt(1 + matrix(1,1) - matrix(0,0) - matrix(2,2));
+        return Quaternion<Real>((matrix(0,2) - matrix(2,0)) / s,
+                                (matrix(0,1) + matrix(1,0)) / s,
+                                s / 4,
+                                (matrix(1,2) + matrix(2,1)) / s);
+    }
+    const Real s = 2 * std::sqrt(1 + matrix(2,2) - matrix(0,0) - matrix(1,1));
+    return Quaternion<Real>((matrix(1,0) - matrix(0,1)) / s,
+                            (matrix(0,2) + matrix(2,0)) / s,
+                            (matrix(1,2) + matrix(2,1)) / s,
+                            s / 4);
+}
+
+template<typename Real>
+constexpr DualQuaternion<Real>::DualQuaternion()
+    : data{1, 0, 0, 0, 0, 0, 0, 0}
+{ }
+
+template<typename Real>
+constexpr DualQuaternion<Real>::DualQuaternion(const Quaternion<Real> & real, const Quaternion<Real> & dual)
+    : data{real.w(), real.x(), real.y(), real.z(), dual.w(), dual.x(), dual.y(), dual.z()}
+{ }
+
+template<typename Real>
+DualQuaternion<Real>::DualQuaternion(const Quaternion<Real> & rotation, const Vector<Real, 3> & translation)
+    : DualQuaternion(rotation, Quaternion<Real>(0, translation) * rotation * Real(0.5))
+{ }
+
+template<typename Real>
+DualQuaternion<Real>::DualQuaternion(const Matrix<Real, 4> & matrix)
+    : DualQuaternion(rotation_from_rigid_matrix(matrix), Vector<Real, 3>(matrix(0,3), matrix(1,3), matrix(2,3)))
+{ }
+
+template<typename Real>
+constexpr Quaternion<Real> DualQuaternion<Real>::get_real() const
+{
+    return Quaternion<Real>(data[0], data[1], data[2], data[3]);
+}
+
+template<typename Real>
+constexpr Quaternion<Real> DualQuaternion<Real>::get_dual() const
+{
+    return Quaternion<Real>(data[4], data[5], data[6], data[7]);
+}
+
+template<typename Real>
+const Real* DualQuaternion<Real>::begin() const
+{
+    return data;
+}
+
+template<typename Real>
+const Real* DualQuaternion<Real>::end() const
+{
+    return data + 8;
+}
+
+template<typename Real>
+Real* DualQuaternion<Real>::begin()
+{
+    return data;
+}
+
+template<typename Real>
+Real* DualQuaternion<Real>::end()
+{
+    return data + 8;
+}
+
+template<typename Real>
+Real & DualQuaternion<Real>::operator[](const size_t & i)
+{
+    assert(i < 8 && "Index operator out of range");
+    return data[i];
+}
+
+template<typename Real>
+constexpr Real DualQuaternion<Real>::operator[](const size_t & i) const
+{
+    return assert(i < 8 && "Index operator out of range"), data[i];
+}
+
+template<typename Real>
+DualQuaternion<Real> & operator+=(DualQuaternion<Real> & to, const DualQuaternion<Real> & other)
+{
+    for (size_t i = 0; i < 8; ++i) {
+        to[i] += other[i];
+    }
+    return to;
+}
+
+template<typename Real>
+DualQuaternion<Real> & operator*=(DualQuaternion<Real> & to, const Real & scalar)
+{
+    for (auto & element : to) {
+        element *= scalar;
+    }
+    return to;
+}
+
+template<typename Real>
+DualQuaternion<Real> operator+(const DualQuaternion<Real> & left, const DualQuaternion<Real> & right)
+{
+    auto result = left;
+    return result += right;
+}
+
+template<typename Real>
+DualQuaternion<Real> operator*(const DualQuaternion<Real> & transform, const Real & scalar)
+{
+    auto result = transform;
+    return result *= scalar;
+}
+
+template<typename Real>
+DualQuaternion<Real> operator*(const Real & scalar, const DualQuaternion<Real> & transform)
+{
+    return transform * scalar;
+}
+
+// (lr + ld e)(rr + rd e) = lr rr + (lr rd + ld rr) e
+template<typename Real>
+DualQuaternion<Real> operator*(const DualQuaternion<Real> & left, const DualQuaternion<Real> & right)
+{
+    const auto left_real = left.get_real();
+    const auto right_real = right.get_real();
+    return DualQuaternion<Real>(left_real * right_real,
+                                left_real * right.get_dual() + left.get_dual() * right_real);
+}
+
+template<typename Real>
+DualQuaternion<Real> dual_quaternion_conjugate(const DualQuaternion<Real> & transform)
+{
+    return DualQuaternion<Real>(quaternion_conjugate(transform.get_real()),
+                                quaternion_conjugate(transform.get_dual()));
+}
+
+// The inverse of r + d e is r^-1 - r^-1 d r^-1 e
+template<typename Real>
+DualQuaternion<Real> dual_quaternion_inverse(const DualQuaternion<Real> & transform)
+{
+    const auto real = transform.get_real();
+    assert(quaternion_norm_squared(real) != 0 && "Can not invert dual quaternion with zero real part");
+
+    const auto real_inverse = quaternion_inverse(real);
+    return DualQuaternion<Real>(real_inverse, real_inverse * transform.get_dual() * real_inverse * Real(-1));
+}
+
+// Divides by the dual number norm |r| + (r.d / |r|) e. With r' = r / |r|
+// that is r' + (d - r' (r'.d)) / |r| e. Summed like the batched blends.
+template<typename Real>
+void dual_quaternion_normalize(DualQuaternion<Real> & transform)
+{
+    const Real norm_squared = quaternion_norm_squared(transform.get_real());
+
+    assert(norm_squared != 0 && "Can not normalize zero dual quaternion");
+
+    const Real scale = 1 / std::sqrt(norm_squared);
+    for (size_t i = 0; i < 4; ++i) {
+        transform[i] *= scale;
+    }
+
+    const Real along = quaternion_dot(transform.get_real(), transform.get_dual());
+    for (size_t i = 0; i < 4; ++i) {
+        transform[i + 4] = (transform[i + 4] - transform[i] * along) * scale;
+    }
+}
+
+// The imaginary part of 2 d conjugate(r): 2 (rw dv - dw rv + rv x dv)
+template<typename Real>
+Vector<Real, 3> dual_quaternion_translation(const DualQuaternion<Real> & transform)
+{
+    const Real * r = transform.begin();
+    const Real * d = transform.begin() + 4;
+    return Vector<Real, 3>(2 * ((r[0]*d[1] - d[0]*r[1]) + (r[2]*d[3] - r[3]*d[2])),
+                           2 * ((r[0]*d[2] - d[0]*r[2]) + (r[3]*d[1] - r[1]*d[3])),
+                           2 * ((r[0]*d[3] - d[0]*r[3]) + (r[1]*d[2] - r[2]*d[1])));
+}
+
+template<typename Real>
+Vector<Real, 3> dual_quaternion_transform_point(const DualQuaternion<Real> & transform, const Vector<Real, 3> & point)
+{
+    return quaternion_rotate(transform.get_real(), point) + dual_quaternion_translation(transform);
+}
+
+template<typename Real>
+Matrix<Real, 4> dual_quaternion_to_matrix(const DualQuaternion<Real> & transform)
+{
+    auto matrix = quaternion_to_matrix(transform.get_real());
+    const auto translation = dual_quaternion_translation(transform);
+    for (size_t i = 0; i < 3; ++i) {
+        matrix(i,3) = translation[i];
+    }
+    return matrix;
+}
+
+template<typename Real>
+DualQuaternion<Real> dual_quaternion_blend(const DualQuaternion<Real> * transforms, const Real * weights,
+                                           const size_t & count)
+{
+    assert(count > 0 && "Can not blend zero transforms");
+
+    const auto pivot = transforms[0].get_real();
+    DualQuaternion<Real> result(Quaternion<Real>(0, 0, 0, 0), Quaternion<Real>(0, 0, 0, 0));
+    for (size_t i = 0; i < count; ++i) {
+        const Real sign = std::copysign(Real(1), quaternion_dot(transforms[i].get_real(), pivot));
+        result += transforms[i] * (sign * weights[i]);
+    }
+    dual_quaternion_normalize(result);
+    return result;
+}
+
+#endif
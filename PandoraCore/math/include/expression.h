@@ -0,0 +1,422 @@
+#ifndef MATH_EXPRESSION_H_INCLUDED
+#define MATH_EXPRESSION_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+
+#include <assert.h>
+#include <type_traits>
+#include <utility>
+
+// True while a constant expression is evaluated, so the operators can use
+// registers everywhere else. Without the builtin the operators always take
+// the constant expression path, which gives the same results.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define MATH_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#if !defined(MATH_CONSTANT_EVALUATED) && defined(_MSC_VER) && _MSC_VER >= 1925
+#define MATH_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#ifndef MATH_CONSTANT_EVALUATED
+#define MATH_CONSTANT_EVALUATED() true
+#endif
+
+namespace Math
+{
+
+// Lazy element wise expressions over vectors and matrices.
+//
+// The element wise operators (+, -, scaling and, for vectors, the component
+// wise product) of vectors and matrices return their result, like they
+// always have, so a + b can be kept in an auto variable, indexed, passed to
+// any function and changed afterwards. A chain started with lazy() instead
+// builds expression nodes, and lazy(a) + lazy(b)*s - c is evaluated in a
+// single pass, a register at a time, when it is assigned to, or used to
+// construct, a Vector or Matrix. Named vectors and matrices are referenced,
+// temporaries are stored by value, so a node never refers to an object
+// destroyed at the end of the full expression.
+
+// Describes a type taking part in expressions. Vector and Matrix specialize
+// it as leaves, the nodes below as non-leaves.
+template<typename T>
+struct ExpressionTraits
+{
+    static const bool is_expression = false;
+    static const bool is_leaf = false;
+};
+
+template<typename T>
+struct IsExpression
+    : std::integral_constant<bool, ExpressionTraits<typename std::decay<T>::type>::is_expression>
+{ };
+
+template<typename T>
+struct IsExpressionNode
+    : std::integral_constant<bool, ExpressionTraits<typename std::decay<T>::type>::is_expression &&
+                                   !ExpressionTraits<typename std::decay<T>::type>::is_leaf>
+{ };
+
+// Only define a type for expressions, so the operators below drop out of
+// overload resolution for everything else
+template<typename T, bool = IsExpression<T>::value>
+struct ExpressionResult
+{ };
+
+template<typename T>
+struct ExpressionResult<T, true>
+{
+    typedef typename ExpressionTraits<typename std::decay<T>::type>::result_type type;
+};
+
+template<typename T, bool = IsExpression<T>::value>
+struct ExpressionReal
+{ };
+
+template<typename T>
+struct ExpressionReal<T, true>
+{
+    typedef typename ExpressionTraits<typename ExpressionResult<T>::type>::real_type type;
+};
+
+// Enabled when both operands are expressions with the same result type
+template<typename Left, typename Right, typename Type,
+         bool = IsExpression<Left>::value && IsExpression<Right>::value>
+struct EnableIfCompatible
+{ };
+
+template<typename Left, typename Right, typename Type>
+struct EnableIfCompatible<Left, Right, Type, true>
+    : std::enable_if<std::is_same<typename ExpressionResult<Left>::type,
+                                  typename ExpressionResult<Right>::type>::value, Type>
+{ };
+
+// Enabled for unevaluated expressions giving the given result type. Used by
+// the leaves to accept expressions in constructors and assignments.
+template<typename Expression, typename Result, typename Type = void,
+         bool = IsExpressionNode<Expression>::value>
+struct EnableIfExpressionOf
+{ };
+
+template<typename Expression, typename Result, typename Type>
+struct EnableIfExpressionOf<Expression, Result, Type, true>
+    : std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Result>::value, Type>
+{ };
+
+// How an operand is held by a node: leaves passed as lvalues by reference,
+// everything else by value. Like any reference, a node kept in an auto
+// variable sees later changes to the vectors it was built from. Name the
+// result type to take a snapshot.
+template<typename T>
+struct ExpressionOperand
+{
+    typedef typename std::decay<T>::type type;
+};
+
+template<typename T>
+struct ExpressionOperand<T &>
+{
+    typedef typename std::decay<T>::type value_type;
+    typedef typename std::conditional<ExpressionTraits<value_type>::is_leaf,
+                                      const value_type &, value_type>::type type;
+};
+
+// The register an expression of the given size is evaluated with
+template<typename Real, size_t size>
+struct EvaluationRegister
+{
+    typedef Simd::Register<Real, 1> type;
+};
+
+#ifdef MATH_USE_SSE2
+template<size_t size>
+struct EvaluationFloatRegister
+{
+#ifdef MATH_USE_AVX
+    typedef typename std::conditional<(size >= 8), Simd::Register<float, 8>,
+            typename std::conditional<(size >= 4), Simd::Register<float, 4>,
+                                      Simd::Register<float, 1> >::type>::type type;
+#else
+    typedef typename std::conditional<(size >= 4), Simd::Register<float, 4>,
+                                      Simd::Register<float, 1> >::type type;
+#endif
+};
+
+template<size_t size>
+struct EvaluationDoubleRegister
+{
+    typedef typename std::conditional<(size >= 4), Simd::Register<double, 4>,
+            typename std::conditional<(size >= 2), Simd::Register<double, 2>,
+                                      Simd::Register<double, 1> >::type>::type type;
+};
+
+template<size_t size>
+struct EvaluationRegister<float, size>
+{
+    typedef typename EvaluationFloatRegister<size>::type type;
+};
+
+template<size_t size>
+struct EvaluationRegister<double, size>
+{
+    typedef typename EvaluationDoubleRegister<size>::type type;
+};
+#endif
+
+// Element operations. They work on scalars and registers alike.
+struct AddOperation
+{
+    template<typename T>
+    static constexpr T apply(const T & left, const T & right) { return left + right; }
+};
+
+struct SubtractOperation
+{
+    template<typename T>
+    static constexpr T apply(const T & left, const T & right) { return left - right; }
+};
+
+struct MultiplyOperation
+{
+    template<typename T>
+    static constexpr T apply(const T & left, const T & right) { return left * right; }
+};
+
+struct DivideOperation
+{
+    template<typename T>
+    static constexpr T apply(const T & left, const T & right) { return left / right; }
+};
+
+// How the leaves divide by a scalar. Vectors divide every element, matrices
+// multiply by the reciprocal, matching their /= operators.
+struct DivideByScalar
+{
+    typedef DivideOperation operation;
+
+    template<typename Real>
+    static constexpr Real scalar(const Real & scalar)
+    {
+        return assert(scalar != 0 && "Can not divide vector by zero"), scalar;
+    }
+};
+
+struct MultiplyByReciprocal
+{
+    typedef MultiplyOperation operation;
+
+    template<typename Real>
+    static constexpr Real scalar(const Real & scalar) { return Real(1./scalar); }
+};
+
+// A leaf taking part in an expression as a node, so the operators build
+// nodes instead of evaluating. Made by lazy().
+template<typename Leaf>
+struct LazyExpression
+{
+public:
+    typedef typename ExpressionTraits<Leaf>::result_type result_type;
+    typedef typename ExpressionTraits<result_type>::real_type real_type;
+
+    constexpr explicit LazyExpression(const Leaf & leaf);
+
+    constexpr real_type operator[](const size_t & i) const;
+    constexpr real_type operator()(const size_t & i, const size_t & j) const;
+
+    template<typename Register>
+    Register packet(const size_t & offset) const;
+private:
+    const Leaf & leaf;
+};
+
+// Reads a register worth of scalars from a node. The leaves overload it.
+template<typename Register, typename Expression>
+Register expression_packet(const Expression & expression, const size_t & offset)
+{
+    return expression.template packet<Register>(offset);
+}
+
+template<typename Operation, typename Left, typename Right>
+struct BinaryExpression
+{
+public:
+    typedef typename ExpressionResult<Left>::type result_type;
+    typedef typename ExpressionReal<Left>::type real_type;
+
+    constexpr BinaryExpression(const Left & left, const Right & right);
+
+    constexpr real_type operator[](const size_t & i) const;
+    constexpr real_type operator()(const size_t & i, const size_t & j) const;
+
+    template<typename Register>
+    Register packet(const size_t & offset) const;
+private:
+    Left left;
+    Right right;
+};
+
+template<typename Operation, typename Operand>
+struct ScalarExpression
+{
+public:
+    typedef typename ExpressionResult<Operand>::type result_type;
+    typedef typename ExpressionReal<Operand>::type real_type;
+
+    constexpr ScalarExpression(const Operand & operand, const real_type & scalar);
+
+    constexpr real_type operator[](const size_t & i) const;
+    constexpr real_type operator()(const size_t & i, const size_t & j) const;
+
+    template<typename Register>
+    Register packet(const size_t & offset) const;
+private:
+    Operand operand;
+    real_type scalar;
+};
+
+template<typename Operation, typename Left, typename Right>
+struct ExpressionTraits<BinaryExpression<Operation, Left, Right> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = false;
+    typedef typename BinaryExpression<Operation, Left, Right>::result_type result_type;
+};
+
+template<typename Operation, typename Operand>
+struct ExpressionTraits<ScalarExpression<Operation, Operand> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = false;
+    typedef typename ScalarExpression<Operation, Operand>::result_type result_type;
+};
+
+template<typename Leaf>
+struct ExpressionTraits<LazyExpression<Leaf> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = false;
+    typedef typename LazyExpression<Leaf>::result_type result_type;
+};
+
+template<typename Operation, typename Left, typename Right>
+struct BinaryExpressionType
+{
+    typedef BinaryExpression<Operation,
+                             typename ExpressionOperand<Left>::type,
+                             typename ExpressionOperand<Right>::type> type;
+};
+
+template<typename Operation, typename Operand>
+struct ScalarExpressionType
+{
+    typedef ScalarExpression<Operation, typename ExpressionOperand<Operand>::type> type;
+};
+
+// What an operator returns, and the node it is computed through. With only
+// leaves as operands it is the result, evaluated straight from the operands
+// while the operator runs. Once an operand is a node it is the node.
+template<typename Operation, typename Left, typename Right,
+         bool = IsExpression<Left>::value && IsExpression<Right>::value>
+struct BinaryOperatorType
+{ };
+
+template<typename Operation, typename Left, typename Right>
+struct BinaryOperatorType<Operation, Left, Right, true>
+{
+    static const bool lazy = IsExpressionNode<Left>::value || IsExpressionNode<Right>::value;
+    typedef typename std::conditional<lazy, typename BinaryExpressionType<Operation, Left, Right>::type,
+                                      BinaryExpression<Operation, const typename std::decay<Left>::type &,
+                                                       const typename std::decay<Right>::type &> >::type node;
+    typedef typename std::conditional<lazy, node, typename node::result_type>::type type;
+};
+
+template<typename Operation, typename Operand, bool = IsExpression<Operand>::value>
+struct ScalarOperatorType
+{ };
+
+template<typename Operation, typename Operand>
+struct ScalarOperatorType<Operation, Operand, true>
+{
+    static const bool lazy = IsExpressionNode<Operand>::value;
+    typedef typename std::conditional<lazy, typename ScalarExpressionType<Operation, Operand>::type,
+                                      ScalarExpression<Operation, const typename std::decay<Operand>::type &> >::type node;
+    typedef typename std::conditional<lazy, node, typename node::result_type>::type type;
+};
+
+// Starts a lazy chain at a vector or matrix. The node refers to the leaf,
+// so it sees later changes to it, and must not outlive it.
+template<typename Leaf>
+constexpr typename std::enable_if<ExpressionTraits<Leaf>::is_leaf, LazyExpression<Leaf> >::type
+lazy(const Leaf & leaf);
+
+template<typename Leaf>
+void lazy(const Leaf && leaf) = delete;
+
+// Materializes an expression into its Vector or Matrix
+template<typename Expression>
+typename ExpressionResult<Expression>::type evaluate(const Expression & expression);
+
+// Gives the result of an operator on leaves outside constant expressions.
+// Vectors overload it to evaluate through registers, the rest construct the
+// result, which is faster for the larger matrices.
+template<typename Result, typename Expression>
+Result evaluate_operator(const Expression & expression, const Result *);
+
+// Writes an expression into the storage of a leaf, optionally combining it
+// with what is already there. Only element i is read when element i is
+// written, so the destination may also appear in the expression.
+template<typename Operation, typename Real, size_t storage_size, typename Expression>
+void assign_expression(Real * destination, const Expression & expression);
+
+template<typename Real, size_t storage_size, typename Expression>
+void assign_expression(Real * destination, const Expression & expression);
+
+// Element wise operators shared by vectors and matrices
+template<typename Left, typename Right>
+constexpr typename EnableIfCompatible<Left, Right, typename BinaryOperatorType<AddOperation, Left, Right>::type>::type
+operator+(Left && left, Right && right);
+
+template<typename Left, typename Right>
+constexpr typename EnableIfCompatible<Left, Right, typename BinaryOperatorType<SubtractOperation, Left, Right>::type>::type
+operator-(Left && left, Right && right);
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+                                  typename ScalarOperatorType<MultiplyOperation, Operand>::type>::type
+operator-(Operand && operand);
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+                                  typename ScalarOperatorType<MultiplyOperation, Operand>::type>::type
+operator*(Operand && operand, const typename ExpressionReal<Operand>::type & scalar);
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+                                  typename ScalarOperatorType<MultiplyOperation, Operand>::type>::type
+operator*(const typename ExpressionReal<Operand>::type & scalar, Operand && operand);
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+        typename ScalarOperatorType<typename ExpressionTraits<typename ExpressionResult<Operand>::type>::scalar_division::operation,
+                                    Operand>::type>::type
+operator/(Operand && operand, const typename ExpressionReal<Operand>::type & scalar);
+
+// Comparison where at least one side is an unevaluated expression
+template<typename Left, typename Right>
+typename std::enable_if<(IsExpressionNode<Left>::value || IsExpressionNode<Right>::value),
+                        typename EnableIfCompatible<Left, Right, bool>::type>::type
+operator==(const Left & left, const Right & right);
+
+template<typename Left, typename Right>
+typename std::enable_if<(IsExpressionNode<Left>::value || IsExpressionNode<Right>::value),
+                        typename EnableIfCompatible<Left, Right, bool>::type>::type
+operator!=(const Left & left, const Right & right);
+
+#define INCLUDED_FROM_EXPRESSION_H
+#include "expression_tmpl.h"
+#undef INCLUDED_FROM_EXPRESSION_H
+
+}
+
+#endif
@@ -0,0 +1,218 @@
+#ifndef INCLUDED_FROM_EXPRESSION_H
+#error "expression_tmpl.h should only be included from expression.h"
+#else
+
+template<typename Operation, typename Left, typename Right>
+constexpr BinaryExpression<Operation, Left, Right>::BinaryExpression(const Left & left, const Right & right)
+    : left(left), right(right)
+{ }
+
+template<typename Operation, typename Left, typename Right>
+constexpr typename BinaryExpression<Operation, Left, Right>::real_type
+BinaryExpression<Operation, Left, Right>::operator[](const size_t & i) const
+{
+    return Operation::apply(real_type(left[i]), real_type(right[i]));
+}
+
+template<typename Operation, typename Left, typename Right>
+constexpr typename BinaryExpression<Operation, Left, Right>::real_type
+BinaryExpression<Operation, Left, Right>::operator()(const size_t & i, const size_t & j) const
+{
+    return Operation::apply(real_type(left(i,j)), real_type(right(i,j)));
+}
+
+template<typename Operation, typename Left, typename Right>
+template<typename Register>
+inline Register BinaryExpression<Operation, Left, Right>::packet(const size_t & offset) const
+{
+    return Operation::apply(expression_packet<Register>(left, offset),
+                            expression_packet<Register>(right, offset));
+}
+
+template<typename Operation, typename Operand>
+constexpr ScalarExpression<Operation, Operand>::ScalarExpression(const Operand & operand, const real_type & scalar)
+    : operand(operand), scalar(scalar)
+{ }
+
+template<typename Operation, typename Operand>
+constexpr typename ScalarExpression<Operation, Operand>::real_type
+ScalarExpression<Operation, Operand>::operator[](const size_t & i) const
+{
+    return Operation::apply(real_type(operand[i]), scalar);
+}
+
+template<typename Operation, typename Operand>
+constexpr typename ScalarExpression<Operation, Operand>::real_type
+ScalarExpression<Operation, Operand>::operator()(const size_t & i, const size_t & j) const
+{
+    return Operation::apply(real_type(operand(i,j)), scalar);
+}
+
+template<typename Operation, typename Operand>
+template<typename Register>
+inline Register ScalarExpression<Operation, Operand>::packet(const size_t & offset) const
+{
+    return Operation::apply(expression_packet<Register>(operand, offset), Register::broadcast(scalar));
+}
+
+template<typename Leaf>
+constexpr LazyExpression<Leaf>::LazyExpression(const Leaf & leaf)
+    : leaf(leaf)
+{ }
+
+template<typename Leaf>
+constexpr typename LazyExpression<Leaf>::real_type LazyExpression<Leaf>::operator[](const size_t & i) const
+{
+    return leaf[i];
+}
+
+template<typename Leaf>
+constexpr typename LazyExpression<Leaf>::real_type
+LazyExpression<Leaf>::operator()(const size_t & i, const size_t & j) const
+{
+    return leaf(i,j);
+}
+
+template<typename Leaf>
+template<typename Register>
+inline Register LazyExpression<Leaf>::packet(const size_t & offset) const
+{
+    return expression_packet<Register>(leaf, offset);
+}
+
+template<typename Leaf>
+constexpr typename std::enable_if<ExpressionTraits<Leaf>::is_leaf, LazyExpression<Leaf> >::type
+lazy(const Leaf & leaf)
+{
+    return LazyExpression<Leaf>(leaf);
+}
+
+template<typename Expression>
+typename ExpressionResult<Expression>::type evaluate(const Expression & expression)
+{
+    return typename ExpressionResult<Expression>::type(expression);
+}
+
+template<typename Result, typename Expression>
+inline Result evaluate_operator(const Expression & expression, const Result *)
+{
+    return Result(expression);
+}
+
+template<typename Operation, typename Real, size_t storage_size, typename Expression>
+inline void assign_expression(Real * destination, const Expression & expression)
+{
+    typedef typename EvaluationRegister<Real, storage_size>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    const size_t packed_size = storage_size - storage_size % reg::size;
+    for (size_t i = 0; i < packed_size; i += reg::size) {
+        Operation::apply(reg::loadu(destination + i),
+                         expression_packet<reg>(expression, i)).storeu(destination + i);
+    }
+    for (size_t i = packed_size; i < storage_size; ++i) {
+        Operation::apply(scalar::load(destination + i),
+                         expression_packet<scalar>(expression, i)).store(destination + i);
+    }
+}
+
+template<typename Real, size_t storage_size, typename Expression>
+inline void assign_expression(Real * destination, const Expression & expression)
+{
+    typedef typename EvaluationRegister<Real, storage_size>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    const size_t packed_size = storage_size - storage_size % reg::size;
+    for (size_t i = 0; i < packed_size; i += reg::size) {
+        expression_packet<reg>(expression, i).storeu(destination + i);
+    }
+    for (size_t i = packed_size; i < storage_size; ++i) {
+        expression_packet<scalar>(expression, i).store(destination + i);
+    }
+}
+
+// The node itself, or the result evaluated from it
+template<typename Result, typename Node>
+constexpr typename std::enable_if<Result::lazy, typename Result::type>::type operator_result(const Node & node)
+{
+    return node;
+}
+
+template<typename Result, typename Node>
+constexpr typename std::enable_if<!Result::lazy, typename Result::type>::type operator_result(const Node & node)
+{
+    return MATH_CONSTANT_EVALUATED() ? typename Result::type(node)
+                                     : evaluate_operator(node, static_cast<const typename Result::type *>(nullptr));
+}
+
+template<typename Left, typename Right>
+constexpr typename EnableIfCompatible<Left, Right, typename BinaryOperatorType<AddOperation, Left, Right>::type>::type
+operator+(Left && left, Right && right)
+{
+    typedef BinaryOperatorType<AddOperation, Left, Right> result;
+    return operator_result<result>(typename result::node(static_cast<Left &&>(left), static_cast<Right &&>(right)));
+}
+
+template<typename Left, typename Right>
+constexpr typename EnableIfCompatible<Left, Right, typename BinaryOperatorType<SubtractOperation, Left, Right>::type>::type
+operator-(Left && left, Right && right)
+{
+    typedef BinaryOperatorType<SubtractOperation, Left, Right> result;
+    return operator_result<result>(typename result::node(static_cast<Left &&>(left), static_cast<Right &&>(right)));
+}
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+                                  typename ScalarOperatorType<MultiplyOperation, Operand>::type>::type
+operator-(Operand && operand)
+{
+    typedef ScalarOperatorType<MultiplyOperation, Operand> result;
+    return operator_result<result>(typename result::node(static_cast<Operand &&>(operand),
+                                                       (typename ExpressionReal<Operand>::type) -1));
+}
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+                                  typename ScalarOperatorType<MultiplyOperation, Operand>::type>::type
+operator*(Operand && operand, const typename ExpressionReal<Operand>::type & scalar)
+{
+    typedef ScalarOperatorType<MultiplyOperation, Operand> result;
+    return operator_result<result>(typename result::node(static_cast<Operand &&>(operand), scalar));
+}
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+                                  typename ScalarOperatorType<MultiplyOperation, Operand>::type>::type
+operator*(const typename ExpressionReal<Operand>::type & scalar, Operand && operand)
+{
+    return static_cast<Operand &&>(operand) * scalar;
+}
+
+template<typename Operand>
+constexpr typename std::enable_if<IsExpression<Operand>::value,
+        typename ScalarOperatorType<typename ExpressionTraits<typename ExpressionResult<Operand>::type>::scalar_division::operation,
+                                    Operand>::type>::type
+operator/(Operand && operand, const typename ExpressionReal<Operand>::type & scalar)
+{
+    typedef typename ExpressionTraits<typename ExpressionResult<Operand>::type>::scalar_division division;
+    typedef ScalarOperatorType<typename division::operation, Operand> result;
+    return operator_result<result>(typename result::node(static_cast<Operand &&>(operand), division::scalar(scalar)));
+}
+
+template<typename Left, typename Right>
+typename std::enable_if<(IsExpressionNode<Left>::value || IsExpressionNode<Right>::value),
+                        typename EnableIfCompatible<Left, Right, bool>::type>::type
+operator==(const Left & left, const Right & right)
+{
+    return evaluate(left) == evaluate(right);
+}
+
+template<typename Left, typename Right>
+typename std::enable_if<(IsExpressionNode<Left>::value || IsExpressionNode<Right>::value),
+                        typename EnableIfCompatible<Left, Right, bool>::type>::type
+operator!=(const Left & left, const Right & right)
+{
+    return !(left == right);
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef MATH_FRUSTUM_H_INCLUDED
+#define MATH_FRUSTUM_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "vector3.h"
+#include "vector4.h"
+#include "matrix4.h"
+#include "vector_soa.h"
+#include "bounding_volume.h"
+#include "batch_transform.h"
+#include "parallel.h"
+
+#include <cassert>
+#include <vector>
+
+namespace Math
+{
+
+// The six planes bounding what a view-projection matrix maps into the clip
+// cube, in the space the matrix maps from, usually the world. Each plane is
+// (a, b, c, d) with a unit normal (a, b, c) pointing into the frustum, so
+// a*x + b*y + c*z + d is the signed distance of a point from it.
+//
+// The planes are in the order left, right, bottom, top, near, far, and use
+// the OpenGL clip cube of matrix_perspective and matrix_orthographic.
+template<typename Real>
+class Frustum
+{
+public:
+    static const size_t plane_count = 6;
+
+    explicit Frustum(const Matrix<Real, 4> & view_projection);
+
+    const Vector<Real, 4> & get_plane(const size_t & i) const;
+private:
+    Vector<Real, 4> planes[plane_count];
+};
+
+typedef Frustum<float>  Frustumf;
+typedef Frustum<double> Frustumd;
+
+template<typename Real>
+bool frustum_contains(const Frustum<Real> & frustum, const Vector<Real, 3> & point);
+
+// The volume is kept unless it is all on the outside of one plane. That is
+// exact for spheres away from the corners of the frustum, and keeps some
+// volumes that are outside near the edges and corners, which is what
+// culling wants.
+template<typename Real>
+bool frustum_intersects(const Frustum<Real> & frustum, const Sphere<Real> & sphere);
+
+template<typename Real>
+bool frustum_intersects(const Frustum<Real> & frustum, const AABB<Real> & box);
+
+// Culls a whole array or batch of volumes, a register of them against all
+// six planes at a time, optionally spread over threads (see parallel_for).
+// The indices of the volumes frustum_intersects keeps are written to the
+// start of visible, in increasing order, and their number returned. visible
+// needs room for an index per volume, as it is written past the visible
+// ones on the way.
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const Sphere<Real> * spheres, const size_t & count,
+                    size_t * visible, const size_t & threads = 1);
+
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const AABB<Real> * boxes, const size_t & count,
+                    size_t * visible, const size_t & threads = 1);
+
+// The spheres around centers[i] with radii[i]
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const VectorSoA<Real, 3> & centers, const Real * radii,
+                    size_t * visible, const size_t & threads = 1);
+
+// The boxes from minimums[i] to maximums[i]
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const VectorSoA<Real, 3> & minimums,
+                    const VectorSoA<Real, 3> & maximums, size_t * visible, const size_t & threads = 1);
+
+// Normalized device coordinates of the points, with the clip space w of
+// each point written to w unless it is null. Points with w <= 0 are at or
+// behind the eye of a perspective projection. Each point takes one division,
+// by w, and is then multiplied by the reciprocal, so the results may differ
+// from transform_points in the last bit.
+template<typename Real>
+void project_points(const Matrix<Real, 4> & view_projection, const VectorSoA<Real, 3> & points,
+                    VectorSoA<Real, 3> & result, Real * w = nullptr, const size_t & threads = 1);
+
+#define INCLUDED_FROM_FRUSTUM_H
+#include "frustum_tmpl.h"
+#undef INCLUDED_FROM_FRUSTUM_H
+
+}
+
+#endif
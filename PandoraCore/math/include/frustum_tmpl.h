@@ -0,0 +1,308 @@
+#ifndef INCLUDED_FROM_FRUSTUM_H
+#error "frustum_tmpl.h can only be included from frustum.h"
+#else
+
+template<typename Real>
+const size_t Frustum<Real>::plane_count;
+
+// A point is inside when -w <= x, y, z <= w in clip space. Each of those is
+// w + x >= 0 or w - x >= 0, the last row of the matrix plus or minus one of
+// the others dotted with the point.
+template<typename Real>
+Frustum<Real>::Frustum(const Matrix<Real, 4> & view_projection)
+{
+    for (size_t axis = 0; axis < 3; ++axis) {
+        for (size_t side = 0; side < 2; ++side) {
+            const Real sign = side ? -1 : 1;
+            Vector<Real, 4> & plane = planes[2 * axis + side];
+            for (size_t c = 0; c < 4; ++c) {
+                plane[c] = view_projection(3, c) + sign * view_projection(axis, c);
+            }
+
+            const Real length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            assert(length != 0 && "Can not extract frustum planes from a degenerate matrix");
+            plane /= length;
+        }
+    }
+}
+
+template<typename Real>
+const Vector<Real, 4> & Frustum<Real>::get_plane(const size_t & i) const
+{
+    assert(i < plane_count && "Index operator out of range");
+    return planes[i];
+}
+
+// Signed distances of a register of points from a plane
+template<typename reg, typename Real>
+inline reg plane_distance(const Vector<Real, 4> & plane, const reg point[3])
+{
+    return ((reg::broadcast(plane[0]) * point[0] + reg::broadcast(plane[1]) * point[1]) +
+            reg::broadcast(plane[2]) * point[2]) + reg::broadcast(plane[3]);
+}
+
+// How far a register of volumes reaches into the frustum past the plane they
+// are furthest outside of. A volume is kept where this is not negative. Every
+// test goes through these, the single ones with scalar registers, so they all
+// keep the same volumes.
+template<typename reg, typename Real>
+inline reg sphere_margin(const Frustum<Real> & frustum, const reg center[3], const reg & radius)
+{
+    reg margin = reg::broadcast(std::numeric_limits<Real>::infinity());
+    for (size_t p = 0; p < Frustum<Real>::plane_count; ++p) {
+        margin = Simd::min(plane_distance(frustum.get_plane(p), center), margin);
+    }
+    return margin + radius;
+}
+
+// The corner of each box furthest along the normal of the plane decides
+template<typename reg, typename Real>
+inline reg box_margin(const Frustum<Real> & frustum, const reg minimum[3], const reg maximum[3])
+{
+    reg margin = reg::broadcast(std::numeric_limits<Real>::infinity());
+    for (size_t p = 0; p < Frustum<Real>::plane_count; ++p) {
+        const Vector<Real, 4> & plane = frustum.get_plane(p);
+        const reg corner[3] = {plane[0] >= 0 ? maximum[0] : minimum[0],
+                               plane[1] >= 0 ? maximum[1] : minimum[1],
+                               plane[2] >= 0 ? maximum[2] : minimum[2]};
+        margin = Simd::min(plane_distance(plane, corner), margin);
+    }
+    return margin;
+}
+
+template<typename Real>
+bool frustum_contains(const Frustum<Real> & frustum, const Vector<Real, 3> & point)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    const scalar position[3] = {scalar(point[0]), scalar(point[1]), scalar(point[2])};
+    return sphere_margin(frustum, position, scalar(0)).value >= 0;
+}
+
+template<typename Real>
+bool frustum_intersects(const Frustum<Real> & frustum, const Sphere<Real> & sphere)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    const Vector<Real, 3> & center = sphere.get_center();
+    const scalar position[3] = {scalar(center[0]), scalar(center[1]), scalar(center[2])};
+    return sphere_margin(frustum, position, scalar(sphere.get_radius())).value >= 0;
+}
+
+template<typename Real>
+bool frustum_intersects(const Frustum<Real> & frustum, const AABB<Real> & box)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    const Vector<Real, 3> & low = box.get_min();
+    const Vector<Real, 3> & high = box.get_max();
+    const scalar minimum[3] = {scalar(low[0]), scalar(low[1]), scalar(low[2])};
+    const scalar maximum[3] = {scalar(high[0]), scalar(high[1]), scalar(high[2])};
+    return box_margin(frustum, minimum, maximum).value >= 0;
+}
+
+// Where the volumes of the batch culling come from. margin<reg>(i) gives the
+// margins of the volumes [i, i + reg::size), the arrays of volumes gathering
+// their members a register at a time.
+template<typename Real>
+struct SphereArrayMargins
+{
+    static const size_t stride = sizeof(Sphere<Real>) / sizeof(Real);
+    static_assert(sizeof(Sphere<Real>) % sizeof(Real) == 0, "Spheres have to be gathered a scalar at a time");
+
+    template<typename reg>
+    reg margin(const size_t & i) const
+    {
+        const Real * center = spheres[i].get_center().begin();
+        const reg centers[3] = {reg::gather(center, stride), reg::gather(center + 1, stride),
+                                reg::gather(center + 2, stride)};
+        return sphere_margin(frustum, centers, reg::gather(&spheres[i].get_radius(), stride));
+    }
+
+    const Frustum<Real> & frustum;
+    const Sphere<Real> * spheres;
+};
+
+template<typename Real>
+const size_t SphereArrayMargins<Real>::stride;
+
+template<typename Real>
+struct BoxArrayMargins
+{
+    static const size_t stride = sizeof(AABB<Real>) / sizeof(Real);
+    static_assert(sizeof(AABB<Real>) % sizeof(Real) == 0, "Boxes have to be gathered a scalar at a time");
+
+    template<typename reg>
+    reg margin(const size_t & i) const
+    {
+        const Real * low = boxes[i].get_min().begin();
+        const Real * high = boxes[i].get_max().begin();
+        const reg minimum[3] = {reg::gather(low, stride), reg::gather(low + 1, stride), reg::gather(low + 2, stride)};
+        const reg maximum[3] = {reg::gather(high, stride), reg::gather(high + 1, stride),
+                                reg::gather(high + 2, stride)};
+        return box_margin(frustum, minimum, maximum);
+    }
+
+    const Frustum<Real> & frustum;
+    const AABB<Real> * boxes;
+};
+
+template<typename Real>
+const size_t BoxArrayMargins<Real>::stride;
+
+template<typename Real>
+struct SphereBatchMargins
+{
+    template<typename reg>
+    reg margin(const size_t & i) const
+    {
+        const reg center[3] = {reg::loadu(centers[0] + i), reg::loadu(centers[1] + i), reg::loadu(centers[2] + i)};
+        return sphere_margin(frustum, center, reg::loadu(radii + i));
+    }
+
+    const Frustum<Real> & frustum;
+    const Real * centers[3];
+    const Real * radii;
+};
+
+template<typename Real>
+struct BoxBatchMargins
+{
+    template<typename reg>
+    reg margin(const size_t & i) const
+    {
+        const reg minimum[3] = {reg::loadu(minimums[0] + i), reg::loadu(minimums[1] + i),
+                                reg::loadu(minimums[2] + i)};
+        const reg maximum[3] = {reg::loadu(maximums[0] + i), reg::loadu(maximums[1] + i),
+                                reg::loadu(maximums[2] + i)};
+        return box_margin(frustum, minimum, maximum);
+    }
+
+    const Frustum<Real> & frustum;
+    const Real * minimums[3];
+    const Real * maximums[3];
+};
+
+// Appends the indices of the kept lanes. Every index is written, and only
+// counted when kept, so there is no branch on the outcome.
+template<typename Real, typename reg>
+inline void append_visible(const reg & margin, const size_t & i, size_t * visible, size_t & found)
+{
+    Real lanes[reg::size];
+    margin.storeu(lanes);
+    for (size_t j = 0; j < reg::size; ++j) {
+        visible[found] = i + j;
+        found += lanes[j] >= 0;
+    }
+}
+
+// Each range of parallel_for compacts into its own part of visible, starting
+// at the same index as the range, and the parts are moved together after
+template<typename Real, typename Margins>
+size_t cull(const Margins & margins, const size_t & count, size_t * visible, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    std::vector<size_t> found((count + parallel_granularity - 1) / parallel_granularity);
+    parallel_for(count, threads, [&](const size_t & begin, const size_t & end) {
+        size_t kept = 0;
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            append_visible<Real>(margins.template margin<reg>(i), i, visible + begin, kept);
+        }
+        for (; i < end; ++i) {
+            append_visible<Real>(margins.template margin<scalar>(i), i, visible + begin, kept);
+        }
+        found[begin / parallel_granularity] = kept;
+    });
+
+    size_t total = 0;
+    for (size_t range = 0; range < found.size(); ++range) {
+        const size_t * part = visible + range * parallel_granularity;
+        if (found[range] && part != visible + total) {
+            std::copy(part, part + found[range], visible + total);
+        }
+        total += found[range];
+    }
+    return total;
+}
+
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const Sphere<Real> * spheres, const size_t & count,
+                    size_t * visible, const size_t & threads)
+{
+    const SphereArrayMargins<Real> margins = {frustum, spheres};
+    return cull<Real>(margins, count, visible, threads);
+}
+
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const AABB<Real> * boxes, const size_t & count,
+                    size_t * visible, const size_t & threads)
+{
+    const BoxArrayMargins<Real> margins = {frustum, boxes};
+    return cull<Real>(margins, count, visible, threads);
+}
+
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const VectorSoA<Real, 3> & centers, const Real * radii,
+                    size_t * visible, const size_t & threads)
+{
+    const SphereBatchMargins<Real> margins = {frustum, {centers.component(0), centers.component(1),
+                                                        centers.component(2)}, radii};
+    return cull<Real>(margins, centers.size(), visible, threads);
+}
+
+template<typename Real>
+size_t frustum_cull(const Frustum<Real> & frustum, const VectorSoA<Real, 3> & minimums,
+                    const VectorSoA<Real, 3> & maximums, size_t * visible, const size_t & threads)
+{
+    assert(minimums.size() == maximums.size() && "Can not cull boxes with unequal numbers of corners");
+    const BoxBatchMargins<Real> margins = {frustum, {minimums.component(0), minimums.component(1),
+                                                     minimums.component(2)},
+                                           {maximums.component(0), maximums.component(1), maximums.component(2)}};
+    return cull<Real>(margins, minimums.size(), visible, threads);
+}
+
+template<typename reg, typename Real>
+void project_points_block(const Matrix<Real, 4> & matrix, const Real * const input[3], Real * const output[3],
+                          Real * w, const size_t & i)
+{
+    const Real * m = matrix.begin();
+    const reg x = reg::loadu(input[0] + i);
+    const reg y = reg::loadu(input[1] + i);
+    const reg z = reg::loadu(input[2] + i);
+
+    const reg clip_w = transform_row(m + 12, x, y, z) + reg::broadcast(m[15]);
+    const reg reciprocal = reg::broadcast(1) / clip_w;
+    ((transform_row(m, x, y, z) + reg::broadcast(m[3])) * reciprocal).storeu(output[0] + i);
+    ((transform_row(m + 4, x, y, z) + reg::broadcast(m[7])) * reciprocal).storeu(output[1] + i);
+    ((transform_row(m + 8, x, y, z) + reg::broadcast(m[11])) * reciprocal).storeu(output[2] + i);
+    if (w) {
+        clip_w.storeu(w + i);
+    }
+}
+
+template<typename Real>
+void project_points(const Matrix<Real, 4> & view_projection, const VectorSoA<Real, 3> & points,
+                    VectorSoA<Real, 3> & result, Real * w, const size_t & threads)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    result.resize(points.size());
+    const Real * const input[3] = {points.component(0), points.component(1), points.component(2)};
+    Real * const output[3] = {result.component(0), result.component(1), result.component(2)};
+
+    parallel_for(points.size(), threads, [&](const size_t & begin, const size_t & end) {
+        size_t i = begin;
+        for (; i + reg::size <= end; i += reg::size) {
+            project_points_block<reg>(view_projection, input, output, w, i);
+        }
+        for (; i < end; ++i) {
+            project_points_block<scalar>(view_projection, input, output, w, i);
+        }
+    });
+}
+
+#endif
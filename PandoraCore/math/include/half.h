@@ -0,0 +1,56 @@
+#ifndef MATH_HALF_H_INCLUDED
+#define MATH_HALF_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "vector.h"
+
+#include <cstring>
+
+namespace Math
+{
+
+// IEEE 754 binary16. It is a storage type, for vectors kept at half the size
+// of float: arithmetic on it is done in float, and a float is rounded to the
+// nearest half, ties to even, when stored.
+struct half
+{
+public:
+    constexpr half();
+    half(const float & value);
+
+    operator float() const;
+
+    half & operator+=(const float & value);
+    half & operator-=(const float & value);
+    half & operator*=(const float & value);
+    half & operator/=(const float & value);
+
+    static half from_bits(const uint16_t & bits);
+    uint16_t get_bits() const;
+private:
+    uint16_t bits;
+};
+
+typedef Vector<half, 2> Vec2h;
+typedef Vector<half, 3> Vec3h;
+typedef Vector<half, 4> Vec4h;
+
+// Conversion of whole arrays, with F16C when the build enables it. Both give
+// the same results as converting one value at a time.
+void float_to_half(const float * values, const size_t & count, half * result);
+void half_to_float(const half * values, const size_t & count, float * result);
+
+template<size_t dim>
+void float_to_half(const Vector<float, dim> * vectors, const size_t & count, Vector<half, dim> * result);
+
+template<size_t dim>
+void half_to_float(const Vector<half, dim> * vectors, const size_t & count, Vector<float, dim> * result);
+
+#define INCLUDED_FROM_HALF_H
+#include "half_tmpl.h"
+#undef INCLUDED_FROM_HALF_H
+
+}
+
+#endif
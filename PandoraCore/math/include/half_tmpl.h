@@ -0,0 +1,262 @@
+#ifndef INCLUDED_FROM_HALF_H
+#error "half_tmpl.h should only be included from half.h"
+#else
+
+constexpr half::half()
+    : bits(0)
+{ }
+
+// Rebiases the exponent from 127 to 15 and rounds away the low 13 bits of the
+// mantissa. Values below the smallest normal half become denormals, rounded
+// the same way, and NaNs keep the top of their payload but are made quiet,
+// like the F16C conversion.
+inline half::half(const float & value)
+{
+    uint32_t single;
+    std::memcpy(&single, &value, sizeof(single));
+
+    const uint32_t sign = (single >> 16) & 0x8000;
+    const uint32_t magnitude = single & 0x7fffffff;
+
+    if (magnitude >= 0x7f800000) {
+        bits = uint16_t(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 | ((magnitude >> 13) & 0x3ff) : 0));
+        return;
+    }
+    // 65520, halfway between the largest half and the next power of two,
+    // rounds to infinity
+    if (magnitude >= 0x477ff000) {
+        bits = uint16_t(sign | 0x7c00);
+        return;
+    }
+    // Below half the smallest denormal everything rounds to zero
+    if (magnitude < 0x33000000) {
+        bits = uint16_t(sign);
+        return;
+    }
+
+    uint32_t result;
+    uint32_t remainder;
+    uint32_t halfway;
+    if (magnitude < 0x38800000) {
+        const uint32_t shift = 126 - (magnitude >> 23);
+        const uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+        result = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    } else {
+        result = (magnitude - 0x38000000) >> 13;
+        remainder = magnitude & 0x1fff;
+        halfway = 0x1000;
+    }
+
+    // A carry out of the mantissa moves on to the next exponent, as it should
+    if (remainder > halfway || (remainder == halfway && (result & 1))) {
+        ++result;
+    }
+    bits = uint16_t(sign | result);
+}
+
+// Every half is exactly a float, denormals included
+inline half::operator float() const
+{
+    const uint32_t sign = uint32_t(bits & 0x8000) << 16;
+    uint32_t exponent = (bits >> 10) & 0x1f;
+    uint32_t mantissa = bits & 0x3ff;
+
+    uint32_t single;
+    if (exponent == 0x1f) {
+        single = sign | 0x7f800000 | (mantissa << 13) | (mantissa ? 0x400000 : 0);
+    } else if (exponent == 0) {
+        if (mantissa == 0) {
+            single = sign;
+        } else {
+            exponent = 113;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            single = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    } else {
+        single = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &single, sizeof(value));
+    return value;
+}
+
+inline half & half::operator+=(const float & value)
+{
+    return *this = float(*this) + value;
+}
+
+inline half & half::operator-=(const float & value)
+{
+    return *this = float(*this) - value;
+}
+
+inline half & half::operator*=(const float & value)
+{
+    return *this = float(*this) * value;
+}
+
+inline half & half::operator/=(const float & value)
+{
+    return *this = float(*this) / value;
+}
+
+inline half half::from_bits(const uint16_t & bits)
+{
+    half value;
+    value.bits = bits;
+    return value;
+}
+
+inline uint16_t half::get_bits() const
+{
+    return bits;
+}
+
+#ifdef MATH_USE_F16C
+
+// Eight values per conversion, the rest one at a time
+inline void float_to_half(const float * values, const size_t & count, half * result)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(result + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (; i < count; ++i) {
+        result[i] = values[i];
+    }
+}
+
+inline void half_to_float(const half * values, const size_t & count, float * result)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(result + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i))));
+    }
+    for (; i < count; ++i) {
+        result[i] = values[i];
+    }
+}
+
+// A padded float vector converts as one register. Four halves are written
+// for three, the last one landing on the next vector before it is written,
+// so the last vector is done one value at a time.
+template<size_t dim>
+void padded_float_to_half(const Vector<float, dim> * vectors, const size_t & count, Vector<half, dim> * result)
+{
+    static_assert(Simd::VectorStorage<float, dim>::size == 4, "Only vectors padded to a register are converted here");
+
+    for (size_t i = 0; i + 1 < count; ++i) {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(result[i].begin()),
+                         _mm_cvtps_ph(_mm_loadu_ps(vectors[i].begin()), _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (size_t j = 0; j < dim; ++j) {
+        result[count - 1][j] = vectors[count - 1][j];
+    }
+}
+
+// Reading four halves takes one from the next vector, which is masked out of
+// the padding
+template<size_t dim>
+void padded_half_to_float(const Vector<half, dim> * vectors, const size_t & count, Vector<float, dim> * result)
+{
+    static_assert(Simd::VectorStorage<float, dim>::size == 4, "Only vectors padded to a register are converted here");
+
+    const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, dim > 1 ? -1 : 0, dim > 2 ? -1 : 0, 0));
+    for (size_t i = 0; i + 1 < count; ++i) {
+        const __m128i halves = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(vectors[i].begin()));
+        _mm_storeu_ps(result[i].begin(), _mm_and_ps(_mm_cvtph_ps(halves), mask));
+    }
+    for (size_t j = 0; j < dim; ++j) {
+        result[count - 1][j] = vectors[count - 1][j];
+    }
+}
+
+#else
+
+inline void float_to_half(const float * values, const size_t & count, half * result)
+{
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = values[i];
+    }
+}
+
+inline void half_to_float(const half * values, const size_t & count, float * result)
+{
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = values[i];
+    }
+}
+
+#endif
+
+// Vectors without padding are converted as one array of values
+template<size_t dim>
+void float_to_half(const Vector<float, dim> * vectors, const size_t & count, Vector<half, dim> * result,
+                   std::true_type)
+{
+    float_to_half(vectors[0].begin(), count * dim, result[0].begin());
+}
+
+template<size_t dim>
+void float_to_half(const Vector<float, dim> * vectors, const size_t & count, Vector<half, dim> * result,
+                   std::false_type)
+{
+#ifdef MATH_USE_F16C
+    padded_float_to_half(vectors, count, result);
+#else
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            result[i][j] = vectors[i][j];
+        }
+    }
+#endif
+}
+
+template<size_t dim>
+void float_to_half(const Vector<float, dim> * vectors, const size_t & count, Vector<half, dim> * result)
+{
+    if (count == 0) {
+        return;
+    }
+    float_to_half(vectors, count, result, std::integral_constant<bool, Simd::VectorStorage<float, dim>::size == dim>());
+}
+
+template<size_t dim>
+void half_to_float(const Vector<half, dim> * vectors, const size_t & count, Vector<float, dim> * result,
+                   std::true_type)
+{
+    half_to_float(vectors[0].begin(), count * dim, result[0].begin());
+}
+
+template<size_t dim>
+void half_to_float(const Vector<half, dim> * vectors, const size_t & count, Vector<float, dim> * result,
+                   std::false_type)
+{
+#ifdef MATH_USE_F16C
+    padded_half_to_float(vectors, count, result);
+#else
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            result[i][j] = vectors[i][j];
+        }
+    }
+#endif
+}
+
+template<size_t dim>
+void half_to_float(const Vector<half, dim> * vectors, const size_t & count, Vector<float, dim> * result)
+{
+    if (count == 0) {
+        return;
+    }
+    half_to_float(vectors, count, result, std::integral_constant<bool, Simd::VectorStorage<float, dim>::size == dim>());
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef MATH_INDICES_H_INCLUDED
+#define MATH_INDICES_H_INCLUDED
+
+#include "config.h"
+
+namespace Math
+{
+
+// Compile time list of indices, used to expand element wise initialization
+// of vectors and matrices in constant expressions.
+template<size_t... indices>
+struct Indices
+{ };
+
+// Indices<0, 1, ..., count-1>
+template<size_t count, size_t... indices>
+struct MakeIndices
+    : MakeIndices<count-1, count-1, indices...>
+{ };
+
+template<size_t... indices>
+struct MakeIndices<0, indices...>
+{
+    typedef Indices<indices...> type;
+};
+
+}
+
+#endif
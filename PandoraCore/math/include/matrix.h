@@ -3,40 +3,135 @@
 
 #include "config.h"
 #include "vector.h"
+#include "indices.h"
 
-#include <array>
 #include <initializer_list>
 #include <algorithm>
+#include <limits>
+#include <type_traits>
 
 namespace Math
 {
 
-template<typename Real, size_t dim>
+// Where element (i, j) of a dim x dim matrix is stored. The transposed
+// order stores the transpose of a matrix in the same place.
+struct ColumnMajor;
+
+struct RowMajor
+{
+    typedef ColumnMajor transposed;
+
+    static constexpr size_t index(const size_t & i, const size_t & j, const size_t & dim) { return i*dim + j; }
+    static constexpr size_t row(const size_t & index, const size_t & dim) { return index / dim; }
+    static constexpr size_t column(const size_t & index, const size_t & dim) { return index % dim; }
+};
+
+struct ColumnMajor
+{
+    typedef RowMajor transposed;
+
+    static constexpr size_t index(const size_t & i, const size_t & j, const size_t & dim) { return j*dim + i; }
+    static constexpr size_t row(const size_t & index, const size_t & dim) { return index % dim; }
+    static constexpr size_t column(const size_t & index, const size_t & dim) { return index / dim; }
+};
+
+// The elements are stored in Order. Column major matrices are for handing
+// data to and from code expecting that layout without a transpose, the
+// functions below work on both, and the ones for sizes 2 to 4 and the
+// register versions are shared with row major matrices through
+// matrix_transposed_order.
+//
+// The arrays, initializer lists and argument lists of the constructors, and
+// begin(), end() and operator[], are the elements in storage order.
+template<typename Real, size_t dim, typename Order = RowMajor>
 struct Matrix
 {
 public:
-    Matrix();
+    constexpr Matrix();
     Matrix(const std::initializer_list<Real> & elements);
-    Matrix(const Real array[dim*dim]);
+    constexpr Matrix(const Real array[dim*dim]);
+
+    // One argument per element, in storage order. Unlike the initializer
+    // list this can be used in constant expressions.
+    template<typename... Elements,
+             typename = typename std::enable_if<sizeof...(Elements) + 1 == dim*dim>::type>
+    constexpr Matrix(const Real & first, const Elements & ... rest);
+
+    // The same matrix, stored in the other order
+    template<typename Other>
+    constexpr explicit Matrix(const Matrix<Real, dim, Other> & matrix);
+
+    template<typename Expression>
+    constexpr Matrix(const Expression & expression,
+                     typename EnableIfExpressionOf<Expression, Matrix>::type * = nullptr);
+
+    template<typename Expression>
+    typename EnableIfExpressionOf<Expression, Matrix, Matrix &>::type
+    operator=(const Expression & expression);
+
+    const Real* begin() const;
+    const Real* end() const;
+    Real* begin();
+    Real* end();
 
     Real & operator[](const size_t & i);
-    Real operator[](const size_t & i) const;
+    constexpr Real operator[](const size_t & i) const;
 
     Real & operator()(const size_t & i, const size_t & j);
-    Real operator()(const size_t & i, const size_t & j) const;
+    constexpr Real operator()(const size_t & i, const size_t & j) const;
 private:
-    std::array<Real, dim*dim> data;
+    template<size_t... indices>
+    constexpr Matrix(Indices<indices...>);
+
+    template<typename Elements, size_t... indices>
+    constexpr Matrix(const Elements & elements, Indices<indices...>);
+
+    template<typename Other, size_t... indices>
+    constexpr Matrix(const Matrix<Real, dim, Other> & matrix, Indices<indices...>, int);
+
+    Real data[dim*dim];
 };
 
-// Non intrusive functions
+// Matrices are the leaves of matrix expressions
+template<typename Real, size_t dim, typename Order>
+struct ExpressionTraits<Matrix<Real, dim, Order> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = true;
+    static const size_t storage_size = dim*dim;
+    typedef Matrix<Real, dim, Order> result_type;
+    typedef Real real_type;
+    typedef MultiplyByReciprocal scalar_division;
+};
+
+template<typename Register, typename Real, size_t dim, typename Order>
+Register expression_packet(const Matrix<Real, dim, Order> & matrix, const size_t & offset);
+
+// LU factorization with partial pivoting of a matrix A, so that the rows of
+// A in the order given by permutation equal L*U. L has a unit diagonal, which
+// is not stored, and shares factors with U. The matrix is singular when a
+// pivot is zero relative to its largest element.
 template<typename Real, size_t dim>
-Real matrix_determinant(const Matrix<Real, dim> & matrix);
+struct LUDecomposition
+{
+    Matrix<Real, dim> factors;
+    size_t permutation[dim];
+    Real sign;
+    bool singular;
+};
 
+// Non intrusive functions. The determinant, adjugate and inverse of larger
+// floating point matrices go through the LU factorization, integer matrices
+// use cofactors. matrix2.h, matrix3.h and matrix4.h add closed form versions
+// for their sizes.
 template<typename Real, size_t dim>
-Matrix<Real, dim> matrix_transpose(const Matrix<Real, dim> & matrix);
+Real matrix_determinant(const Matrix<Real, dim> & matrix);
 
 template<typename Real, size_t dim>
-Real matrix_trace(const Matrix<Real, dim> & matrix);
+constexpr Matrix<Real, dim> matrix_transpose(const Matrix<Real, dim> & matrix);
+
+template<typename Real, size_t dim, typename Order>
+Real matrix_trace(const Matrix<Real, dim, Order> & matrix);
 
 template<typename Real, size_t dim>
 Matrix<Real, dim> matrix_adjugate(const Matrix<Real, dim> & matrix);
@@ -44,28 +139,41 @@ Matrix<Real, dim> matrix_adjugate(const Matrix<Real, dim> & matrix);
 template<typename Real, size_t dim>
 Matrix<Real, dim> matrix_inverse(const Matrix<Real, dim> & matrix);
 
-
-// Inline arithmetic operations
 template<typename Real, size_t dim>
-Matrix<Real, dim> & operator+=(Matrix<Real, dim> & to, const Matrix<Real, dim> & from);
+LUDecomposition<Real, dim> matrix_lu_decompose(const Matrix<Real, dim> & matrix);
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> & operator-=(Matrix<Real, dim> & to, const Matrix<Real, dim> & from);
+Vector<Real, dim> lu_solve(const LUDecomposition<Real, dim> & lu, const Vector<Real, dim> & vector);
 
+// The x solving matrix * x = vector, without forming the inverse
 template<typename Real, size_t dim>
-Matrix<Real, dim> & operator*=(Matrix<Real, dim> & matrix, const Real & scalar);
+Vector<Real, dim> matrix_solve(const Matrix<Real, dim> & matrix, const Vector<Real, dim> & vector);
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> & operator/=(Matrix<Real, dim> & matrix, const Real & scalar);
 
+// Inline arithmetic operations
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator+=(Matrix<Real, dim, Order> & to, const Matrix<Real, dim, Order> & from);
 
-// Arithmetic operations
-template<typename Real, size_t dim>
-Matrix<Real, dim> operator+(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right);
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator-=(Matrix<Real, dim, Order> & to, const Matrix<Real, dim, Order> & from);
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> operator-(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right);
+template<typename Real, size_t dim, typename Order, typename Expression>
+typename EnableIfExpressionOf<Expression, Matrix<Real, dim, Order>, Matrix<Real, dim, Order> &>::type
+operator+=(Matrix<Real, dim, Order> & to, const Expression & from);
 
+template<typename Real, size_t dim, typename Order, typename Expression>
+typename EnableIfExpressionOf<Expression, Matrix<Real, dim, Order>, Matrix<Real, dim, Order> &>::type
+operator-=(Matrix<Real, dim, Order> & to, const Expression & from);
+
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator*=(Matrix<Real, dim, Order> & matrix, const Real & scalar);
+
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator/=(Matrix<Real, dim, Order> & matrix, const Real & scalar);
+
+
+// Arithmetic operations. The element wise +, -, scaling and division by a
+// scalar come from expression.h.
 template<typename Real, size_t dim>
 Matrix<Real, dim> operator*(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right);
 
@@ -75,25 +183,59 @@ Vector<Real, dim> operator*(const Matrix<Real, dim> & matrix, const Vector<Real,
 template<typename Real, size_t dim>
 Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Matrix<Real, dim> & matrix);
 
+
+// Matrix comparison
+template<typename Real, size_t dim, typename Order>
+bool operator==(const Matrix<Real, dim, Order> & left, const Matrix<Real, dim, Order> & right);
+
+template<typename Real, size_t dim, typename Order>
+bool operator!=(const Matrix<Real, dim, Order> & left, const Matrix<Real, dim, Order> & right);
+
+
+// The transpose of a matrix stored in the other order, which is the same
+// elements in the same place. The elements are copied as they are, with no
+// shuffling unlike matrix_transpose, and an operation that is naturally
+// transposed can run on the other order.
+template<typename Real, size_t dim, typename Order>
+constexpr Matrix<Real, dim, typename Order::transposed> matrix_transposed_order(const Matrix<Real, dim, Order> & matrix);
+
+// The functions and products of column major matrices. Each runs the row
+// major one on the transposes, like the product of A and B is the transpose
+// of the product of the transposes of B and A. The arguments and results are
+// copied to and from the other order on the way, so these cost a few copies
+// of dim*dim elements more than the row major ones.
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator*(const Matrix<Real, dim> & matrix, const Real & scalar);
+Real matrix_determinant(const Matrix<Real, dim, ColumnMajor> & matrix);
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator*(const Real & scalar, const Matrix<Real, dim> & matrix);
+Matrix<Real, dim, ColumnMajor> matrix_transpose(const Matrix<Real, dim, ColumnMajor> & matrix);
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator/(const Matrix<Real, dim> & matrix, const Real & scalar);
+Matrix<Real, dim, ColumnMajor> matrix_adjugate(const Matrix<Real, dim, ColumnMajor> & matrix);
 
+template<typename Real, size_t dim>
+Matrix<Real, dim, ColumnMajor> matrix_inverse(const Matrix<Real, dim, ColumnMajor> & matrix);
+
+// The factors are row major, like for row major matrices
+template<typename Real, size_t dim>
+LUDecomposition<Real, dim> matrix_lu_decompose(const Matrix<Real, dim, ColumnMajor> & matrix);
+
+template<typename Real, size_t dim>
+Vector<Real, dim> matrix_solve(const Matrix<Real, dim, ColumnMajor> & matrix, const Vector<Real, dim> & vector);
+
+template<typename Real, size_t dim>
+Matrix<Real, dim, ColumnMajor> operator*(const Matrix<Real, dim, ColumnMajor> & left,
+                                         const Matrix<Real, dim, ColumnMajor> & right);
 
-// Matrix comparison
 template<typename Real, size_t dim>
-bool operator==(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right);
+Vector<Real, dim> operator*(const Matrix<Real, dim, ColumnMajor> & matrix, const Vector<Real, dim> & vector);
 
 template<typename Real, size_t dim>
-bool operator!=(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right);
+Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Matrix<Real, dim, ColumnMajor> & matrix);
 
 #define INCLUDED_FROM_MATRIX_H
 #include "matrix_tmpl.h"
+#include "matrix_simd_tmpl.h"
 #undef INCLUDED_FROM_MATRIX_H
 
 }
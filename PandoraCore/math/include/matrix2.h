@@ -11,10 +11,35 @@ typedef Matrix<double,    2> Matrix2d;
 typedef Matrix<int,       2> Matrix2i;
 typedef Matrix<uint32_t,  2> Matrix2u;
 
+template<typename Real>
+constexpr Real matrix_determinant(const Matrix<Real, 2> & matrix);
+
+template<typename Real>
+Matrix<Real, 2> matrix_adjugate(const Matrix<Real, 2> & matrix);
+
+template<typename Real>
+Matrix<Real, 2> matrix_inverse(const Matrix<Real, 2> & matrix);
+
 #define INCLUDED_FROM_MATRIX2_H
 #include "matrix2_tmpl.h"
 #undef INCLUDED_FROM_MATRIX2_H
 
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Matrix<float, 2>;
+extern template struct Matrix<double, 2>;
+extern template Matrix<float, 2> matrix_adjugate(const Matrix<float, 2> &);
+extern template Matrix<double, 2> matrix_adjugate(const Matrix<double, 2> &);
+extern template Matrix<float, 2> matrix_inverse(const Matrix<float, 2> &);
+extern template Matrix<double, 2> matrix_inverse(const Matrix<double, 2> &);
+extern template LUDecomposition<float, 2> matrix_lu_decompose(const Matrix<float, 2> &);
+extern template LUDecomposition<double, 2> matrix_lu_decompose(const Matrix<double, 2> &);
+extern template Vector<float, 2> lu_solve(const LUDecomposition<float, 2> &, const Vector<float, 2> &);
+extern template Vector<double, 2> lu_solve(const LUDecomposition<double, 2> &, const Vector<double, 2> &);
+extern template Vector<float, 2> matrix_solve(const Matrix<float, 2> &, const Vector<float, 2> &);
+extern template Vector<double, 2> matrix_solve(const Matrix<double, 2> &, const Vector<double, 2> &);
+#endif
+
 }
 
 #endif
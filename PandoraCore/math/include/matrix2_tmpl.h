@@ -2,6 +2,12 @@
 #error "matrix2_tmpl.h can only be included from matrix2.h"
 #else
 
+template<typename Real>
+constexpr Real matrix_determinant(const Matrix<Real, 2> & matrix)
+{
+    return matrix(0,0) * matrix(1,1) - matrix(0,1) * matrix(1,0);
+}
+
 template<typename Real>
 Matrix<Real, 2> matrix_adjugate(const Matrix<Real, 2> & matrix)
 {
@@ -9,4 +15,10 @@ Matrix<Real, 2> matrix_adjugate(const Matrix<Real, 2> & matrix)
                             -matrix[2], matrix[0]});
 }
 
+template<typename Real>
+Matrix<Real, 2> matrix_inverse(const Matrix<Real, 2> & matrix)
+{
+    return adjugate_inverse(matrix, matrix_adjugate(matrix));
+}
+
 #endif
@@ -11,5 +11,34 @@ typedef Matrix<double,    3>  Matrix3d;
 typedef Matrix<int,       3>  Matrix3i;
 typedef Matrix<uint32_t,  3>  Matrix3u;
 
+template<typename Real>
+constexpr Real matrix_determinant(const Matrix<Real, 3> & matrix);
+
+template<typename Real>
+Matrix<Real, 3> matrix_adjugate(const Matrix<Real, 3> & matrix);
+
+template<typename Real>
+Matrix<Real, 3> matrix_inverse(const Matrix<Real, 3> & matrix);
+
+#define INCLUDED_FROM_MATRIX3_H
+#include "matrix3_tmpl.h"
+#undef INCLUDED_FROM_MATRIX3_H
+
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Matrix<float, 3>;
+extern template struct Matrix<double, 3>;
+extern template Matrix<float, 3> matrix_adjugate(const Matrix<float, 3> &);
+extern template Matrix<double, 3> matrix_adjugate(const Matrix<double, 3> &);
+extern template Matrix<float, 3> matrix_inverse(const Matrix<float, 3> &);
+extern template Matrix<double, 3> matrix_inverse(const Matrix<double, 3> &);
+extern template LUDecomposition<float, 3> matrix_lu_decompose(const Matrix<float, 3> &);
+extern template LUDecomposition<double, 3> matrix_lu_decompose(const Matrix<double, 3> &);
+extern template Vector<float, 3> lu_solve(const LUDecomposition<float, 3> &, const Vector<float, 3> &);
+extern template Vector<double, 3> lu_solve(const LUDecomposition<double, 3> &, const Vector<double, 3> &);
+extern template Vector<float, 3> matrix_solve(const Matrix<float, 3> &, const Vector<float, 3> &);
+extern template Vector<double, 3> matrix_solve(const Matrix<double, 3> &, const Vector<double, 3> &);
+#endif
+
 }
 #endif
@@ -0,0 +1,36 @@
+#ifndef INCLUDED_FROM_MATRIX3_H
+#error "matrix3_tmpl.h can only be included from matrix3.h"
+#else
+
+// Expanded along the first row
+template<typename Real>
+constexpr Real matrix_determinant(const Matrix<Real, 3> & matrix)
+{
+    return matrix(0,0) * (matrix(1,1) * matrix(2,2) - matrix(1,2) * matrix(2,1)) -
+           matrix(0,1) * (matrix(1,0) * matrix(2,2) - matrix(1,2) * matrix(2,0)) +
+           matrix(0,2) * (matrix(1,0) * matrix(2,1) - matrix(1,1) * matrix(2,0));
+}
+
+template<typename Real>
+Matrix<Real, 3> matrix_adjugate(const Matrix<Real, 3> & matrix)
+{
+    return Matrix<Real, 3>(matrix(1,1) * matrix(2,2) - matrix(1,2) * matrix(2,1),
+                           matrix(0,2) * matrix(2,1) - matrix(0,1) * matrix(2,2),
+                           matrix(0,1) * matrix(1,2) - matrix(0,2) * matrix(1,1),
+
+                           matrix(1,2) * matrix(2,0) - matrix(1,0) * matrix(2,2),
+                           matrix(0,0) * matrix(2,2) - matrix(0,2) * matrix(2,0),
+                           matrix(0,2) * matrix(1,0) - matrix(0,0) * matrix(1,2),
+
+                           matrix(1,0) * matrix(2,1) - matrix(1,1) * matrix(2,0),
+                           matrix(0,1) * matrix(2,0) - matrix(0,0) * matrix(2,1),
+                           matrix(0,0) * matrix(1,1) - matrix(0,1) * matrix(1,0));
+}
+
+template<typename Real>
+Matrix<Real, 3> matrix_inverse(const Matrix<Real, 3> & matrix)
+{
+    return adjugate_inverse(matrix, matrix_adjugate(matrix));
+}
+
+#endif
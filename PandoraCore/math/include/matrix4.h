@@ -2,6 +2,10 @@
 #define MATH_MATRIX4_H_INCLUDED
 
 #include "matrix.h"
+#include "matrix3.h"
+#include "vector3.h"
+
+#include <limits>
 
 namespace Math
 {
@@ -11,6 +15,87 @@ typedef Matrix<double,    4>  Matrix4d;
 typedef Matrix<int,       4>  Matrix4i;
 typedef Matrix<uint32_t,  4>  Matrix4u;
 
+template<typename Real>
+constexpr Real matrix_determinant(const Matrix<Real, 4> & matrix);
+
+template<typename Real>
+Matrix<Real, 4> matrix_adjugate(const Matrix<Real, 4> & matrix);
+
+template<typename Real>
+Matrix<Real, 4> matrix_inverse(const Matrix<Real, 4> & matrix);
+
+// Transforms acting on column vectors, with the translation in the last
+// column. An affine transform has (0, 0, 0, 1) as its last row, a rigid one
+// also has an orthonormal upper 3x3 block.
+template<typename Real>
+bool matrix_is_affine(const Matrix<Real, 4> & matrix);
+
+template<typename Real>
+bool matrix_is_rigid(const Matrix<Real, 4> & matrix,
+                     const Real & tolerance = std::sqrt(std::numeric_limits<Real>::epsilon()));
+
+// Inverses of affine and rigid transforms, much cheaper than the general
+// inverse. Debug builds assert that the matrix is such a transform.
+template<typename Real>
+Matrix<Real, 4> matrix_inverse_affine(const Matrix<Real, 4> & matrix);
+
+template<typename Real>
+Matrix<Real, 4> matrix_inverse_rigid(const Matrix<Real, 4> & matrix);
+
+// The same for column major matrices, which hold the same transforms, only
+// stored the other way
+template<typename Real>
+bool matrix_is_affine(const Matrix<Real, 4, ColumnMajor> & matrix);
+
+template<typename Real>
+bool matrix_is_rigid(const Matrix<Real, 4, ColumnMajor> & matrix,
+                     const Real & tolerance = std::sqrt(std::numeric_limits<Real>::epsilon()));
+
+template<typename Real>
+Matrix<Real, 4, ColumnMajor> matrix_inverse_affine(const Matrix<Real, 4, ColumnMajor> & matrix);
+
+template<typename Real>
+Matrix<Real, 4, ColumnMajor> matrix_inverse_rigid(const Matrix<Real, 4, ColumnMajor> & matrix);
+
+// Camera matrices, in the OpenGL conventions: the camera looks down -z with
+// y up, and the projections map the view volume to the cube [-1, 1]^3 after
+// the divide by w, with z_near going to -1. Angles are in radians.
+template<typename Real>
+Matrix<Real, 4> matrix_perspective(const Real & fov_y, const Real & aspect, const Real & z_near, const Real & z_far);
+
+template<typename Real>
+Matrix<Real, 4> matrix_orthographic(const Real & left, const Real & right, const Real & bottom, const Real & top,
+                                    const Real & z_near, const Real & z_far);
+
+// The rigid transform from world to view space for a camera at eye, looking
+// at target. up only has to be somewhere above the view direction.
+template<typename Real>
+Matrix<Real, 4> matrix_look_at(const Vector<Real, 3> & eye, const Vector<Real, 3> & target,
+                               const Vector<Real, 3> & up);
+
+#define INCLUDED_FROM_MATRIX4_H
+#include "matrix4_tmpl.h"
+#include "matrix4_simd_tmpl.h"
+#undef INCLUDED_FROM_MATRIX4_H
+
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Matrix<float, 4>;
+extern template struct Matrix<double, 4>;
+extern template Matrix<float, 4> matrix_adjugate(const Matrix<float, 4> &);
+extern template Matrix<double, 4> matrix_adjugate(const Matrix<double, 4> &);
+extern template Matrix<float, 4> matrix_inverse(const Matrix<float, 4> &);
+extern template Matrix<double, 4> matrix_inverse(const Matrix<double, 4> &);
+extern template bool matrix_is_rigid(const Matrix<float, 4> &, const float &);
+extern template bool matrix_is_rigid(const Matrix<double, 4> &, const double &);
+extern template LUDecomposition<float, 4> matrix_lu_decompose(const Matrix<float, 4> &);
+extern template LUDecomposition<double, 4> matrix_lu_decompose(const Matrix<double, 4> &);
+extern template Vector<float, 4> lu_solve(const LUDecomposition<float, 4> &, const Vector<float, 4> &);
+extern template Vector<double, 4> lu_solve(const LUDecomposition<double, 4> &, const Vector<double, 4> &);
+extern template Vector<float, 4> matrix_solve(const Matrix<float, 4> &, const Vector<float, 4> &);
+extern template Vector<double, 4> matrix_solve(const Matrix<double, 4> &, const Vector<double, 4> &);
+#endif
+
 }
 
 #endif
@@ -0,0 +1,76 @@
+#ifndef INCLUDED_FROM_MATRIX4_H
+#error "matrix4_simd_tmpl.h can only be included from matrix4.h"
+#else
+
+// Register backed versions of the 4x4 float and double matrix operations.
+// They give bit for bit the same results as the versions in matrix4_tmpl.h.
+
+#ifdef MATH_USE_SSE2
+
+// Cramer's rule, a row of the inverse per register. With ck the columns of
+// the matrix and xk the same columns with neighbouring lanes swapped,
+// ci*xj - xi*cj holds the minors sij of the first two rows in lanes 0 and 1,
+// and cij of the last two rows in lanes 2 and 3.
+template<typename Real>
+Matrix<Real, 4> simd_matrix_inverse(const Matrix<Real, 4> & matrix)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    const auto columns = matrix_transpose(matrix);
+    const reg c0 = reg::loadu(columns.begin());
+    const reg c1 = reg::loadu(columns.begin() + 4);
+    const reg c2 = reg::loadu(columns.begin() + 8);
+    const reg c3 = reg::loadu(columns.begin() + 12);
+
+    const reg x0 = Simd::shuffle<1, 0, 3, 2>(c0);
+    const reg x1 = Simd::shuffle<1, 0, 3, 2>(c1);
+    const reg x2 = Simd::shuffle<1, 0, 3, 2>(c2);
+    const reg x3 = Simd::shuffle<1, 0, 3, 2>(c3);
+
+    // The minors as {cij, cij, sij, sij}, lined up with the lanes of xk
+    const reg m01 = Simd::shuffle<2, 2, 0, 0>(c0 * x1 - x0 * c1);
+    const reg m02 = Simd::shuffle<2, 2, 0, 0>(c0 * x2 - x0 * c2);
+    const reg m03 = Simd::shuffle<2, 2, 0, 0>(c0 * x3 - x0 * c3);
+    const reg m12 = Simd::shuffle<2, 2, 0, 0>(c1 * x2 - x1 * c2);
+    const reg m13 = Simd::shuffle<2, 2, 0, 0>(c1 * x3 - x1 * c3);
+    const reg m23 = Simd::shuffle<2, 2, 0, 0>(c2 * x3 - x2 * c3);
+
+    // {1, -1, 1, -1} and {-1, 1, -1, 1}
+    const Real signs[5] = {1, -1, 1, -1, 1};
+    const reg even = reg::loadu(signs);
+    const reg odd = reg::loadu(signs + 1);
+
+    const reg row0 = (x1 * m23 - x2 * m13 + x3 * m12) * even;
+    const reg row1 = (x0 * m23 - x2 * m03 + x3 * m02) * odd;
+    const reg row2 = (x0 * m13 - x1 * m03 + x3 * m01) * even;
+    const reg row3 = (x0 * m12 - x1 * m02 + x2 * m01) * odd;
+
+    // Expanded along the first column, like adjugate_inverse, summed in
+    // registers in the same order
+    const Real determinant = Simd::horizontal_sum(c0 * row0);
+    assert(determinant != 0 && "Can not invert singular matrix");
+
+    const reg reciprocal = reg::broadcast(Real(1./determinant));
+    Matrix<Real, 4> inverse;
+    (row0 * reciprocal).storeu(inverse.begin());
+    (row1 * reciprocal).storeu(inverse.begin() + 4);
+    (row2 * reciprocal).storeu(inverse.begin() + 8);
+    (row3 * reciprocal).storeu(inverse.begin() + 12);
+    return inverse;
+}
+
+template<>
+inline Matrix<float, 4> matrix_inverse(const Matrix<float, 4> & matrix)
+{
+    return simd_matrix_inverse(matrix);
+}
+
+template<>
+inline Matrix<double, 4> matrix_inverse(const Matrix<double, 4> & matrix)
+{
+    return simd_matrix_inverse(matrix);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef INCLUDED_FROM_MATRIX4_H
+#error "matrix4_tmpl.h can only be included from matrix4.h"
+#else
+
+// 2x2 determinant of the last two rows and the given columns
+template<typename Real>
+constexpr Real lower_minor(const Matrix<Real, 4> & matrix, const size_t & first, const size_t & second)
+{
+    return matrix(2,first) * matrix(3,second) - matrix(2,second) * matrix(3,first);
+}
+
+template<typename Real>
+constexpr Real expand_determinant(const Matrix<Real, 4> & matrix,
+                                  const Real & minor01, const Real & minor02, const Real & minor03,
+                                  const Real & minor12, const Real & minor13, const Real & minor23)
+{
+    return matrix(0,0) * (matrix(1,1) * minor23 - matrix(1,2) * minor13 + matrix(1,3) * minor12) -
+           matrix(0,1) * (matrix(1,0) * minor23 - matrix(1,2) * minor03 + matrix(1,3) * minor02) +
+           matrix(0,2) * (matrix(1,0) * minor13 - matrix(1,1) * minor03 + matrix(1,3) * minor01) -
+           matrix(0,3) * (matrix(1,0) * minor12 - matrix(1,1) * minor02 + matrix(1,2) * minor01);
+}
+
+// Expanded along the first row, and every 3x3 cofactor along its first row.
+// The cofactors share the six 2x2 minors of the last two rows.
+template<typename Real>
+constexpr Real matrix_determinant(const Matrix<Real, 4> & matrix)
+{
+    return expand_determinant(matrix,
+                              lower_minor(matrix, 0, 1), lower_minor(matrix, 0, 2), lower_minor(matrix, 0, 3),
+                              lower_minor(matrix, 1, 2), lower_minor(matrix, 1, 3), lower_minor(matrix, 2, 3));
+}
+
+// 2x2 determinant of the given row and the one below it, and the given columns
+template<typename Real>
+Real row_pair_minor(const Matrix<Real, 4> & matrix, const size_t & row, const size_t & first, const size_t & second)
+{
+    return matrix(row,first) * matrix(row+1,second) - matrix(row+1,first) * matrix(row,second);
+}
+
+// Every cofactor is built from three of the twelve 2x2 minors of the first
+// (s) and last (c) two rows. The order of the operations matches the
+// register version in matrix4_simd_tmpl.h.
+template<typename Real>
+Matrix<Real, 4> matrix_adjugate(const Matrix<Real, 4> & matrix)
+{
+    const Real s01 = row_pair_minor(matrix, 0, 0, 1);
+    const Real s02 = row_pair_minor(matrix, 0, 0, 2);
+    const Real s03 = row_pair_minor(matrix, 0, 0, 3);
+    const Real s12 = row_pair_minor(matrix, 0, 1, 2);
+    const Real s13 = row_pair_minor(matrix, 0, 1, 3);
+    const Real s23 = row_pair_minor(matrix, 0, 2, 3);
+
+    const Real c01 = row_pair_minor(matrix, 2, 0, 1);
+    const Real c02 = row_pair_minor(matrix, 2, 0, 2);
+    const Real c03 = row_pair_minor(matrix, 2, 0, 3);
+    const Real c12 = row_pair_minor(matrix, 2, 1, 2);
+    const Real c13 = row_pair_minor(matrix, 2, 1, 3);
+    const Real c23 = row_pair_minor(matrix, 2, 2, 3);
+
+    return Matrix<Real, 4>( (matrix(1,1) * c23 - matrix(1,2) * c13 + matrix(1,3) * c12),
+                           -(matrix(0,1) * c23 - matrix(0,2) * c13 + matrix(0,3) * c12),
+                            (matrix(3,1) * s23 - matrix(3,2) * s13 + matrix(3,3) * s12),
+                           -(matrix(2,1) * s23 - matrix(2,2) * s13 + matrix(2,3) * s12),
+
+                           -(matrix(1,0) * c23 - matrix(1,2) * c03 + matrix(1,3) * c02),
+                            (matrix(0,0) * c23 - matrix(0,2) * c03 + matrix(0,3) * c02),
+                           -(matrix(3,0) * s23 - matrix(3,2) * s03 + matrix(3,3) * s02),
+                            (matrix(2,0) * s23 - matrix(2,2) * s03 + matrix(2,3) * s02),
+
+                            (matrix(1,0) * c13 - matrix(1,1) * c03 + matrix(1,3) * c01),
+                           -(matrix(0,0) * c13 - matrix(0,1) * c03 + matrix(0,3) * c01),
+                            (matrix(3,0) * s13 - matrix(3,1) * s03 + matrix(3,3) * s01),
+                           -(matrix(2,0) * s13 - matrix(2,1) * s03 + matrix(2,3) * s01),
+
+                           -(matrix(1,0) * c12 - matrix(1,1) * c02 + matrix(1,2) * c01),
+                            (matrix(0,0) * c12 - matrix(0,1) * c02 + matrix(0,2) * c01),
+                           -(matrix(3,0) * s12 - matrix(3,1) * s02 + matrix(3,2) * s01),
+                            (matrix(2,0) * s12 - matrix(2,1) * s02 + matrix(2,2) * s01));
+}
+
+template<typename Real>
+Matrix<Real, 4> matrix_inverse(const Matrix<Real, 4> & matrix)
+{
+    return adjugate_inverse(matrix, matrix_adjugate(matrix));
+}
+
+template<typename Real>
+bool matrix_is_affine(const Matrix<Real, 4> & matrix)
+{
+    return matrix(3,0) == 0 && matrix(3,1) == 0 && matrix(3,2) == 0 && matrix(3,3) == 1;
+}
+
+template<typename Real>
+bool matrix_is_rigid(const Matrix<Real, 4> & matrix, const Real & tolerance)
+{
+    if (!matrix_is_affine(matrix)) {
+        return false;
+    }
+
+    // The columns of the rotation are orthogonal unit vectors
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = i; j < 3; ++j) {
+            const Real product = matrix(0,i) * matrix(0,j) + matrix(1,i) * matrix(1,j) + matrix(2,i) * matrix(2,j);
+            if (std::abs(product - (i == j ? 1 : 0)) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The inverse of the upper 3x3 block, and the translation taken through it
+// and negated
+template<typename Real>
+Matrix<Real, 4> matrix_inverse_affine(const Matrix<Real, 4> & matrix)
+{
+    assert(matrix_is_affine(matrix) && "Matrix is not an affine transform");
+
+    const auto inverse = matrix_inverse(Matrix<Real, 3>(matrix(0,0), matrix(0,1), matrix(0,2),
+                                                        matrix(1,0), matrix(1,1), matrix(1,2),
+                                                        matrix(2,0), matrix(2,1), matrix(2,2)));
+    const Real x = matrix(0,3);
+    const Real y = matrix(1,3);
+    const Real z = matrix(2,3);
+
+    return Matrix<Real, 4>(inverse(0,0), inverse(0,1), inverse(0,2), -(inverse(0,0) * x + inverse(0,1) * y + inverse(0,2) * z),
+                           inverse(1,0), inverse(1,1), inverse(1,2), -(inverse(1,0) * x + inverse(1,1) * y + inverse(1,2) * z),
+                           inverse(2,0), inverse(2,1), inverse(2,2), -(inverse(2,0) * x + inverse(2,1) * y + inverse(2,2) * z),
+                           0, 0, 0, 1);
+}
+
+// Like the affine inverse, with the transpose as the inverse of the rotation
+template<typename Real>
+Matrix<Real, 4> matrix_inverse_rigid(const Matrix<Real, 4> & matrix)
+{
+    assert(matrix_is_rigid(matrix) && "Matrix is not a rigid transform");
+
+    const Real x = matrix(0,3);
+    const Real y = matrix(1,3);
+    const Real z = matrix(2,3);
+
+    return Matrix<Real, 4>(matrix(0,0), matrix(1,0), matrix(2,0), -(matrix(0,0) * x + matrix(1,0) * y + matrix(2,0) * z),
+                           matrix(0,1), matrix(1,1), matrix(2,1), -(matrix(0,1) * x + matrix(1,1) * y + matrix(2,1) * z),
+                           matrix(0,2), matrix(1,2), matrix(2,2), -(matrix(0,2) * x + matrix(1,2) * y + matrix(2,2) * z),
+                           0, 0, 0, 1);
+}
+
+template<typename Real>
+inline bool matrix_is_affine(const Matrix<Real, 4, ColumnMajor> & matrix)
+{
+    return matrix_is_affine(Matrix<Real, 4>(matrix));
+}
+
+template<typename Real>
+inline bool matrix_is_rigid(const Matrix<Real, 4, ColumnMajor> & matrix, const Real & tolerance)
+{
+    return matrix_is_rigid(Matrix<Real, 4>(matrix), tolerance);
+}
+
+template<typename Real>
+inline Matrix<Real, 4, ColumnMajor> matrix_inverse_affine(const Matrix<Real, 4, ColumnMajor> & matrix)
+{
+    return Matrix<Real, 4, ColumnMajor>(matrix_inverse_affine(Matrix<Real, 4>(matrix)));
+}
+
+template<typename Real>
+inline Matrix<Real, 4, ColumnMajor> matrix_inverse_rigid(const Matrix<Real, 4, ColumnMajor> & matrix)
+{
+    return Matrix<Real, 4, ColumnMajor>(matrix_inverse_rigid(Matrix<Real, 4>(matrix)));
+}
+
+template<typename Real>
+Matrix<Real, 4> matrix_perspective(const Real & fov_y, const Real & aspect, const Real & z_near, const Real & z_far)
+{
+    assert(z_near > 0 && z_far > z_near && "Can not project with the near plane at or behind the eye or far plane");
+
+    const Real focal = 1 / std::tan(fov_y / 2);
+    const Real depth = z_near - z_far;
+    return Matrix<Real, 4>(focal / aspect, 0, 0, 0,
+                           0, focal, 0, 0,
+                           0, 0, (z_far + z_near) / depth, 2 * z_far * z_near / depth,
+                           0, 0, -1, 0);
+}
+
+template<typename Real>
+Matrix<Real, 4> matrix_orthographic(const Real & left, const Real & right, const Real & bottom, const Real & top,
+                                    const Real & z_near, const Real & z_far)
+{
+    assert(left != right && bottom != top && z_near != z_far && "Can not project an empty view volume");
+
+    const Real width = right - left;
+    const Real height = top - bottom;
+    const Real depth = z_far - z_near;
+    return Matrix<Real, 4>(2 / width, 0, 0, -(right + left) / width,
+                           0, 2 / height, 0, -(top + bottom) / height,
+                           0, 0, -2 / depth, -(z_far + z_near) / depth,
+                           0, 0, 0, 1);
+}
+
+// The rows are the camera axes in world space, right, up and backwards
+template<typename Real>
+Matrix<Real, 4> matrix_look_at(const Vector<Real, 3> & eye, const Vector<Real, 3> & target,
+                               const Vector<Real, 3> & up)
+{
+    Vector<Real, 3> forward(target - eye);
+    normalize_vector(forward);
+    Vector<Real, 3> side = cross_product(forward, up);
+    normalize_vector(side);
+    const Vector<Real, 3> camera_up = cross_product(side, forward);
+
+    return Matrix<Real, 4>(side[0], side[1], side[2], -dot_product(side, eye),
+                           camera_up[0], camera_up[1], camera_up[2], -dot_product(camera_up, eye),
+                           -forward[0], -forward[1], -forward[2], dot_product(forward, eye),
+                           0, 0, 0, 1);
+}
+
+#endif
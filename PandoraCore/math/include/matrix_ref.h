@@ -0,0 +1,165 @@
+#ifndef MATH_MATRIX_REF_H_INCLUDED
+#define MATH_MATRIX_REF_H_INCLUDED
+
+#include "config.h"
+#include "expression.h"
+#include "matrix.h"
+#include "vector_ref.h"
+
+#include <assert.h>
+#include <type_traits>
+
+namespace Math
+{
+
+// A row major dim x dim matrix in memory owned by someone else, with the
+// rows row_stride elements apart, so it can also view a block of a larger
+// matrix. MatrixRef<const Real, dim> is the read-only view. Like VectorRef
+// it behaves as a reference, and mixes with matrices and vectors in the
+// expressions and functions below.
+template<typename Real, size_t dim>
+class MatrixRef
+{
+public:
+    typedef typename std::remove_const<Real>::type value_type;
+    typedef typename std::conditional<std::is_const<Real>::value,
+                                      const Matrix<value_type, dim>, Matrix<value_type, dim> >::type matrix_type;
+
+    explicit MatrixRef(Real * data, const size_t & row_stride = dim);
+    MatrixRef(matrix_type & matrix);
+
+    template<typename Other,
+             typename = typename std::enable_if<std::is_same<const Other, Real>::value>::type>
+    MatrixRef(const MatrixRef<Other, dim> & other);
+
+    // Copies the view, where assignment copies the elements
+    MatrixRef(const MatrixRef & other) = default;
+    const MatrixRef & operator=(const MatrixRef & other) const;
+
+    template<typename Expression>
+    typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Matrix<value_type, dim> >::value,
+                            const MatrixRef &>::type
+    operator=(const Expression & expression) const;
+
+    Real * get_data() const;
+    const size_t & get_row_stride() const;
+
+    // Element i of the matrix, as if it was stored without gaps
+    Real & operator[](const size_t & i) const;
+    Real & operator()(const size_t & i, const size_t & j) const;
+
+    // The view of a row, or of a column with a stride of row_stride
+    VectorRef<Real, dim> row(const size_t & i) const;
+    VectorRef<Real, dim> column(const size_t & j) const;
+
+    operator Matrix<value_type, dim>() const;
+private:
+    Real * elements;
+    size_t row_stride;
+};
+
+template<typename Real, size_t dim>
+struct ExpressionTraits<MatrixRef<Real, dim> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = true;
+    static const size_t storage_size = dim*dim;
+    typedef Matrix<typename std::remove_const<Real>::type, dim> result_type;
+    typedef typename std::remove_const<Real>::type real_type;
+    typedef MultiplyByReciprocal scalar_division;
+};
+
+template<typename Register, typename Real, size_t dim>
+Register expression_packet(const MatrixRef<Real, dim> & matrix, const size_t & offset);
+
+template<typename T>
+struct MatrixOperand
+{
+    static const bool value = false;
+    static const bool is_view = false;
+};
+
+template<typename Real, size_t dim_>
+struct MatrixOperand<Matrix<Real, dim_> >
+{
+    static const bool value = true;
+    static const bool is_view = false;
+    static const size_t dim = dim_;
+    typedef Real real_type;
+};
+
+template<typename Real, size_t dim_>
+struct MatrixOperand<MatrixRef<Real, dim_> >
+{
+    static const bool value = true;
+    static const bool is_view = true;
+    static const size_t dim = dim_;
+    typedef typename std::remove_const<Real>::type real_type;
+};
+
+// Enabled when at least one of the operands is a view, and they have the
+// same type and size. Products of only matrices and vectors keep using the
+// ones of matrix.h.
+template<typename Left, typename Right, typename Type,
+         bool = MatrixOperand<Left>::value && MatrixOperand<Right>::value &&
+                (MatrixOperand<Left>::is_view || MatrixOperand<Right>::is_view)>
+struct EnableIfMatrixViews
+{ };
+
+template<typename Left, typename Right, typename Type>
+struct EnableIfMatrixViews<Left, Right, Type, true>
+    : std::enable_if<std::is_same<typename MatrixOperand<Left>::real_type,
+                                  typename MatrixOperand<Right>::real_type>::value &&
+                     MatrixOperand<Left>::dim == MatrixOperand<Right>::dim, Type>
+{ };
+
+template<typename MatrixType, typename VectorType, typename Type,
+         bool = MatrixOperand<MatrixType>::value && VectorOperand<VectorType>::value &&
+                (MatrixOperand<MatrixType>::is_view || VectorOperand<VectorType>::is_view)>
+struct EnableIfMatrixVectorViews
+{ };
+
+template<typename MatrixType, typename VectorType, typename Type>
+struct EnableIfMatrixVectorViews<MatrixType, VectorType, Type, true>
+    : std::enable_if<std::is_same<typename MatrixOperand<MatrixType>::real_type,
+                                  typename VectorOperand<VectorType>::real_type>::value &&
+                     MatrixOperand<MatrixType>::dim == VectorOperand<VectorType>::dim, Type>
+{ };
+
+template<typename Real, size_t dim>
+Matrix<typename std::remove_const<Real>::type, dim> matrix_transpose(const MatrixRef<Real, dim> & matrix);
+
+template<typename Real, size_t dim>
+typename std::remove_const<Real>::type matrix_trace(const MatrixRef<Real, dim> & matrix);
+
+template<typename Left, typename Right>
+typename EnableIfMatrixViews<Left, Right,
+                             Matrix<typename MatrixOperand<Left>::real_type, MatrixOperand<Left>::dim> >::type
+operator*(const Left & left, const Right & right);
+
+template<typename Left, typename Right>
+typename EnableIfMatrixVectorViews<Left, Right,
+                                   Vector<typename VectorOperand<Right>::real_type, VectorOperand<Right>::dim> >::type
+operator*(const Left & matrix, const Right & vector);
+
+// Sums the rows scaled by the elements of the vector, without transposing
+template<typename Left, typename Right>
+typename EnableIfMatrixVectorViews<Right, Left,
+                                   Vector<typename VectorOperand<Left>::real_type, VectorOperand<Left>::dim> >::type
+operator*(const Left & vector, const Right & matrix);
+
+template<typename Left, typename Right>
+typename EnableIfMatrixViews<Left, Right, bool>::type
+operator==(const Left & left, const Right & right);
+
+template<typename Left, typename Right>
+typename EnableIfMatrixViews<Left, Right, bool>::type
+operator!=(const Left & left, const Right & right);
+
+#define INCLUDED_FROM_MATRIX_REF_H
+#include "matrix_ref_tmpl.h"
+#undef INCLUDED_FROM_MATRIX_REF_H
+
+}
+
+#endif
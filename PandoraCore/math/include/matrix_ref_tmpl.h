@@ -0,0 +1,211 @@
+#ifndef INCLUDED_FROM_MATRIX_REF_H
+#error "matrix_ref_tmpl.h can only be included from matrix_ref.h"
+#else
+
+template<typename Real, size_t dim>
+inline MatrixRef<Real, dim>::MatrixRef(Real * data, const size_t & row_stride)
+    : elements(data), row_stride(row_stride)
+{
+    assert(data && "Can not view a null pointer");
+    assert(row_stride >= dim && "Can not view matrix with overlapping rows");
+}
+
+template<typename Real, size_t dim>
+inline MatrixRef<Real, dim>::MatrixRef(matrix_type & matrix)
+    : elements(matrix.begin()), row_stride(dim)
+{
+}
+
+template<typename Real, size_t dim>
+template<typename Other, typename>
+inline MatrixRef<Real, dim>::MatrixRef(const MatrixRef<Other, dim> & other)
+    : elements(other.get_data()), row_stride(other.get_row_stride())
+{
+}
+
+template<typename Real, size_t dim>
+inline const MatrixRef<Real, dim> & MatrixRef<Real, dim>::operator=(const MatrixRef & other) const
+{
+    return operator=<MatrixRef>(other);
+}
+
+template<typename Real, size_t dim>
+template<typename Expression>
+typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type,
+                                     Matrix<typename MatrixRef<Real, dim>::value_type, dim> >::value,
+                        const MatrixRef<Real, dim> &>::type
+MatrixRef<Real, dim>::operator=(const Expression & expression) const
+{
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            elements[i*row_stride + j] = expression(i,j);
+        }
+    }
+    return *this;
+}
+
+template<typename Real, size_t dim>
+inline Real * MatrixRef<Real, dim>::get_data() const
+{
+    return elements;
+}
+
+template<typename Real, size_t dim>
+inline const size_t & MatrixRef<Real, dim>::get_row_stride() const
+{
+    return row_stride;
+}
+
+template<typename Real, size_t dim>
+inline Real & MatrixRef<Real, dim>::operator[](const size_t & i) const
+{
+    assert(i < dim*dim && "Index operator out of range");
+    return elements[(i / dim)*row_stride + i % dim];
+}
+
+template<typename Real, size_t dim>
+inline Real & MatrixRef<Real, dim>::operator()(const size_t & i, const size_t & j) const
+{
+    assert(i < dim && j < dim && "Index operator out of range");
+    return elements[i*row_stride + j];
+}
+
+template<typename Real, size_t dim>
+inline VectorRef<Real, dim> MatrixRef<Real, dim>::row(const size_t & i) const
+{
+    assert(i < dim && "Index operator out of range");
+    return VectorRef<Real, dim>(elements + i*row_stride);
+}
+
+template<typename Real, size_t dim>
+inline VectorRef<Real, dim> MatrixRef<Real, dim>::column(const size_t & j) const
+{
+    assert(j < dim && "Index operator out of range");
+    return VectorRef<Real, dim>(elements + j, row_stride);
+}
+
+template<typename Real, size_t dim>
+inline MatrixRef<Real, dim>::operator Matrix<value_type, dim>() const
+{
+    Matrix<value_type, dim> matrix;
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            matrix(i,j) = elements[i*row_stride + j];
+        }
+    }
+    return matrix;
+}
+
+// Rows without gaps are read like a matrix, otherwise an element at a time
+template<typename Register, typename Real, size_t dim>
+inline Register expression_packet(const MatrixRef<Real, dim> & matrix, const size_t & offset)
+{
+    typedef typename MatrixRef<Real, dim>::value_type value_type;
+
+    if (matrix.get_row_stride() == dim) {
+        return Register::loadu(matrix.get_data() + offset);
+    }
+
+    value_type lanes[Register::size];
+    for (size_t j = 0; j < Register::size; ++j) {
+        lanes[j] = matrix[offset + j];
+    }
+    return Register::loadu(lanes);
+}
+
+template<typename Real, size_t dim>
+Matrix<typename std::remove_const<Real>::type, dim> matrix_transpose(const MatrixRef<Real, dim> & matrix)
+{
+    Matrix<typename std::remove_const<Real>::type, dim> transpose;
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            transpose(j,i) = matrix(i,j);
+        }
+    }
+    return transpose;
+}
+
+template<typename Real, size_t dim>
+typename std::remove_const<Real>::type matrix_trace(const MatrixRef<Real, dim> & matrix)
+{
+    typename std::remove_const<Real>::type result = 0;
+    for (size_t i = 0; i < dim; ++i) {
+        result += matrix(i,i);
+    }
+    return result;
+}
+
+template<typename Left, typename Right>
+typename EnableIfMatrixViews<Left, Right,
+                             Matrix<typename MatrixOperand<Left>::real_type, MatrixOperand<Left>::dim> >::type
+operator*(const Left & left, const Right & right)
+{
+    const size_t dim = MatrixOperand<Left>::dim;
+
+    Matrix<typename MatrixOperand<Left>::real_type, dim> result;
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            auto element = left(i,0) * right(0,j);
+            for (size_t k = 1; k < dim; ++k) {
+                element += left(i,k) * right(k,j);
+            }
+            result(i,j) = element;
+        }
+    }
+    return result;
+}
+
+template<typename Left, typename Right>
+typename EnableIfMatrixVectorViews<Left, Right,
+                                   Vector<typename VectorOperand<Right>::real_type, VectorOperand<Right>::dim> >::type
+operator*(const Left & matrix, const Right & vector)
+{
+    const size_t dim = VectorOperand<Right>::dim;
+
+    Vector<typename VectorOperand<Right>::real_type, dim> result;
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            result[i] += matrix(i,j) * vector[j];
+        }
+    }
+    return result;
+}
+
+template<typename Left, typename Right>
+typename EnableIfMatrixVectorViews<Right, Left,
+                                   Vector<typename VectorOperand<Left>::real_type, VectorOperand<Left>::dim> >::type
+operator*(const Left & vector, const Right & matrix)
+{
+    const size_t dim = VectorOperand<Left>::dim;
+
+    Vector<typename VectorOperand<Left>::real_type, dim> result;
+    for (size_t k = 0; k < dim; ++k) {
+        for (size_t j = 0; j < dim; ++j) {
+            result[j] += vector[k] * matrix(k,j);
+        }
+    }
+    return result;
+}
+
+template<typename Left, typename Right>
+typename EnableIfMatrixViews<Left, Right, bool>::type
+operator==(const Left & left, const Right & right)
+{
+    for (size_t i = 0; i < MatrixOperand<Left>::dim; ++i) {
+        for (size_t j = 0; j < MatrixOperand<Left>::dim; ++j) {
+            if (left(i,j) != right(i,j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<typename Left, typename Right>
+typename EnableIfMatrixViews<Left, Right, bool>::type
+operator!=(const Left & left, const Right & right)
+{
+    return !(left == right);
+}
+
+#endif
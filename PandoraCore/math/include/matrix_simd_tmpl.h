@@ -0,0 +1,112 @@
+#ifndef INCLUDED_FROM_MATRIX_H
+#error "matrix_simd_tmpl.h can only be included from matrix.h"
+#else
+
+// Register backed versions of the 3x3 and 4x4 float and double matrix
+// products. Every row of a product is the rows of the right hand side scaled
+// by the elements of a row on the left hand side and summed, a register per
+// row. The sums run in the same order as in the generic versions, so the
+// results are bit for bit the same.
+
+#ifdef MATH_USE_SSE2
+
+template<typename Real>
+Matrix<Real, 4> simd_matrix_product(const Matrix<Real, 4> & left, const Matrix<Real, 4> & right)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const Real * a = left.begin();
+    const Real * b = right.begin();
+
+    const reg row0 = reg::loadu(b);
+    const reg row1 = reg::loadu(b + 4);
+    const reg row2 = reg::loadu(b + 8);
+    const reg row3 = reg::loadu(b + 12);
+
+    Real elements[16];
+    for (size_t i = 0; i < 4; ++i) {
+        (reg::broadcast(a[4*i])     * row0 +
+         reg::broadcast(a[4*i + 1]) * row1 +
+         reg::broadcast(a[4*i + 2]) * row2 +
+         reg::broadcast(a[4*i + 3]) * row3).storeu(elements + 4*i);
+    }
+    return Matrix<Real, 4>(elements);
+}
+
+// The rows of a 3x3 matrix are read four elements at a time. The first two
+// rows pick up the start of the next row in their last lane, the last row is
+// read from one element earlier and shifted down, so nothing outside the
+// matrix is read. Each row of the product spills its last lane into the
+// start of the next row, which is written afterwards.
+template<typename Real>
+Matrix<Real, 3> simd_matrix_product(const Matrix<Real, 3> & left, const Matrix<Real, 3> & right)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const Real * a = left.begin();
+    const Real * b = right.begin();
+
+    const reg row0 = reg::loadu(b);
+    const reg row1 = reg::loadu(b + 3);
+    const reg row2 = Simd::shuffle<1, 2, 3, 3>(reg::loadu(b + 5));
+
+    Real elements[10];
+    for (size_t i = 0; i < 3; ++i) {
+        (reg::broadcast(a[3*i])     * row0 +
+         reg::broadcast(a[3*i + 1]) * row1 +
+         reg::broadcast(a[3*i + 2]) * row2).storeu(elements + 3*i);
+    }
+    return Matrix<Real, 3>(elements);
+}
+
+template<typename Real>
+Vector<Real, 4> simd_vector_matrix_product(const Vector<Real, 4> & vector, const Matrix<Real, 4> & matrix)
+{
+    typedef Simd::Register<Real, 4> reg;
+    const Real * b = matrix.begin();
+
+    Vector<Real, 4> result;
+    (reg::broadcast(vector[0]) * reg::loadu(b) +
+     reg::broadcast(vector[1]) * reg::loadu(b + 4) +
+     reg::broadcast(vector[2]) * reg::loadu(b + 8) +
+     reg::broadcast(vector[3]) * reg::loadu(b + 12)).storeu(result.begin());
+    return result;
+}
+
+template<>
+inline Matrix<float, 3> operator*(const Matrix<float, 3> & left, const Matrix<float, 3> & right)
+{
+    return simd_matrix_product(left, right);
+}
+
+template<>
+inline Matrix<double, 3> operator*(const Matrix<double, 3> & left, const Matrix<double, 3> & right)
+{
+    return simd_matrix_product(left, right);
+}
+
+template<>
+inline Matrix<float, 4> operator*(const Matrix<float, 4> & left, const Matrix<float, 4> & right)
+{
+    return simd_matrix_product(left, right);
+}
+
+template<>
+inline Matrix<double, 4> operator*(const Matrix<double, 4> & left, const Matrix<double, 4> & right)
+{
+    return simd_matrix_product(left, right);
+}
+
+template<>
+inline Vector<float, 4> operator*(const Vector<float, 4> & vector, const Matrix<float, 4> & matrix)
+{
+    return simd_vector_matrix_product(vector, matrix);
+}
+
+template<>
+inline Vector<double, 4> operator*(const Vector<double, 4> & vector, const Matrix<double, 4> & matrix)
+{
+    return simd_vector_matrix_product(vector, matrix);
+}
+
+#endif
+
+#endif
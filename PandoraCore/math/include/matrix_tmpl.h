@@ -3,130 +3,372 @@
 #else
 
 template<typename Real, size_t dim>
-static Matrix<Real, dim-1> create_submatrix(const Matrix<Real, dim> & matrix, const size_t & row, const size_t & col);
+constexpr Matrix<Real, dim-1> create_submatrix(const Matrix<Real, dim> & matrix, const size_t & row, const size_t & col);
 
-template<typename Real, size_t dim>
-Real calculate_element(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right,
-        const size_t & i, const size_t & j);
+template<typename Real, size_t dim, typename Order>
+constexpr Matrix<Real, dim, Order>::Matrix()
+    : Matrix(typename MakeIndices<dim*dim>::type())
+{
+}
 
-template<typename Real, size_t dim>
-Matrix<Real, dim>::Matrix()
-    : data {{0,}}
+template<typename Real, size_t dim, typename Order>
+inline Matrix<Real, dim, Order>::Matrix(const std::initializer_list<Real> & elements)
 {
-    for (size_t i = 0; i < dim; ++i) {
-        data[i*dim+i] = 1;
-    }
+    std::copy(elements.begin(), elements.end(), data);
 }
 
-template<typename Real, size_t dim>
-Matrix<Real, dim>::Matrix(const std::initializer_list<Real> & elements)
+template<typename Real, size_t dim, typename Order>
+constexpr Matrix<Real, dim, Order>::Matrix(const Real array[dim*dim])
+    : Matrix(array, typename MakeIndices<dim*dim>::type())
 {
-    std::copy(elements.begin(), elements.end(), data.begin());
 }
 
-template<typename Real, size_t dim>
-Matrix<Real, dim>::Matrix(const Real array[dim*dim])
+template<typename Real, size_t dim, typename Order>
+template<typename... Elements, typename>
+constexpr Matrix<Real, dim, Order>::Matrix(const Real & first, const Elements & ... rest)
+    : data {first, Real(rest)...}
 {
-    std::copy(array, array + dim*dim, data.begin());
 }
 
-template<typename Real, size_t dim>
-Real & Matrix<Real, dim>::operator[](const size_t & i)
+// The identity matrix
+template<typename Real, size_t dim, typename Order>
+template<size_t... indices>
+constexpr Matrix<Real, dim, Order>::Matrix(Indices<indices...>)
+    : data {Real(indices % (dim+1) == 0 ? 1 : 0)...}
 {
-    assert(i < dim*dim && "Index operator out of range");
-    return data[i];
 }
 
-template<typename Real, size_t dim>
-Real Matrix<Real, dim>::operator[](const size_t & i) const
+template<typename Real, size_t dim, typename Order>
+template<typename Elements, size_t... indices>
+constexpr Matrix<Real, dim, Order>::Matrix(const Elements & elements, Indices<indices...>)
+    : data {Real(elements[indices])...}
+{
+}
+
+template<typename Real, size_t dim, typename Order>
+template<typename Other>
+constexpr Matrix<Real, dim, Order>::Matrix(const Matrix<Real, dim, Other> & matrix)
+    : Matrix(matrix, typename MakeIndices<dim*dim>::type(), 0)
+{
+}
+
+// Element k of the storage is read from the same row and column of the other
+// order
+template<typename Real, size_t dim, typename Order>
+template<typename Other, size_t... indices>
+constexpr Matrix<Real, dim, Order>::Matrix(const Matrix<Real, dim, Other> & matrix, Indices<indices...>, int)
+    : data {matrix[Other::index(Order::row(indices, dim), Order::column(indices, dim), dim)]...}
+{
+}
+
+template<typename Real, size_t dim, typename Order>
+template<typename Expression>
+constexpr Matrix<Real, dim, Order>::Matrix(const Expression & expression,
+                                           typename EnableIfExpressionOf<Expression, Matrix>::type *)
+    : Matrix(expression, typename MakeIndices<dim*dim>::type())
+{
+}
+
+template<typename Real, size_t dim, typename Order>
+template<typename Expression>
+typename EnableIfExpressionOf<Expression, Matrix<Real, dim, Order>, Matrix<Real, dim, Order> &>::type
+Matrix<Real, dim, Order>::operator=(const Expression & expression)
+{
+    assign_expression<Real, dim*dim>(data, expression);
+    return *this;
+}
+
+template<typename Real, size_t dim, typename Order>
+inline const Real* Matrix<Real, dim, Order>::begin() const
+{
+    return data;
+}
+
+template<typename Real, size_t dim, typename Order>
+inline const Real* Matrix<Real, dim, Order>::end() const
+{
+    return data + dim*dim;
+}
+
+template<typename Real, size_t dim, typename Order>
+inline Real* Matrix<Real, dim, Order>::begin()
+{
+    return data;
+}
+
+template<typename Real, size_t dim, typename Order>
+inline Real* Matrix<Real, dim, Order>::end()
+{
+    return data + dim*dim;
+}
+
+template<typename Real, size_t dim, typename Order>
+inline Real & Matrix<Real, dim, Order>::operator[](const size_t & i)
 {
     assert(i < dim*dim && "Index operator out of range");
     return data[i];
 }
 
-template<typename Real, size_t dim>
-Real & Matrix<Real, dim>::operator()(const size_t & i, const size_t & j)
+template<typename Real, size_t dim, typename Order>
+constexpr Real Matrix<Real, dim, Order>::operator[](const size_t & i) const
+{
+    return assert(i < dim*dim && "Index operator out of range"), data[i];
+}
+
+template<typename Real, size_t dim, typename Order>
+inline Real & Matrix<Real, dim, Order>::operator()(const size_t & i, const size_t & j)
 {
     assert(i < dim && j < dim && "Index operator out of range");
-    return data[i*dim + j];
+    return data[Order::index(i, j, dim)];
+}
+
+template<typename Real, size_t dim, typename Order>
+constexpr Real Matrix<Real, dim, Order>::operator()(const size_t & i, const size_t & j) const
+{
+    return assert(i < dim && j < dim && "Index operator out of range"), data[Order::index(i, j, dim)];
+}
+
+template<typename Register, typename Real, size_t dim, typename Order>
+Register expression_packet(const Matrix<Real, dim, Order> & matrix, const size_t & offset)
+{
+    return Register::loadu(matrix.begin() + offset);
 }
 
 template<typename Real, size_t dim>
-Real Matrix<Real, dim>::operator()(const size_t & i, const size_t & j) const
+Real lu_determinant(const LUDecomposition<Real, dim> & lu)
 {
-    assert(i < dim && j < dim && "Index operator out of range");
-    return data[i*dim + j];
+    if (lu.singular) {
+        return 0;
+    }
+
+    Real determinant = lu.sign;
+    for (size_t i = 0; i < dim; ++i) {
+        determinant *= lu.factors(i,i);
+    }
+    return determinant;
 }
 
+template<typename Real, size_t dim>
+Real matrix_determinant(const Matrix<Real, dim> & matrix, std::true_type)
+{
+    return lu_determinant(matrix_lu_decompose(matrix));
+}
+
+// Integer matrices have no LU factorization, and are expanded along the
+// first row down to 1x1 minors, so they need none of the closed forms of
+// matrix2.h, matrix3.h and matrix4.h
 template<typename Real>
-Real matrix_determinant(const Matrix<Real, 2> & matrix)
+Real matrix_determinant(const Matrix<Real, 1> & matrix, std::false_type)
+{
+    return matrix(0,0);
+}
+
+template<typename Real, size_t dim>
+Real matrix_determinant(const Matrix<Real, dim> & matrix, std::false_type)
 {
-    return matrix(0,0) * matrix(1,1) - matrix(0,1) * matrix(1,0);
+    Real determinant = 0;
+    for (size_t j = 0; j < dim; ++j) {
+        const Real term = matrix(0,j) * matrix_determinant(create_submatrix(matrix, 0, j));
+        determinant += j % 2 ? -term : term;
+    }
+    return determinant;
 }
 
 template<typename Real, size_t dim>
 Real matrix_determinant(const Matrix<Real, dim> & matrix)
+{
+    return matrix_determinant(matrix, std::is_floating_point<Real>());
+}
+
+template<typename Real, size_t dim, size_t... indices>
+constexpr Matrix<Real, dim> transpose_elements(const Matrix<Real, dim> & matrix, Indices<indices...>)
+{
+    return Matrix<Real, dim>(matrix(indices % dim, indices / dim)...);
+}
+
+template<typename Real, size_t dim>
+constexpr Matrix<Real, dim> matrix_transpose(const Matrix<Real, dim> & matrix)
+{
+    return transpose_elements(matrix, typename MakeIndices<dim*dim>::type());
+}
+
+template<typename Real, size_t dim, typename Order>
+Real matrix_trace(const Matrix<Real, dim, Order> & matrix)
 {
     Real result = 0;
-    int sign = 1;
     for (size_t i = 0; i < dim; ++i) {
-        result += sign * matrix(0, i) * matrix_determinant(create_submatrix(matrix, 0, i));
-        sign *= -1;
+        result += matrix(i,i);
     }
-
     return result;
 }
 
+// Solved one column of the identity at a time
 template<typename Real, size_t dim>
-Matrix<Real, dim> matrix_transpose(const Matrix<Real, dim> & matrix)
+Matrix<Real, dim> lu_inverse(const LUDecomposition<Real, dim> & lu)
 {
-    Matrix<Real, dim> result;
+    Matrix<Real, dim> inverse;
+    for (size_t j = 0; j < dim; ++j) {
+        Vector<Real, dim> unit;
+        unit[j] = 1;
+
+        const auto column = lu_solve(lu, unit);
+        for (size_t i = 0; i < dim; ++i) {
+            inverse(i,j) = column[i];
+        }
+    }
+    return inverse;
+}
+
+// The cofactors, each the determinant of a submatrix
+template<typename Real, size_t dim>
+Matrix<Real, dim> matrix_adjugate(const Matrix<Real, dim> & matrix, std::false_type)
+{
+    Matrix<Real, dim> adjugate;
     for (size_t i = 0; i < dim; ++i) {
         for (size_t j = 0; j < dim; ++j) {
-            result(i,j) = matrix(j,i);
+            const Real minor = matrix_determinant(create_submatrix(matrix, i, j));
+            adjugate(j,i) = (i + j) % 2 ? -minor : minor;
         }
     }
-    return result;
+    return adjugate;
 }
 
+// det(A) * inverse(A), both from one factorization. A singular matrix has no
+// inverse, but can still have a non zero adjugate, which is then built from
+// the cofactors.
 template<typename Real, size_t dim>
-Real matrix_trace(const Matrix<Real, dim> & matrix)
+Matrix<Real, dim> matrix_adjugate(const Matrix<Real, dim> & matrix, std::true_type)
 {
-    Real result = 0;
+    const auto lu = matrix_lu_decompose(matrix);
+    if (lu.singular) {
+        return matrix_adjugate(matrix, std::false_type());
+    }
+
+    auto adjugate = lu_inverse(lu);
+    adjugate *= lu_determinant(lu);
+    return adjugate;
+}
+
+template<typename Real, size_t dim>
+Matrix<Real, dim> matrix_adjugate(const Matrix<Real, dim> & matrix)
+{
+    return matrix_adjugate(matrix, std::is_floating_point<Real>());
+}
+
+template<typename Real, size_t dim>
+Matrix<Real, dim> matrix_inverse(const Matrix<Real, dim> & matrix)
+{
+    const auto lu = matrix_lu_decompose(matrix);
+    assert(!lu.singular && "Can not invert singular matrix");
+
+    return lu_inverse(lu);
+}
+
+// Inverse from a closed form adjugate. The determinant is expanded along the
+// first column, reusing the cofactors already in the adjugate.
+template<typename Real, size_t dim>
+Matrix<Real, dim> adjugate_inverse(const Matrix<Real, dim> & matrix, Matrix<Real, dim> adjugate)
+{
+    Real determinant = 0;
     for (size_t i = 0; i < dim; ++i) {
-        result += matrix(i,i);
+        determinant += matrix(i,0) * adjugate(0,i);
     }
-    return result;
+    assert(determinant != 0 && "Can not invert singular matrix");
+
+    adjugate *= Real(1./determinant);
+    return adjugate;
 }
 
 template<typename Real, size_t dim>
-Real sub_determinant(const Matrix<Real, dim> & matrix, const size_t & row, const size_t & col)
+LUDecomposition<Real, dim> matrix_lu_decompose(const Matrix<Real, dim> & matrix)
 {
-    auto submatrix = create_submatrix(matrix, row, col);
-    return matrix_determinant(submatrix);
+    static_assert(std::is_floating_point<Real>::value, "LU factorization needs a floating point matrix");
+
+    LUDecomposition<Real, dim> lu;
+    lu.factors = matrix;
+    lu.sign = 1;
+    lu.singular = false;
+    for (size_t i = 0; i < dim; ++i) {
+        lu.permutation[i] = i;
+    }
+
+    // Each element of the factors is a sum of products, and a pivot is only
+    // taken as zero when it is small next to the magnitude of the terms it was
+    // summed from. Rounding in a singular matrix then does not count as a
+    // pivot, while badly scaled rows and columns keep their own pivots.
+    Real magnitudes[dim*dim];
+    for (size_t i = 0; i < dim*dim; ++i) {
+        magnitudes[i] = std::abs(matrix[i]);
+    }
+    const Real tolerance = dim * std::numeric_limits<Real>::epsilon();
+
+    auto & factors = lu.factors;
+    for (size_t k = 0; k < dim; ++k) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < dim; ++i) {
+            if (std::abs(factors(i,k)) > std::abs(factors(pivot,k))) {
+                pivot = i;
+            }
+        }
+
+        const Real pivot_value = std::abs(factors(pivot,k));
+        if (pivot_value == 0 || pivot_value <= tolerance * magnitudes[pivot*dim + k]) {
+            lu.singular = true;
+            continue;
+        }
+
+        if (pivot != k) {
+            std::swap_ranges(factors.begin() + k*dim, factors.begin() + (k+1)*dim, factors.begin() + pivot*dim);
+            std::swap_ranges(magnitudes + k*dim, magnitudes + (k+1)*dim, magnitudes + pivot*dim);
+            std::swap(lu.permutation[k], lu.permutation[pivot]);
+            lu.sign = -lu.sign;
+        }
+
+        for (size_t i = k + 1; i < dim; ++i) {
+            factors(i,k) /= factors(k,k);
+            const Real multiplier = std::abs(factors(i,k));
+            for (size_t j = k + 1; j < dim; ++j) {
+                factors(i,j) -= factors(i,k) * factors(k,j);
+                magnitudes[i*dim + j] += multiplier * std::abs(factors(k,j));
+            }
+        }
+    }
+    return lu;
 }
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> matrix_adjugate(const Matrix<Real, dim> & matrix)
+Vector<Real, dim> lu_solve(const LUDecomposition<Real, dim> & lu, const Vector<Real, dim> & vector)
 {
-    Matrix<Real, dim> adjugate;
-    for (size_t i = 0; i < dim; i++) {
-        for (size_t j = 0; j < dim; j++) {
-            adjugate(i,j) = pow(-1,i+j) * sub_determinant(matrix, i, j);
+    assert(!lu.singular && "Can not solve singular system");
+
+    // Forward substitution with L, then back substitution with U
+    Vector<Real, dim> result;
+    for (size_t i = 0; i < dim; ++i) {
+        Real element = vector[lu.permutation[i]];
+        for (size_t j = 0; j < i; ++j) {
+            element -= lu.factors(i,j) * result[j];
         }
+        result[i] = element;
     }
 
-    return matrix_transpose(adjugate);
+    for (size_t i = dim; i-- > 0;) {
+        Real element = result[i];
+        for (size_t j = i + 1; j < dim; ++j) {
+            element -= lu.factors(i,j) * result[j];
+        }
+        result[i] = element / lu.factors(i,i);
+    }
+    return result;
 }
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> matrix_inverse(const Matrix<Real, dim> & matrix)
+Vector<Real, dim> matrix_solve(const Matrix<Real, dim> & matrix, const Vector<Real, dim> & vector)
 {
-    return matrix_adjugate(matrix) / matrix_determinant(matrix);
+    return lu_solve(matrix_lu_decompose(matrix), vector);
 }
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> & operator+=(Matrix<Real, dim> & to, const Matrix<Real, dim> & from)
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator+=(Matrix<Real, dim, Order> & to, const Matrix<Real, dim, Order> & from)
 {
     for (size_t i = 0; i < dim*dim; ++i) {
         to[i] += from[i];
@@ -134,8 +376,8 @@ Matrix<Real, dim> & operator+=(Matrix<Real, dim> & to, const Matrix<Real, dim> &
     return to;
 }
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> & operator-=(Matrix<Real, dim> & to, const Matrix<Real, dim> & from)
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator-=(Matrix<Real, dim, Order> & to, const Matrix<Real, dim, Order> & from)
 {
     for (size_t i = 0; i < dim*dim; ++i) {
         to[i] -= from[i];
@@ -143,8 +385,24 @@ Matrix<Real, dim> & operator-=(Matrix<Real, dim> & to, const Matrix<Real, dim> &
     return to;
 }
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> & operator*=(Matrix<Real, dim> & matrix, const Real & scalar)
+template<typename Real, size_t dim, typename Order, typename Expression>
+typename EnableIfExpressionOf<Expression, Matrix<Real, dim, Order>, Matrix<Real, dim, Order> &>::type
+operator+=(Matrix<Real, dim, Order> & to, const Expression & from)
+{
+    assign_expression<AddOperation, Real, dim*dim>(to.begin(), from);
+    return to;
+}
+
+template<typename Real, size_t dim, typename Order, typename Expression>
+typename EnableIfExpressionOf<Expression, Matrix<Real, dim, Order>, Matrix<Real, dim, Order> &>::type
+operator-=(Matrix<Real, dim, Order> & to, const Expression & from)
+{
+    assign_expression<SubtractOperation, Real, dim*dim>(to.begin(), from);
+    return to;
+}
+
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator*=(Matrix<Real, dim, Order> & matrix, const Real & scalar)
 {
     for (size_t i = 0; i < dim*dim; ++i) {
         matrix[i] *= scalar;
@@ -152,124 +410,174 @@ Matrix<Real, dim> & operator*=(Matrix<Real, dim> & matrix, const Real & scalar)
     return matrix;
 }
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> & operator/=(Matrix<Real, dim> & matrix, const Real & scalar)
+template<typename Real, size_t dim, typename Order>
+Matrix<Real, dim, Order> & operator/=(Matrix<Real, dim, Order> & matrix, const Real & scalar)
 {
     matrix *= (1./scalar);
     return matrix;
 }
 
+// The products below work on the storage directly, every index is in range
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator+(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right)
+Matrix<Real, dim> operator*(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right)
 {
-    auto result (left);
-    result += right;
-    return result;
-}
+    const Real * a = left.begin();
+    const Real * b = right.begin();
 
-template<typename Real, size_t dim>
-Matrix<Real, dim> operator-(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right)
-{
-    auto result (left);
-    result -= right;
-    return result;
+    Real elements[dim*dim];
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            Real element = a[i*dim] * b[j];
+            for (size_t k = 1; k < dim; ++k) {
+                element += a[i*dim + k] * b[k*dim + j];
+            }
+            elements[i*dim + j] = element;
+        }
+    }
+    return Matrix<Real, dim>(elements);
 }
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator*(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right)
+Vector<Real, dim> operator*(const Matrix<Real, dim> & matrix, const Vector<Real, dim> & vector)
 {
-    Matrix<Real, dim> result;
+    const Real * elements = matrix.begin();
+    const Real * v = vector.begin();
+
+    Vector<Real, dim> result;
+    Real * r = result.begin();
     for (size_t i = 0; i < dim; ++i) {
         for (size_t j = 0; j < dim; ++j) {
-            result(i,j) = calculate_element(left, right, i, j);
+            r[i] += elements[i*dim + j] * v[j];
         }
     }
     return result;
 }
 
+// Sums the rows scaled by the elements of the vector, without transposing
 template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Matrix<Real, dim> & matrix, const Vector<Real, dim> & vector)
+Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Matrix<Real, dim> & matrix)
 {
+    const Real * elements = matrix.begin();
+    const Real * v = vector.begin();
+
     Vector<Real, dim> result;
-    for (size_t i = 0; i < dim; ++i) {
+    Real * r = result.begin();
+    for (size_t k = 0; k < dim; ++k) {
         for (size_t j = 0; j < dim; ++j) {
-            result[i] += matrix(i,j) * vector[j];
+            r[j] += v[k] * elements[k*dim + j];
         }
     }
     return result;
 }
 
+template<typename Real, size_t dim, typename Order>
+bool operator==(const Matrix<Real, dim, Order> & left, const Matrix<Real, dim, Order> & right)
+{
+    for (size_t i = 0; i < dim*dim; ++i) {
+        if (left[i] != right[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Real, size_t dim, typename Order>
+bool operator!=(const Matrix<Real, dim, Order> & left, const Matrix<Real, dim, Order> & right)
+{
+    return !(left == right);
+}
+
+// Element index of the submatrix, without the given row or column, in the
+// full matrix
+constexpr size_t submatrix_index(const size_t & index, const size_t & removed)
+{
+    return index + (index >= removed ? 1 : 0);
+}
+
+template<typename Real, size_t dim, size_t... indices>
+constexpr Matrix<Real, dim-1> submatrix_elements(const Matrix<Real, dim> & matrix, const size_t & row, const size_t & col,
+                                                 Indices<indices...>)
+{
+    return Matrix<Real, dim-1>(matrix(submatrix_index(indices / (dim-1), row),
+                                      submatrix_index(indices % (dim-1), col))...);
+}
+
 template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Matrix<Real, dim> & matrix)
+constexpr Matrix<Real, dim-1> create_submatrix(const Matrix<Real, dim> & matrix, const size_t & row, const size_t & col)
+{
+    return submatrix_elements(matrix, row, col, typename MakeIndices<(dim-1)*(dim-1)>::type());
+}
+
+template<typename Real, size_t dim, typename Order, size_t... indices>
+constexpr Matrix<Real, dim, typename Order::transposed> transposed_order_elements(const Matrix<Real, dim, Order> & matrix,
+                                                                                  Indices<indices...>)
 {
-    return matrix_transpose(matrix) * vector;
+    return Matrix<Real, dim, typename Order::transposed>(matrix[indices]...);
 }
 
+template<typename Real, size_t dim, typename Order>
+constexpr Matrix<Real, dim, typename Order::transposed> matrix_transposed_order(const Matrix<Real, dim, Order> & matrix)
+{
+    return transposed_order_elements(matrix, typename MakeIndices<dim*dim>::type());
+}
+
+// The determinant of the transpose is the same
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator*(const Matrix<Real, dim> & matrix, const Real & scalar)
+Real matrix_determinant(const Matrix<Real, dim, ColumnMajor> & matrix)
 {
-    auto result (matrix);
-    result *= scalar;
-    return result;
+    return matrix_determinant(matrix_transposed_order(matrix));
 }
 
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator*(const Real & scalar, const Matrix<Real, dim> & matrix)
+Matrix<Real, dim, ColumnMajor> matrix_transpose(const Matrix<Real, dim, ColumnMajor> & matrix)
 {
-    return matrix * scalar;
+    return matrix_transposed_order(matrix_transpose(matrix_transposed_order(matrix)));
 }
 
+// The adjugate and inverse of the transpose are the transposes
 template<typename Real, size_t dim>
-Matrix<Real, dim> operator/(const Matrix<Real, dim> & matrix, const Real & scalar)
+Matrix<Real, dim, ColumnMajor> matrix_adjugate(const Matrix<Real, dim, ColumnMajor> & matrix)
 {
-    auto result (matrix);
-    result /= scalar;
-    return result;
+    return matrix_transposed_order(matrix_adjugate(matrix_transposed_order(matrix)));
 }
 
 template<typename Real, size_t dim>
-bool operator==(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right)
+Matrix<Real, dim, ColumnMajor> matrix_inverse(const Matrix<Real, dim, ColumnMajor> & matrix)
 {
-    for (size_t i = 0; i < dim*dim; ++i) {
-        if (left[i] != right[i]) {
-            return false;
-        }
-    }
-    return true;
+    return matrix_transposed_order(matrix_inverse(matrix_transposed_order(matrix)));
 }
 
 template<typename Real, size_t dim>
-bool operator!=(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right)
+LUDecomposition<Real, dim> matrix_lu_decompose(const Matrix<Real, dim, ColumnMajor> & matrix)
 {
-    return !(left == right);
+    return matrix_lu_decompose(Matrix<Real, dim>(matrix));
 }
 
 template<typename Real, size_t dim>
-Real calculate_element(const Matrix<Real, dim> & left, const Matrix<Real, dim> & right,
-        const size_t& i, const size_t& j)
+Vector<Real, dim> matrix_solve(const Matrix<Real, dim, ColumnMajor> & matrix, const Vector<Real, dim> & vector)
 {
-    Real element = 0;
-    for (size_t k = 0; k < dim; ++k) {
-        element += left(i,k) * right(k,j);
-    }
-    return element;
+    return lu_solve(matrix_lu_decompose(matrix), vector);
 }
 
 template<typename Real, size_t dim>
-static Matrix<Real, dim-1> create_submatrix(const Matrix<Real, dim> & matrix, const size_t & row, const size_t & col)
+Matrix<Real, dim, ColumnMajor> operator*(const Matrix<Real, dim, ColumnMajor> & left,
+                                         const Matrix<Real, dim, ColumnMajor> & right)
 {
-    Matrix<Real, dim-1> result;
-    size_t index = 0;
+    return matrix_transposed_order(matrix_transposed_order(right) * matrix_transposed_order(left));
+}
 
-    for (size_t i = 0; i < dim; ++i) {
-        for (size_t j = 0; j < dim; ++j) {
-            if (i != row && j != col) {
-                result[index++] = matrix(i, j);
-            }
-        }
-    }
+// The transpose of a column vector times the matrix is the row vector times
+// the transpose of the matrix, and the other way around
+template<typename Real, size_t dim>
+Vector<Real, dim> operator*(const Matrix<Real, dim, ColumnMajor> & matrix, const Vector<Real, dim> & vector)
+{
+    return vector * matrix_transposed_order(matrix);
+}
 
-    return result;
+template<typename Real, size_t dim>
+Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Matrix<Real, dim, ColumnMajor> & matrix)
+{
+    return matrix_transposed_order(matrix) * vector;
 }
 
 #endif
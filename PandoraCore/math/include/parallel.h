@@ -0,0 +1,92 @@
+#ifndef MATH_PARALLEL_H_INCLUDED
+#define MATH_PARALLEL_H_INCLUDED
+
+#include "config.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Math
+{
+
+// Every range handed out by parallel_for, except the last, holds a multiple
+// of this many elements, so ranges of a batch start at aligned offsets.
+static const size_t parallel_granularity = 64;
+
+// Worker threads kept from one parallel call to the next, so a call only
+// wakes them instead of starting threads. Workers are started when a call
+// first needs them, and live until the pool is destroyed.
+class ThreadPool
+{
+public:
+    ThreadPool();
+    ~ThreadPool();
+
+    // The pool parallel_tasks and parallel_for run on
+    static ThreadPool & shared();
+
+    // Starts workers until threads - 1 of them are running, the calling
+    // thread being the last, so the first run does not pay for them. Zero
+    // means one per hardware thread. Waits for a run on another thread, and
+    // does nothing when called from a task.
+    void reserve(const size_t & threads);
+    size_t size() const;
+
+    // Calls task(0) on the calling thread and task(i) on worker i - 1, and
+    // returns when all are done, rethrowing the first exception of a task.
+    // Returns false without calling any task when called from a task of a
+    // pool, or when another thread is already running tasks on this one.
+    bool try_run(const size_t & count, const std::function<void(const size_t &)> & task);
+
+private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool & operator=(const ThreadPool &);
+
+    // Needs running to be locked
+    void start_workers(const size_t & threads);
+    void work(const size_t & index, size_t seen);
+
+    // Locked for a whole run, and while workers start
+    std::mutex running;
+    std::vector<std::thread> workers;
+
+    // The current run, guarded by state
+    mutable std::mutex state;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(const size_t &)> * current;
+    size_t task_count;
+    size_t generation;
+    size_t pending;
+    bool stopping;
+    std::exception_ptr error;
+};
+
+// Calls task(i) for every i in [0, tasks), task(0) on the calling thread and
+// the others on threads of the shared pool, and returns when all are done.
+// Calls from inside a task, or made while another thread has the pool, get
+// threads of their own, which costs microseconds to start.
+template<typename Task>
+void parallel_tasks(const size_t & tasks, const Task & task);
+
+// Calls function(begin, end) for contiguous ranges covering [0, count),
+// spread over up to the given number of threads. The calling thread takes
+// the first range and returns when all ranges are done. Zero threads means
+// one per hardware thread. Waking the threads of the pool still costs a few
+// microseconds, so only batches of many thousands of elements gain from more
+// than one.
+template<typename Function>
+void parallel_for(const size_t & count, const size_t & threads, const Function & function);
+
+#define INCLUDED_FROM_PARALLEL_H
+#include "parallel_tmpl.h"
+#undef INCLUDED_FROM_PARALLEL_H
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef INCLUDED_FROM_PARALLEL_H
+#error "parallel_tmpl.h should only be included from parallel.h"
+#else
+
+// Joins the threads when it goes out of scope, also when the calling thread
+// throws, since destroying a joinable thread terminates the program
+class ThreadPoolJoiner
+{
+public:
+    explicit ThreadPoolJoiner(std::vector<std::thread> & pool)
+        : pool(pool)
+    {}
+
+    ~ThreadPoolJoiner()
+    {
+        for (auto & thread : pool) {
+            thread.join();
+        }
+    }
+
+private:
+    ThreadPoolJoiner(const ThreadPoolJoiner &);
+    ThreadPoolJoiner & operator=(const ThreadPoolJoiner &);
+
+    std::vector<std::thread> & pool;
+};
+
+template<typename Task>
+void parallel_tasks(const size_t & tasks, const Task & task)
+{
+    if (tasks <= 1) {
+        task(size_t(0));
+        return;
+    }
+
+    if (ThreadPool::shared().try_run(tasks, std::cref(task))) {
+        return;
+    }
+
+    // An exception escaping a thread terminates the program, so the first
+    // one is kept and rethrown once every thread is joined. An exception of
+    // the calling thread comes first, as on the pool.
+    std::mutex failed;
+    std::exception_ptr error;
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(tasks - 1);
+        const ThreadPoolJoiner joiner(threads);
+        for (size_t i = 1; i < tasks; ++i) {
+            threads.emplace_back([&task, &failed, &error, i]() {
+                try {
+                    task(i);
+                } catch (...) {
+                    const std::lock_guard<std::mutex> lock(failed);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            });
+        }
+
+        task(size_t(0));
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template<typename Function>
+void parallel_for(const size_t & count, const size_t & threads, const Function & function)
+{
+    const size_t blocks = (count + parallel_granularity - 1) / parallel_granularity;
+    const size_t workers = std::min(threads ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1),
+                                    blocks);
+
+    if (workers <= 1) {
+        function(size_t(0), count);
+        return;
+    }
+
+    const size_t range = (blocks + workers - 1) / workers * parallel_granularity;
+    const size_t ranges = (count + range - 1) / range;
+
+    parallel_tasks(ranges, [&](const size_t & i) {
+        function(i * range, std::min((i + 1) * range, count));
+    });
+}
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <limits>
 
 namespace Math
 {
@@ -15,19 +16,20 @@ template<typename Real>
 struct Quaternion
 {
 public:
-    explicit Quaternion();
+    constexpr explicit Quaternion();
 
-    explicit Quaternion(const Real & w, const Real & x, const Real & y, const Real & z);
+    constexpr explicit Quaternion(const Real & w, const Real & x, const Real & y, const Real & z);
 
-    explicit Quaternion(const Real array[4]);
+    constexpr explicit Quaternion(const Real array[4]);
 
-    explicit Quaternion(const Real & scalar, const Vector<Real, 3> & imaginary_vector);
+    constexpr explicit Quaternion(const Real & scalar, const Vector<Real, 3> & imaginary_vector);
 
     explicit Quaternion(const Vector<Real, 3> & axis, const Real & angle);
 
     explicit Quaternion(const Matrix<Real, 4> & matrix);
+    explicit Quaternion(const Matrix<Real, 4, ColumnMajor> & matrix);
 
-    Vector<Real,3> get_imag() const;
+    constexpr Vector<Real,3> get_imag() const;
     Vector<Real,3> & get_imag();
 
     Real & w();
@@ -35,10 +37,10 @@ public:
     Real & y();
     Real & z();
 
-    Real w() const;
-    Real x() const;
-    Real y() const;
-    Real z() const;
+    constexpr Real w() const;
+    constexpr Real x() const;
+    constexpr Real y() const;
+    constexpr Real z() const;
 public:
     Real real;
     Vector<Real, 3> imag;
@@ -60,38 +62,72 @@ template<typename Real>
 Quaternion<Real> & operator/=(Quaternion<Real> & to, const Real & scalar);
 
 template<typename Real>
-Quaternion<Real> operator+(const Quaternion<Real> & left, const Quaternion<Real> & right);
+constexpr Quaternion<Real> operator+(const Quaternion<Real> & left, const Quaternion<Real> & right);
 
 template<typename Real>
-Quaternion<Real> operator-(const Quaternion<Real> & left, const Quaternion<Real> & right);
+constexpr Quaternion<Real> operator-(const Quaternion<Real> & left, const Quaternion<Real> & right);
 
 template<typename Real>
-Quaternion<Real> operator*(const Quaternion<Real> & left, const Quaternion<Real> & right);
+constexpr Quaternion<Real> operator*(const Quaternion<Real> & left, const Quaternion<Real> & right);
 
 template<typename Real>
-Quaternion<Real> operator*(const Quaternion<Real> & quaternion, const Real & scalar);
+constexpr Quaternion<Real> operator*(const Quaternion<Real> & quaternion, const Real & scalar);
 
 template<typename Real>
-Quaternion<Real> operator*(const Real & scalar, const Quaternion<Real> & quaternion);
+constexpr Quaternion<Real> operator*(const Real & scalar, const Quaternion<Real> & quaternion);
 
 template<typename Real>
-Quaternion<Real> operator/(const Quaternion<Real> & quaternion, const Real & scalar);
+constexpr Quaternion<Real> operator/(const Quaternion<Real> & quaternion, const Real & scalar);
+
+// The rotation matrix, in either storage order, as quaternion_to_matrix(q)
+// or quaternion_to_matrix<ColumnMajor>(q)
+template<typename Order = RowMajor, typename Real>
+constexpr Matrix<Real, 4, Order> quaternion_to_matrix(const Quaternion<Real> & quaternion);
 
 template<typename Real>
-Matrix<Real, 4> quaternion_to_matrix(const Quaternion<Real> & quaternion);
+constexpr Real quaternion_norm(const Quaternion<Real> & quaternion);
 
 template<typename Real>
-Real quaternion_norm(const Quaternion<Real> & quaternion);
+constexpr Real quaternion_norm_squared(const Quaternion<Real> & quaternion);
 
 template<typename Real>
 void quaternion_normalize(Quaternion<Real> & quaternion);
 
+// Like normalize_vector_fast, a multiplication by Simd::rsqrt of the squared
+// norm. Float quaternions end up within 5e-7 of unit norm.
+template<typename Real>
+void quaternion_normalize_fast(Quaternion<Real> & quaternion);
+
 template<typename Real>
-Quaternion<Real> quaternion_conjugate(const Quaternion<Real> & quaternion);
+constexpr Quaternion<Real> quaternion_conjugate(const Quaternion<Real> & quaternion);
 
 template<typename Real>
 Quaternion<Real> quaternion_inverse(const Quaternion<Real> & quaternion);
 
+// Rotates the vector by a unit quaternion, as q * v * conjugate(q) without
+// the two full products: t = 2 (imag x v), v + w t + imag x t
+template<typename Real>
+constexpr Vector<Real, 3> quaternion_rotate(const Quaternion<Real> & quaternion, const Vector<Real, 3> & vector);
+
+// The four dimensional dot product, the cosine of the angle between two unit
+// quaternions
+template<typename Real>
+constexpr Real quaternion_dot(const Quaternion<Real> & left, const Quaternion<Real> & right);
+
+// Interpolation between unit quaternions. q and -q are the same rotation, so
+// all of them go the shorter way, towards whichever of to and -to is closer.
+//
+// nlerp normalizes the linear interpolation. It is the cheapest, but does
+// not move at a constant speed. fast_slerp evaluates the slerp weights as a
+// polynomial without any transcendental functions, to within 3e-5 of slerp,
+// and within 5e-7 for rotations less than a radian apart. slerp is exact,
+// and falls back on nlerp when the quaternions are too close for acos.
+template<typename Real>
+Quaternion<Real> quaternion_nlerp(const Quaternion<Real> & from, const Quaternion<Real> & to, const Real & t);
+
+template<typename Real>
+Quaternion<Real> quaternion_fast_slerp(const Quaternion<Real> & from, const Quaternion<Real> & to, const Real & t);
+
 template<typename Real>
 Quaternion<Real> quaternion_slerp(const Quaternion<Real> & from, const Quaternion<Real> & to, const Real & t);
 
@@ -99,5 +135,13 @@ Quaternion<Real> quaternion_slerp(const Quaternion<Real> & from, const Quaternio
 #include "quaternion_tmpl.h"
 #undef INCLUDED_FROM_QUATERNION_H
 
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Quaternion<float>;
+extern template struct Quaternion<double>;
+extern template Quaternion<float> quaternion_slerp(const Quaternion<float> &, const Quaternion<float> &, const float &);
+extern template Quaternion<double> quaternion_slerp(const Quaternion<double> &, const Quaternion<double> &, const double &);
+#endif
+
 }
 #endif
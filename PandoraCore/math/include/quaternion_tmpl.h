@@ -3,25 +3,30 @@
 #else
 
 template<typename Real>
-static Matrix<Real, 4> create_matrix_with_scale_from_quaternion(const Quaternion<Real> & quaternion, const Real & s);
+constexpr Matrix<Real, 4> create_matrix_with_scale_from_quaternion(const Quaternion<Real> & quaternion, const Real & s,
+                                                                   RowMajor);
 
 template<typename Real>
-Quaternion<Real>::Quaternion()
-    : real(1)
+constexpr Matrix<Real, 4, ColumnMajor> create_matrix_with_scale_from_quaternion(const Quaternion<Real> & quaternion,
+                                                                                const Real & s, ColumnMajor);
+
+template<typename Real>
+constexpr Quaternion<Real>::Quaternion()
+    : real(1), imag()
 { }
 
 template<typename Real>
-Quaternion<Real>::Quaternion(const Real & w, const Real & x, const Real & y, const Real & z)
-    : real(w), imag({x, y, z})
+constexpr Quaternion<Real>::Quaternion(const Real & w, const Real & x, const Real & y, const Real & z)
+    : real(w), imag(x, y, z)
 { }
 
 template<typename Real>
-Quaternion<Real>::Quaternion(const Real array[4])
-    : real(array[0]), imag({array[1], array[2], array[3]})
+constexpr Quaternion<Real>::Quaternion(const Real array[4])
+    : real(array[0]), imag(array[1], array[2], array[3])
 { }
 
 template<typename Real>
-Quaternion<Real>::Quaternion(const Real & real, const Vector<Real, 3> & imaginary_vector)
+constexpr Quaternion<Real>::Quaternion(const Real & real, const Vector<Real, 3> & imaginary_vector)
     : real(real), imag(imaginary_vector)
 { }
 
@@ -43,61 +48,67 @@ Quaternion<Real>::Quaternion(const Matrix<Real, 4> & matrix)
 }
 
 template<typename Real>
-Vector<Real,3> Quaternion<Real>::get_imag() const
+inline Quaternion<Real>::Quaternion(const Matrix<Real, 4, ColumnMajor> & matrix)
+    : Quaternion(Matrix<Real, 4>(matrix))
+{
+}
+
+template<typename Real>
+constexpr Vector<Real,3> Quaternion<Real>::get_imag() const
 {
     return imag;
 }
 
 template<typename Real>
-Vector<Real,3> & Quaternion<Real>::get_imag()
+inline Vector<Real,3> & Quaternion<Real>::get_imag()
 {
     return imag;
 }
 
 template<typename Real>
-Real & Quaternion<Real>::w()
+inline Real & Quaternion<Real>::w()
 {
     return real;
 }
 
 template<typename Real>
-Real Quaternion<Real>::w() const
+constexpr Real Quaternion<Real>::w() const
 {
     return real;
 }
 
 template<typename Real>
-Real & Quaternion<Real>::x()
+inline Real & Quaternion<Real>::x()
 {
     return imag[0];
 }
 
 template<typename Real>
-Real Quaternion<Real>::x() const
+constexpr Real Quaternion<Real>::x() const
 {
     return imag[0];
 }
 
 template<typename Real>
-Real & Quaternion<Real>::y()
+inline Real & Quaternion<Real>::y()
 {
     return imag[1];
 }
 
 template<typename Real>
-Real Quaternion<Real>::y() const
+constexpr Real Quaternion<Real>::y() const
 {
     return imag[1];
 }
 
 template<typename Real>
-Real & Quaternion<Real>::z()
+inline Real & Quaternion<Real>::z()
 {
     return imag[2];
 }
 
 template<typename Real>
-Real Quaternion<Real>::z() const
+constexpr Real Quaternion<Real>::z() const
 {
     return imag[2];
 }
@@ -131,51 +142,64 @@ Quaternion<Real> & operator/=(Quaternion<Real> & to, const Real & scalar)
 {
     assert(scalar != 0 && "Ca not divide quaternion by zero");
 
-    auto scalevalue = 1.0/scalar;
+    const auto scalevalue = Real(1)/scalar;
     to *= scalevalue;
 
     return to;
 }
 
-template<typename Real>
-Matrix<Real, 4> quaternion_to_matrix(const Quaternion<Real> & quaternion)
+template<typename Order, typename Real>
+constexpr Matrix<Real, 4, Order> quaternion_to_matrix(const Quaternion<Real> & quaternion)
 {
-    const auto quat_norm = quaternion_norm(quaternion);
-
-    assert(quat_norm != 0 && "Can not make matrix from zero quaternion");
-
-    const auto s = 2.0 / quat_norm;
-    return create_matrix_with_scale_from_quaternion(quaternion, s);
+    return assert(quaternion_norm(quaternion) != 0 && "Can not make matrix from zero quaternion"),
+           create_matrix_with_scale_from_quaternion(quaternion, Real(2.0 / quaternion_norm(quaternion)), Order());
 }
 
 template<typename Real>
-Matrix<Real, 4> create_matrix_with_scale_from_quaternion(const Quaternion<Real> & quaternion, const Real & s)
+constexpr Matrix<Real, 4> create_matrix_with_scale_from_quaternion(const Quaternion<Real> & quaternion, const Real & s,
+                                                                   RowMajor)
 {
-    Matrix<Real, 4> result;
-    const auto real = quaternion.w();
-    const auto imag = quaternion.get_imag();
-
-    result(0,0) -= s *(imag[1] * imag[1] + imag[2] * imag[2]);
-    result(0,1) += s *(imag[0] * imag[1] - real * imag[2]);
-    result(0,2) += s *(imag[0] * imag[2] + real * imag[1]);
-
-    result(1,0) += s *(imag[0] * imag[1] + real * imag[2]);
-    result(1,1) -= s *(imag[0] * imag[0] + imag[2] * imag[2]);
-    result(1,2) += s *(imag[1] * imag[2] - real * imag[0]);
+    return Matrix<Real, 4>(
+        1 - s *(quaternion.y() * quaternion.y() + quaternion.z() * quaternion.z()),
+        s *(quaternion.x() * quaternion.y() - quaternion.w() * quaternion.z()),
+        s *(quaternion.x() * quaternion.z() + quaternion.w() * quaternion.y()),
+        0,
+
+        s *(quaternion.x() * quaternion.y() + quaternion.w() * quaternion.z()),
+        1 - s *(quaternion.x() * quaternion.x() + quaternion.z() * quaternion.z()),
+        s *(quaternion.y() * quaternion.z() - quaternion.w() * quaternion.x()),
+        0,
+
+        s *(quaternion.x() * quaternion.z() - quaternion.w() * quaternion.y()),
+        s *(quaternion.y() * quaternion.z() + quaternion.w() * quaternion.x()),
+        1 - s *(quaternion.x() * quaternion.x() + quaternion.y() * quaternion.y()),
+        0,
+
+        0, 0, 0, 1);
+}
 
-    result(2,0) += s *(imag[0] * imag[2] - real * imag[1]);
-    result(2,1) += s *(imag[1] * imag[2] + real * imag[0]);
-    result(2,2) -= s *(imag[0] * imag[0] + imag[1] * imag[1]);
+// The rotation of the conjugate is the transpose, which is the column major
+// storage of the rotation
+template<typename Real>
+constexpr Matrix<Real, 4, ColumnMajor> create_matrix_with_scale_from_quaternion(const Quaternion<Real> & quaternion,
+                                                                                const Real & s, ColumnMajor)
+{
+    return matrix_transposed_order(create_matrix_with_scale_from_quaternion(quaternion_conjugate(quaternion), s,
+                                                                            RowMajor()));
+}
 
-    return result;
+template<typename Real>
+constexpr Real quaternion_norm(const Quaternion<Real> & quaternion)
+{
+    return std::sqrt(quaternion_norm_squared(quaternion));
 }
 
+// The imaginary part is summed in index order, like dot_product
 template<typename Real>
-Real quaternion_norm(const Quaternion<Real> & quaternion)
+constexpr Real quaternion_norm_squared(const Quaternion<Real> & quaternion)
 {
-    const auto real = quaternion.w();
-    const auto imag = quaternion.get_imag();
-    return std::sqrt(dot_product(imag, imag) + real * real);
+    return ((quaternion.x() * quaternion.x() + quaternion.y() * quaternion.y()) +
+            quaternion.z() * quaternion.z()) + quaternion.w() * quaternion.w();
 }
 
 template<typename Real>
@@ -189,11 +213,19 @@ void quaternion_normalize(Quaternion<Real> & quaternion)
 }
 
 template<typename Real>
-Quaternion<Real> quaternion_conjugate(const Quaternion<Real> & quaternion)
+void quaternion_normalize_fast(Quaternion<Real> & quaternion)
 {
-    const auto real = quaternion.w();
-    const auto imag = quaternion.get_imag();
-    return Quaternion<Real>(real, -imag);
+    const Real norm_squared = quaternion_norm_squared(quaternion);
+
+    assert(norm_squared != 0 && "Can not normalize zero quaternion");
+
+    quaternion *= Simd::rsqrt(Simd::Register<Real, 1>(norm_squared)).value;
+}
+
+template<typename Real>
+constexpr Quaternion<Real> quaternion_conjugate(const Quaternion<Real> & quaternion)
+{
+    return Quaternion<Real>(quaternion.w(), -quaternion.x(), -quaternion.y(), -quaternion.z());
 }
 
 template<typename Real>
@@ -207,58 +239,170 @@ Quaternion<Real> quaternion_inverse(const Quaternion<Real> & quaternion)
     return quaternion_conjugate(quaternion) / normsquared;
 }
 
+template<typename Real>
+constexpr Vector<Real, 3> rotate_with_offset(const Quaternion<Real> & quaternion, const Vector<Real, 3> & vector,
+                                             const Real & tx, const Real & ty, const Real & tz)
+{
+    return Vector<Real, 3>((vector[0] + quaternion.w()*tx) + (quaternion.y()*tz - quaternion.z()*ty),
+                           (vector[1] + quaternion.w()*ty) + (quaternion.z()*tx - quaternion.x()*tz),
+                           (vector[2] + quaternion.w()*tz) + (quaternion.x()*ty - quaternion.y()*tx));
+}
+
+template<typename Real>
+constexpr Vector<Real, 3> quaternion_rotate(const Quaternion<Real> & quaternion, const Vector<Real, 3> & vector)
+{
+    return rotate_with_offset(quaternion, vector,
+                              2 * (quaternion.y()*vector[2] - quaternion.z()*vector[1]),
+                              2 * (quaternion.z()*vector[0] - quaternion.x()*vector[2]),
+                              2 * (quaternion.x()*vector[1] - quaternion.y()*vector[0]));
+}
+
+template<typename Real>
+constexpr Real quaternion_dot(const Quaternion<Real> & left, const Quaternion<Real> & right)
+{
+    return left.w() * right.w() + ((left.x() * right.x() + left.y() * right.y()) + left.z() * right.z());
+}
+
+template<typename Real>
+Quaternion<Real> quaternion_nlerp(const Quaternion<Real> & from, const Quaternion<Real> & to, const Real & t)
+{
+    const Real sign = std::copysign(Real(1), quaternion_dot(from, to));
+    const auto result = from * (1 - t) + to * (sign * t);
+    return result * (1 / quaternion_norm(result));
+}
+
+// The coefficients of the fast_slerp polynomial, u_i = 1/(i (2i + 1)) and
+// v_i = i/(2i + 1) for i = 1 to 8. The last pair is scaled up to make up for
+// the terms left out. See D. Eberly, A Fast and Accurate Algorithm for
+// Computing SLERP.
+template<typename Real>
+struct FastSlerp
+{
+    static const size_t terms = 8;
+    static constexpr double last_term_scale = 1.90110745351730037;
+
+    static constexpr Real u[terms] = {Real(1. / 3), Real(1. / 10), Real(1. / 21), Real(1. / 36),
+                                      Real(1. / 55), Real(1. / 78), Real(1. / 105),
+                                      Real(last_term_scale / 136)};
+    static constexpr Real v[terms] = {Real(1. / 3), Real(2. / 5), Real(3. / 7), Real(4. / 9),
+                                      Real(5. / 11), Real(6. / 13), Real(7. / 15),
+                                      Real(last_term_scale * 8 / 17)};
+};
+
+template<typename Real>
+constexpr Real FastSlerp<Real>::u[FastSlerp<Real>::terms];
+
+template<typename Real>
+constexpr Real FastSlerp<Real>::v[FastSlerp<Real>::terms];
+
+// sin(t angle)/sin(angle) from cos(angle) - 1. Evaluated in registers, so the
+// batches share it lane by lane.
+template<typename Real, typename reg>
+reg fast_slerp_weight(const reg & t, const reg & cos_minus_one)
+{
+    typedef FastSlerp<Real> coefficients;
+
+    const reg one = reg::broadcast(1);
+    const reg t_squared = t * t;
+    reg weight = one;
+    for (size_t i = coefficients::terms; i-- > 0;) {
+        const reg u = reg::broadcast(coefficients::u[i]);
+        const reg v = reg::broadcast(coefficients::v[i]);
+        weight = one + (u * t_squared - v) * cos_minus_one * weight;
+    }
+    return t * weight;
+}
+
+template<typename Real>
+Quaternion<Real> quaternion_fast_slerp(const Quaternion<Real> & from, const Quaternion<Real> & to, const Real & t)
+{
+    typedef Simd::Register<Real, 1> scalar;
+
+    const Real cos = quaternion_dot(from, to);
+    const scalar cos_minus_one(std::abs(cos) - 1);
+    const Real from_scale = fast_slerp_weight<Real>(scalar(1 - t), cos_minus_one).value;
+    const Real to_scale = std::copysign(Real(1), cos) * fast_slerp_weight<Real>(scalar(t), cos_minus_one).value;
+    return from * from_scale + to * to_scale;
+}
+
 template<typename Real>
 Quaternion<Real> quaternion_slerp(const Quaternion<Real> & from, const Quaternion<Real> & to, const Real & t)
 {
-    const auto angle = std::acos(from.real * to.real + dot_product(from.imag, to.imag));
-    const auto from_scale = std::sin(angle *(1 - t))/std::sin(angle);
-    const auto to_scale = std::sin(angle * t)/std::sin(angle);
+    const Real cos = quaternion_dot(from, to);
+    if (1 - std::abs(cos) < std::sqrt(std::numeric_limits<Real>::epsilon())) {
+        return quaternion_nlerp(from, to, t);
+    }
+
+    const Real angle = std::acos(std::abs(cos));
+    const Real sine = std::sin(angle);
+    const Real from_scale = std::sin(angle *(1 - t))/sine;
+    const Real to_scale = std::copysign(Real(1), cos) * (std::sin(angle * t)/sine);
     return from_scale * from + to_scale * to;
 }
 
+#ifdef MATH_USE_SSE2
+// The cross product on padded vectors, in the order of quaternion_rotate and
+// the quaternion product. Lane 3 of the operands is zero, so it stays zero
+// in the result.
+template<typename Real>
+Simd::Register<Real, 4> simd_cross_product(const Simd::Register<Real, 4> & left,
+                                           const Simd::Register<Real, 4> & right)
+{
+    return Simd::shuffle<1, 2, 0, 3>(left) * Simd::shuffle<2, 0, 1, 3>(right) -
+           Simd::shuffle<2, 0, 1, 3>(left) * Simd::shuffle<1, 2, 0, 3>(right);
+}
+#endif
+
+// The binary operators build their result directly from the components, so
+// chains of them do not create intermediate vectors
 template<typename Real>
-Quaternion<Real> operator+(const Quaternion<Real> & left, const Quaternion<Real> & right)
+constexpr Quaternion<Real> operator+(const Quaternion<Real> & left, const Quaternion<Real> & right)
 {
-    Quaternion<Real> res = left;
-    res += right;
-    return res;
+    return Quaternion<Real>(left.w() + right.w(),
+                            left.x() + right.x(),
+                            left.y() + right.y(),
+                            left.z() + right.z());
 }
 
 template<typename Real>
-Quaternion<Real> operator-(const Quaternion<Real> & left, const Quaternion<Real> & right)
+constexpr Quaternion<Real> operator-(const Quaternion<Real> & left, const Quaternion<Real> & right)
 {
-    Quaternion<Real> res = left;
-    res -= right;
-    return res;
+    return Quaternion<Real>(left.w() - right.w(),
+                            left.x() - right.x(),
+                            left.y() - right.y(),
+                            left.z() - right.z());
 }
 
 template<typename Real>
-Quaternion<Real> operator*(const Quaternion<Real> & left, const Quaternion<Real> & right)
+constexpr Quaternion<Real> operator*(const Quaternion<Real> & left, const Quaternion<Real> & right)
 {
-    return Quaternion<Real>(left.w() * right.w() - dot_product(left.imag, right.imag),
-            cross_product(left.imag, right.imag) + left.real * right.imag + right.real * left.imag);
+    // w = lw*rw - l.r, imag = l x r + lw*r + rw*l
+    return Quaternion<Real>(
+        left.w()*right.w() - ((left.x()*right.x() + left.y()*right.y()) + left.z()*right.z()),
+        ((left.y()*right.z() - left.z()*right.y()) + left.w()*right.x()) + right.w()*left.x(),
+        ((left.z()*right.x() - left.x()*right.z()) + left.w()*right.y()) + right.w()*left.y(),
+        ((left.x()*right.y() - left.y()*right.x()) + left.w()*right.z()) + right.w()*left.z());
 }
 
 template<typename Real>
-Quaternion<Real> operator*(const Quaternion<Real> & quaternion, const Real & scalar)
+constexpr Quaternion<Real> operator*(const Quaternion<Real> & quaternion, const Real & scalar)
 {
-    Quaternion<Real> res = quaternion;
-    res *= scalar;
-    return res;
+    return Quaternion<Real>(quaternion.w() * scalar,
+                            quaternion.x() * scalar,
+                            quaternion.y() * scalar,
+                            quaternion.z() * scalar);
 }
 
 template<typename Real>
-Quaternion<Real> operator*(const Real & scalar, const Quaternion<Real> & quaternion)
+constexpr Quaternion<Real> operator*(const Real & scalar, const Quaternion<Real> & quaternion)
 {
     return quaternion * scalar;
 }
 
 template<typename Real>
-Quaternion<Real> operator/(const Quaternion<Real> & quaternion, const Real & scalar)
+constexpr Quaternion<Real> operator/(const Quaternion<Real> & quaternion, const Real & scalar)
 {
-    Quaternion<Real> res = quaternion;
-    res /= scalar;
-    return res;
+    return assert(scalar != 0 && "Ca not divide quaternion by zero"), quaternion * (Real(1)/scalar);
 }
 
 template<typename Real>
@@ -278,7 +422,7 @@ void Quaternion<Real>::create_quaternion_from_matrix_with_smallest_u(const Matri
     imag[1] = std::sqrt(-matrix(0,0) + matrix(1,1) - matrix(2,2) + matrix(3,3));
     imag[2] = std::sqrt(-matrix(0,0) - matrix(1,1) + matrix(2,2) + matrix(3,3));
 
-    imag *= 0.5;
+    imag *= Real(0.5);
 }
 
 #endif
@@ -0,0 +1,865 @@
+#ifndef MATH_SIMD_H_INCLUDED
+#define MATH_SIMD_H_INCLUDED
+
+#include "config.h"
+
+#include <cmath>
+
+// The SIMD paths are selected from what the compiler is generating code for,
+// so every library and executable built with the same flags agrees on them.
+// PANDORA_ENABLE_SIMD=OFF writes MATH_NO_SIMD to config.h, which forces the
+// scalar code everywhere.
+#if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(MATH_USE_SSE2) && defined(__AVX__)
+#define MATH_USE_AVX
+#include <immintrin.h>
+#endif
+
+// The half precision conversions. Visual C++ has no switch of its own for
+// them, but every cpu with AVX2 has them.
+#if defined(MATH_USE_AVX) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define MATH_USE_F16C
+#endif
+
+// Fused multiply-adds, which round once instead of twice
+#if defined(MATH_USE_AVX) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define MATH_USE_FMA
+#endif
+
+namespace Math
+{
+
+namespace Simd
+{
+
+// Number of scalars Vector<Real, dim> stores. Three dimensional float and
+// double vectors are padded with a zero lane so they fill a whole register.
+template<typename Real, size_t dim>
+struct VectorStorage
+{
+    static const size_t size = dim;
+    static const size_t alignment = alignof(Real);
+};
+
+#ifdef MATH_USE_SSE2
+template<>
+struct VectorStorage<float, 3>
+{
+    static const size_t size = 4;
+    static const size_t alignment = 16;
+};
+
+template<>
+struct VectorStorage<float, 4>
+{
+    static const size_t size = 4;
+    static const size_t alignment = 16;
+};
+
+template<>
+struct VectorStorage<double, 2>
+{
+    static const size_t size = 2;
+    static const size_t alignment = 16;
+};
+
+template<>
+struct VectorStorage<double, 3>
+{
+    static const size_t size = 4;
+    static const size_t alignment = 16;
+};
+
+template<>
+struct VectorStorage<double, 4>
+{
+    static const size_t size = 4;
+    static const size_t alignment = 16;
+};
+#endif
+
+// A fixed number of scalars held in registers. The generic version is the
+// scalar fallback, and only exists for a width of one. gather reads the
+// lanes stride scalars apart, to pick a member out of an array of structs,
+// or at the given offsets, to pick it out of structs found through indices.
+template<typename Real, size_t width>
+struct Register;
+
+template<typename Real>
+struct Register<Real, 1>
+{
+    static const size_t size = 1;
+
+    static Register load(const Real * source) { return Register(*source); }
+    static Register loadu(const Real * source) { return Register(*source); }
+    static Register broadcast(const Real & scalar) { return Register(scalar); }
+    static Register gather(const Real * source, const size_t &) { return Register(*source); }
+    static Register gather(const Real * source, const size_t * offsets) { return Register(source[*offsets]); }
+
+    void store(Real * destination) const { *destination = value; }
+    void storeu(Real * destination) const { *destination = value; }
+
+    explicit Register(const Real & value) : value(value) {}
+
+    Real value;
+};
+
+template<typename Real>
+Register<Real, 1> operator+(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value + right.value);
+}
+
+template<typename Real>
+Register<Real, 1> operator-(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value - right.value);
+}
+
+template<typename Real>
+Register<Real, 1> operator*(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value * right.value);
+}
+
+template<typename Real>
+Register<Real, 1> operator/(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value / right.value);
+}
+
+template<typename Real>
+Register<Real, 1> sqrt(const Register<Real, 1> & reg)
+{
+    return Register<Real, 1>(std::sqrt(reg.value));
+}
+
+// Approximate 1/sqrt. The float registers refine the hardware estimate
+// with one Newton iteration, to within 5e-7 of 1/sqrt. There is no double
+// estimate without AVX-512, so doubles, and every type without SIMD, divide
+// by sqrt instead.
+template<typename Real>
+Register<Real, 1> rsqrt(const Register<Real, 1> & reg)
+{
+    return Register<Real, 1>(1 / std::sqrt(reg.value));
+}
+
+template<typename Real>
+Register<Real, 1> abs(const Register<Real, 1> & reg)
+{
+    return Register<Real, 1>(std::abs(reg.value));
+}
+
+// The magnitudes with the signs of sign, lane by lane
+template<typename Real>
+Register<Real, 1> copysign(const Register<Real, 1> & magnitude, const Register<Real, 1> & sign)
+{
+    return Register<Real, 1>(std::copysign(magnitude.value, sign.value));
+}
+
+// The smaller and larger of each pair of lanes. Where the comparison is false,
+// a NaN in either lane included, the right lane is taken, the same as the SSE
+// instructions, so every width gives the same results.
+template<typename Real>
+Register<Real, 1> min(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value < right.value ? left.value : right.value);
+}
+
+template<typename Real>
+Register<Real, 1> max(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value > right.value ? left.value : right.value);
+}
+
+// left * right + addend, fused where the target has the instructions, so the
+// result depends on MATH_USE_FMA, but never on the width
+template<typename Real>
+Register<Real, 1> multiply_add(const Register<Real, 1> & left, const Register<Real, 1> & right,
+                               const Register<Real, 1> & addend)
+{
+#ifdef MATH_USE_FMA
+    return Register<Real, 1>(std::fma(left.value, right.value, addend.value));
+#else
+    return Register<Real, 1>(left.value * right.value + addend.value);
+#endif
+}
+
+// A mask of the lanes where left and right are equal. Masks are only good for
+// select and all_of.
+template<typename Real>
+Register<Real, 1> equal(const Register<Real, 1> & left, const Register<Real, 1> & right)
+{
+    return Register<Real, 1>(left.value == right.value ? Real(1) : Real(0));
+}
+
+// The lanes of if_true where mask is set, and of if_false elsewhere
+template<typename Real>
+Register<Real, 1> select(const Register<Real, 1> & mask, const Register<Real, 1> & if_true,
+                         const Register<Real, 1> & if_false)
+{
+    return mask.value != 0 ? if_true : if_false;
+}
+
+template<typename Real>
+bool all_of(const Register<Real, 1> & mask)
+{
+    return mask.value != 0;
+}
+
+// The sum of the lanes, added in registers one lane after the other, so it
+// rounds the same as a loop over the lanes
+template<typename Real>
+Real horizontal_sum(const Register<Real, 1> & reg)
+{
+    return reg.value;
+}
+
+#ifdef MATH_USE_SSE2
+template<>
+struct Register<float, 4>
+{
+    static const size_t size = 4;
+
+    static Register load(const float * source) { return Register(_mm_load_ps(source)); }
+    static Register loadu(const float * source) { return Register(_mm_loadu_ps(source)); }
+    static Register broadcast(const float & scalar) { return Register(_mm_set1_ps(scalar)); }
+    static Register gather(const float * source, const size_t & stride)
+    {
+        return Register(_mm_setr_ps(source[0], source[stride], source[2 * stride], source[3 * stride]));
+    }
+
+    static Register gather(const float * source, const size_t * offsets)
+    {
+        return Register(_mm_setr_ps(source[offsets[0]], source[offsets[1]], source[offsets[2]], source[offsets[3]]));
+    }
+
+    void store(float * destination) const { _mm_store_ps(destination, value); }
+    void storeu(float * destination) const { _mm_storeu_ps(destination, value); }
+
+    explicit Register(const __m128 & value) : value(value) {}
+
+    __m128 value;
+};
+
+inline Register<float, 4> operator+(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_add_ps(left.value, right.value));
+}
+
+inline Register<float, 4> operator-(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_sub_ps(left.value, right.value));
+}
+
+inline Register<float, 4> operator*(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_mul_ps(left.value, right.value));
+}
+
+inline Register<float, 4> operator/(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_div_ps(left.value, right.value));
+}
+
+inline Register<float, 4> sqrt(const Register<float, 4> & reg)
+{
+    return Register<float, 4>(_mm_sqrt_ps(reg.value));
+}
+
+inline Register<float, 4> abs(const Register<float, 4> & reg)
+{
+    return Register<float, 4>(_mm_andnot_ps(_mm_set1_ps(-0.f), reg.value));
+}
+
+inline Register<float, 4> copysign(const Register<float, 4> & magnitude, const Register<float, 4> & sign)
+{
+    const __m128 mask = _mm_set1_ps(-0.f);
+    return Register<float, 4>(_mm_or_ps(_mm_andnot_ps(mask, magnitude.value), _mm_and_ps(mask, sign.value)));
+}
+
+inline Register<float, 4> min(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_min_ps(left.value, right.value));
+}
+
+inline Register<float, 4> max(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_max_ps(left.value, right.value));
+}
+
+inline Register<float, 4> multiply_add(const Register<float, 4> & left, const Register<float, 4> & right,
+                                       const Register<float, 4> & addend)
+{
+#ifdef MATH_USE_FMA
+    return Register<float, 4>(_mm_fmadd_ps(left.value, right.value, addend.value));
+#else
+    return Register<float, 4>(_mm_add_ps(_mm_mul_ps(left.value, right.value), addend.value));
+#endif
+}
+
+inline Register<float, 4> equal(const Register<float, 4> & left, const Register<float, 4> & right)
+{
+    return Register<float, 4>(_mm_cmpeq_ps(left.value, right.value));
+}
+
+inline Register<float, 4> select(const Register<float, 4> & mask, const Register<float, 4> & if_true,
+                                 const Register<float, 4> & if_false)
+{
+    return Register<float, 4>(_mm_or_ps(_mm_and_ps(mask.value, if_true.value), _mm_andnot_ps(mask.value, if_false.value)));
+}
+
+inline bool all_of(const Register<float, 4> & mask)
+{
+    return _mm_movemask_ps(mask.value) == 0xf;
+}
+
+// Adds lanes 1 to 3 of value to the first lane of sum, in order
+inline __m128 add_upper_lanes(const __m128 & sum, const __m128 & value)
+{
+    const __m128 first = _mm_add_ss(sum, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1)));
+    const __m128 second = _mm_add_ss(first, _mm_movehl_ps(value, value));
+    return _mm_add_ss(second, _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+inline float horizontal_sum(const Register<float, 4> & reg)
+{
+    return _mm_cvtss_f32(add_upper_lanes(reg.value, reg.value));
+}
+
+// One Newton iteration for 1/sqrt(reg) from the estimate
+template<typename FloatRegister>
+FloatRegister refine_rsqrt(const FloatRegister & reg, const FloatRegister & estimate)
+{
+    const FloatRegister half = FloatRegister::broadcast(0.5f);
+    const FloatRegister three_halves = FloatRegister::broadcast(1.5f);
+    return estimate * (three_halves - (half * reg) * (estimate * estimate));
+}
+
+inline Register<float, 1> rsqrt(const Register<float, 1> & reg)
+{
+    return refine_rsqrt(reg, Register<float, 1>(_mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(reg.value)))));
+}
+
+inline Register<float, 4> rsqrt(const Register<float, 4> & reg)
+{
+    return refine_rsqrt(reg, Register<float, 4>(_mm_rsqrt_ps(reg.value)));
+}
+
+// Lane i of the result is lane i0, i1, i2 or i3 of reg
+template<size_t i0, size_t i1, size_t i2, size_t i3>
+inline Register<float, 4> shuffle(const Register<float, 4> & reg)
+{
+    return Register<float, 4>(_mm_shuffle_ps(reg.value, reg.value, _MM_SHUFFLE(i3, i2, i1, i0)));
+}
+
+template<>
+struct Register<double, 2>
+{
+    static const size_t size = 2;
+
+    static Register load(const double * source) { return Register(_mm_load_pd(source)); }
+    static Register loadu(const double * source) { return Register(_mm_loadu_pd(source)); }
+    static Register broadcast(const double & scalar) { return Register(_mm_set1_pd(scalar)); }
+    static Register gather(const double * source, const size_t & stride)
+    {
+        return Register(_mm_setr_pd(source[0], source[stride]));
+    }
+
+    static Register gather(const double * source, const size_t * offsets)
+    {
+        return Register(_mm_setr_pd(source[offsets[0]], source[offsets[1]]));
+    }
+
+    void store(double * destination) const { _mm_store_pd(destination, value); }
+    void storeu(double * destination) const { _mm_storeu_pd(destination, value); }
+
+    explicit Register(const __m128d & value) : value(value) {}
+
+    __m128d value;
+};
+
+inline Register<double, 2> operator+(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_add_pd(left.value, right.value));
+}
+
+inline Register<double, 2> operator-(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_sub_pd(left.value, right.value));
+}
+
+inline Register<double, 2> operator*(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_mul_pd(left.value, right.value));
+}
+
+inline Register<double, 2> operator/(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_div_pd(left.value, right.value));
+}
+
+inline Register<double, 2> sqrt(const Register<double, 2> & reg)
+{
+    return Register<double, 2>(_mm_sqrt_pd(reg.value));
+}
+
+inline Register<double, 2> rsqrt(const Register<double, 2> & reg)
+{
+    return Register<double, 2>::broadcast(1) / sqrt(reg);
+}
+
+inline Register<double, 2> abs(const Register<double, 2> & reg)
+{
+    return Register<double, 2>(_mm_andnot_pd(_mm_set1_pd(-0.), reg.value));
+}
+
+inline Register<double, 2> copysign(const Register<double, 2> & magnitude, const Register<double, 2> & sign)
+{
+    const __m128d mask = _mm_set1_pd(-0.);
+    return Register<double, 2>(_mm_or_pd(_mm_andnot_pd(mask, magnitude.value), _mm_and_pd(mask, sign.value)));
+}
+
+inline Register<double, 2> min(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_min_pd(left.value, right.value));
+}
+
+inline Register<double, 2> max(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_max_pd(left.value, right.value));
+}
+
+inline Register<double, 2> multiply_add(const Register<double, 2> & left, const Register<double, 2> & right,
+                                        const Register<double, 2> & addend)
+{
+#ifdef MATH_USE_FMA
+    return Register<double, 2>(_mm_fmadd_pd(left.value, right.value, addend.value));
+#else
+    return Register<double, 2>(_mm_add_pd(_mm_mul_pd(left.value, right.value), addend.value));
+#endif
+}
+
+inline Register<double, 2> equal(const Register<double, 2> & left, const Register<double, 2> & right)
+{
+    return Register<double, 2>(_mm_cmpeq_pd(left.value, right.value));
+}
+
+inline Register<double, 2> select(const Register<double, 2> & mask, const Register<double, 2> & if_true,
+                                  const Register<double, 2> & if_false)
+{
+    return Register<double, 2>(_mm_or_pd(_mm_and_pd(mask.value, if_true.value), _mm_andnot_pd(mask.value, if_false.value)));
+}
+
+inline bool all_of(const Register<double, 2> & mask)
+{
+    return _mm_movemask_pd(mask.value) == 0x3;
+}
+
+inline double horizontal_sum(const Register<double, 2> & reg)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(reg.value, _mm_unpackhi_pd(reg.value, reg.value)));
+}
+#endif
+
+#ifdef MATH_USE_AVX
+template<>
+struct Register<float, 8>
+{
+    static const size_t size = 8;
+
+    static Register load(const float * source) { return Register(_mm256_load_ps(source)); }
+    static Register loadu(const float * source) { return Register(_mm256_loadu_ps(source)); }
+    static Register broadcast(const float & scalar) { return Register(_mm256_set1_ps(scalar)); }
+    static Register gather(const float * source, const size_t & stride)
+    {
+        return Register(_mm256_setr_ps(source[0], source[stride], source[2 * stride], source[3 * stride],
+                                       source[4 * stride], source[5 * stride], source[6 * stride], source[7 * stride]));
+    }
+
+    static Register gather(const float * source, const size_t * offsets)
+    {
+        return Register(_mm256_setr_ps(source[offsets[0]], source[offsets[1]], source[offsets[2]], source[offsets[3]],
+                                       source[offsets[4]], source[offsets[5]], source[offsets[6]], source[offsets[7]]));
+    }
+
+    void store(float * destination) const { _mm256_store_ps(destination, value); }
+    void storeu(float * destination) const { _mm256_storeu_ps(destination, value); }
+
+    explicit Register(const __m256 & value) : value(value) {}
+
+    __m256 value;
+};
+
+inline Register<float, 8> operator+(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_add_ps(left.value, right.value));
+}
+
+inline Register<float, 8> operator-(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_sub_ps(left.value, right.value));
+}
+
+inline Register<float, 8> operator*(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_mul_ps(left.value, right.value));
+}
+
+inline Register<float, 8> operator/(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_div_ps(left.value, right.value));
+}
+
+inline Register<float, 8> sqrt(const Register<float, 8> & reg)
+{
+    return Register<float, 8>(_mm256_sqrt_ps(reg.value));
+}
+
+inline Register<float, 8> rsqrt(const Register<float, 8> & reg)
+{
+    return refine_rsqrt(reg, Register<float, 8>(_mm256_rsqrt_ps(reg.value)));
+}
+
+inline Register<float, 8> abs(const Register<float, 8> & reg)
+{
+    return Register<float, 8>(_mm256_andnot_ps(_mm256_set1_ps(-0.f), reg.value));
+}
+
+inline Register<float, 8> copysign(const Register<float, 8> & magnitude, const Register<float, 8> & sign)
+{
+    const __m256 mask = _mm256_set1_ps(-0.f);
+    return Register<float, 8>(_mm256_or_ps(_mm256_andnot_ps(mask, magnitude.value), _mm256_and_ps(mask, sign.value)));
+}
+
+inline Register<float, 8> min(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_min_ps(left.value, right.value));
+}
+
+inline Register<float, 8> max(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_max_ps(left.value, right.value));
+}
+
+inline Register<float, 8> multiply_add(const Register<float, 8> & left, const Register<float, 8> & right,
+                                       const Register<float, 8> & addend)
+{
+#ifdef MATH_USE_FMA
+    return Register<float, 8>(_mm256_fmadd_ps(left.value, right.value, addend.value));
+#else
+    return Register<float, 8>(_mm256_add_ps(_mm256_mul_ps(left.value, right.value), addend.value));
+#endif
+}
+
+inline Register<float, 8> equal(const Register<float, 8> & left, const Register<float, 8> & right)
+{
+    return Register<float, 8>(_mm256_cmp_ps(left.value, right.value, _CMP_EQ_OQ));
+}
+
+inline Register<float, 8> select(const Register<float, 8> & mask, const Register<float, 8> & if_true,
+                                 const Register<float, 8> & if_false)
+{
+    return Register<float, 8>(_mm256_blendv_ps(if_false.value, if_true.value, mask.value));
+}
+
+inline bool all_of(const Register<float, 8> & mask)
+{
+    return _mm256_movemask_ps(mask.value) == 0xff;
+}
+
+inline float horizontal_sum(const Register<float, 8> & reg)
+{
+    const __m128 high = _mm256_extractf128_ps(reg.value, 1);
+    const __m128 low_sum = add_upper_lanes(_mm256_castps256_ps128(reg.value), _mm256_castps256_ps128(reg.value));
+    return _mm_cvtss_f32(add_upper_lanes(_mm_add_ss(low_sum, high), high));
+}
+
+template<>
+struct Register<double, 4>
+{
+    static const size_t size = 4;
+
+    static Register load(const double * source) { return Register(_mm256_load_pd(source)); }
+    static Register loadu(const double * source) { return Register(_mm256_loadu_pd(source)); }
+    static Register broadcast(const double & scalar) { return Register(_mm256_set1_pd(scalar)); }
+    static Register gather(const double * source, const size_t & stride)
+    {
+        return Register(_mm256_setr_pd(source[0], source[stride], source[2 * stride], source[3 * stride]));
+    }
+
+    static Register gather(const double * source, const size_t * offsets)
+    {
+        return Register(_mm256_setr_pd(source[offsets[0]], source[offsets[1]], source[offsets[2]], source[offsets[3]]));
+    }
+
+    void store(double * destination) const { _mm256_store_pd(destination, value); }
+    void storeu(double * destination) const { _mm256_storeu_pd(destination, value); }
+
+    explicit Register(const __m256d & value) : value(value) {}
+
+    __m256d value;
+};
+
+inline Register<double, 4> operator+(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_add_pd(left.value, right.value));
+}
+
+inline Register<double, 4> operator-(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_sub_pd(left.value, right.value));
+}
+
+inline Register<double, 4> operator*(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_mul_pd(left.value, right.value));
+}
+
+inline Register<double, 4> operator/(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_div_pd(left.value, right.value));
+}
+
+inline Register<double, 4> sqrt(const Register<double, 4> & reg)
+{
+    return Register<double, 4>(_mm256_sqrt_pd(reg.value));
+}
+
+inline Register<double, 4> rsqrt(const Register<double, 4> & reg)
+{
+    return Register<double, 4>::broadcast(1) / sqrt(reg);
+}
+
+inline Register<double, 4> abs(const Register<double, 4> & reg)
+{
+    return Register<double, 4>(_mm256_andnot_pd(_mm256_set1_pd(-0.), reg.value));
+}
+
+inline Register<double, 4> copysign(const Register<double, 4> & magnitude, const Register<double, 4> & sign)
+{
+    const __m256d mask = _mm256_set1_pd(-0.);
+    return Register<double, 4>(_mm256_or_pd(_mm256_andnot_pd(mask, magnitude.value), _mm256_and_pd(mask, sign.value)));
+}
+
+inline Register<double, 4> min(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_min_pd(left.value, right.value));
+}
+
+inline Register<double, 4> max(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_max_pd(left.value, right.value));
+}
+
+inline Register<double, 4> multiply_add(const Register<double, 4> & left, const Register<double, 4> & right,
+                                        const Register<double, 4> & addend)
+{
+#ifdef MATH_USE_FMA
+    return Register<double, 4>(_mm256_fmadd_pd(left.value, right.value, addend.value));
+#else
+    return Register<double, 4>(_mm256_add_pd(_mm256_mul_pd(left.value, right.value), addend.value));
+#endif
+}
+
+inline Register<double, 4> equal(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm256_cmp_pd(left.value, right.value, _CMP_EQ_OQ));
+}
+
+inline Register<double, 4> select(const Register<double, 4> & mask, const Register<double, 4> & if_true,
+                                  const Register<double, 4> & if_false)
+{
+    return Register<double, 4>(_mm256_blendv_pd(if_false.value, if_true.value, mask.value));
+}
+
+inline bool all_of(const Register<double, 4> & mask)
+{
+    return _mm256_movemask_pd(mask.value) == 0xf;
+}
+
+inline double horizontal_sum(const Register<double, 4> & reg)
+{
+    const __m128d low = _mm256_castpd256_pd128(reg.value);
+    const __m128d high = _mm256_extractf128_pd(reg.value, 1);
+    const __m128d sum = _mm_add_sd(_mm_add_sd(low, _mm_unpackhi_pd(low, low)), high);
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(high, high)));
+}
+
+// Shuffling across the two 128 bit lanes of a __m256d needs AVX2, so the
+// halves are shuffled with SSE2 and put back together
+template<size_t i0, size_t i1, size_t i2, size_t i3>
+inline Register<double, 4> shuffle(const Register<double, 4> & reg)
+{
+    const __m128d halves[2] = {_mm256_castpd256_pd128(reg.value), _mm256_extractf128_pd(reg.value, 1)};
+    const __m128d low = _mm_shuffle_pd(halves[i0 / 2], halves[i1 / 2], (i0 % 2) | (i1 % 2) << 1);
+    const __m128d high = _mm_shuffle_pd(halves[i2 / 2], halves[i3 / 2], (i2 % 2) | (i3 % 2) << 1);
+    return Register<double, 4>(_mm256_insertf128_pd(_mm256_castpd128_pd256(low), high, 1));
+}
+#elif defined(MATH_USE_SSE2)
+// Without AVX four doubles are carried in two SSE2 registers
+template<>
+struct Register<double, 4>
+{
+    static const size_t size = 4;
+
+    static Register load(const double * source) { return Register(_mm_load_pd(source), _mm_load_pd(source + 2)); }
+    static Register loadu(const double * source) { return Register(_mm_loadu_pd(source), _mm_loadu_pd(source + 2)); }
+    static Register broadcast(const double & scalar) { return Register(_mm_set1_pd(scalar), _mm_set1_pd(scalar)); }
+    static Register gather(const double * source, const size_t & stride)
+    {
+        return Register(_mm_setr_pd(source[0], source[stride]), _mm_setr_pd(source[2 * stride], source[3 * stride]));
+    }
+
+    static Register gather(const double * source, const size_t * offsets)
+    {
+        return Register(_mm_setr_pd(source[offsets[0]], source[offsets[1]]),
+                        _mm_setr_pd(source[offsets[2]], source[offsets[3]]));
+    }
+
+    void store(double * destination) const { _mm_store_pd(destination, low); _mm_store_pd(destination + 2, high); }
+    void storeu(double * destination) const { _mm_storeu_pd(destination, low); _mm_storeu_pd(destination + 2, high); }
+
+    explicit Register(const __m128d & low, const __m128d & high) : low(low), high(high) {}
+
+    __m128d low;
+    __m128d high;
+};
+
+inline Register<double, 4> operator+(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_add_pd(left.low, right.low), _mm_add_pd(left.high, right.high));
+}
+
+inline Register<double, 4> operator-(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_sub_pd(left.low, right.low), _mm_sub_pd(left.high, right.high));
+}
+
+inline Register<double, 4> operator*(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_mul_pd(left.low, right.low), _mm_mul_pd(left.high, right.high));
+}
+
+inline Register<double, 4> operator/(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_div_pd(left.low, right.low), _mm_div_pd(left.high, right.high));
+}
+
+inline Register<double, 4> sqrt(const Register<double, 4> & reg)
+{
+    return Register<double, 4>(_mm_sqrt_pd(reg.low), _mm_sqrt_pd(reg.high));
+}
+
+inline Register<double, 4> rsqrt(const Register<double, 4> & reg)
+{
+    return Register<double, 4>::broadcast(1) / sqrt(reg);
+}
+
+inline Register<double, 4> abs(const Register<double, 4> & reg)
+{
+    const __m128d mask = _mm_set1_pd(-0.);
+    return Register<double, 4>(_mm_andnot_pd(mask, reg.low), _mm_andnot_pd(mask, reg.high));
+}
+
+inline Register<double, 4> copysign(const Register<double, 4> & magnitude, const Register<double, 4> & sign)
+{
+    const __m128d mask = _mm_set1_pd(-0.);
+    return Register<double, 4>(_mm_or_pd(_mm_andnot_pd(mask, magnitude.low), _mm_and_pd(mask, sign.low)),
+                               _mm_or_pd(_mm_andnot_pd(mask, magnitude.high), _mm_and_pd(mask, sign.high)));
+}
+
+inline Register<double, 4> min(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_min_pd(left.low, right.low), _mm_min_pd(left.high, right.high));
+}
+
+inline Register<double, 4> max(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_max_pd(left.low, right.low), _mm_max_pd(left.high, right.high));
+}
+
+inline Register<double, 4> multiply_add(const Register<double, 4> & left, const Register<double, 4> & right,
+                                        const Register<double, 4> & addend)
+{
+    return Register<double, 4>(_mm_add_pd(_mm_mul_pd(left.low, right.low), addend.low),
+                               _mm_add_pd(_mm_mul_pd(left.high, right.high), addend.high));
+}
+
+inline Register<double, 4> equal(const Register<double, 4> & left, const Register<double, 4> & right)
+{
+    return Register<double, 4>(_mm_cmpeq_pd(left.low, right.low), _mm_cmpeq_pd(left.high, right.high));
+}
+
+inline Register<double, 4> select(const Register<double, 4> & mask, const Register<double, 4> & if_true,
+                                  const Register<double, 4> & if_false)
+{
+    return Register<double, 4>(_mm_or_pd(_mm_and_pd(mask.low, if_true.low), _mm_andnot_pd(mask.low, if_false.low)),
+                               _mm_or_pd(_mm_and_pd(mask.high, if_true.high), _mm_andnot_pd(mask.high, if_false.high)));
+}
+
+inline bool all_of(const Register<double, 4> & mask)
+{
+    return (_mm_movemask_pd(mask.low) & _mm_movemask_pd(mask.high)) == 0x3;
+}
+
+inline double horizontal_sum(const Register<double, 4> & reg)
+{
+    const __m128d sum = _mm_add_sd(_mm_add_sd(reg.low, _mm_unpackhi_pd(reg.low, reg.low)), reg.high);
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(reg.high, reg.high)));
+}
+
+template<size_t i0, size_t i1, size_t i2, size_t i3>
+inline Register<double, 4> shuffle(const Register<double, 4> & reg)
+{
+    const __m128d halves[2] = {reg.low, reg.high};
+    return Register<double, 4>(_mm_shuffle_pd(halves[i0 / 2], halves[i1 / 2], (i0 % 2) | (i1 % 2) << 1),
+                               _mm_shuffle_pd(halves[i2 / 2], halves[i3 / 2], (i2 % 2) | (i3 % 2) << 1));
+}
+#endif
+
+// The widest register available for Real, used by the batch kernels
+template<typename Real>
+struct Native
+{
+    typedef Register<Real, 1> type;
+};
+
+#ifdef MATH_USE_AVX
+template<>
+struct Native<float>
+{
+    typedef Register<float, 8> type;
+};
+
+template<>
+struct Native<double>
+{
+    typedef Register<double, 4> type;
+};
+#elif defined(MATH_USE_SSE2)
+template<>
+struct Native<float>
+{
+    typedef Register<float, 4> type;
+};
+
+template<>
+struct Native<double>
+{
+    typedef Register<double, 2> type;
+};
+#endif
+
+// Alignment of batch storage, enough for aligned loads of any Native register
+static const size_t batch_alignment = 32;
+
+}
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef MATH_TRANSFORM_H_INCLUDED
+#define MATH_TRANSFORM_H_INCLUDED
+
+#include "config.h"
+#include "vector3.h"
+#include "matrix4.h"
+#include "quaternion.h"
+
+#include <cassert>
+
+namespace Math
+{
+
+// A translation, a unit quaternion rotation and a uniform scale, applied to
+// a point as translation + rotation(scale * point). Composition and inverse
+// stay in this form, so a hierarchy is walked without any matrices.
+//
+// The scale is uniform because that is what keeps composition closed: a
+// rotation followed by a non-uniform scale is a shear.
+//
+// The matrix is only built when asked for, and then kept until one of the
+// parts changes. Like any other lazily filled cache, get_matrix is not safe
+// to call from several threads on the same transform.
+template<typename Real>
+class Transform
+{
+public:
+    explicit Transform();
+    explicit Transform(const Vector<Real, 3> & translation,
+                       const Quaternion<Real> & rotation = Quaternion<Real>(),
+                       const Real & scale = 1);
+
+    const Vector<Real, 3> & get_translation() const;
+    void set_translation(const Vector<Real, 3> & translation);
+
+    const Quaternion<Real> & get_rotation() const;
+    void set_rotation(const Quaternion<Real> & rotation);
+
+    const Real & get_scale() const;
+    void set_scale(const Real & scale);
+
+    const Matrix<Real, 4> & get_matrix() const;
+private:
+    Vector<Real, 3> translation;
+    Quaternion<Real> rotation;
+    Real scale;
+
+    mutable Matrix<Real, 4> matrix;
+    mutable bool matrix_dirty;
+};
+
+typedef Transform<float>  Transformf;
+typedef Transform<double> Transformd;
+
+// Composition. Like matrices, left * right applies right first.
+template<typename Real>
+Transform<Real> operator*(const Transform<Real> & left, const Transform<Real> & right);
+
+template<typename Real>
+Transform<Real> transform_inverse(const Transform<Real> & transform);
+
+template<typename Real>
+Vector<Real, 3> transform_point(const Transform<Real> & transform, const Vector<Real, 3> & point);
+
+// Rotates and scales, leaving out the translation
+template<typename Real>
+Vector<Real, 3> transform_direction(const Transform<Real> & transform, const Vector<Real, 3> & direction);
+
+#define INCLUDED_FROM_TRANSFORM_H
+#include "transform_tmpl.h"
+#undef INCLUDED_FROM_TRANSFORM_H
+
+}
+
+#endif
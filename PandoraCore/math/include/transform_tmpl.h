@@ -0,0 +1,211 @@
+#ifndef INCLUDED_FROM_TRANSFORM_H
+#error "transform_tmpl.h can only be included from transform.h"
+#else
+
+template<typename Real>
+Transform<Real>::Transform()
+    : translation(), rotation(), scale(1), matrix(), matrix_dirty(false)
+{ }
+
+template<typename Real>
+Transform<Real>::Transform(const Vector<Real, 3> & translation, const Quaternion<Real> & rotation, const Real & scale)
+    : translation(translation), rotation(rotation), scale(scale), matrix(), matrix_dirty(true)
+{ }
+
+template<typename Real>
+const Vector<Real, 3> & Transform<Real>::get_translation() const
+{
+    return translation;
+}
+
+template<typename Real>
+void Transform<Real>::set_translation(const Vector<Real, 3> & new_translation)
+{
+    translation = new_translation;
+    matrix_dirty = true;
+}
+
+template<typename Real>
+const Quaternion<Real> & Transform<Real>::get_rotation() const
+{
+    return rotation;
+}
+
+template<typename Real>
+void Transform<Real>::set_rotation(const Quaternion<Real> & new_rotation)
+{
+    rotation = new_rotation;
+    matrix_dirty = true;
+}
+
+template<typename Real>
+const Real & Transform<Real>::get_scale() const
+{
+    return scale;
+}
+
+template<typename Real>
+void Transform<Real>::set_scale(const Real & new_scale)
+{
+    scale = new_scale;
+    matrix_dirty = true;
+}
+
+// The rotation matrix with its columns scaled, and the translation as the
+// last column
+template<typename Real>
+const Matrix<Real, 4> & Transform<Real>::get_matrix() const
+{
+    if (matrix_dirty) {
+        matrix = quaternion_to_matrix(rotation);
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                matrix(i,j) *= scale;
+            }
+            matrix(i,3) = translation[i];
+        }
+        matrix_dirty = false;
+    }
+    return matrix;
+}
+
+// The translation of the result is where left takes the translation of
+// right
+template<typename Real>
+Transform<Real> operator*(const Transform<Real> & left, const Transform<Real> & right)
+{
+    return Transform<Real>(transform_point(left, right.get_translation()),
+                           left.get_rotation() * right.get_rotation(),
+                           left.get_scale() * right.get_scale());
+}
+
+template<typename Real>
+Transform<Real> transform_inverse(const Transform<Real> & transform)
+{
+    assert(transform.get_scale() != 0 && "Can not invert transform with zero scale");
+
+    const Real scale = 1 / transform.get_scale();
+    const auto rotation = quaternion_conjugate(transform.get_rotation());
+    const auto rotated = quaternion_rotate(rotation, transform.get_translation());
+    return Transform<Real>(Vector<Real, 3>(-rotated[0] * scale, -rotated[1] * scale, -rotated[2] * scale),
+                           rotation, scale);
+}
+
+template<typename Real>
+Vector<Real, 3> transform_point(const Transform<Real> & transform, const Vector<Real, 3> & point)
+{
+    const auto & translation = transform.get_translation();
+    const auto direction = transform_direction(transform, point);
+    return Vector<Real, 3>(translation[0] + direction[0],
+                           translation[1] + direction[1],
+                           translation[2] + direction[2]);
+}
+
+template<typename Real>
+Vector<Real, 3> transform_direction(const Transform<Real> & transform, const Vector<Real, 3> & direction)
+{
+    const auto rotated = quaternion_rotate(transform.get_rotation(), direction);
+    const Real scale = transform.get_scale();
+    return Vector<Real, 3>(rotated[0] * scale, rotated[1] * scale, rotated[2] * scale);
+}
+
+#ifdef MATH_USE_SSE2
+
+// Float and double keep the vectors in registers from load to store, with
+// the same operations in the same order as the generic versions
+template<typename Real>
+Simd::Register<Real, 4> simd_transform_direction(const Transform<Real> & transform,
+                                                 const Simd::Register<Real, 4> & direction)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    const auto & rotation = transform.get_rotation();
+    const reg w = reg::broadcast(rotation.w());
+    const reg imag = reg::loadu(rotation.imag.begin());
+    const reg t = reg::broadcast(2) * simd_cross_product(imag, direction);
+    return ((direction + w * t) + simd_cross_product(imag, t)) * reg::broadcast(transform.get_scale());
+}
+
+template<typename Real>
+Vector<Real, 3> simd_transform_point(const Transform<Real> & transform, const Vector<Real, 3> & point)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    Vector<Real, 3> result;
+    (reg::loadu(transform.get_translation().begin()) +
+     simd_transform_direction(transform, reg::loadu(point.begin()))).storeu(result.begin());
+    return result;
+}
+
+template<typename Real>
+Vector<Real, 3> simd_transform_direction(const Transform<Real> & transform, const Vector<Real, 3> & direction)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    Vector<Real, 3> result;
+    simd_transform_direction(transform, reg::loadu(direction.begin())).storeu(result.begin());
+    return result;
+}
+
+// The imaginary part of the product is l x r + lw r + rw l, like operator*
+// on quaternions
+template<typename Real>
+Transform<Real> simd_compose_transforms(const Transform<Real> & left, const Transform<Real> & right)
+{
+    typedef Simd::Register<Real, 4> reg;
+
+    const auto & left_rotation = left.get_rotation();
+    const auto & right_rotation = right.get_rotation();
+    const reg left_imag = reg::loadu(left_rotation.imag.begin());
+    const reg right_imag = reg::loadu(right_rotation.imag.begin());
+
+    Quaternion<Real> rotation(left_rotation.w() * right_rotation.w() -
+                              ((left_rotation.x() * right_rotation.x() + left_rotation.y() * right_rotation.y()) +
+                               left_rotation.z() * right_rotation.z()),
+                              Vector<Real, 3>());
+    ((simd_cross_product(left_imag, right_imag) + reg::broadcast(left_rotation.w()) * right_imag) +
+     reg::broadcast(right_rotation.w()) * left_imag).storeu(rotation.imag.begin());
+
+    return Transform<Real>(simd_transform_point(left, right.get_translation()), rotation,
+                           left.get_scale() * right.get_scale());
+}
+
+template<>
+inline Transform<float> operator*(const Transform<float> & left, const Transform<float> & right)
+{
+    return simd_compose_transforms(left, right);
+}
+
+template<>
+inline Transform<double> operator*(const Transform<double> & left, const Transform<double> & right)
+{
+    return simd_compose_transforms(left, right);
+}
+
+template<>
+inline Vector<float, 3> transform_point(const Transform<float> & transform, const Vector<float, 3> & point)
+{
+    return simd_transform_point(transform, point);
+}
+
+template<>
+inline Vector<double, 3> transform_point(const Transform<double> & transform, const Vector<double, 3> & point)
+{
+    return simd_transform_point(transform, point);
+}
+
+template<>
+inline Vector<float, 3> transform_direction(const Transform<float> & transform, const Vector<float, 3> & direction)
+{
+    return simd_transform_direction(transform, direction);
+}
+
+template<>
+inline Vector<double, 3> transform_direction(const Transform<double> & transform, const Vector<double, 3> & direction)
+{
+    return simd_transform_direction(transform, direction);
+}
+
+#endif
+
+#endif
@@ -2,9 +2,12 @@
 #define MATH_VECTOR_H_INCLUDED
 
 #include "config.h"
+#include "simd.h"
+#include "expression.h"
+#include "indices.h"
 
 #include <assert.h>
-#include <array>
+#include <cmath>
 #include <initializer_list>
 #include <algorithm>
 
@@ -15,70 +18,119 @@ template<typename Real, size_t dim>
 struct Vector
 {
 public:
-    explicit Vector();
+    constexpr explicit Vector();
     explicit Vector(std::initializer_list<Real> arguments);
-    explicit Vector(const Real array[dim]);
+    constexpr explicit Vector(const Real array[dim]);
+
+    // One argument per element. Unlike the initializer list this can be
+    // used in constant expressions.
+    template<typename... Elements,
+             typename = typename std::enable_if<sizeof...(Elements) + 1 == dim>::type>
+    constexpr explicit Vector(const Real & first, const Elements & ... rest);
+
+    template<typename Expression>
+    constexpr Vector(const Expression & expression,
+                     typename EnableIfExpressionOf<Expression, Vector>::type * = nullptr);
 
     Vector& operator=(const Real array[dim]);
 
+    template<typename Expression>
+    typename EnableIfExpressionOf<Expression, Vector, Vector &>::type
+    operator=(const Expression & expression);
+
     const Real* begin() const;
     const Real* end() const;
     Real* begin();
     Real* end();
 
     Real & operator[](const size_t & i);
-    Real operator[](const size_t & i) const;
+    constexpr Real operator[](const size_t & i) const;
 private:
-    std::array<Real, dim> data;
+    template<typename Elements, size_t... indices>
+    constexpr Vector(const Elements & elements, Indices<indices...>);
+
+    void clear_padding();
+
+    alignas(Simd::VectorStorage<Real, dim>::alignment)
+    Real data[Simd::VectorStorage<Real, dim>::size];
 };
 
-template<typename Real, size_t dim>
-Real vector_length(const Vector<Real, dim> & vector);
+template<typename T>
+struct IsVector : std::false_type
+{ };
 
 template<typename Real, size_t dim>
-Real vector_length_squared(const Vector<Real, dim> & vector);
+struct IsVector<Vector<Real, dim> > : std::true_type
+{ };
 
+// Vectors are the leaves of vector expressions
 template<typename Real, size_t dim>
-Vector<Real, dim> normalize_vector(Vector<Real, dim> & vector);
+struct ExpressionTraits<Vector<Real, dim> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = true;
+    static const size_t storage_size = Simd::VectorStorage<Real, dim>::size;
+    typedef Vector<Real, dim> result_type;
+    typedef Real real_type;
+    typedef DivideByScalar scalar_division;
+};
 
-template<typename Real, size_t dim>
-Real dot_product(const Vector<Real, dim> & left, const Vector<Real, dim> & right);
+template<typename Register, typename Real, size_t dim>
+Register expression_packet(const Vector<Real, dim> & vector, const size_t & offset);
 
-template<typename Real, size_t dim>
-Vector<Real, dim> & operator+=(Vector<Real, dim> & to, const Vector<Real, dim> & from);
+// The results of the operators are evaluated a register at a time, straight
+// into the padded storage
+template<typename Real, size_t dim, typename Expression>
+Vector<Real, dim> evaluate_operator(const Expression & expression, const Vector<Real, dim> *);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> & operator-=(Vector<Real, dim> & to, const Vector<Real, dim> & from);
+Real vector_length(const Vector<Real, dim> & vector);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> & operator*=(Vector<Real, dim> & to, const Vector<Real, dim> & from);
+Real vector_length_squared(const Vector<Real, dim> & vector);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> & operator*=(Vector<Real, dim> & to, const Real & scalar);
+Vector<Real, dim> normalize_vector(Vector<Real, dim> & vector);
 
+// Scales by Simd::rsqrt of the squared length instead of dividing by the
+// length. Float vectors end up within 5e-7 of unit length, doubles are
+// exact but still save a division per element.
 template<typename Real, size_t dim>
-Vector<Real, dim> & operator/=(Vector<Real, dim> & to, const Real & scalar);
+Vector<Real, dim> normalize_vector_fast(Vector<Real, dim> & vector);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> operator-(const Vector<Real, dim> & vector);
+Real dot_product(const Vector<Real, dim> & left, const Vector<Real, dim> & right);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> operator+(const Vector<Real, dim> & left, const Vector<Real, dim> & right);
-template<typename Real, size_t dim>
-Vector<Real, dim> operator-(const Vector<Real, dim> & left, const Vector<Real, dim> & right);
+Vector<Real, dim> & operator+=(Vector<Real, dim> & to, const Vector<Real, dim> & from);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Vector<Real, dim> & left, const Vector<Real, dim> & right);
+Vector<Real, dim> & operator-=(Vector<Real, dim> & to, const Vector<Real, dim> & from);
+
+template<typename Real, size_t dim, typename Expression>
+typename EnableIfExpressionOf<Expression, Vector<Real, dim>, Vector<Real, dim> &>::type
+operator+=(Vector<Real, dim> & to, const Expression & from);
+
+template<typename Real, size_t dim, typename Expression>
+typename EnableIfExpressionOf<Expression, Vector<Real, dim>, Vector<Real, dim> &>::type
+operator-=(Vector<Real, dim> & to, const Expression & from);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Real & scalar);
+Vector<Real, dim> & operator*=(Vector<Real, dim> & to, const Vector<Real, dim> & from);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Real & scalar, const Vector<Real, dim> & vector);
+Vector<Real, dim> & operator*=(Vector<Real, dim> & to, const Real & scalar);
 
 template<typename Real, size_t dim>
-Vector<Real, dim> operator/(const Vector<Real, dim> & vector, const Real & scalar);
+Vector<Real, dim> & operator/=(Vector<Real, dim> & to, const Real & scalar);
 
+// The element wise +, -, scaling and division by a scalar come from
+// expression.h. The component wise product is only defined for vectors.
+template<typename Left, typename Right>
+constexpr typename EnableIfCompatible<Left, Right,
+    typename std::enable_if<IsVector<typename ExpressionResult<Left>::type>::value,
+                            typename BinaryOperatorType<MultiplyOperation, Left, Right>::type>::type>::type
+operator*(Left && left, Right && right);
 
 template<typename Real, size_t dim>
 bool operator==(const Vector<Real, dim> & left, const Vector<Real, dim> & right);
@@ -88,6 +140,7 @@ bool operator!=(const Vector<Real, dim> & left, const Vector<Real, dim> & right)
 
 #define INCLUDED_FROM_VECTOR_H
 #include "vector_tmpl.h"
+#include "vector_simd_tmpl.h"
 #undef INCLUDED_FROM_VECTOR_H
 
 }
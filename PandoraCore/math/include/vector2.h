@@ -24,6 +24,14 @@ void generate_orthonormal_basis(Vector<Real, 2> & vector1, Vector<Real, 2> & vec
 #include "vector2_tmpl.h"
 #undef INCLUDED_FROM_VECTOR2_H
 
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Vector<float, 2>;
+extern template struct Vector<double, 2>;
+extern template void generate_orthonormal_basis(Vector<float, 2> &, Vector<float, 2> &);
+extern template void generate_orthonormal_basis(Vector<double, 2> &, Vector<double, 2> &);
+#endif
+
 }
 
 #endif
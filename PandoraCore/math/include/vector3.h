@@ -23,6 +23,14 @@ void generate_orthonormal_basis(Vector<Real, 3> & vector1,
 #include "vector3_tmpl.h"
 #undef INCLUDED_FROM_VECTOR3_H
 
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Vector<float, 3>;
+extern template struct Vector<double, 3>;
+extern template void generate_orthonormal_basis(Vector<float, 3> &, Vector<float, 3> &, Vector<float, 3> &);
+extern template void generate_orthonormal_basis(Vector<double, 3> &, Vector<double, 3> &, Vector<double, 3> &);
+#endif
+
 }
 
 #endif
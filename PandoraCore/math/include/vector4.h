@@ -11,6 +11,12 @@ typedef Vector<double,   4> Vec4d;
 typedef Vector<int,      4> Vec4i;
 typedef Vector<uint32_t, 4> Vec4u;
 
+// Instantiated in the library, see config.h
+#ifndef MATH_HEADER_ONLY
+extern template struct Vector<float, 4>;
+extern template struct Vector<double, 4>;
+#endif
+
 }
 
 #endif
@@ -0,0 +1,172 @@
+#ifndef MATH_VECTOR_REF_H_INCLUDED
+#define MATH_VECTOR_REF_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "expression.h"
+#include "vector.h"
+#include "vector3.h"
+
+#include <assert.h>
+#include <type_traits>
+
+namespace Math
+{
+
+// A vector of dim elements in memory owned by someone else, a file loader,
+// a mapped file or another library, stride elements apart. VectorRef<const
+// Real, dim> is the read-only view.
+//
+// A view behaves like a reference: assigning to it writes the elements it
+// views, and copying it copies the view, not the elements. It takes part
+// in the vector expressions, and the functions below take views and vectors
+// in any mix, so nothing has to be copied into a Vector first.
+template<typename Real, size_t dim>
+class VectorRef
+{
+public:
+    typedef typename std::remove_const<Real>::type value_type;
+    typedef typename std::conditional<std::is_const<Real>::value,
+                                      const Vector<value_type, dim>, Vector<value_type, dim> >::type vector_type;
+
+    explicit VectorRef(Real * data, const size_t & stride = 1);
+    VectorRef(vector_type & vector);
+
+    // A view converts to the read-only view of the same elements
+    template<typename Other,
+             typename = typename std::enable_if<std::is_same<const Other, Real>::value>::type>
+    VectorRef(const VectorRef<Other, dim> & other);
+
+    // Copies the view, where assignment copies the elements
+    VectorRef(const VectorRef & other) = default;
+    const VectorRef & operator=(const VectorRef & other) const;
+
+    template<typename Expression>
+    typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Vector<value_type, dim> >::value,
+                            const VectorRef &>::type
+    operator=(const Expression & expression) const;
+
+    Real * get_data() const;
+    const size_t & get_stride() const;
+
+    Real & operator[](const size_t & i) const;
+
+    operator Vector<value_type, dim>() const;
+private:
+    Real * elements;
+    size_t stride;
+};
+
+// Views are leaves of vector expressions, evaluating to a Vector
+template<typename Real, size_t dim>
+struct ExpressionTraits<VectorRef<Real, dim> >
+{
+    static const bool is_expression = true;
+    static const bool is_leaf = true;
+    static const size_t storage_size = dim;
+    typedef Vector<typename std::remove_const<Real>::type, dim> result_type;
+    typedef typename std::remove_const<Real>::type real_type;
+    typedef DivideByScalar scalar_division;
+};
+
+// Reads straight from the viewed memory, and zeros for the padding of the
+// vector being assigned to, which is past the end of the view
+template<typename Register, typename Real, size_t dim>
+Register expression_packet(const VectorRef<Real, dim> & vector, const size_t & offset);
+
+// What a vector or a view of one looks like to the functions below
+template<typename T>
+struct VectorOperand
+{
+    static const bool value = false;
+    static const bool is_view = false;
+};
+
+template<typename Real, size_t dim_>
+struct VectorOperand<Vector<Real, dim_> >
+{
+    static const bool value = true;
+    static const bool is_view = false;
+    static const size_t dim = dim_;
+    typedef Real real_type;
+};
+
+template<typename Real, size_t dim_>
+struct VectorOperand<VectorRef<Real, dim_> >
+{
+    static const bool value = true;
+    static const bool is_view = true;
+    static const size_t dim = dim_;
+    typedef typename std::remove_const<Real>::type real_type;
+};
+
+// Enabled for a view and a vector, or two views, of the same type and size.
+// Two vectors keep using the functions of vector.h.
+template<typename Left, typename Right, typename Type,
+         bool = VectorOperand<Left>::value && VectorOperand<Right>::value &&
+                (VectorOperand<Left>::is_view || VectorOperand<Right>::is_view)>
+struct EnableIfVectorViews
+{ };
+
+template<typename Left, typename Right, typename Type>
+struct EnableIfVectorViews<Left, Right, Type, true>
+    : std::enable_if<std::is_same<typename VectorOperand<Left>::real_type,
+                                  typename VectorOperand<Right>::real_type>::value &&
+                     VectorOperand<Left>::dim == VectorOperand<Right>::dim, Type>
+{ };
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, typename VectorOperand<Left>::real_type>::type
+dot_product(const Left & left, const Right & right);
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, Vector<typename VectorOperand<Left>::real_type, 3> >::type
+cross_product(const Left & left, const Right & right);
+
+template<typename Real, size_t dim>
+typename std::remove_const<Real>::type vector_length(const VectorRef<Real, dim> & vector);
+
+template<typename Real, size_t dim>
+typename std::remove_const<Real>::type vector_length_squared(const VectorRef<Real, dim> & vector);
+
+// Normalizes the viewed elements
+template<typename Real, size_t dim>
+Vector<Real, dim> normalize_vector(const VectorRef<Real, dim> & vector);
+
+template<typename Real, size_t dim, typename Expression>
+typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Vector<Real, dim> >::value,
+                        const VectorRef<Real, dim> &>::type
+operator+=(const VectorRef<Real, dim> & to, const Expression & from);
+
+template<typename Real, size_t dim, typename Expression>
+typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Vector<Real, dim> >::value,
+                        const VectorRef<Real, dim> &>::type
+operator-=(const VectorRef<Real, dim> & to, const Expression & from);
+
+template<typename Real, size_t dim>
+const VectorRef<Real, dim> & operator*=(const VectorRef<Real, dim> & to, const Real & scalar);
+
+template<typename Real, size_t dim>
+const VectorRef<Real, dim> & operator/=(const VectorRef<Real, dim> & to, const Real & scalar);
+
+template<typename Real, size_t dim, typename Other>
+Vector<Real, dim> & operator+=(Vector<Real, dim> & to, const VectorRef<Other, dim> & from);
+
+template<typename Real, size_t dim, typename Other>
+Vector<Real, dim> & operator-=(Vector<Real, dim> & to, const VectorRef<Other, dim> & from);
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, bool>::type
+operator==(const Left & left, const Right & right);
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, bool>::type
+operator!=(const Left & left, const Right & right);
+
+#define INCLUDED_FROM_VECTOR_REF_H
+#include "vector_ref_tmpl.h"
+#undef INCLUDED_FROM_VECTOR_REF_H
+
+}
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef INCLUDED_FROM_VECTOR_REF_H
+#error "vector_ref_tmpl.h should only be included from vector_ref.h"
+#else
+
+template<typename Real, size_t dim>
+inline VectorRef<Real, dim>::VectorRef(Real * data, const size_t & stride)
+    : elements(data), stride(stride)
+{
+    assert(data && "Can not view a null pointer");
+    assert(stride != 0 && "Can not view vector with a stride of zero");
+}
+
+template<typename Real, size_t dim>
+inline VectorRef<Real, dim>::VectorRef(vector_type & vector)
+    : elements(vector.begin()), stride(1)
+{
+}
+
+template<typename Real, size_t dim>
+template<typename Other, typename>
+inline VectorRef<Real, dim>::VectorRef(const VectorRef<Other, dim> & other)
+    : elements(other.get_data()), stride(other.get_stride())
+{
+}
+
+template<typename Real, size_t dim>
+inline const VectorRef<Real, dim> & VectorRef<Real, dim>::operator=(const VectorRef & other) const
+{
+    return operator=<VectorRef>(other);
+}
+
+// Element i is only read when element i is written, like assign_expression
+template<typename Real, size_t dim>
+template<typename Expression>
+typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type,
+                                     Vector<typename VectorRef<Real, dim>::value_type, dim> >::value,
+                        const VectorRef<Real, dim> &>::type
+VectorRef<Real, dim>::operator=(const Expression & expression) const
+{
+    for (size_t i = 0; i < dim; ++i) {
+        elements[i*stride] = expression[i];
+    }
+    return *this;
+}
+
+template<typename Real, size_t dim>
+inline Real * VectorRef<Real, dim>::get_data() const
+{
+    return elements;
+}
+
+template<typename Real, size_t dim>
+inline const size_t & VectorRef<Real, dim>::get_stride() const
+{
+    return stride;
+}
+
+template<typename Real, size_t dim>
+inline Real & VectorRef<Real, dim>::operator[](const size_t & i) const
+{
+    assert(i < dim && "Index operator out of range");
+    return elements[i*stride];
+}
+
+template<typename Real, size_t dim>
+inline VectorRef<Real, dim>::operator Vector<value_type, dim>() const
+{
+    Vector<value_type, dim> vector;
+    for (size_t i = 0; i < dim; ++i) {
+        vector[i] = elements[i*stride];
+    }
+    return vector;
+}
+
+template<typename Register, typename Real, size_t dim>
+inline Register expression_packet(const VectorRef<Real, dim> & vector, const size_t & offset)
+{
+    typedef typename VectorRef<Real, dim>::value_type value_type;
+
+    const size_t & stride = vector.get_stride();
+    if (offset + Register::size <= dim) {
+        return stride == 1 ? Register::loadu(vector.get_data() + offset)
+                           : Register::gather(vector.get_data() + offset*stride, stride);
+    }
+
+    value_type lanes[Register::size];
+    for (size_t j = 0; j < Register::size; ++j) {
+        lanes[j] = offset + j < dim ? vector.get_data()[(offset + j)*stride] : value_type(0);
+    }
+    return Register::loadu(lanes);
+}
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, typename VectorOperand<Left>::real_type>::type
+dot_product(const Left & left, const Right & right)
+{
+    typename VectorOperand<Left>::real_type result = 0;
+    for (size_t i = 0; i < VectorOperand<Left>::dim; ++i) {
+        result += left[i] * right[i];
+    }
+    return result;
+}
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, Vector<typename VectorOperand<Left>::real_type, 3> >::type
+cross_product(const Left & left, const Right & right)
+{
+    static_assert(VectorOperand<Left>::dim == 3, "The cross product is only defined for three dimensional vectors");
+
+    Vector<typename VectorOperand<Left>::real_type, 3> result;
+
+    result[0] = left[1]*right[2] - left[2]*right[1];
+    result[1] = left[2]*right[0] - left[0]*right[2];
+    result[2] = left[0]*right[1] - left[1]*right[0];
+
+    return result;
+}
+
+template<typename Real, size_t dim>
+typename std::remove_const<Real>::type vector_length(const VectorRef<Real, dim> & vector)
+{
+    return std::sqrt(vector_length_squared(vector));
+}
+
+template<typename Real, size_t dim>
+typename std::remove_const<Real>::type vector_length_squared(const VectorRef<Real, dim> & vector)
+{
+    return dot_product(vector, vector);
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> normalize_vector(const VectorRef<Real, dim> & vector)
+{
+    Real length = vector_length(vector);
+
+    assert(length != 0 && "Can not normalize zero vector");
+
+    vector /= length;
+    return vector;
+}
+
+template<typename Real, size_t dim, typename Expression>
+typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Vector<Real, dim> >::value,
+                        const VectorRef<Real, dim> &>::type
+operator+=(const VectorRef<Real, dim> & to, const Expression & from)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        to[i] += from[i];
+    }
+    return to;
+}
+
+template<typename Real, size_t dim, typename Expression>
+typename std::enable_if<std::is_same<typename ExpressionResult<Expression>::type, Vector<Real, dim> >::value,
+                        const VectorRef<Real, dim> &>::type
+operator-=(const VectorRef<Real, dim> & to, const Expression & from)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        to[i] -= from[i];
+    }
+    return to;
+}
+
+template<typename Real, size_t dim>
+const VectorRef<Real, dim> & operator*=(const VectorRef<Real, dim> & to, const Real & scalar)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        to[i] *= scalar;
+    }
+    return to;
+}
+
+template<typename Real, size_t dim>
+const VectorRef<Real, dim> & operator/=(const VectorRef<Real, dim> & to, const Real & scalar)
+{
+    assert(scalar != 0 && "Can not divide vector by zero");
+    for (size_t i = 0; i < dim; ++i) {
+        to[i] /= scalar;
+    }
+    return to;
+}
+
+template<typename Real, size_t dim, typename Other>
+Vector<Real, dim> & operator+=(Vector<Real, dim> & to, const VectorRef<Other, dim> & from)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        to[i] += from[i];
+    }
+    return to;
+}
+
+template<typename Real, size_t dim, typename Other>
+Vector<Real, dim> & operator-=(Vector<Real, dim> & to, const VectorRef<Other, dim> & from)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        to[i] -= from[i];
+    }
+    return to;
+}
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, bool>::type
+operator==(const Left & left, const Right & right)
+{
+    for (size_t i = 0; i < VectorOperand<Left>::dim; ++i) {
+        if (left[i] != right[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Left, typename Right>
+typename EnableIfVectorViews<Left, Right, bool>::type
+operator!=(const Left & left, const Right & right)
+{
+    return !(left == right);
+}
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef INCLUDED_FROM_VECTOR_H
+#error "vector_simd_tmpl.h should only be included from vector.h"
+#else
+
+// Register backed versions of the vector operations. They are used for the
+// float and double vectors whose (padded) storage fills a whole register,
+// and give bit for bit the same results as the generic loops.
+
+template<typename Real, size_t dim>
+struct VectorRegister
+{
+    typedef Simd::Register<Real, Simd::VectorStorage<Real, dim>::size> type;
+};
+
+template<typename Real, size_t dim>
+Vector<Real, dim> & simd_add_assign(Vector<Real, dim> & to, const Vector<Real, dim> & from)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    (reg::loadu(to.begin()) + reg::loadu(from.begin())).storeu(to.begin());
+    return to;
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> & simd_subtract_assign(Vector<Real, dim> & to, const Vector<Real, dim> & from)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    (reg::loadu(to.begin()) - reg::loadu(from.begin())).storeu(to.begin());
+    return to;
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> & simd_multiply_assign(Vector<Real, dim> & to, const Vector<Real, dim> & from)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    (reg::loadu(to.begin()) * reg::loadu(from.begin())).storeu(to.begin());
+    return to;
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> & simd_scale_assign(Vector<Real, dim> & to, const Real & scalar)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    (reg::loadu(to.begin()) * reg::broadcast(scalar)).storeu(to.begin());
+    return to;
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> & simd_divide_assign(Vector<Real, dim> & to, const Real & scalar)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    assert(scalar != 0 && "Can not divide vector by zero");
+    (reg::loadu(to.begin()) / reg::broadcast(scalar)).storeu(to.begin());
+    return to;
+}
+
+template<typename Real, size_t dim>
+Real simd_dot_product(const Vector<Real, dim> & left, const Vector<Real, dim> & right)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    return Simd::horizontal_sum(reg::loadu(left.begin()) * reg::loadu(right.begin()));
+}
+
+// The elements are loaded once, for the length and for the division
+template<typename Real, size_t dim>
+Vector<Real, dim> simd_normalize_vector(Vector<Real, dim> & vector)
+{
+    typedef typename VectorRegister<Real, dim>::type reg;
+    const reg elements = reg::loadu(vector.begin());
+    const Real length = std::sqrt(Simd::horizontal_sum(elements * elements));
+
+    assert(length != 0 && "Can not normalize zero vector");
+
+    (elements / reg::broadcast(length)).storeu(vector.begin());
+    return vector;
+}
+
+#ifdef MATH_USE_SSE2
+
+template<>
+inline Vector<float, 3> & operator+=(Vector<float, 3> & to, const Vector<float, 3> & from)
+{
+    return simd_add_assign(to, from);
+}
+
+template<>
+inline Vector<float, 3> & operator-=(Vector<float, 3> & to, const Vector<float, 3> & from)
+{
+    return simd_subtract_assign(to, from);
+}
+
+template<>
+inline Vector<float, 3> & operator*=(Vector<float, 3> & to, const Vector<float, 3> & from)
+{
+    return simd_multiply_assign(to, from);
+}
+
+template<>
+inline Vector<float, 3> & operator*=(Vector<float, 3> & to, const float & scalar)
+{
+    return simd_scale_assign(to, scalar);
+}
+
+template<>
+inline Vector<float, 3> & operator/=(Vector<float, 3> & to, const float & scalar)
+{
+    return simd_divide_assign(to, scalar);
+}
+
+template<>
+inline float dot_product(const Vector<float, 3> & left, const Vector<float, 3> & right)
+{
+    return simd_dot_product(left, right);
+}
+
+template<>
+inline Vector<float, 3> normalize_vector(Vector<float, 3> & vector)
+{
+    return simd_normalize_vector(vector);
+}
+
+template<>
+inline Vector<float, 4> & operator+=(Vector<float, 4> & to, const Vector<float, 4> & from)
+{
+    return simd_add_assign(to, from);
+}
+
+template<>
+inline Vector<float, 4> & operator-=(Vector<float, 4> & to, const Vector<float, 4> & from)
+{
+    return simd_subtract_assign(to, from);
+}
+
+template<>
+inline Vector<float, 4> & operator*=(Vector<float, 4> & to, const Vector<float, 4> & from)
+{
+    return simd_multiply_assign(to, from);
+}
+
+template<>
+inline Vector<float, 4> & operator*=(Vector<float, 4> & to, const float & scalar)
+{
+    return simd_scale_assign(to, scalar);
+}
+
+template<>
+inline Vector<float, 4> & operator/=(Vector<float, 4> & to, const float & scalar)
+{
+    return simd_divide_assign(to, scalar);
+}
+
+template<>
+inline float dot_product(const Vector<float, 4> & left, const Vector<float, 4> & right)
+{
+    return simd_dot_product(left, right);
+}
+
+template<>
+inline Vector<float, 4> normalize_vector(Vector<float, 4> & vector)
+{
+    return simd_normalize_vector(vector);
+}
+
+template<>
+inline Vector<double, 2> & operator+=(Vector<double, 2> & to, const Vector<double, 2> & from)
+{
+    return simd_add_assign(to, from);
+}
+
+template<>
+inline Vector<double, 2> & operator-=(Vector<double, 2> & to, const Vector<double, 2> & from)
+{
+    return simd_subtract_assign(to, from);
+}
+
+template<>
+inline Vector<double, 2> & operator*=(Vector<double, 2> & to, const Vector<double, 2> & from)
+{
+    return simd_multiply_assign(to, from);
+}
+
+template<>
+inline Vector<double, 2> & operator*=(Vector<double, 2> & to, const double & scalar)
+{
+    return simd_scale_assign(to, scalar);
+}
+
+template<>
+inline Vector<double, 2> & operator/=(Vector<double, 2> & to, const double & scalar)
+{
+    return simd_divide_assign(to, scalar);
+}
+
+template<>
+inline double dot_product(const Vector<double, 2> & left, const Vector<double, 2> & right)
+{
+    return simd_dot_product(left, right);
+}
+
+template<>
+inline Vector<double, 2> normalize_vector(Vector<double, 2> & vector)
+{
+    return simd_normalize_vector(vector);
+}
+
+template<>
+inline Vector<double, 3> & operator+=(Vector<double, 3> & to, const Vector<double, 3> & from)
+{
+    return simd_add_assign(to, from);
+}
+
+template<>
+inline Vector<double, 3> & operator-=(Vector<double, 3> & to, const Vector<double, 3> & from)
+{
+    return simd_subtract_assign(to, from);
+}
+
+template<>
+inline Vector<double, 3> & operator*=(Vector<double, 3> & to, const Vector<double, 3> & from)
+{
+    return simd_multiply_assign(to, from);
+}
+
+template<>
+inline Vector<double, 3> & operator*=(Vector<double, 3> & to, const double & scalar)
+{
+    return simd_scale_assign(to, scalar);
+}
+
+template<>
+inline Vector<double, 3> & operator/=(Vector<double, 3> & to, const double & scalar)
+{
+    return simd_divide_assign(to, scalar);
+}
+
+template<>
+inline double dot_product(const Vector<double, 3> & left, const Vector<double, 3> & right)
+{
+    return simd_dot_product(left, right);
+}
+
+template<>
+inline Vector<double, 3> normalize_vector(Vector<double, 3> & vector)
+{
+    return simd_normalize_vector(vector);
+}
+
+template<>
+inline Vector<double, 4> & operator+=(Vector<double, 4> & to, const Vector<double, 4> & from)
+{
+    return simd_add_assign(to, from);
+}
+
+template<>
+inline Vector<double, 4> & operator-=(Vector<double, 4> & to, const Vector<double, 4> & from)
+{
+    return simd_subtract_assign(to, from);
+}
+
+template<>
+inline Vector<double, 4> & operator*=(Vector<double, 4> & to, const Vector<double, 4> & from)
+{
+    return simd_multiply_assign(to, from);
+}
+
+template<>
+inline Vector<double, 4> & operator*=(Vector<double, 4> & to, const double & scalar)
+{
+    return simd_scale_assign(to, scalar);
+}
+
+template<>
+inline Vector<double, 4> & operator/=(Vector<double, 4> & to, const double & scalar)
+{
+    return simd_divide_assign(to, scalar);
+}
+
+template<>
+inline double dot_product(const Vector<double, 4> & left, const Vector<double, 4> & right)
+{
+    return simd_dot_product(left, right);
+}
+
+template<>
+inline Vector<double, 4> normalize_vector(Vector<double, 4> & vector)
+{
+    return simd_normalize_vector(vector);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef MATH_VECTOR_SOA_H_INCLUDED
+#define MATH_VECTOR_SOA_H_INCLUDED
+
+#include "config.h"
+#include "simd.h"
+#include "aligned_allocator.h"
+#include "vector.h"
+
+#include <array>
+#include <vector>
+
+namespace Math
+{
+
+// A batch of vectors stored as one contiguous, aligned array per component.
+// Elements are read and written as Vector<Real, dim> through gather/scatter
+// or the element proxies, so code can move over to the batch kernels below
+// one loop at a time.
+template<typename Real, size_t dim>
+struct VectorSoA
+{
+public:
+    typedef std::vector<Real, AlignedAllocator<Real, Simd::batch_alignment> > Component;
+
+    struct Reference
+    {
+    public:
+        Reference & operator=(const Vector<Real, dim> & vector);
+        operator Vector<Real, dim>() const;
+
+        Real & operator[](const size_t & i);
+        Real operator[](const size_t & i) const;
+    private:
+        friend struct VectorSoA;
+        Reference(VectorSoA & soa, const size_t & index);
+
+        VectorSoA & soa;
+        size_t index;
+    };
+
+    explicit VectorSoA();
+    explicit VectorSoA(const size_t & size);
+    explicit VectorSoA(const Vector<Real, dim> * vectors, const size_t & count);
+
+    size_t size() const;
+    void resize(const size_t & size);
+    void reserve(const size_t & size);
+    void clear();
+    void push_back(const Vector<Real, dim> & vector);
+
+    Real * component(const size_t & i);
+    const Real * component(const size_t & i) const;
+
+    Vector<Real, dim> get(const size_t & index) const;
+    void set(const size_t & index, const Vector<Real, dim> & vector);
+
+    Reference operator[](const size_t & index);
+    Vector<Real, dim> operator[](const size_t & index) const;
+
+    void gather(const size_t * indices, const size_t & count, Vector<Real, dim> * vectors) const;
+    void scatter(const size_t * indices, const size_t & count, const Vector<Real, dim> * vectors);
+private:
+    std::array<Component, dim> components;
+};
+
+// Conversion between arrays of vectors and the batch layout
+template<typename Real, size_t dim>
+void aos_to_soa(const Vector<Real, dim> * vectors, const size_t & count, VectorSoA<Real, dim> & soa);
+
+template<typename Real, size_t dim>
+void soa_to_aos(const VectorSoA<Real, dim> & soa, Vector<Real, dim> * vectors);
+
+// Batch kernels, applied element by element over equally sized batches
+template<typename Real, size_t dim>
+VectorSoA<Real, dim> & operator+=(VectorSoA<Real, dim> & to, const VectorSoA<Real, dim> & from);
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim> & operator*=(VectorSoA<Real, dim> & to, const Real & scalar);
+
+// to += scalar * from
+template<typename Real, size_t dim>
+VectorSoA<Real, dim> & axpy(VectorSoA<Real, dim> & to, const Real & scalar, const VectorSoA<Real, dim> & from);
+
+template<typename Real, size_t dim>
+void dot_product(const VectorSoA<Real, dim> & left, const VectorSoA<Real, dim> & right, Real * result);
+
+template<typename Real>
+void cross_product(const VectorSoA<Real, 3> & left, const VectorSoA<Real, 3> & right, VectorSoA<Real, 3> & result);
+
+template<typename Real, size_t dim>
+void vector_length(const VectorSoA<Real, dim> & vectors, Real * result);
+
+// Zero vectors have no direction, and are left with non finite components
+template<typename Real, size_t dim>
+void normalize_vector(VectorSoA<Real, dim> & vectors);
+
+// Gives the same as normalize_vector_fast on each vector
+template<typename Real, size_t dim>
+void normalize_vector_fast(VectorSoA<Real, dim> & vectors);
+
+#define INCLUDED_FROM_VECTOR_SOA_H
+#include "vector_soa_tmpl.h"
+#undef INCLUDED_FROM_VECTOR_SOA_H
+
+}
+
+#endif
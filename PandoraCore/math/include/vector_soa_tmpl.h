@@ -0,0 +1,388 @@
+#ifndef INCLUDED_FROM_VECTOR_SOA_H
+#error "vector_soa_tmpl.h should only be included from vector_soa.h"
+#else
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim>::Reference::Reference(VectorSoA & soa, const size_t & index)
+    : soa(soa), index(index)
+{ }
+
+template<typename Real, size_t dim>
+typename VectorSoA<Real, dim>::Reference & VectorSoA<Real, dim>::Reference::operator=(const Vector<Real, dim> & vector)
+{
+    soa.set(index, vector);
+    return *this;
+}
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim>::Reference::operator Vector<Real, dim>() const
+{
+    return soa.get(index);
+}
+
+template<typename Real, size_t dim>
+Real & VectorSoA<Real, dim>::Reference::operator[](const size_t & i)
+{
+    assert(i < dim && "Index operator out of range");
+    return soa.components[i][index];
+}
+
+template<typename Real, size_t dim>
+Real VectorSoA<Real, dim>::Reference::operator[](const size_t & i) const
+{
+    assert(i < dim && "Index operator out of range");
+    return soa.components[i][index];
+}
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim>::VectorSoA()
+{ }
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim>::VectorSoA(const size_t & size)
+{
+    resize(size);
+}
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim>::VectorSoA(const Vector<Real, dim> * vectors, const size_t & count)
+{
+    aos_to_soa(vectors, count, *this);
+}
+
+template<typename Real, size_t dim>
+size_t VectorSoA<Real, dim>::size() const
+{
+    return components[0].size();
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::resize(const size_t & size)
+{
+    for (auto & component : components) {
+        component.resize(size);
+    }
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::reserve(const size_t & size)
+{
+    for (auto & component : components) {
+        component.reserve(size);
+    }
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::clear()
+{
+    for (auto & component : components) {
+        component.clear();
+    }
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::push_back(const Vector<Real, dim> & vector)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        components[i].push_back(vector[i]);
+    }
+}
+
+template<typename Real, size_t dim>
+Real * VectorSoA<Real, dim>::component(const size_t & i)
+{
+    assert(i < dim && "Component out of range");
+    return components[i].data();
+}
+
+template<typename Real, size_t dim>
+const Real * VectorSoA<Real, dim>::component(const size_t & i) const
+{
+    assert(i < dim && "Component out of range");
+    return components[i].data();
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> VectorSoA<Real, dim>::get(const size_t & index) const
+{
+    assert(index < size() && "Index operator out of range");
+    Vector<Real, dim> vector;
+    for (size_t i = 0; i < dim; ++i) {
+        vector[i] = components[i][index];
+    }
+    return vector;
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::set(const size_t & index, const Vector<Real, dim> & vector)
+{
+    assert(index < size() && "Index operator out of range");
+    for (size_t i = 0; i < dim; ++i) {
+        components[i][index] = vector[i];
+    }
+}
+
+template<typename Real, size_t dim>
+typename VectorSoA<Real, dim>::Reference VectorSoA<Real, dim>::operator[](const size_t & index)
+{
+    assert(index < size() && "Index operator out of range");
+    return Reference(*this, index);
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> VectorSoA<Real, dim>::operator[](const size_t & index) const
+{
+    return get(index);
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::gather(const size_t * indices, const size_t & count, Vector<Real, dim> * vectors) const
+{
+    for (size_t i = 0; i < count; ++i) {
+        vectors[i] = get(indices[i]);
+    }
+}
+
+template<typename Real, size_t dim>
+void VectorSoA<Real, dim>::scatter(const size_t * indices, const size_t & count, const Vector<Real, dim> * vectors)
+{
+    for (size_t i = 0; i < count; ++i) {
+        set(indices[i], vectors[i]);
+    }
+}
+
+template<typename Real, size_t dim>
+void aos_to_soa(const Vector<Real, dim> * vectors, const size_t & count, VectorSoA<Real, dim> & soa)
+{
+    soa.resize(count);
+    for (size_t i = 0; i < dim; ++i) {
+        auto component = soa.component(i);
+        for (size_t j = 0; j < count; ++j) {
+            component[j] = vectors[j][i];
+        }
+    }
+}
+
+template<typename Real, size_t dim>
+void soa_to_aos(const VectorSoA<Real, dim> & soa, Vector<Real, dim> * vectors)
+{
+    for (size_t i = 0; i < dim; ++i) {
+        const auto component = soa.component(i);
+        for (size_t j = 0; j < soa.size(); ++j) {
+            vectors[j][i] = component[j];
+        }
+    }
+}
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim> & operator+=(VectorSoA<Real, dim> & to, const VectorSoA<Real, dim> & from)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    assert(to.size() == from.size() && "Batches must be of equal size");
+
+    const auto count = to.size();
+    for (size_t c = 0; c < dim; ++c) {
+        auto destination = to.component(c);
+        const auto source = from.component(c);
+
+        size_t i = 0;
+        for (; i + reg::size <= count; i += reg::size) {
+            (reg::load(destination + i) + reg::load(source + i)).store(destination + i);
+        }
+        for (; i < count; ++i) {
+            destination[i] += source[i];
+        }
+    }
+    return to;
+}
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim> & operator*=(VectorSoA<Real, dim> & to, const Real & scalar)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    const auto factor = reg::broadcast(scalar);
+
+    const auto count = to.size();
+    for (size_t c = 0; c < dim; ++c) {
+        auto destination = to.component(c);
+
+        size_t i = 0;
+        for (; i + reg::size <= count; i += reg::size) {
+            (reg::load(destination + i) * factor).store(destination + i);
+        }
+        for (; i < count; ++i) {
+            destination[i] *= scalar;
+        }
+    }
+    return to;
+}
+
+template<typename Real, size_t dim>
+VectorSoA<Real, dim> & axpy(VectorSoA<Real, dim> & to, const Real & scalar, const VectorSoA<Real, dim> & from)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    assert(to.size() == from.size() && "Batches must be of equal size");
+    const auto factor = reg::broadcast(scalar);
+
+    const auto count = to.size();
+    for (size_t c = 0; c < dim; ++c) {
+        auto destination = to.component(c);
+        const auto source = from.component(c);
+
+        size_t i = 0;
+        for (; i + reg::size <= count; i += reg::size) {
+            (reg::load(destination + i) + factor * reg::load(source + i)).store(destination + i);
+        }
+        for (; i < count; ++i) {
+            destination[i] += scalar * source[i];
+        }
+    }
+    return to;
+}
+
+template<typename Real, size_t dim>
+void dot_product(const VectorSoA<Real, dim> & left, const VectorSoA<Real, dim> & right, Real * result)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    assert(left.size() == right.size() && "Batches must be of equal size");
+
+    const auto count = left.size();
+    size_t i = 0;
+    for (; i + reg::size <= count; i += reg::size) {
+        auto sum = reg::load(left.component(0) + i) * reg::load(right.component(0) + i);
+        for (size_t c = 1; c < dim; ++c) {
+            sum = sum + reg::load(left.component(c) + i) * reg::load(right.component(c) + i);
+        }
+        sum.storeu(result + i);
+    }
+    for (; i < count; ++i) {
+        Real sum = left.component(0)[i] * right.component(0)[i];
+        for (size_t c = 1; c < dim; ++c) {
+            sum += left.component(c)[i] * right.component(c)[i];
+        }
+        result[i] = sum;
+    }
+}
+
+template<typename Real>
+void cross_product(const VectorSoA<Real, 3> & left, const VectorSoA<Real, 3> & right, VectorSoA<Real, 3> & result)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    assert(left.size() == right.size() && "Batches must be of equal size");
+
+    const auto count = left.size();
+    result.resize(count);
+
+    const Real * l[3] = {left.component(0), left.component(1), left.component(2)};
+    const Real * r[3] = {right.component(0), right.component(1), right.component(2)};
+    Real * out[3] = {result.component(0), result.component(1), result.component(2)};
+
+    size_t i = 0;
+    for (; i + reg::size <= count; i += reg::size) {
+        const auto lx = reg::load(l[0] + i);
+        const auto ly = reg::load(l[1] + i);
+        const auto lz = reg::load(l[2] + i);
+        const auto rx = reg::load(r[0] + i);
+        const auto ry = reg::load(r[1] + i);
+        const auto rz = reg::load(r[2] + i);
+
+        (ly*rz - lz*ry).store(out[0] + i);
+        (lz*rx - lx*rz).store(out[1] + i);
+        (lx*ry - ly*rx).store(out[2] + i);
+    }
+    for (; i < count; ++i) {
+        const Real x = l[1][i]*r[2][i] - l[2][i]*r[1][i];
+        const Real y = l[2][i]*r[0][i] - l[0][i]*r[2][i];
+        const Real z = l[0][i]*r[1][i] - l[1][i]*r[0][i];
+        out[0][i] = x;
+        out[1][i] = y;
+        out[2][i] = z;
+    }
+}
+
+template<typename Real, size_t dim>
+void vector_length(const VectorSoA<Real, dim> & vectors, Real * result)
+{
+    typedef typename Simd::Native<Real>::type reg;
+
+    const auto count = vectors.size();
+    size_t i = 0;
+    for (; i + reg::size <= count; i += reg::size) {
+        auto sum = reg::load(vectors.component(0) + i) * reg::load(vectors.component(0) + i);
+        for (size_t c = 1; c < dim; ++c) {
+            const auto value = reg::load(vectors.component(c) + i);
+            sum = sum + value * value;
+        }
+        Simd::sqrt(sum).storeu(result + i);
+    }
+    for (; i < count; ++i) {
+        Real sum = vectors.component(0)[i] * vectors.component(0)[i];
+        for (size_t c = 1; c < dim; ++c) {
+            sum += vectors.component(c)[i] * vectors.component(c)[i];
+        }
+        result[i] = std::sqrt(sum);
+    }
+}
+
+template<typename Real, size_t dim>
+void normalize_vector(VectorSoA<Real, dim> & vectors)
+{
+    typedef typename Simd::Native<Real>::type reg;
+
+    const auto count = vectors.size();
+    size_t i = 0;
+    for (; i + reg::size <= count; i += reg::size) {
+        auto sum = reg::load(vectors.component(0) + i) * reg::load(vectors.component(0) + i);
+        for (size_t c = 1; c < dim; ++c) {
+            const auto value = reg::load(vectors.component(c) + i);
+            sum = sum + value * value;
+        }
+        const auto length = Simd::sqrt(sum);
+        for (size_t c = 0; c < dim; ++c) {
+            (reg::load(vectors.component(c) + i) / length).store(vectors.component(c) + i);
+        }
+    }
+    for (; i < count; ++i) {
+        Real sum = vectors.component(0)[i] * vectors.component(0)[i];
+        for (size_t c = 1; c < dim; ++c) {
+            sum += vectors.component(c)[i] * vectors.component(c)[i];
+        }
+        const Real length = std::sqrt(sum);
+        for (size_t c = 0; c < dim; ++c) {
+            vectors.component(c)[i] /= length;
+        }
+    }
+}
+
+template<typename Real, size_t dim>
+void normalize_vector_fast(VectorSoA<Real, dim> & vectors)
+{
+    typedef typename Simd::Native<Real>::type reg;
+    typedef Simd::Register<Real, 1> scalar;
+
+    const auto count = vectors.size();
+    size_t i = 0;
+    for (; i + reg::size <= count; i += reg::size) {
+        auto sum = reg::load(vectors.component(0) + i) * reg::load(vectors.component(0) + i);
+        for (size_t c = 1; c < dim; ++c) {
+            const auto value = reg::load(vectors.component(c) + i);
+            sum = sum + value * value;
+        }
+        const auto scale = Simd::rsqrt(sum);
+        for (size_t c = 0; c < dim; ++c) {
+            (reg::load(vectors.component(c) + i) * scale).store(vectors.component(c) + i);
+        }
+    }
+    for (; i < count; ++i) {
+        Real sum = vectors.component(0)[i] * vectors.component(0)[i];
+        for (size_t c = 1; c < dim; ++c) {
+            sum += vectors.component(c)[i] * vectors.component(c)[i];
+        }
+        const Real scale = Simd::rsqrt(scalar(sum)).value;
+        for (size_t c = 0; c < dim; ++c) {
+            vectors.component(c)[i] *= scale;
+        }
+    }
+}
+
+#endif
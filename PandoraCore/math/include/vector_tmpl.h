@@ -3,69 +3,124 @@
 #else
 
 template<typename Real, size_t dim>
-Vector<Real, dim>::Vector()
-    : data {{0,}}
+constexpr Vector<Real, dim>::Vector()
+    : data {}
 {
 }
 
 template<typename Real, size_t dim>
-Vector<Real, dim>::Vector(std::initializer_list<Real> arguments)
+inline Vector<Real, dim>::Vector(std::initializer_list<Real> arguments)
 {
     assert(arguments.size() == dim &&
             "Creation of an N dimensional vector requires N or zero arguments");
-    std::copy(arguments.begin(), arguments.end(), data.begin());
+    std::copy(arguments.begin(), arguments.end(), data);
+    clear_padding();
 }
 
 template<typename Real, size_t dim>
-Vector<Real, dim>::Vector(const Real array[dim])
+constexpr Vector<Real, dim>::Vector(const Real array[dim])
+    : Vector(array, typename MakeIndices<dim>::type())
 {
-    std::copy(array, array + dim, data.begin());
 }
 
 template<typename Real, size_t dim>
-Vector<Real, dim> & Vector<Real, dim>::operator=(const Real array[dim])
+template<typename... Elements, typename>
+constexpr Vector<Real, dim>::Vector(const Real & first, const Elements & ... rest)
+    : data {first, Real(rest)...}
 {
-    std::copy(array, array + dim, data.begin());
+}
+
+template<typename Real, size_t dim>
+template<typename Expression>
+constexpr Vector<Real, dim>::Vector(const Expression & expression,
+                                    typename EnableIfExpressionOf<Expression, Vector>::type *)
+    : Vector(expression, typename MakeIndices<dim>::type())
+{
+}
+
+// The elements not listed, the padding, are zero initialized
+template<typename Real, size_t dim>
+template<typename Elements, size_t... indices>
+constexpr Vector<Real, dim>::Vector(const Elements & elements, Indices<indices...>)
+    : data {Real(elements[indices])...}
+{
+}
+
+template<typename Real, size_t dim>
+inline Vector<Real, dim> & Vector<Real, dim>::operator=(const Real array[dim])
+{
+    std::copy(array, array + dim, data);
+    clear_padding();
+    return *this;
+}
+
+template<typename Real, size_t dim>
+template<typename Expression>
+typename EnableIfExpressionOf<Expression, Vector<Real, dim>, Vector<Real, dim> &>::type
+Vector<Real, dim>::operator=(const Expression & expression)
+{
+    assign_expression<Real, Simd::VectorStorage<Real, dim>::size>(data, expression);
     return *this;
 }
 
 template<typename Real, size_t dim>
-const Real* Vector<Real, dim>::begin() const
+inline const Real* Vector<Real, dim>::begin() const
 {
-    return data.cbegin();
+    return data;
 }
 
 template<typename Real, size_t dim>
-const Real* Vector<Real, dim>::end() const
+inline const Real* Vector<Real, dim>::end() const
 {
-    return data.cend();
+    return data + dim;
 }
 
 template<typename Real, size_t dim>
-Real* Vector<Real, dim>::begin()
+inline Real* Vector<Real, dim>::begin()
 {
-    return data.begin();
+    return data;
 }
 
 template<typename Real, size_t dim>
-Real* Vector<Real, dim>::end()
+inline Real* Vector<Real, dim>::end()
 {
-    return data.end();
+    return data + dim;
 }
 
 
 template<typename Real, size_t dim>
-Real & Vector<Real, dim>::operator[](const size_t & i)
+inline Real & Vector<Real, dim>::operator[](const size_t & i)
 {
     assert(i < dim && "Index operator out of range");
     return data[i];
 }
 
 template<typename Real, size_t dim>
-Real Vector<Real, dim>::operator[](const size_t & i) const
+constexpr Real Vector<Real, dim>::operator[](const size_t & i) const
 {
-    assert(i < dim && "Index operator out of range");
-    return data[i];
+    return assert(i < dim && "Index operator out of range"), data[i];
+}
+
+template<typename Real, size_t dim>
+inline void Vector<Real, dim>::clear_padding()
+{
+    for (size_t i = dim; i < Simd::VectorStorage<Real, dim>::size; ++i) {
+        data[i] = 0;
+    }
+}
+
+template<typename Register, typename Real, size_t dim>
+Register expression_packet(const Vector<Real, dim> & vector, const size_t & offset)
+{
+    return Register::loadu(vector.begin() + offset);
+}
+
+template<typename Real, size_t dim, typename Expression>
+inline Vector<Real, dim> evaluate_operator(const Expression & expression, const Vector<Real, dim> *)
+{
+    Vector<Real, dim> result;
+    result = expression;
+    return result;
 }
 
 template<typename Real, size_t dim>
@@ -87,9 +142,18 @@ Vector<Real, dim> normalize_vector(Vector<Real, dim> & vector)
 
     assert(length != 0 && "Can not normalize zero vector");
 
-    for (size_t i = 0; i < dim; ++i) {
-        vector[i] /= length;
-    }
+    vector /= length;
+    return vector;
+}
+
+template<typename Real, size_t dim>
+Vector<Real, dim> normalize_vector_fast(Vector<Real, dim> & vector)
+{
+    const Real length_squared = vector_length_squared(vector);
+
+    assert(length_squared != 0 && "Can not normalize zero vector");
+
+    vector *= Simd::rsqrt(Simd::Register<Real, 1>(length_squared)).value;
     return vector;
 }
 
@@ -121,6 +185,22 @@ Vector<Real, dim> & operator-=(Vector<Real, dim> & to, const Vector<Real, dim> &
     return to;
 }
 
+template<typename Real, size_t dim, typename Expression>
+typename EnableIfExpressionOf<Expression, Vector<Real, dim>, Vector<Real, dim> &>::type
+operator+=(Vector<Real, dim> & to, const Expression & from)
+{
+    assign_expression<AddOperation, Real, Simd::VectorStorage<Real, dim>::size>(to.begin(), from);
+    return to;
+}
+
+template<typename Real, size_t dim, typename Expression>
+typename EnableIfExpressionOf<Expression, Vector<Real, dim>, Vector<Real, dim> &>::type
+operator-=(Vector<Real, dim> & to, const Expression & from)
+{
+    assign_expression<SubtractOperation, Real, Simd::VectorStorage<Real, dim>::size>(to.begin(), from);
+    return to;
+}
+
 template<typename Real, size_t dim>
 Vector<Real, dim> & operator*=(Vector<Real, dim> & to, const Vector<Real, dim> & from)
 {
@@ -149,56 +229,14 @@ Vector<Real, dim> & operator/=(Vector<Real, dim> & to, const Real & scalar)
     return to;
 }
 
-template<typename Real, size_t dim>
-Vector<Real, dim> operator-(const Vector<Real, dim> & vector)
-{
-    return vector * (Real) -1;
-}
-
-template<typename Real, size_t dim>
-Vector<Real, dim> operator+(const Vector<Real, dim> & left, const Vector<Real, dim> & right)
-{
-    Vector<Real, dim> result = left;
-    result += right;
-    return result;
-}
-
-template<typename Real, size_t dim>
-Vector<Real, dim> operator-(const Vector<Real, dim> & left, const Vector<Real, dim> & right)
+template<typename Left, typename Right>
+constexpr typename EnableIfCompatible<Left, Right,
+    typename std::enable_if<IsVector<typename ExpressionResult<Left>::type>::value,
+                            typename BinaryOperatorType<MultiplyOperation, Left, Right>::type>::type>::type
+operator*(Left && left, Right && right)
 {
-    Vector<Real, dim> result = left;
-    result -= right;
-    return result;
-}
-
-template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Vector<Real, dim> & left, const Vector<Real, dim> & right)
-{
-    Vector<Real, dim> result = left;
-    result *= right;
-    return result;
-}
-
-template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Vector<Real, dim> & vector, const Real & scalar)
-{
-    Vector<Real, dim> result = vector;
-    result *= scalar;
-    return result;
-}
-
-template<typename Real, size_t dim>
-Vector<Real, dim> operator*(const Real & scalar, const Vector<Real, dim> & vector)
-{
-    return vector * scalar;
-}
-
-template<typename Real, size_t dim>
-Vector<Real, dim> operator/(const Vector<Real, dim> & vector, const Real & scalar)
-{
-    Vector<Real, dim> result = vector;
-    result /= scalar;
-    return result;
+    typedef BinaryOperatorType<MultiplyOperation, Left, Right> result;
+    return operator_result<result>(typename result::node(static_cast<Left &&>(left), static_cast<Right &&>(right)));
 }
 
 template<typename Real, size_t dim>
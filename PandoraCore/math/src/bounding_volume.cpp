@@ -0,0 +1 @@
+#include "bounding_volume.h"
@@ -0,0 +1 @@
+#include "dual_quaternion.h"
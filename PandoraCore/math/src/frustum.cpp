@@ -0,0 +1 @@
+#include "frustum.h"
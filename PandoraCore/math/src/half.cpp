@@ -0,0 +1 @@
+#include "half.h"
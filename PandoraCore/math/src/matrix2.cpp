@@ -1 +1,19 @@
 #include "matrix2.h"
+
+namespace Math
+{
+
+template struct Matrix<float, 2>;
+template struct Matrix<double, 2>;
+template Matrix<float, 2> matrix_adjugate(const Matrix<float, 2> &);
+template Matrix<double, 2> matrix_adjugate(const Matrix<double, 2> &);
+template Matrix<float, 2> matrix_inverse(const Matrix<float, 2> &);
+template Matrix<double, 2> matrix_inverse(const Matrix<double, 2> &);
+template LUDecomposition<float, 2> matrix_lu_decompose(const Matrix<float, 2> &);
+template LUDecomposition<double, 2> matrix_lu_decompose(const Matrix<double, 2> &);
+template Vector<float, 2> lu_solve(const LUDecomposition<float, 2> &, const Vector<float, 2> &);
+template Vector<double, 2> lu_solve(const LUDecomposition<double, 2> &, const Vector<double, 2> &);
+template Vector<float, 2> matrix_solve(const Matrix<float, 2> &, const Vector<float, 2> &);
+template Vector<double, 2> matrix_solve(const Matrix<double, 2> &, const Vector<double, 2> &);
+
+}
@@ -1 +1,19 @@
 #include "matrix3.h"
+
+namespace Math
+{
+
+template struct Matrix<float, 3>;
+template struct Matrix<double, 3>;
+template Matrix<float, 3> matrix_adjugate(const Matrix<float, 3> &);
+template Matrix<double, 3> matrix_adjugate(const Matrix<double, 3> &);
+template Matrix<float, 3> matrix_inverse(const Matrix<float, 3> &);
+template Matrix<double, 3> matrix_inverse(const Matrix<double, 3> &);
+template LUDecomposition<float, 3> matrix_lu_decompose(const Matrix<float, 3> &);
+template LUDecomposition<double, 3> matrix_lu_decompose(const Matrix<double, 3> &);
+template Vector<float, 3> lu_solve(const LUDecomposition<float, 3> &, const Vector<float, 3> &);
+template Vector<double, 3> lu_solve(const LUDecomposition<double, 3> &, const Vector<double, 3> &);
+template Vector<float, 3> matrix_solve(const Matrix<float, 3> &, const Vector<float, 3> &);
+template Vector<double, 3> matrix_solve(const Matrix<double, 3> &, const Vector<double, 3> &);
+
+}
@@ -1 +1,21 @@
 #include "matrix4.h"
+
+namespace Math
+{
+
+template struct Matrix<float, 4>;
+template struct Matrix<double, 4>;
+template Matrix<float, 4> matrix_adjugate(const Matrix<float, 4> &);
+template Matrix<double, 4> matrix_adjugate(const Matrix<double, 4> &);
+template Matrix<float, 4> matrix_inverse(const Matrix<float, 4> &);
+template Matrix<double, 4> matrix_inverse(const Matrix<double, 4> &);
+template bool matrix_is_rigid(const Matrix<float, 4> &, const float &);
+template bool matrix_is_rigid(const Matrix<double, 4> &, const double &);
+template LUDecomposition<float, 4> matrix_lu_decompose(const Matrix<float, 4> &);
+template LUDecomposition<double, 4> matrix_lu_decompose(const Matrix<double, 4> &);
+template Vector<float, 4> lu_solve(const LUDecomposition<float, 4> &, const Vector<float, 4> &);
+template Vector<double, 4> lu_solve(const LUDecomposition<double, 4> &, const Vector<double, 4> &);
+template Vector<float, 4> matrix_solve(const Matrix<float, 4> &, const Vector<float, 4> &);
+template Vector<double, 4> matrix_solve(const Matrix<double, 4> &, const Vector<double, 4> &);
+
+}
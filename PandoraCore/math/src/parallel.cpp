@@ -0,0 +1,164 @@
+#include "parallel.h"
+
+namespace Math
+{
+
+namespace
+{
+
+// Set on a thread while it runs a task of a pool. A call from inside a task
+// may then not wait for, or lock, a pool the thread might already hold.
+thread_local bool running_task = false;
+
+class RunningTask
+{
+public:
+    RunningTask()
+    {
+        running_task = true;
+    }
+
+    ~RunningTask()
+    {
+        running_task = false;
+    }
+
+private:
+    RunningTask(const RunningTask &);
+    RunningTask & operator=(const RunningTask &);
+};
+
+}
+
+ThreadPool::ThreadPool()
+    : current(nullptr), task_count(0), generation(0), pending(0), stopping(false)
+{}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard<std::mutex> lock(state);
+        stopping = true;
+    }
+    started.notify_all();
+
+    for (auto & worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool & ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::reserve(const size_t & threads)
+{
+    if (running_task) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> run(running);
+    start_workers(threads ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1));
+}
+
+size_t ThreadPool::size() const
+{
+    const std::lock_guard<std::mutex> lock(state);
+    return workers.size() + 1;
+}
+
+bool ThreadPool::try_run(const size_t & count, const std::function<void(const size_t &)> & task)
+{
+    if (running_task) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> run(running, std::try_to_lock);
+    if (!run.owns_lock()) {
+        return false;
+    }
+    start_workers(count);
+
+    {
+        const std::lock_guard<std::mutex> lock(state);
+        current = &task;
+        task_count = count;
+        pending = count - 1;
+        error = nullptr;
+        ++generation;
+    }
+    started.notify_all();
+
+    // The workers use task until they are done, also when the calling
+    // thread throws
+    std::exception_ptr own_error;
+    try {
+        const RunningTask running_first;
+        task(size_t(0));
+    } catch (...) {
+        own_error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(state);
+    finished.wait(lock, [this]() { return pending == 0; });
+    current = nullptr;
+
+    if (own_error) {
+        std::rethrow_exception(own_error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return true;
+}
+
+void ThreadPool::start_workers(const size_t & threads)
+{
+    const std::lock_guard<std::mutex> lock(state);
+    while (workers.size() + 1 < threads) {
+        // A worker only runs what is started after it, so it can not miss
+        // the run that started it
+        const size_t index = workers.size() + 1;
+        const size_t seen = generation;
+        workers.emplace_back([this, index, seen]() { work(index, seen); });
+    }
+}
+
+// Worker index - 1 runs task(index) of every run with more than index tasks
+void ThreadPool::work(const size_t & index, size_t seen)
+{
+    std::unique_lock<std::mutex> lock(state);
+
+    while (true) {
+        started.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        if (index >= task_count) {
+            continue;
+        }
+
+        const auto & task = *current;
+        lock.unlock();
+        try {
+            const RunningTask running_own;
+            task(index);
+        } catch (...) {
+            lock.lock();
+            if (!error) {
+                error = std::current_exception();
+            }
+            lock.unlock();
+        }
+        lock.lock();
+
+        if (--pending == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+}
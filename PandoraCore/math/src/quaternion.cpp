@@ -1 +1,11 @@
 #include "quaternion.h"
+
+namespace Math
+{
+
+template struct Quaternion<float>;
+template struct Quaternion<double>;
+template Quaternion<float> quaternion_slerp(const Quaternion<float> &, const Quaternion<float> &, const float &);
+template Quaternion<double> quaternion_slerp(const Quaternion<double> &, const Quaternion<double> &, const double &);
+
+}
@@ -1 +1,11 @@
 #include "vector2.h"
+
+namespace Math
+{
+
+template struct Vector<float, 2>;
+template struct Vector<double, 2>;
+template void generate_orthonormal_basis(Vector<float, 2> &, Vector<float, 2> &);
+template void generate_orthonormal_basis(Vector<double, 2> &, Vector<double, 2> &);
+
+}
@@ -1 +1,11 @@
 #include "vector3.h"
+
+namespace Math
+{
+
+template struct Vector<float, 3>;
+template struct Vector<double, 3>;
+template void generate_orthonormal_basis(Vector<float, 3> &, Vector<float, 3> &, Vector<float, 3> &);
+template void generate_orthonormal_basis(Vector<double, 3> &, Vector<double, 3> &, Vector<double, 3> &);
+
+}
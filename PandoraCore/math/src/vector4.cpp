@@ -1 +1,9 @@
 #include "vector4.h"
+
+namespace Math
+{
+
+template struct Vector<float, 4>;
+template struct Vector<double, 4>;
+
+}
@@ -0,0 +1,455 @@
+#include "test-helpers.h"
+
+#include <batch_transform.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+template<typename Real>
+class BatchTransformTest : public ::testing::Test
+{
+protected:
+    typedef Math::Vector<Real, 3> Vec3;
+    typedef Math::Vector<Real, 4> Vec4;
+    typedef Math::Matrix<Real, 4> Matrix4;
+
+    static const size_t count = 1000;
+
+    void SetUp()
+    {
+        for (auto & element : matrix) {
+            element = create_random_scalar();
+        }
+        affine = matrix;
+        affine(3,0) = 0;
+        affine(3,1) = 0;
+        affine(3,2) = 0;
+        affine(3,3) = 1;
+
+        for (size_t i = 0; i < count; ++i) {
+            vectors3.push_back(Vec3(Real(create_random_scalar()), Real(create_random_scalar()),
+                                    Real(create_random_scalar())));
+            vectors4.push_back(Vec4(Real(create_random_scalar()), Real(create_random_scalar()),
+                                    Real(create_random_scalar()), Real(create_random_scalar())));
+        }
+    }
+
+    // What transforming the vector by itself gives
+    Vec3 transform_point(const Matrix4 & matrix, const Vec3 & point)
+    {
+        const auto transformed = matrix * Vec4(point[0], point[1], point[2], Real(1));
+        return Vec3(transformed[0] / transformed[3], transformed[1] / transformed[3], transformed[2] / transformed[3]);
+    }
+
+    Vec3 transform_direction(const Matrix4 & matrix, const Vec3 & direction)
+    {
+        const auto transformed = matrix * Vec4(direction[0], direction[1], direction[2], Real(0));
+        return Vec3(transformed[0], transformed[1], transformed[2]);
+    }
+
+    Matrix4 matrix;
+    Matrix4 affine;
+    std::vector<Vec3> vectors3;
+    std::vector<Vec4> vectors4;
+};
+
+template<typename Real>
+const size_t BatchTransformTest<Real>::count;
+
+typedef ::testing::Types<float, double> BatchTransformTypes;
+TYPED_TEST_CASE(BatchTransformTest, BatchTransformTypes);
+
+TYPED_TEST(BatchTransformTest, transforming_points_gives_the_same_as_transforming_each_point)
+{
+    std::vector<typename TestFixture::Vec3> result(this->count);
+
+    transform_points(this->affine, this->vectors3.data(), this->count, result.data());
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(this->transform_point(this->affine, this->vectors3[i]), result[i]);
+    }
+
+    transform_points(this->matrix, this->vectors3.data(), this->count, result.data());
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(this->transform_point(this->matrix, this->vectors3[i]), result[i]);
+    }
+}
+
+TYPED_TEST(BatchTransformTest, transforming_directions_ignores_the_translation)
+{
+    std::vector<typename TestFixture::Vec3> result(this->count);
+
+    transform_directions(this->matrix, this->vectors3.data(), this->count, result.data());
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(this->transform_direction(this->matrix, this->vectors3[i]), result[i]);
+    }
+}
+
+TYPED_TEST(BatchTransformTest, transforming_homogeneous_vectors_gives_the_same_as_matrix_times_vector)
+{
+    std::vector<typename TestFixture::Vec4> result(this->count);
+
+    transform_homogeneous(this->matrix, this->vectors4.data(), this->count, result.data());
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(this->matrix * this->vectors4[i], result[i]);
+    }
+}
+
+TYPED_TEST(BatchTransformTest, padding_of_transformed_points_stays_zero)
+{
+    std::vector<typename TestFixture::Vec3> result(this->count);
+    transform_points(this->matrix, this->vectors3.data(), this->count, result.data());
+
+    for (const auto & point : result) {
+        EXPECT_EQ(dot_product(point, point), point[0]*point[0] + point[1]*point[1] + point[2]*point[2]);
+    }
+
+    // A w of zero divides the padding lane to NaN, and a huge last row
+    // overflows it, neither may leak into the result
+    typedef typename TestFixture::Vec3 Vec3;
+    const TypeParam infinity = std::numeric_limits<TypeParam>::infinity();
+    const TypeParam largest = std::numeric_limits<TypeParam>::max();
+
+    auto projective = typename TestFixture::Matrix4();
+    projective(2,3) = 1;
+    projective(3,2) = 1;
+    projective(3,3) = 0;
+    const Vec3 point(1, 2, 0);
+    Vec3 transformed;
+    transform_points(projective, &point, 1, &transformed);
+    EXPECT_EQ(this->transform_point(projective, point), transformed);
+    EXPECT_EQ(infinity, dot_product(transformed, transformed));
+
+    auto overflowing = typename TestFixture::Matrix4();
+    overflowing(3,0) = largest;
+    const Vec3 direction(largest, 0, 0);
+    transform_directions(overflowing, &direction, 1, &transformed);
+    EXPECT_EQ(this->transform_direction(overflowing, direction), transformed);
+    EXPECT_EQ(infinity, dot_product(transformed, transformed));
+}
+
+TYPED_TEST(BatchTransformTest, transforming_batches_gives_the_same_as_transforming_arrays)
+{
+    typedef Math::VectorSoA<TypeParam, 3> Batch3;
+    typedef Math::VectorSoA<TypeParam, 4> Batch4;
+    std::vector<typename TestFixture::Vec3> expected3(this->count);
+    std::vector<typename TestFixture::Vec4> expected4(this->count);
+
+    const Batch3 batch3(this->vectors3.data(), this->count);
+    const Batch4 batch4(this->vectors4.data(), this->count);
+    Batch3 result3;
+    Batch4 result4;
+
+    transform_points(this->matrix, this->vectors3.data(), this->count, expected3.data());
+    transform_points(this->matrix, batch3, result3);
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(expected3[i], result3.get(i));
+    }
+
+    transform_points(this->affine, this->vectors3.data(), this->count, expected3.data());
+    transform_points(this->affine, batch3, result3);
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(expected3[i], result3.get(i));
+    }
+
+    transform_directions(this->matrix, this->vectors3.data(), this->count, expected3.data());
+    transform_directions(this->matrix, batch3, result3);
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(expected3[i], result3.get(i));
+    }
+
+    transform_homogeneous(this->matrix, this->vectors4.data(), this->count, expected4.data());
+    transform_homogeneous(this->matrix, batch4, result4);
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(expected4[i], result4.get(i));
+    }
+}
+
+TYPED_TEST(BatchTransformTest, transforming_in_place_overwrites_the_input)
+{
+    std::vector<typename TestFixture::Vec3> expected(this->count);
+    transform_points(this->matrix, this->vectors3.data(), this->count, expected.data());
+
+    Math::VectorSoA<TypeParam, 3> batch(this->vectors3.data(), this->count);
+    transform_points(this->matrix, this->vectors3.data(), this->count, this->vectors3.data());
+    transform_points(this->matrix, batch, batch);
+
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(expected[i], this->vectors3[i]);
+        EXPECT_EQ(expected[i], batch.get(i));
+    }
+}
+
+TYPED_TEST(BatchTransformTest, transforming_on_several_threads_gives_the_same_as_on_one)
+{
+    std::vector<typename TestFixture::Vec3> expected(this->count);
+    std::vector<typename TestFixture::Vec3> result(this->count);
+    const Math::VectorSoA<TypeParam, 3> batch(this->vectors3.data(), this->count);
+    Math::VectorSoA<TypeParam, 3> batch_result;
+
+    transform_points(this->matrix, this->vectors3.data(), this->count, expected.data());
+    transform_points(this->matrix, this->vectors3.data(), this->count, result.data(), 4);
+    transform_points(this->matrix, batch, batch_result, 4);
+
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(expected[i], result[i]);
+        EXPECT_EQ(expected[i], batch_result.get(i));
+    }
+}
+
+TYPED_TEST(BatchTransformTest, rotating_vectors_gives_the_same_as_rotating_each_vector)
+{
+    typedef Math::Quaternion<TypeParam> Quaternion;
+    std::vector<Quaternion> quaternions;
+    for (size_t i = 0; i < this->count; ++i) {
+        Quaternion quaternion = Quaternion(TypeParam(create_random_scalar()), TypeParam(create_random_scalar()),
+                                           TypeParam(create_random_scalar()), TypeParam(create_random_scalar()));
+        quaternion_normalize(quaternion);
+        quaternions.push_back(quaternion);
+    }
+
+    const Math::VectorSoA<TypeParam, 3> batch(this->vectors3.data(), this->count);
+    Math::VectorSoA<TypeParam, 3> batch_result;
+    std::vector<typename TestFixture::Vec3> result(this->count);
+
+    quaternion_rotate(quaternions[0], this->vectors3.data(), this->count, result.data());
+    quaternion_rotate(quaternions[0], batch, batch_result);
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto expected = quaternion_rotate(quaternions[0], this->vectors3[i]);
+        EXPECT_EQ(expected, result[i]);
+        EXPECT_EQ(expected, batch_result.get(i));
+    }
+
+    quaternion_rotate(quaternions.data(), this->vectors3.data(), this->count, result.data(), 4);
+    quaternion_rotate(quaternions.data(), batch, batch_result, 4);
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto expected = quaternion_rotate(quaternions[i], this->vectors3[i]);
+        EXPECT_EQ(expected, result[i]);
+        EXPECT_EQ(expected, batch_result.get(i));
+    }
+}
+
+TYPED_TEST(BatchTransformTest, interpolating_arrays_gives_the_same_as_interpolating_each_pair)
+{
+    typedef Math::Quaternion<TypeParam> Quaternion;
+    std::vector<Quaternion> from;
+    std::vector<Quaternion> to;
+    std::vector<TypeParam> t;
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto & a = this->vectors4[i];
+        const auto & b = this->vectors4[(i * 7) % this->count];
+        Quaternion first = Quaternion(a[0], a[1], a[2], a[3]);
+        Quaternion second = Quaternion(b[3], -b[2], b[1], (i % 2 ? 1 : -1) * b[0]);
+        quaternion_normalize(first);
+        quaternion_normalize(second);
+        from.push_back(first);
+        to.push_back(second);
+        t.push_back(TypeParam(i % 17) / 16);
+    }
+    std::vector<Quaternion> result(this->count);
+
+    quaternion_nlerp(from.data(), to.data(), t.data(), this->count, result.data());
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto expected = quaternion_nlerp(from[i], to[i], t[i]);
+        EXPECT_EQ(expected.w(), result[i].w());
+        EXPECT_EQ(expected.get_imag(), result[i].get_imag());
+    }
+
+    quaternion_fast_slerp(from.data(), to.data(), t.data(), this->count, result.data(), 4);
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto expected = quaternion_fast_slerp(from[i], to[i], t[i]);
+        EXPECT_EQ(expected.w(), result[i].w());
+        EXPECT_EQ(expected.get_imag(), result[i].get_imag());
+    }
+
+    quaternion_slerp(from.data(), to.data(), t.data(), this->count, result.data(), 4);
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto expected = quaternion_slerp(from[i], to[i], t[i]);
+        EXPECT_EQ(expected.w(), result[i].w());
+        EXPECT_EQ(expected.get_imag(), result[i].get_imag());
+    }
+}
+
+TYPED_TEST(BatchTransformTest, fast_normalizing_arrays_gives_the_same_as_fast_normalizing_each_element)
+{
+    typedef Math::Quaternion<TypeParam> Quaternion;
+    std::vector<Quaternion> quaternions;
+    for (const auto & vector : this->vectors4) {
+        quaternions.push_back(Quaternion(vector[0], vector[1], vector[2], vector[3]));
+    }
+    auto vectors3 = this->vectors3;
+    auto vectors4 = this->vectors4;
+    auto normalized = quaternions;
+
+    normalize_vector_fast(vectors3.data(), this->count);
+    normalize_vector_fast(vectors4.data(), this->count, 4);
+    quaternion_normalize_fast(normalized.data(), this->count, 4);
+
+    for (size_t i = 0; i < this->count; ++i) {
+        EXPECT_EQ(normalize_vector_fast(this->vectors3[i]), vectors3[i]);
+        EXPECT_EQ(normalize_vector_fast(this->vectors4[i]), vectors4[i]);
+
+        quaternion_normalize_fast(quaternions[i]);
+        EXPECT_EQ(quaternions[i].w(), normalized[i].w());
+        EXPECT_EQ(quaternions[i].get_imag(), normalized[i].get_imag());
+    }
+}
+
+TYPED_TEST(BatchTransformTest, blending_and_transforming_by_dual_quaternions_gives_the_same_as_each_vertex_by_itself)
+{
+    typedef Math::DualQuaternion<TypeParam> DualQuaternion;
+    const size_t bones = 20;
+    const size_t influences = 3;
+
+    std::vector<DualQuaternion> transforms;
+    for (size_t i = 0; i < bones; ++i) {
+        const auto & vector = this->vectors4[i];
+        auto rotation = Math::Quaternion<TypeParam>(vector[0], vector[1], vector[2], (i % 2 ? 1 : -1) * vector[3]);
+        quaternion_normalize(rotation);
+        transforms.push_back(DualQuaternion(rotation, this->vectors3[i]));
+    }
+
+    std::vector<size_t> indices;
+    std::vector<TypeParam> weights;
+    for (size_t i = 0; i < this->count; ++i) {
+        for (size_t k = 0; k < influences; ++k) {
+            indices.push_back((i * 7 + k * 3) % bones);
+            weights.push_back(TypeParam(i % 5 + k + 1) / (3 * (i % 5) + 6));
+        }
+    }
+    std::vector<DualQuaternion> blended(this->count);
+
+    dual_quaternion_blend(transforms.data(), indices.data(), weights.data(), influences, this->count, blended.data(), 4);
+    for (size_t i = 0; i < this->count; ++i) {
+        DualQuaternion influencing[influences];
+        for (size_t k = 0; k < influences; ++k) {
+            influencing[k] = transforms[indices[i * influences + k]];
+        }
+        const auto expected = dual_quaternion_blend(influencing, weights.data() + i * influences, influences);
+        for (size_t c = 0; c < 8; ++c) {
+            EXPECT_EQ(expected[c], blended[i][c]);
+        }
+    }
+
+    std::vector<typename TestFixture::Vec3> result(this->count);
+    Math::VectorSoA<TypeParam, 3> batch(this->vectors3.data(), this->count);
+    Math::VectorSoA<TypeParam, 3> batch_result;
+
+    dual_quaternion_transform_points(blended.data(), this->vectors3.data(), this->count, result.data());
+    dual_quaternion_transform_points(blended.data(), batch, batch_result, 4);
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto expected = dual_quaternion_transform_point(blended[i], this->vectors3[i]);
+        EXPECT_EQ(expected, result[i]);
+        EXPECT_EQ(expected, batch_result.get(i));
+    }
+}
+
+TEST(ParallelForTest, ranges_cover_every_element_once)
+{
+    const size_t count = 1000;
+    std::vector<int> visits(count, 0);
+
+    Math::parallel_for(count, 3, [&](const size_t & begin, const size_t & end) {
+        EXPECT_EQ(0u, begin % Math::parallel_granularity);
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+
+    for (const auto & visit : visits) {
+        EXPECT_EQ(1, visit);
+    }
+}
+
+TEST(ParallelForTest, empty_range_calls_the_function_once_with_nothing_to_do)
+{
+    size_t calls = 0;
+    Math::parallel_for(0, 4, [&](const size_t & begin, const size_t & end) {
+        EXPECT_EQ(begin, end);
+        ++calls;
+    });
+    EXPECT_EQ(1u, calls);
+}
+
+TEST(ParallelForTest, exception_on_the_calling_thread_waits_for_the_other_ranges)
+{
+    const size_t count = 1000;
+    std::vector<int> visits(count, 0);
+    size_t first_end = 0;
+
+    EXPECT_THROW(Math::parallel_for(count, 3, [&](const size_t & begin, const size_t & end) {
+        if (begin == 0) {
+            first_end = end;
+            throw std::runtime_error("first range");
+        }
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    }), std::runtime_error);
+
+    EXPECT_LT(0u, first_end);
+    for (size_t i = first_end; i < count; ++i) {
+        EXPECT_EQ(1, visits[i]);
+    }
+}
+
+TEST(ParallelForTest, ranges_run_on_the_same_threads_every_call)
+{
+    const size_t count = 1000;
+    std::vector<std::thread::id> first(count);
+    std::vector<std::thread::id> second(count);
+
+    Math::parallel_for(count, 3, [&](const size_t & begin, const size_t & end) {
+        std::fill(first.begin() + begin, first.begin() + end, std::this_thread::get_id());
+    });
+    Math::parallel_for(count, 3, [&](const size_t & begin, const size_t & end) {
+        std::fill(second.begin() + begin, second.begin() + end, std::this_thread::get_id());
+    });
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first.front(), first.back());
+}
+
+TEST(ParallelForTest, exception_on_another_thread_is_rethrown)
+{
+    const size_t count = 1000;
+
+    EXPECT_THROW(Math::parallel_for(count, 3, [&](const size_t & begin, const size_t &) {
+        if (begin != 0) {
+            throw std::runtime_error("later range");
+        }
+    }), std::runtime_error);
+}
+
+TEST(ParallelForTest, parallel_for_inside_a_range_gets_threads_of_its_own)
+{
+    const size_t count = 1000;
+    std::vector<std::vector<int> > visits(4, std::vector<int>(count, 0));
+
+    Math::parallel_tasks(4, [&](const size_t & task) {
+        Math::parallel_for(count, 3, [&](const size_t & begin, const size_t & end) {
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[task][i];
+            }
+        });
+    });
+
+    for (const auto & task_visits : visits) {
+        for (const auto & visit : task_visits) {
+            EXPECT_EQ(1, visit);
+        }
+    }
+}
+
+TEST(ParallelForTest, exception_in_a_nested_range_is_rethrown)
+{
+    const size_t count = 1000;
+
+    EXPECT_THROW(Math::parallel_tasks(2, [&](const size_t &) {
+        Math::parallel_for(count, 3, [&](const size_t & begin, const size_t &) {
+            if (begin != 0) {
+                throw std::runtime_error("later nested range");
+            }
+        });
+    }), std::runtime_error);
+}
@@ -0,0 +1,282 @@
+#include "test-helpers.h"
+
+#include <bounding_volume.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+template<typename Real>
+class BoundingVolumeTest : public ::testing::Test
+{
+protected:
+    typedef Math::Vector<Real, 3> Vec3;
+    typedef Math::AABB<Real> AABB;
+    typedef Math::Sphere<Real> Sphere;
+    typedef Math::Ray<Real> Ray;
+
+    // Not a multiple of any register width
+    static const size_t count = 1001;
+
+    void SetUp()
+    {
+        for (size_t i = 0; i < count; ++i) {
+            points.push_back(random_vector());
+        }
+    }
+
+    static Vec3 random_vector()
+    {
+        return Vec3(Real(create_random_scalar()), Real(create_random_scalar()), Real(create_random_scalar()));
+    }
+
+    static bool same_bits(const Real & left, const Real & right)
+    {
+        return !std::memcmp(&left, &right, sizeof(Real));
+    }
+
+    std::vector<Vec3> points;
+};
+
+template<typename Real>
+const size_t BoundingVolumeTest<Real>::count;
+
+typedef ::testing::Types<float, double> BoundingVolumeTypes;
+TYPED_TEST_CASE(BoundingVolumeTest, BoundingVolumeTypes);
+
+TYPED_TEST(BoundingVolumeTest, default_volumes_are_empty_and_merging_into_them_gives_the_other)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    const typename TestFixture::AABB box(Vec3(-1, -2, -3), Vec3(1, 2, 3));
+    const typename TestFixture::Sphere sphere(Vec3(1, 2, 3), 4);
+
+    EXPECT_TRUE(typename TestFixture::AABB().is_empty());
+    EXPECT_TRUE(typename TestFixture::Sphere().is_empty());
+    EXPECT_FALSE(box.is_empty());
+    EXPECT_FALSE(sphere.is_empty());
+
+    const auto merged_box = Math::aabb_merge(typename TestFixture::AABB(), box);
+    EXPECT_EQ(box.get_min(), merged_box.get_min());
+    EXPECT_EQ(box.get_max(), merged_box.get_max());
+
+    const auto merged_sphere = Math::sphere_merge(typename TestFixture::Sphere(), sphere);
+    EXPECT_EQ(sphere.get_center(), merged_sphere.get_center());
+    EXPECT_EQ(sphere.get_radius(), merged_sphere.get_radius());
+}
+
+TYPED_TEST(BoundingVolumeTest, box_of_points_is_the_smallest_holding_them)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    Vec3 minimum = this->points[0];
+    Vec3 maximum = this->points[0];
+    for (const auto & point : this->points) {
+        for (size_t c = 0; c < 3; ++c) {
+            minimum[c] = std::min(minimum[c], point[c]);
+            maximum[c] = std::max(maximum[c], point[c]);
+        }
+    }
+
+    for (size_t count = 1; count <= this->count; count += 250) {
+        const typename TestFixture::AABB box(this->points.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_TRUE(Math::aabb_contains(box, this->points[i]));
+        }
+    }
+
+    const typename TestFixture::AABB box(this->points.data(), this->count);
+    const typename TestFixture::AABB soa_box(Math::VectorSoA<TypeParam, 3>(this->points.data(), this->count));
+    EXPECT_EQ(minimum, box.get_min());
+    EXPECT_EQ(maximum, box.get_max());
+    EXPECT_EQ(minimum, soa_box.get_min());
+    EXPECT_EQ(maximum, soa_box.get_max());
+    EXPECT_TRUE(typename TestFixture::AABB(this->points.data(), 0).is_empty());
+}
+
+TYPED_TEST(BoundingVolumeTest, expanding_a_box_moves_its_faces_out)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    const typename TestFixture::AABB box(Vec3(0, 0, 0), Vec3(1, 1, 1));
+
+    const auto grown = Math::aabb_expand(box, Vec3(2, -1, TypeParam(0.5)));
+    EXPECT_EQ(Vec3(0, -1, 0), grown.get_min());
+    EXPECT_EQ(Vec3(2, 1, 1), grown.get_max());
+
+    const auto padded = Math::aabb_expand(box, TypeParam(0.5));
+    EXPECT_EQ(Vec3(-0.5, -0.5, -0.5), padded.get_min());
+    EXPECT_EQ(Vec3(1.5, 1.5, 1.5), padded.get_max());
+    EXPECT_EQ(Vec3(0.5, 0.5, 0.5), padded.get_center());
+    EXPECT_EQ(Vec3(1, 1, 1), padded.get_half_size());
+}
+
+TYPED_TEST(BoundingVolumeTest, touching_boxes_overlap_and_empty_boxes_never_do)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    typedef typename TestFixture::AABB AABB;
+    const AABB box(Vec3(0, 0, 0), Vec3(1, 1, 1));
+
+    EXPECT_TRUE(Math::aabb_overlaps(box, AABB(Vec3(1, 0.5, 0.5), Vec3(2, 2, 2))));
+    EXPECT_TRUE(Math::aabb_overlaps(box, AABB(Vec3(0.25, 0.25, 0.25), Vec3(0.5, 0.5, 0.5))));
+    EXPECT_FALSE(Math::aabb_overlaps(box, AABB(Vec3(0.5, 1.25, 0.5), Vec3(2, 2, 2))));
+    EXPECT_FALSE(Math::aabb_overlaps(box, AABB()));
+    EXPECT_FALSE(Math::aabb_overlaps(AABB(), AABB()));
+
+    EXPECT_TRUE(Math::aabb_contains(box, Vec3(1, 0, 0.5)));
+    EXPECT_FALSE(Math::aabb_contains(box, Vec3(1, 0, -0.001)));
+    EXPECT_FALSE(Math::aabb_contains(AABB(), Vec3(0, 0, 0)));
+}
+
+TYPED_TEST(BoundingVolumeTest, sphere_overlaps_box_when_the_closest_point_is_inside_it)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    typedef typename TestFixture::Sphere Sphere;
+    const typename TestFixture::AABB box(Vec3(0, 0, 0), Vec3(1, 1, 1));
+
+    EXPECT_TRUE(Math::aabb_overlaps(box, Sphere(Vec3(0.5, 0.5, 0.5), TypeParam(0.1))));
+    EXPECT_TRUE(Math::aabb_overlaps(box, Sphere(Vec3(2, 0.5, 0.5), 1)));
+    EXPECT_TRUE(Math::aabb_overlaps(box, Sphere(Vec3(1.5, 1.5, 0.5), TypeParam(0.75))));
+    // Close to the faces, but not to the edge between them
+    EXPECT_FALSE(Math::aabb_overlaps(box, Sphere(Vec3(1.5, 1.5, 0.5), TypeParam(0.7))));
+    EXPECT_FALSE(Math::aabb_overlaps(box, Sphere()));
+    EXPECT_FALSE(Math::aabb_overlaps(typename TestFixture::AABB(), Sphere(Vec3(0, 0, 0), 10)));
+}
+
+TYPED_TEST(BoundingVolumeTest, sphere_of_points_holds_them_and_fits_their_box)
+{
+    const typename TestFixture::Sphere sphere(this->points.data(), this->count);
+    const typename TestFixture::Sphere soa_sphere(Math::VectorSoA<TypeParam, 3>(this->points.data(), this->count));
+    const typename TestFixture::AABB box(this->points.data(), this->count);
+
+    const TypeParam tolerance = TypeParam(4) * std::numeric_limits<TypeParam>::epsilon();
+    const typename TestFixture::Sphere padded(sphere.get_center(), sphere.get_radius() * (1 + tolerance));
+    for (const auto & point : this->points) {
+        EXPECT_TRUE(Math::sphere_contains(padded, point));
+    }
+
+    EXPECT_EQ(box.get_center(), sphere.get_center());
+    EXPECT_EQ(box.get_center(), soa_sphere.get_center());
+    EXPECT_NEAR(sphere.get_radius(), soa_sphere.get_radius(), tolerance * sphere.get_radius());
+    EXPECT_LE(sphere.get_radius(), Math::vector_length(box.get_half_size()) * (1 + tolerance));
+    EXPECT_TRUE(typename TestFixture::Sphere(this->points.data(), 0).is_empty());
+}
+
+TYPED_TEST(BoundingVolumeTest, merged_sphere_holds_both_spheres)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    typedef typename TestFixture::Sphere Sphere;
+    const Sphere left(Vec3(0, 0, 0), 1);
+    const Sphere right(Vec3(4, 0, 0), 2);
+    const Sphere inner(Vec3(0.5, 0, 0), TypeParam(0.25));
+
+    const auto merged = Math::sphere_merge(left, right);
+    EXPECT_EQ(Vec3(2.5, 0, 0), merged.get_center());
+    EXPECT_EQ(3.5, merged.get_radius());
+
+    EXPECT_EQ(left.get_radius(), Math::sphere_merge(left, inner).get_radius());
+    EXPECT_EQ(left.get_radius(), Math::sphere_merge(inner, left).get_radius());
+
+    const auto expanded = Math::sphere_expand(left, Vec3(0, 3, 0));
+    EXPECT_EQ(Vec3(0, 1, 0), expanded.get_center());
+    EXPECT_EQ(2, expanded.get_radius());
+
+    EXPECT_TRUE(Math::sphere_overlaps(left, Sphere(Vec3(3, 0, 0), 2)));
+    EXPECT_FALSE(Math::sphere_overlaps(left, Sphere(Vec3(3, 0, 0), TypeParam(1.5))));
+    EXPECT_FALSE(Math::sphere_overlaps(left, Sphere()));
+    EXPECT_FALSE(Math::sphere_contains(Sphere(), Vec3(0, 0, 0)));
+}
+
+TYPED_TEST(BoundingVolumeTest, ray_enters_the_box_at_the_nearest_face)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    typedef typename TestFixture::Ray Ray;
+    const typename TestFixture::AABB box(Vec3(1, 1, 1), Vec3(2, 3, 4));
+    TypeParam distance;
+
+    EXPECT_TRUE(Math::aabb_intersects_ray(box, Ray(Vec3(0, 2, 2), Vec3(2, 0, 0)), distance));
+    EXPECT_EQ(TypeParam(0.5), distance);
+
+    EXPECT_TRUE(Math::aabb_intersects_ray(box, Ray(Vec3(3, 4, 5), Vec3(-1, -1, -1)), distance));
+    EXPECT_EQ(1, distance);
+
+    // From the inside, and in through an edge
+    EXPECT_TRUE(Math::aabb_intersects_ray(box, Ray(Vec3(1.5, 2, 2), Vec3(0, 0, 1)), distance));
+    EXPECT_EQ(0, distance);
+    EXPECT_TRUE(Math::aabb_intersects_ray(box, Ray(Vec3(0, 0, 2), Vec3(1, 1, 0)), distance));
+    EXPECT_EQ(1, distance);
+
+    EXPECT_FALSE(Math::aabb_intersects_ray(box, Ray(Vec3(0, 2, 2), Vec3(-1, 0, 0))));
+    EXPECT_FALSE(Math::aabb_intersects_ray(box, Ray(Vec3(0, 0, 0), Vec3(1, 0, 1))));
+    EXPECT_FALSE(Math::aabb_intersects_ray(box, Ray(Vec3(0, 5, 2), Vec3(1, 0, 0))));
+    EXPECT_FALSE(Math::aabb_intersects_ray(typename TestFixture::AABB(), Ray(Vec3(0, 0, 0), Vec3(1, 1, 1))));
+}
+
+TYPED_TEST(BoundingVolumeTest, one_ray_against_a_batch_gives_the_same_as_each_box_by_itself)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    Math::VectorSoA<TypeParam, 3> minimums;
+    Math::VectorSoA<TypeParam, 3> maximums;
+    std::vector<typename TestFixture::AABB> boxes;
+    for (size_t i = 0; i < this->count; ++i) {
+        const Vec3 center(this->points[i] / TypeParam(100));
+        const TypeParam size = TypeParam(0.1) * (i % 5);
+        boxes.push_back(i % 7 ? Math::aabb_expand(typename TestFixture::AABB(center, center), size)
+                              : typename TestFixture::AABB());
+        minimums.push_back(boxes.back().get_min());
+        maximums.push_back(boxes.back().get_max());
+    }
+
+    const typename TestFixture::Ray ray(Vec3(-1, -1, -1), Vec3(1, TypeParam(1.1), TypeParam(0.9)));
+    for (const size_t & threads : {size_t(1), size_t(3)}) {
+        std::vector<TypeParam> distances(this->count);
+        Math::aabb_intersect_ray(minimums, maximums, ray, distances.data(), threads);
+
+        size_t hits = 0;
+        for (size_t i = 0; i < this->count; ++i) {
+            TypeParam distance;
+            if (Math::aabb_intersects_ray(boxes[i], ray, distance)) {
+                EXPECT_TRUE(this->same_bits(distance, distances[i]));
+                ++hits;
+            } else {
+                EXPECT_EQ(std::numeric_limits<TypeParam>::infinity(), distances[i]);
+            }
+        }
+        EXPECT_LT(0u, hits);
+        EXPECT_GT(this->count, hits);
+    }
+}
+
+TYPED_TEST(BoundingVolumeTest, a_batch_of_rays_against_one_box_gives_the_same_as_each_ray_by_itself)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    const typename TestFixture::AABB box(Vec3(-0.5, -0.25, -0.5), Vec3(0.5, 0.25, 0.5));
+    Math::VectorSoA<TypeParam, 3> origins;
+    Math::VectorSoA<TypeParam, 3> directions;
+    for (size_t i = 0; i < this->count; ++i) {
+        Vec3 direction(this->random_vector() - Vec3(100, 100, 100));
+        // Some rays along the axes, through the infinities of the inverse
+        if (i % 11 == 0) {
+            direction[i % 3] = 0;
+        }
+        origins.push_back(Vec3(this->points[i] / TypeParam(100) - Vec3(1, 1, 1)));
+        directions.push_back(direction);
+    }
+
+    for (const size_t & threads : {size_t(1), size_t(3)}) {
+        std::vector<TypeParam> distances(this->count);
+        Math::aabb_intersect_rays(box, origins, directions, distances.data(), threads);
+
+        size_t hits = 0;
+        for (size_t i = 0; i < this->count; ++i) {
+            TypeParam distance;
+            if (Math::aabb_intersects_ray(box, typename TestFixture::Ray(origins[i], directions[i]), distance)) {
+                EXPECT_TRUE(this->same_bits(distance, distances[i]));
+                ++hits;
+            } else {
+                EXPECT_EQ(std::numeric_limits<TypeParam>::infinity(), distances[i]);
+            }
+        }
+        EXPECT_LT(0u, hits);
+        EXPECT_GT(this->count, hits);
+    }
+}
@@ -0,0 +1,233 @@
+#include <dual_quaternion.h>
+#include <vector3.h>
+#include <vector4.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "test-helpers.h"
+
+const Math::Vec3d create_random_vector3();
+Math::Quaternion<double> create_random_quaternion();
+
+Math::Quaternion<double> create_random_rotation();
+Math::DualQuaterniond create_random_transform();
+
+class DualQuaternionTest : public ::testing::Test
+{
+protected:
+    void expect_near(const Math::Vec3d & expected, const Math::Vec3d & actual)
+    {
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_NEAR(expected[i], actual[i], 1e-10);
+        }
+    }
+
+    void expect_near(const Math::Matrix4d & expected, const Math::Matrix4d & actual)
+    {
+        for (size_t i = 0; i < 16; ++i) {
+            EXPECT_NEAR(expected[i], actual[i], 1e-10);
+        }
+    }
+};
+
+TEST_F(DualQuaternionTest, default_dual_quaternion_is_the_identity_transform)
+{
+    const Math::DualQuaterniond transform;
+    const auto point = create_random_vector3();
+
+    EXPECT_EQ(1, transform[0]);
+    for (size_t i = 1; i < 8; ++i) {
+        EXPECT_EQ(0, transform[i]);
+    }
+    EXPECT_EQ(point, dual_quaternion_transform_point(transform, point));
+}
+
+TEST_F(DualQuaternionTest, creating_dual_quaternion_from_real_and_dual_part_packs_them_in_order)
+{
+    const auto real = create_random_quaternion();
+    const auto dual = create_random_quaternion();
+    const Math::DualQuaterniond transform(real, dual);
+
+    const double expected[8] = {real.w(), real.x(), real.y(), real.z(), dual.w(), dual.x(), dual.y(), dual.z()};
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(expected[i], transform[i]);
+    }
+    EXPECT_EQ(real.w(), transform.get_real().w());
+    EXPECT_EQ(dual.z(), transform.get_dual().z());
+}
+
+TEST_F(DualQuaternionTest, dual_quaternion_is_half_the_size_of_a_matrix)
+{
+    EXPECT_EQ(8 * sizeof(float), sizeof(Math::DualQuaternionf));
+    EXPECT_EQ(8 * sizeof(double), sizeof(Math::DualQuaterniond));
+}
+
+TEST_F(DualQuaternionTest, transforming_point_rotates_it_and_then_translates_it)
+{
+    const auto rotation = create_random_rotation();
+    const auto translation = create_random_vector3();
+    const Math::DualQuaterniond transform(rotation, translation);
+    const auto point = create_random_vector3();
+
+    const Math::Vec3d correct = quaternion_rotate(rotation, point) + translation;
+
+    expect_near(translation, dual_quaternion_translation(transform));
+    expect_near(correct, dual_quaternion_transform_point(transform, point));
+}
+
+TEST_F(DualQuaternionTest, composition_applies_the_right_transform_first)
+{
+    const auto first = create_random_transform();
+    const auto second = create_random_transform();
+    const auto point = create_random_vector3();
+
+    const auto correct = dual_quaternion_transform_point(second, dual_quaternion_transform_point(first, point));
+
+    expect_near(correct, dual_quaternion_transform_point(second * first, point));
+}
+
+TEST_F(DualQuaternionTest, composition_is_the_same_as_multiplying_the_matrices)
+{
+    const auto first = create_random_transform();
+    const auto second = create_random_transform();
+
+    expect_near(dual_quaternion_to_matrix(second) * dual_quaternion_to_matrix(first),
+                dual_quaternion_to_matrix(second * first));
+}
+
+TEST_F(DualQuaternionTest, transforming_point_is_the_same_as_multiplying_by_the_matrix)
+{
+    const auto transform = create_random_transform();
+    const auto point = create_random_vector3();
+
+    const auto correct = dual_quaternion_to_matrix(transform) * Math::Vec4d(point[0], point[1], point[2], 1.0);
+
+    expect_near(Math::Vec3d(correct[0], correct[1], correct[2]), dual_quaternion_transform_point(transform, point));
+}
+
+TEST_F(DualQuaternionTest, creating_dual_quaternion_from_matrix_gives_back_the_same_matrix)
+{
+    const auto transform = create_random_transform();
+    const auto matrix = dual_quaternion_to_matrix(transform);
+
+    expect_near(matrix, dual_quaternion_to_matrix(Math::DualQuaterniond(matrix)));
+}
+
+TEST_F(DualQuaternionTest, creating_dual_quaternion_from_half_turns_gives_back_the_same_matrix)
+{
+    // The trace is -1, so the rotation is found from one of the diagonal elements
+    const Math::Quaternion<double> half_turns[3] = {Math::Quaternion<double>(0, 1, 0, 0),
+                                                    Math::Quaternion<double>(0, 0, 1, 0),
+                                                    Math::Quaternion<double>(0, 0, 0, 1)};
+    for (const auto & rotation : half_turns) {
+        const auto matrix = dual_quaternion_to_matrix(Math::DualQuaterniond(rotation, create_random_vector3()));
+
+        expect_near(matrix, dual_quaternion_to_matrix(Math::DualQuaterniond(matrix)));
+    }
+}
+
+TEST_F(DualQuaternionTest, dual_quaternion_times_its_inverse_is_the_identity)
+{
+    const auto transform = create_random_transform() * 3.0;
+    const auto identity = transform * dual_quaternion_inverse(transform);
+
+    EXPECT_NEAR(1, identity[0], 1e-12);
+    for (size_t i = 1; i < 8; ++i) {
+        EXPECT_NEAR(0, identity[i], 1e-10);
+    }
+}
+
+TEST_F(DualQuaternionTest, inverse_of_unit_dual_quaternion_is_its_conjugate)
+{
+    const auto transform = create_random_transform();
+    const auto inverse = dual_quaternion_inverse(transform);
+    const auto conjugate = dual_quaternion_conjugate(transform);
+
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_NEAR(conjugate[i], inverse[i], 1e-12);
+    }
+}
+
+TEST_F(DualQuaternionTest, normalizing_gives_unit_real_part_orthogonal_to_the_dual_part)
+{
+    Math::DualQuaterniond transform(create_random_quaternion(), create_random_quaternion());
+    dual_quaternion_normalize(transform);
+
+    EXPECT_NEAR(1, quaternion_norm(transform.get_real()), 1e-12);
+    EXPECT_NEAR(0, quaternion_dot(transform.get_real(), transform.get_dual()), 1e-10);
+}
+
+TEST_F(DualQuaternionTest, normalizing_scaled_unit_dual_quaternion_gives_back_the_same_transform)
+{
+    const auto transform = create_random_transform();
+    auto scaled = transform * 5.0;
+    dual_quaternion_normalize(scaled);
+
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_NEAR(transform[i], scaled[i], 1e-12);
+    }
+}
+
+TEST_F(DualQuaternionTest, blending_single_transform_gives_the_transform)
+{
+    const Math::DualQuaterniond transforms[1] = {create_random_transform()};
+    const double weights[1] = {0.5};
+    const auto blended = dual_quaternion_blend(transforms, weights, 1);
+
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_NEAR(transforms[0][i], blended[i], 1e-12);
+    }
+}
+
+TEST_F(DualQuaternionTest, blending_transform_with_its_negation_gives_the_transform)
+{
+    const auto transform = create_random_transform();
+    const Math::DualQuaterniond transforms[2] = {transform, transform * -1.0};
+    const double weights[2] = {0.25, 0.75};
+    const auto blended = dual_quaternion_blend(transforms, weights, 2);
+
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_NEAR(transform[i], blended[i], 1e-12);
+    }
+}
+
+TEST_F(DualQuaternionTest, blending_two_rotations_evenly_rotates_halfway)
+{
+    // The identity and a quarter turn around z. c is the cosine and sine of
+    // an eighth turn.
+    const double c = std::sqrt(0.5);
+    const Math::DualQuaterniond transforms[2] = {
+        Math::DualQuaterniond(Math::Quaternion<double>(), create_random_vector3()),
+        Math::DualQuaterniond(Math::Quaternion<double>(c, 0.0, 0.0, c), create_random_vector3())};
+    const double weights[2] = {0.5, 0.5};
+    const auto blended = dual_quaternion_blend(transforms, weights, 2);
+
+    expect_near(Math::Vec3d(c, c, 0.0), quaternion_rotate(blended.get_real(), Math::Vec3d(1.0, 0.0, 0.0)));
+}
+
+TEST_F(DualQuaternionTest, blending_transforms_with_the_same_rotation_gives_the_weighted_translation)
+{
+    const auto rotation = create_random_rotation();
+    const auto first = create_random_vector3();
+    const auto second = create_random_vector3();
+    const Math::DualQuaterniond transforms[2] = {Math::DualQuaterniond(rotation, first),
+                                                 Math::DualQuaterniond(rotation, second)};
+    const double weights[2] = {0.25, 0.75};
+    const auto blended = dual_quaternion_blend(transforms, weights, 2);
+
+    const Math::Vec3d correct = first * 0.25 + second * 0.75;
+    expect_near(correct, dual_quaternion_translation(blended));
+}
+
+// Helper functions
+Math::Quaternion<double> create_random_rotation()
+{
+    auto rotation = create_random_quaternion();
+    quaternion_normalize(rotation);
+    return rotation;
+}
+
+Math::DualQuaterniond create_random_transform()
+{
+    return Math::DualQuaterniond(create_random_rotation(), create_random_vector3());
+}
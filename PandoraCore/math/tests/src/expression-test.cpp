@@ -0,0 +1,201 @@
+#include "test-helpers.h"
+
+#include <vector3.h>
+#include <vector4.h>
+#include <matrix4.h>
+
+#include <gtest/gtest.h>
+
+class ExpressionTest : public ::testing::Test
+{
+protected:
+    void SetUp();
+
+    Math::Vec3d create_random_vector();
+    Math::Matrix4d create_random_matrix();
+
+    Math::Vec3d a;
+    Math::Vec3d b;
+    Math::Vec3d c;
+    Math::Matrix4d m;
+    Math::Matrix4d n;
+    double scalar;
+};
+
+void ExpressionTest::SetUp()
+{
+    a = create_random_vector();
+    b = create_random_vector();
+    c = create_random_vector();
+    m = create_random_matrix();
+    n = create_random_matrix();
+    scalar = create_random_scalar() + 1;
+}
+
+Math::Vec3d ExpressionTest::create_random_vector()
+{
+    auto array = create_double_array_of_size(3);
+    Math::Vec3d vector(array);
+    delete[] array;
+    return vector;
+}
+
+Math::Matrix4d ExpressionTest::create_random_matrix()
+{
+    auto array = create_double_array_of_size(16);
+    Math::Matrix4d matrix(array);
+    delete[] array;
+    return matrix;
+}
+
+TEST_F(ExpressionTest, fused_vector_expression_gives_same_as_evaluating_each_operation)
+{
+    const Math::Vec3d result = Math::lazy(a) + Math::lazy(b)*scalar - c;
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ((a[i] + b[i]*scalar) - c[i], result[i]);
+    }
+}
+
+TEST_F(ExpressionTest, fused_float_vector_expression_gives_same_as_evaluating_each_operation)
+{
+    const Math::Vec4f left({1.5f, -2.25f, 3.125f, 0.5f});
+    const Math::Vec4f right({0.75f, 8.5f, -1.0f, 2.0f});
+    const float factor = 1.25f;
+
+    const Math::Vec4f result = (Math::lazy(left) - right) * factor + Math::lazy(left) * right / factor;
+
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ((left[i] - right[i]) * factor + (left[i] * right[i]) / factor, result[i]);
+    }
+}
+
+TEST_F(ExpressionTest, expression_can_be_indexed_without_evaluating_it)
+{
+    const auto expression = scalar * (Math::lazy(a) - b);
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ((a[i] - b[i]) * scalar, expression[i]);
+    }
+}
+
+TEST_F(ExpressionTest, expression_keeps_temporary_operands_alive)
+{
+    const auto expression = -Math::lazy(a) + Math::Vec3d({1.0, 2.0, 3.0});
+    const Math::Vec3d result = expression;
+
+    EXPECT_EQ(1.0 - a[0], result[0]);
+    EXPECT_EQ(2.0 - a[1], result[1]);
+    EXPECT_EQ(3.0 - a[2], result[2]);
+}
+
+TEST_F(ExpressionTest, expression_refers_to_named_operands)
+{
+    const auto expression = Math::lazy(a) + b;
+    a[0] = 1.0;
+
+    const Math::Vec3d result = expression;
+    EXPECT_EQ(1.0 + b[0], result[0]);
+}
+
+TEST_F(ExpressionTest, assigning_expression_to_one_of_its_operands_uses_the_old_values)
+{
+    const Math::Vec3d old = a;
+    a = Math::lazy(b) - Math::lazy(a)*scalar;
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(b[i] - old[i]*scalar, a[i]);
+    }
+}
+
+TEST_F(ExpressionTest, adding_expression_inplace_gives_same_as_adding_the_evaluated_expression)
+{
+    const Math::Vec3d evaluated = b*scalar - c;
+    auto expected = a;
+    expected += evaluated;
+
+    a += Math::lazy(b)*scalar - c;
+    EXPECT_EQ(expected, a);
+
+    a -= Math::lazy(b)*scalar - c;
+    expected -= evaluated;
+    EXPECT_EQ(expected, a);
+}
+
+TEST_F(ExpressionTest, expressions_compare_equal_to_their_result)
+{
+    const Math::Vec3d result = a + b;
+
+    EXPECT_TRUE(Math::lazy(a) + b == result);
+    EXPECT_TRUE(result == Math::lazy(b) + a);
+    EXPECT_TRUE(Math::lazy(a) - b != result);
+}
+
+TEST_F(ExpressionTest, integer_vectors_take_part_in_expressions)
+{
+    const Math::Vec3i left({1, 2, 3});
+    const Math::Vec3i right({4, 5, 6});
+
+    const Math::Vec3i result = Math::lazy(left)*2 - right;
+    EXPECT_EQ(Math::Vec3i({-2, -1, 0}), result);
+}
+
+TEST_F(ExpressionTest, fused_matrix_expression_gives_same_as_evaluating_each_operation)
+{
+    const Math::Matrix4d result = Math::lazy(m) - Math::lazy(n)*scalar + m;
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ((m(i,j) - n(i,j)*scalar) + m(i,j), result(i,j));
+        }
+    }
+}
+
+TEST_F(ExpressionTest, dividing_matrix_expression_multiplies_by_the_reciprocal)
+{
+    const Math::Matrix4d result = (Math::lazy(m) + n) / scalar;
+
+    auto expected = m;
+    expected += n;
+    expected /= scalar;
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(ExpressionTest, matrix_expression_can_be_used_in_matrix_products)
+{
+    const Math::Matrix4d sum = m + n;
+
+    EXPECT_EQ(sum * m, Math::Matrix4d(Math::lazy(m) + n) * m);
+}
+
+TEST_F(ExpressionTest, operators_on_vectors_and_matrices_give_values)
+{
+    const Math::Vec3d sum = Math::lazy(a) + b;
+    auto result = a + b;
+    b += a;
+    EXPECT_EQ(sum, result);
+
+    result[0] = 1.0;
+    EXPECT_EQ(1.0, result[0]);
+    Math::normalize_vector(result);
+    EXPECT_NEAR(1.0, Math::vector_length(result), PRECISION);
+
+    auto matrix = m * scalar;
+    m *= 2.0;
+    EXPECT_EQ(Math::Matrix4d(Math::lazy(m) * (scalar / 2.0)), matrix);
+}
+
+TEST_F(ExpressionTest, results_of_operators_can_be_passed_to_vector_and_matrix_functions)
+{
+    const Math::Vec3d difference = Math::lazy(a) - b;
+    const Math::Vec4d vector({a[0], a[1], a[2], 1.0});
+    const Math::Matrix4d product = m * n;
+
+    EXPECT_EQ(Math::dot_product(difference, c), Math::dot_product(a - b, c));
+    EXPECT_EQ(Math::vector_length(difference), Math::vector_length(a - b));
+    EXPECT_EQ(Math::cross_product(difference, c), Math::cross_product(a - b, c));
+    EXPECT_EQ(Math::matrix_transpose(Math::Matrix4d(Math::lazy(m) + n)), Math::matrix_transpose(m + n));
+    EXPECT_EQ(Math::matrix_determinant(Math::Matrix4d(Math::lazy(m) - n)), Math::matrix_determinant(m - n));
+    EXPECT_EQ(m * Math::Vec4d(Math::lazy(vector) + vector), m * (vector + vector));
+    EXPECT_EQ(Math::Matrix4d(product + product), (m + m) * n);
+}
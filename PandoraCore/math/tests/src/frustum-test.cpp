@@ -0,0 +1,195 @@
+#include "test-helpers.h"
+
+#include <frustum.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+template<typename Real>
+class FrustumTest : public ::testing::Test
+{
+protected:
+    typedef Math::Vector<Real, 3> Vec3;
+    typedef Math::Vector<Real, 4> Vec4;
+    typedef Math::Matrix<Real, 4> Matrix4;
+
+    // Not a multiple of any register width, and more than one range of
+    // parallel_for
+    static const size_t count = 1001;
+
+    FrustumTest()
+        : view_projection(Math::matrix_perspective(Real(1.2), Real(1.5), Real(0.5), Real(50)) *
+                          Math::matrix_look_at(Vec3(1, 2, 3), Vec3(4, 6, -9), Vec3(0, 1, 0))),
+          frustum(view_projection)
+    { }
+
+    void SetUp()
+    {
+        // Spread around the camera, so some are in view, some behind it and
+        // some beyond the far plane
+        for (size_t i = 0; i < count; ++i) {
+            points.push_back(Vec3(Real(create_random_scalar() / 2 - 50), Real(create_random_scalar() / 2 - 50),
+                                  Real(create_random_scalar() / 2 - 50)));
+        }
+    }
+
+    bool inside_clip_cube(const Vec3 & point) const
+    {
+        const Vec4 clip = view_projection * Vec4(point[0], point[1], point[2], Real(1));
+        return std::abs(clip[0]) <= clip[3] && std::abs(clip[1]) <= clip[3] && std::abs(clip[2]) <= clip[3];
+    }
+
+    const Matrix4 view_projection;
+    const Math::Frustum<Real> frustum;
+    std::vector<Vec3> points;
+};
+
+template<typename Real>
+const size_t FrustumTest<Real>::count;
+
+typedef ::testing::Types<float, double> FrustumTypes;
+TYPED_TEST_CASE(FrustumTest, FrustumTypes);
+
+TYPED_TEST(FrustumTest, planes_have_unit_normals_pointing_into_the_frustum)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    const auto view = Math::matrix_look_at(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0));
+    const auto projection = Math::matrix_orthographic(TypeParam(-1), TypeParam(1), TypeParam(-2), TypeParam(2),
+                                                      TypeParam(1), TypeParam(9));
+    const Math::Frustum<TypeParam> frustum(projection * view);
+
+    const typename TestFixture::Vec4 expected[6] = {
+        typename TestFixture::Vec4(1, 0, 0, 1), typename TestFixture::Vec4(-1, 0, 0, 1),
+        typename TestFixture::Vec4(0, 1, 0, 2), typename TestFixture::Vec4(0, -1, 0, 2),
+        typename TestFixture::Vec4(0, 0, -1, -1), typename TestFixture::Vec4(0, 0, 1, 9)};
+    for (size_t p = 0; p < Math::Frustum<TypeParam>::plane_count; ++p) {
+        for (size_t c = 0; c < 4; ++c) {
+            EXPECT_NEAR(expected[p][c], frustum.get_plane(p)[c], 1e-6) << "plane " << p;
+        }
+    }
+}
+
+TYPED_TEST(FrustumTest, a_point_is_inside_when_it_projects_into_the_clip_cube)
+{
+    size_t inside = 0;
+    for (const auto & point : this->points) {
+        // Leave out points too close to a plane to tell with rounding
+        TypeParam distance = std::numeric_limits<TypeParam>::infinity();
+        for (size_t p = 0; p < Math::Frustum<TypeParam>::plane_count; ++p) {
+            const auto & plane = this->frustum.get_plane(p);
+            distance = std::min(distance, std::abs(plane[0] * point[0] + plane[1] * point[1] +
+                                                   plane[2] * point[2] + plane[3]));
+        }
+        if (distance < TypeParam(1e-3)) {
+            continue;
+        }
+
+        EXPECT_EQ(this->inside_clip_cube(point), Math::frustum_contains(this->frustum, point));
+        inside += Math::frustum_contains(this->frustum, point);
+    }
+    EXPECT_LT(0u, inside);
+    EXPECT_GT(this->count, inside);
+}
+
+TYPED_TEST(FrustumTest, volumes_are_culled_only_when_all_outside_one_plane)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    typedef Math::Sphere<TypeParam> Sphere;
+    typedef Math::AABB<TypeParam> AABB;
+    const auto view = Math::matrix_look_at(Vec3(0, 0, 0), Vec3(0, 0, -1), Vec3(0, 1, 0));
+    const Math::Frustum<TypeParam> frustum(Math::matrix_orthographic(TypeParam(-1), TypeParam(1), TypeParam(-1),
+                                                                     TypeParam(1), TypeParam(1), TypeParam(9)) * view);
+
+    EXPECT_TRUE(Math::frustum_intersects(frustum, Sphere(Vec3(0, 0, -5), TypeParam(0.5))));
+    EXPECT_TRUE(Math::frustum_intersects(frustum, Sphere(Vec3(1.5, 0, -5), TypeParam(0.75))));
+    EXPECT_TRUE(Math::frustum_intersects(frustum, Sphere(Vec3(0, 0, 0), TypeParam(1))));
+    EXPECT_FALSE(Math::frustum_intersects(frustum, Sphere(Vec3(1.5, 0, -5), TypeParam(0.25))));
+    EXPECT_FALSE(Math::frustum_intersects(frustum, Sphere(Vec3(0, 0, -10), TypeParam(0.5))));
+
+    EXPECT_TRUE(Math::frustum_intersects(frustum, AABB(Vec3(-5, -5, -5), Vec3(5, 5, 5))));
+    EXPECT_TRUE(Math::frustum_intersects(frustum, AABB(Vec3(1, 0, -3), Vec3(2, 1, -2))));
+    EXPECT_FALSE(Math::frustum_intersects(frustum, AABB(Vec3(1.25, 0, -3), Vec3(2, 1, -2))));
+    EXPECT_FALSE(Math::frustum_intersects(frustum, AABB(Vec3(0, 0, -0.5), Vec3(1, 1, 0))));
+}
+
+TYPED_TEST(FrustumTest, culling_spheres_keeps_the_same_as_testing_each_sphere)
+{
+    typedef Math::Sphere<TypeParam> Sphere;
+    std::vector<Sphere> spheres;
+    std::vector<TypeParam> radii;
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < this->count; ++i) {
+        spheres.push_back(Sphere(this->points[i], TypeParam(i % 10)));
+        radii.push_back(spheres.back().get_radius());
+        if (Math::frustum_intersects(this->frustum, spheres.back())) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_LT(0u, expected.size());
+    EXPECT_GT(this->count, expected.size());
+
+    const Math::VectorSoA<TypeParam, 3> centers(this->points.data(), this->count);
+    for (const size_t & threads : {size_t(1), size_t(3)}) {
+        std::vector<size_t> visible(this->count);
+        visible.resize(Math::frustum_cull(this->frustum, spheres.data(), this->count, visible.data(), threads));
+        EXPECT_EQ(expected, visible);
+
+        visible.assign(this->count, 0);
+        visible.resize(Math::frustum_cull(this->frustum, centers, radii.data(), visible.data(), threads));
+        EXPECT_EQ(expected, visible);
+    }
+}
+
+TYPED_TEST(FrustumTest, culling_boxes_keeps_the_same_as_testing_each_box)
+{
+    typedef typename TestFixture::Vec3 Vec3;
+    typedef Math::AABB<TypeParam> AABB;
+    std::vector<AABB> boxes;
+    Math::VectorSoA<TypeParam, 3> minimums;
+    Math::VectorSoA<TypeParam, 3> maximums;
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < this->count; ++i) {
+        const TypeParam size = TypeParam(i % 7);
+        boxes.push_back(AABB(this->points[i], Vec3(this->points[i] + Vec3(size, 2 * size, size))));
+        minimums.push_back(boxes.back().get_min());
+        maximums.push_back(boxes.back().get_max());
+        if (Math::frustum_intersects(this->frustum, boxes.back())) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_LT(0u, expected.size());
+    EXPECT_GT(this->count, expected.size());
+
+    for (const size_t & threads : {size_t(1), size_t(3)}) {
+        std::vector<size_t> visible(this->count);
+        visible.resize(Math::frustum_cull(this->frustum, boxes.data(), this->count, visible.data(), threads));
+        EXPECT_EQ(expected, visible);
+
+        visible.assign(this->count, 0);
+        visible.resize(Math::frustum_cull(this->frustum, minimums, maximums, visible.data(), threads));
+        EXPECT_EQ(expected, visible);
+    }
+}
+
+TYPED_TEST(FrustumTest, projecting_points_divides_the_clip_coordinates_by_w)
+{
+    const Math::VectorSoA<TypeParam, 3> points(this->points.data(), this->count);
+    Math::VectorSoA<TypeParam, 3> projected;
+    std::vector<TypeParam> w(this->count);
+
+    Math::project_points(this->view_projection, points, projected, w.data(), 3);
+    ASSERT_EQ(this->count, projected.size());
+
+    const TypeParam tolerance = 4 * std::numeric_limits<TypeParam>::epsilon();
+    for (size_t i = 0; i < this->count; ++i) {
+        const auto & point = this->points[i];
+        const auto clip = this->view_projection * typename TestFixture::Vec4(point[0], point[1], point[2], 1);
+        EXPECT_NEAR(clip[3], w[i], tolerance * std::abs(clip[3]));
+        for (size_t c = 0; c < 3; ++c) {
+            const TypeParam expected = clip[c] / clip[3];
+            EXPECT_NEAR(expected, projected[i][c], tolerance * std::abs(expected));
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#include "test-helpers.h"
+
+#include <half.h>
+#include <vector3.h>
+#include <vector4.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+uint32_t float_bits(const float & value);
+
+TEST(HalfTest, default_half_is_zero)
+{
+    const Math::half value;
+
+    EXPECT_EQ(0, value.get_bits());
+    EXPECT_EQ(0.0f, float(value));
+}
+
+TEST(HalfTest, exact_values_keep_their_value)
+{
+    EXPECT_EQ(0x3c00, Math::half(1.0f).get_bits());
+    EXPECT_EQ(0xc000, Math::half(-2.0f).get_bits());
+    EXPECT_EQ(0x3555, Math::half(0.333251953125f).get_bits());
+    EXPECT_EQ(0x7bff, Math::half(65504.0f).get_bits());
+    EXPECT_EQ(0x0400, Math::half(std::ldexp(1.0f, -14)).get_bits());
+    EXPECT_EQ(0x0001, Math::half(std::ldexp(1.0f, -24)).get_bits());
+    EXPECT_EQ(0x8000, Math::half(-0.0f).get_bits());
+}
+
+TEST(HalfTest, conversion_from_float_rounds_to_nearest_even)
+{
+    const float ulp = std::ldexp(1.0f, -10);
+
+    EXPECT_EQ(0x3c00, Math::half(1 + ulp / 2).get_bits());
+    EXPECT_EQ(0x3c02, Math::half(1 + 3 * ulp / 2).get_bits());
+    EXPECT_EQ(0x3c01, Math::half(1 + ulp / 2 + ulp / 64).get_bits());
+    EXPECT_EQ(0x3c00, Math::half(1 + ulp / 2 - ulp / 64).get_bits());
+}
+
+TEST(HalfTest, small_values_round_to_denormals_and_zero)
+{
+    const float smallest = std::ldexp(1.0f, -24);
+
+    EXPECT_EQ(0x0000, Math::half(smallest / 2).get_bits());
+    EXPECT_EQ(0x0002, Math::half(3 * smallest / 2).get_bits());
+    EXPECT_EQ(0x0001, Math::half(smallest * 0.75f).get_bits());
+    EXPECT_EQ(0x8000, Math::half(-smallest / 4).get_bits());
+    EXPECT_EQ(0x0000, Math::half(std::numeric_limits<float>::denorm_min()).get_bits());
+}
+
+TEST(HalfTest, large_values_overflow_to_infinity)
+{
+    EXPECT_EQ(0x7bff, Math::half(65519.0f).get_bits());
+    EXPECT_EQ(0x7c00, Math::half(65520.0f).get_bits());
+    EXPECT_EQ(0xfc00, Math::half(-1e10f).get_bits());
+    EXPECT_EQ(0x7c00, Math::half(std::numeric_limits<float>::infinity()).get_bits());
+}
+
+TEST(HalfTest, nan_stays_nan)
+{
+    const Math::half value(std::numeric_limits<float>::quiet_NaN());
+
+    EXPECT_EQ(0x7c00, value.get_bits() & 0x7c00);
+    EXPECT_NE(0, value.get_bits() & 0x3ff);
+    EXPECT_TRUE(std::isnan(float(value)));
+}
+
+TEST(HalfTest, every_half_converts_to_float_and_back)
+{
+    for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        const auto value = Math::half::from_bits(uint16_t(bits));
+        if ((bits & 0x7c00) == 0x7c00 && (bits & 0x3ff)) {
+            EXPECT_TRUE(std::isnan(float(value)));
+            continue;
+        }
+        EXPECT_EQ(bits, Math::half(float(value)).get_bits());
+    }
+}
+
+TEST(HalfTest, arithmetic_is_done_in_float)
+{
+    const Math::half left(1.5f);
+    const Math::half right(0.25f);
+    Math::half sum = left;
+    sum += right;
+
+    static_assert(std::is_same<decltype(left + right), float>::value, "Arithmetic on halves should give float");
+    EXPECT_EQ(1.75f, left + right);
+    EXPECT_EQ(0.375f, left * right);
+    EXPECT_EQ(1.75f, float(sum));
+}
+
+TEST(HalfTest, vector_of_halves_stores_and_adds_its_elements)
+{
+    const Math::Vec3h left(Math::half(1.0f), Math::half(2.0f), Math::half(3.0f));
+    const Math::Vec3h right(Math::half(0.5f), Math::half(0.25f), Math::half(-3.0f));
+
+    const Math::Vec3h sum = left + right;
+
+    EXPECT_EQ(3 * sizeof(Math::half), sizeof(Math::Vec3h));
+    EXPECT_EQ(1.5f, sum[0]);
+    EXPECT_EQ(2.25f, sum[1]);
+    EXPECT_EQ(0.0f, sum[2]);
+}
+
+TEST(HalfTest, array_conversion_is_the_same_as_converting_each_value)
+{
+    // Spread over every exponent of half and some beyond, and not a multiple
+    // of the register width
+    std::vector<float> values;
+    for (int exponent = -27; exponent < 18; ++exponent) {
+        values.push_back(std::ldexp(float(create_random_scalar()), exponent));
+        values.push_back(-std::ldexp(float(create_random_scalar()), exponent));
+    }
+    values.push_back(std::numeric_limits<float>::quiet_NaN());
+
+    std::vector<Math::half> halves(values.size());
+    std::vector<float> floats(values.size());
+    Math::float_to_half(values.data(), values.size(), halves.data());
+    Math::half_to_float(halves.data(), halves.size(), floats.data());
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(Math::half(values[i]).get_bits(), halves[i].get_bits());
+        EXPECT_EQ(float_bits(halves[i]), float_bits(floats[i]));
+    }
+}
+
+// With F16C this compares the instructions with the conversions of half
+TEST(HalfTest, array_conversion_matches_single_values_for_every_kind_of_float)
+{
+    std::vector<float> values;
+    for (uint64_t bits = 0; bits <= 0xffffffff; bits += 4099) {
+        const uint32_t single = uint32_t(bits);
+        float value;
+        std::memcpy(&value, &single, sizeof(value));
+        values.push_back(value);
+    }
+
+    std::vector<Math::half> halves(values.size());
+    Math::float_to_half(values.data(), values.size(), halves.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(Math::half(values[i]).get_bits(), halves[i].get_bits()) << "float bits " << float_bits(values[i]);
+    }
+
+    std::vector<Math::half> all_halves;
+    for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        all_halves.push_back(Math::half::from_bits(uint16_t(bits)));
+    }
+    std::vector<float> floats(all_halves.size());
+    Math::half_to_float(all_halves.data(), all_halves.size(), floats.data());
+    for (size_t i = 0; i < all_halves.size(); ++i) {
+        ASSERT_EQ(float_bits(all_halves[i]), float_bits(floats[i])) << "half bits " << all_halves[i].get_bits();
+    }
+}
+
+TEST(HalfTest, vector_array_conversion_is_the_same_as_converting_each_element)
+{
+    const size_t count = 13;
+    std::vector<Math::Vec3f> vectors3(count);
+    std::vector<Math::Vec4f> vectors4(count);
+    for (size_t i = 0; i < count; ++i) {
+        vectors3[i] = Math::Vec3f(float(create_random_scalar()), float(-create_random_scalar()), 1e-6f * i);
+        vectors4[i] = Math::Vec4f(float(create_random_scalar()), 70000.0f, 1e-6f * i, float(i));
+    }
+
+    std::vector<Math::Vec3h> halves3(count);
+    std::vector<Math::Vec4h> halves4(count);
+    std::vector<Math::Vec3f> floats3(count);
+    std::vector<Math::Vec4f> floats4(count);
+    Math::float_to_half(vectors3.data(), count, halves3.data());
+    Math::float_to_half(vectors4.data(), count, halves4.data());
+    Math::half_to_float(halves3.data(), count, floats3.data());
+    Math::half_to_float(halves4.data(), count, floats4.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_EQ(Math::half(vectors3[i][j]).get_bits(), halves3[i][j].get_bits());
+            EXPECT_EQ(float(halves3[i][j]), floats3[i][j]);
+        }
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ(Math::half(vectors4[i][j]).get_bits(), halves4[i][j].get_bits());
+            EXPECT_EQ(float(halves4[i][j]), floats4[i][j]);
+        }
+        if (Math::Simd::VectorStorage<float, 3>::size > 3) {
+            EXPECT_EQ(0.0f, floats3[i].end()[0]);
+        }
+    }
+}
+
+// Helper function
+uint32_t float_bits(const float & value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
@@ -0,0 +1,87 @@
+#include <matrix4.h>
+#include <quaternion.h>
+#include <vector3.h>
+#include <vector4.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+// Built without MATH_HEADER_ONLY, so the float and double functions below
+// come from the instantiations in the library, through the extern template
+// declarations of the headers
+template<typename Real>
+class LibraryTest : public ::testing::Test
+{
+protected:
+    typedef Math::Matrix<Real, 4> Matrix4;
+    typedef Math::Vector<Real, 3> Vec3;
+    typedef Math::Vector<Real, 4> Vec4;
+    typedef Math::Quaternion<Real> Quaternion;
+
+    // Small enough for float
+    Real precision() const
+    {
+        return Real(1e-4);
+    }
+
+    const Matrix4 matrix = Matrix4(4, 1, 0, 2,
+                                   1, 3, 1, 0,
+                                   0, 2, 5, 1,
+                                   1, 0, 1, 3);
+};
+
+typedef ::testing::Types<float, double> LibraryTypes;
+TYPED_TEST_CASE(LibraryTest, LibraryTypes);
+
+TYPED_TEST(LibraryTest, matrix_times_inverse_of_matrix_is_identity)
+{
+    const typename TestFixture::Matrix4 identity;
+    const auto res = this->matrix * matrix_inverse(this->matrix);
+
+    for (size_t i = 0; i < 16; ++i) {
+        EXPECT_NEAR(identity[i], res[i], this->precision());
+    }
+}
+
+TYPED_TEST(LibraryTest, matrix_times_solution_gives_the_vector)
+{
+    const typename TestFixture::Vec4 vector(1, -2, 3, 0.5);
+    const auto res = this->matrix * matrix_solve(this->matrix, vector);
+
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_NEAR(vector[i], res[i], this->precision());
+    }
+}
+
+TYPED_TEST(LibraryTest, slerp_halfway_between_rotations_about_an_axis_halves_the_angle)
+{
+    typedef typename TestFixture::Quaternion Quaternion;
+    const typename TestFixture::Vec3 axis(0, 0, 1);
+    const Quaternion from(axis, TypeParam(0.2));
+    const Quaternion to(axis, TypeParam(1.4));
+
+    const auto res = quaternion_slerp(from, to, TypeParam(0.5));
+    const Quaternion expected(axis, TypeParam(0.8));
+
+    EXPECT_NEAR(expected.w(), res.w(), this->precision());
+    EXPECT_NEAR(expected.x(), res.x(), this->precision());
+    EXPECT_NEAR(expected.y(), res.y(), this->precision());
+    EXPECT_NEAR(expected.z(), res.z(), this->precision());
+}
+
+TYPED_TEST(LibraryTest, orthonormal_basis_gives_orthogonal_vectors_of_length_1)
+{
+    typename TestFixture::Vec3 vector1(1, 2, 3);
+    typename TestFixture::Vec3 vector2(-1, 0, 2);
+    typename TestFixture::Vec3 vector3(0, 1, -1);
+
+    generate_orthonormal_basis(vector1, vector2, vector3);
+
+    EXPECT_NEAR(1, vector_length(vector1), this->precision());
+    EXPECT_NEAR(1, vector_length(vector2), this->precision());
+    EXPECT_NEAR(1, vector_length(vector3), this->precision());
+    EXPECT_NEAR(0, dot_product(vector1, vector2), this->precision());
+    EXPECT_NEAR(0, dot_product(vector1, vector3), this->precision());
+    EXPECT_NEAR(0, dot_product(vector2, vector3), this->precision());
+}
@@ -0,0 +1,29 @@
+// Only matrix.h, so the determinant and adjugate of integer matrices can not
+// lean on the closed forms of matrix2.h, matrix3.h and matrix4.h
+#include <matrix.h>
+
+#include <gtest/gtest.h>
+
+TEST(MatrixIntegerTest, determinant_of_integer_matrix_needs_only_matrix_h)
+{
+    const Math::Matrix<int, 3> matrix(2, 0, 1,
+                                      1, 3, 2,
+                                      1, 1, 2);
+
+    EXPECT_EQ(6, matrix_determinant(matrix));
+    EXPECT_EQ(0, matrix_determinant(Math::Matrix<int, 3>(1, 2, 3,
+                                                         2, 4, 6,
+                                                         0, 1, 5)));
+}
+
+TEST(MatrixIntegerTest, adjugate_of_integer_matrix_needs_only_matrix_h)
+{
+    const Math::Matrix<int, 3> matrix(2, 0, 1,
+                                      1, 3, 2,
+                                      1, 1, 2);
+
+    const Math::Matrix<int, 3> adjugate(4, 1, -3,
+                                        0, 3, -3,
+                                        -2, -2, 6);
+    EXPECT_EQ(adjugate, matrix_adjugate(matrix));
+}
@@ -0,0 +1,230 @@
+#include <matrix4.h>
+
+#include <gtest/gtest.h>
+
+#include "test-helpers.h"
+
+// Matrices larger than 4x4 have no closed form determinant, adjugate or
+// inverse, and go through the LU factorization
+typedef Math::Matrix<double, 5> Matrix5d;
+typedef Math::Vector<double, 5> Vec5d;
+
+class MatrixLUTest : public ::testing::Test
+{
+protected:
+    void SetUp();
+
+    Matrix5d random_matrix;
+    Vec5d random_vector;
+};
+
+void MatrixLUTest::SetUp()
+{
+    auto array = create_double_array_of_size(25);
+    random_matrix = Matrix5d(array);
+    delete[] array;
+
+    array = create_double_array_of_size(5);
+    random_vector = Vec5d(array);
+    delete[] array;
+}
+
+TEST_F(MatrixLUTest, factors_multiply_to_the_permuted_matrix)
+{
+    const auto lu = matrix_lu_decompose(random_matrix);
+
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            double element = 0;
+            for (size_t k = 0; k <= std::min(i, j); ++k) {
+                element += (k == i ? 1 : lu.factors(i,k)) * lu.factors(k,j);
+            }
+            EXPECT_NEAR(random_matrix(lu.permutation[i], j), element, PRECISION);
+        }
+    }
+}
+
+TEST_F(MatrixLUTest, determinant_of_identity_matrix_is_one)
+{
+    const Matrix5d identity;
+    EXPECT_EQ(1, matrix_determinant(identity));
+}
+
+TEST_F(MatrixLUTest, determinant_of_matrix_with_equal_rows_is_zero)
+{
+    auto matrix = random_matrix;
+    for (size_t j = 0; j < 5; ++j) {
+        matrix(3,j) = matrix(1,j);
+    }
+    EXPECT_EQ(0, matrix_determinant(matrix));
+}
+
+TEST_F(MatrixLUTest, determinant_of_matrix_follows_mathematical_rules)
+{
+    double determinant = 0;
+    for (size_t j = 0; j < 5; ++j) {
+        const double cofactor = matrix_determinant(create_submatrix(random_matrix, 0, j));
+        determinant += (j % 2 ? -1 : 1) * random_matrix(0,j) * cofactor;
+    }
+
+    EXPECT_NEAR(determinant, matrix_determinant(random_matrix), PRECISION * std::abs(determinant));
+}
+
+TEST_F(MatrixLUTest, determinant_of_matrix_with_dependent_rows_is_zero)
+{
+    // The last pivot is not exactly zero, because of rounding
+    Matrix5d matrix(0.2, 0.1, 0.0, 0.3, 0.1,
+                    0.1, 0.3, 0.2, 0.0, 0.1,
+                    0.0, 0.1, 0.4, 0.1, 0.2,
+                    0.3, 0.0, 0.1, 0.2, 0.1,
+                    0.1, 0.2, 0.0, 0.1, 0.3);
+    for (size_t j = 0; j < 5; ++j) {
+        matrix(3,j) = 0.3 * matrix(0,j) - 0.7 * matrix(1,j);
+    }
+    EXPECT_EQ(0, matrix_determinant(matrix));
+}
+
+TEST_F(MatrixLUTest, determinant_of_small_matrix_is_not_zero)
+{
+    const auto matrix = 1e-30 * random_matrix;
+    const auto determinant = matrix_determinant(random_matrix) * 1e-150;
+
+    EXPECT_NEAR(determinant, matrix_determinant(matrix), PRECISION * std::abs(determinant));
+}
+
+TEST_F(MatrixLUTest, badly_scaled_matrix_is_not_singular)
+{
+    const Matrix5d matrix(1e20, 0, 0, 0, 0,
+                          0,    1, 0, 0, 0,
+                          0,    0, 1, 0, 0,
+                          0,    0, 0, 1, 0,
+                          0,    0, 0, 0, 1);
+
+    EXPECT_EQ(1e20, matrix_determinant(matrix));
+
+    const auto inverse = matrix_inverse(matrix);
+    EXPECT_EQ(1e-20, inverse(0,0));
+    for (size_t i = 1; i < 5; ++i) {
+        EXPECT_EQ(1, inverse(i,i));
+    }
+
+    const auto solution = matrix_solve(matrix, random_vector);
+    EXPECT_NEAR(random_vector[0] * 1e-20, solution[0], PRECISION * 1e-20 * std::abs(random_vector[0]));
+    for (size_t i = 1; i < 5; ++i) {
+        EXPECT_NEAR(random_vector[i], solution[i], PRECISION);
+    }
+}
+
+TEST_F(MatrixLUTest, badly_scaled_block_matrix_is_not_singular)
+{
+    // Eliminating the large first row leaves a pivot of -1e-20 in the second
+    Matrix5d matrix(1e20, 1, 0, 0, 0,
+                    1,    0, 0, 0, 0,
+                    0,    0, 1, 0, 0,
+                    0,    0, 0, 1, 0,
+                    0,    0, 0, 0, 1);
+
+    EXPECT_NEAR(-1, matrix_determinant(matrix), PRECISION);
+
+    const Matrix5d expected(0, 1,     0, 0, 0,
+                            1, -1e20, 0, 0, 0,
+                            0, 0,     1, 0, 0,
+                            0, 0,     0, 1, 0,
+                            0, 0,     0, 0, 1);
+    const auto inverse = matrix_inverse(matrix);
+    for (auto i = 0; i < 25; ++i) {
+        EXPECT_NEAR(expected[i], inverse[i], PRECISION * std::max(1., std::abs(expected[i])));
+    }
+}
+
+TEST_F(MatrixLUTest, swapping_two_rows_negates_the_determinant)
+{
+    auto matrix = random_matrix;
+    for (size_t j = 0; j < 5; ++j) {
+        std::swap(matrix(0,j), matrix(4,j));
+    }
+
+    const auto determinant = matrix_determinant(random_matrix);
+    EXPECT_NEAR(-determinant, matrix_determinant(matrix), PRECISION * std::abs(determinant));
+}
+
+TEST_F(MatrixLUTest, matrix_times_inverse_of_matrix_is_identity)
+{
+    const Matrix5d identity;
+    const auto res = random_matrix * matrix_inverse(random_matrix);
+
+    for (auto i = 0; i < 25; ++i) {
+        EXPECT_NEAR(identity[i], res[i], PRECISION);
+    }
+}
+
+TEST_F(MatrixLUTest, adjugate_is_determinant_times_inverse)
+{
+    const auto adjugate = matrix_adjugate(random_matrix);
+    const auto inverse = matrix_inverse(random_matrix);
+    const auto determinant = matrix_determinant(random_matrix);
+
+    for (auto i = 0; i < 25; ++i) {
+        EXPECT_NEAR(determinant * inverse[i], adjugate[i], PRECISION * std::abs(determinant));
+    }
+}
+
+TEST_F(MatrixLUTest, adjugate_of_singular_matrix_comes_from_the_cofactors)
+{
+    auto matrix = random_matrix;
+    for (size_t j = 0; j < 5; ++j) {
+        matrix(3,j) = matrix(1,j);
+    }
+
+    const auto adjugate = matrix_adjugate(matrix);
+
+    bool all_zero = true;
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            const double minor = matrix_determinant(create_submatrix(matrix, j, i));
+            EXPECT_EQ((i + j) % 2 ? -minor : minor, adjugate(i,j));
+            all_zero = all_zero && adjugate(i,j) == 0;
+        }
+    }
+    EXPECT_FALSE(all_zero);
+}
+
+TEST(MatrixIntegerTest, determinant_and_adjugate_of_integer_matrix_are_exact)
+{
+    const Math::Matrix<int, 5> matrix(2, 1, 0, 3, 1,
+                                      1, 3, 2, 0, 1,
+                                      0, 1, 4, 1, 2,
+                                      3, 0, 1, 2, 1,
+                                      1, 2, 0, 1, 3);
+
+    const int determinant = matrix_determinant(matrix);
+    const auto res = matrix * matrix_adjugate(matrix);
+
+    EXPECT_NE(0, determinant);
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(i == j ? determinant : 0, res(i,j));
+        }
+    }
+}
+
+TEST_F(MatrixLUTest, matrix_times_solution_gives_the_vector)
+{
+    const auto solution = matrix_solve(random_matrix, random_vector);
+    const auto res = random_matrix * solution;
+
+    for (auto i = 0; i < 5; ++i) {
+        EXPECT_NEAR(random_vector[i], res[i], PRECISION);
+    }
+}
+
+TEST_F(MatrixLUTest, solving_singular_system_asserts)
+{
+    const Matrix5d zero(0, 0, 0, 0, 0,
+                        0, 0, 0, 0, 0,
+                        0, 0, 0, 0, 0,
+                        0, 0, 0, 0, 0,
+                        0, 0, 0, 0, 0);
+
+    EXPECT_DEATH(matrix_solve(zero, random_vector), "Can not solve singular system");
+}
@@ -0,0 +1,184 @@
+#include <matrix2.h>
+#include <matrix3.h>
+#include <matrix4.h>
+#include <quaternion.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "test-helpers.h"
+
+template<typename Matrix>
+struct MatrixType;
+
+template<typename Real_, size_t dim_>
+struct MatrixType<Math::Matrix<Real_, dim_> >
+{
+    typedef Real_ Real;
+    static const size_t dim = dim_;
+};
+
+// Every column major function is checked against the row major one on the
+// same matrix
+template<typename RowMatrix>
+class MatrixOrderTest : public ::testing::Test
+{
+protected:
+    typedef typename MatrixType<RowMatrix>::Real Real;
+    static const size_t dim = MatrixType<RowMatrix>::dim;
+    typedef Math::Matrix<Real, dim, Math::ColumnMajor> ColumnMatrix;
+    typedef Math::Vector<Real, dim> Vector;
+
+    void SetUp()
+    {
+        double * array = create_double_array_of_size(2*dim*dim + dim);
+        for (size_t i = 0; i < dim*dim; ++i) {
+            left[i] = Real(array[i]);
+            right[i] = Real(array[dim*dim + i]);
+        }
+        // A dominant diagonal keeps left away from singular, so its inverse
+        // and solutions do not lose too much to rounding
+        for (size_t i = 0; i < dim; ++i) {
+            vector[i] = Real(array[2*dim*dim + i]);
+            left(i,i) += Real(250 * dim);
+        }
+        delete[] array;
+    }
+
+    // Relative to the largest element, as the small ones come from
+    // cancellation
+    template<typename Matrix>
+    void expect_near(const RowMatrix & expected, const Matrix & matrix)
+    {
+        Real largest = 0;
+        for (size_t i = 0; i < dim*dim; ++i) {
+            largest = std::max(largest, std::abs(expected[i]));
+        }
+        for (size_t i = 0; i < dim; ++i) {
+            for (size_t j = 0; j < dim; ++j) {
+                EXPECT_NEAR(expected(i,j), matrix(i,j), tolerance(largest)) << "(" << i << "," << j << ")";
+            }
+        }
+    }
+
+    Real tolerance(const Real & value) const
+    {
+        return 100 * std::numeric_limits<Real>::epsilon() * std::abs(value);
+    }
+
+    RowMatrix left;
+    RowMatrix right;
+    Vector vector;
+};
+
+typedef ::testing::Types<Math::Matrix2d, Math::Matrix3f, Math::Matrix3d, Math::Matrix4f, Math::Matrix4d,
+                         Math::Matrix<double, 5> > MatrixOrderTypes;
+TYPED_TEST_CASE(MatrixOrderTest, MatrixOrderTypes);
+
+TYPED_TEST(MatrixOrderTest, column_major_matrices_store_the_columns_one_after_the_other)
+{
+    const size_t dim = TestFixture::dim;
+    const typename TestFixture::ColumnMatrix column(this->left);
+
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            EXPECT_EQ(this->left(i,j), column(i,j));
+            EXPECT_EQ(this->left[i*dim + j], column[j*dim + i]);
+        }
+    }
+    EXPECT_EQ(this->left, TypeParam(column));
+}
+
+TYPED_TEST(MatrixOrderTest, the_transposed_order_keeps_the_storage_and_transposes_the_matrix)
+{
+    const size_t dim = TestFixture::dim;
+    const auto transposed = Math::matrix_transposed_order(this->left);
+
+    for (size_t i = 0; i < dim*dim; ++i) {
+        EXPECT_EQ(this->left[i], transposed[i]);
+    }
+    EXPECT_EQ(typename TestFixture::ColumnMatrix(Math::matrix_transpose(this->left)), transposed);
+    EXPECT_EQ(this->left, Math::matrix_transposed_order(transposed));
+}
+
+TYPED_TEST(MatrixOrderTest, products_are_the_same_in_both_orders)
+{
+    typedef typename TestFixture::ColumnMatrix ColumnMatrix;
+    const ColumnMatrix left(this->left);
+    const ColumnMatrix right(this->right);
+
+    EXPECT_EQ(ColumnMatrix(this->left * this->right), left * right);
+    EXPECT_EQ(this->left * this->vector, left * this->vector);
+    EXPECT_EQ(this->vector * this->left, this->vector * left);
+}
+
+TYPED_TEST(MatrixOrderTest, element_wise_operations_are_the_same_in_both_orders)
+{
+    typedef typename TestFixture::ColumnMatrix ColumnMatrix;
+    typedef typename TestFixture::Real Real;
+    ColumnMatrix left(this->left);
+    const ColumnMatrix right(this->right);
+
+    EXPECT_EQ(ColumnMatrix(TypeParam(this->left + this->right * Real(2))), ColumnMatrix(left + right * Real(2)));
+    EXPECT_EQ(ColumnMatrix(TypeParam(this->left / Real(4))), ColumnMatrix(left / Real(4)));
+
+    auto row = this->left;
+    row += this->right;
+    row *= Real(3);
+    left += right;
+    left *= Real(3);
+    EXPECT_EQ(ColumnMatrix(row), left);
+    EXPECT_TRUE(left != ColumnMatrix(this->left));
+}
+
+TYPED_TEST(MatrixOrderTest, matrix_functions_are_the_same_in_both_orders)
+{
+    typedef typename TestFixture::ColumnMatrix ColumnMatrix;
+    const ColumnMatrix left(this->left);
+    const auto determinant = Math::matrix_determinant(this->left);
+
+    EXPECT_NEAR(determinant, Math::matrix_determinant(left), this->tolerance(determinant));
+    EXPECT_EQ(Math::matrix_trace(this->left), Math::matrix_trace(left));
+    EXPECT_EQ(ColumnMatrix(Math::matrix_transpose(this->left)), Math::matrix_transpose(left));
+    this->expect_near(Math::matrix_adjugate(this->left), Math::matrix_adjugate(left));
+    this->expect_near(Math::matrix_inverse(this->left), Math::matrix_inverse(left));
+
+    const auto solution = Math::matrix_solve(this->left, this->vector);
+    const auto column_solution = Math::matrix_solve(left, this->vector);
+    typename TestFixture::Real largest = 0;
+    for (size_t i = 0; i < TestFixture::dim; ++i) {
+        largest = std::max(largest, std::abs(solution[i]));
+    }
+    for (size_t i = 0; i < TestFixture::dim; ++i) {
+        EXPECT_NEAR(solution[i], column_solution[i], this->tolerance(largest));
+    }
+}
+
+TEST(MatrixOrderTransformTest, transform_functions_take_column_major_matrices)
+{
+    // A quarter turn around z, then a translation
+    const Math::Matrix4d rigid(0, -1, 0, 3,
+                               1, 0, 0, 5,
+                               0, 0, 1, 7,
+                               0, 0, 0, 1);
+    Math::Matrix4d affine = rigid;
+    affine(0,0) = 2;
+    const Math::Matrix<double, 4, Math::ColumnMajor> column_rigid(rigid);
+    const Math::Matrix<double, 4, Math::ColumnMajor> column_affine(affine);
+
+    EXPECT_TRUE(Math::matrix_is_affine(column_affine));
+    EXPECT_TRUE(Math::matrix_is_rigid(column_rigid));
+    EXPECT_FALSE(Math::matrix_is_rigid(column_affine));
+    EXPECT_FALSE(Math::matrix_is_affine(Math::matrix_transposed_order(column_rigid)));
+
+    EXPECT_EQ(Math::matrix_inverse_rigid(rigid), Math::Matrix4d(Math::matrix_inverse_rigid(column_rigid)));
+    EXPECT_EQ(Math::matrix_inverse_affine(affine), Math::Matrix4d(Math::matrix_inverse_affine(column_affine)));
+
+    const Math::Quaternion<double> quaternion(rigid);
+    const Math::Quaternion<double> column_quaternion(column_rigid);
+    EXPECT_EQ(quaternion.real, column_quaternion.real);
+    EXPECT_EQ(quaternion.imag, column_quaternion.imag);
+}
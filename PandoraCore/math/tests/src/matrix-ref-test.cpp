@@ -0,0 +1,118 @@
+#include "test-helpers.h"
+
+#include <matrix_ref.h>
+#include <matrix3.h>
+#include <matrix4.h>
+#include <vector4.h>
+
+#include <gtest/gtest.h>
+
+// A 4x4 matrix in the upper left block of a 4x6 buffer, so the rows are six
+// elements apart
+class MatrixRefTest : public ::testing::Test
+{
+protected:
+    void SetUp();
+
+    Math::MatrixRef<double, 4> block();
+    Math::Matrix4d copy();
+
+    double buffer[24];
+};
+
+void MatrixRefTest::SetUp()
+{
+    for (size_t i = 0; i < 24; ++i) {
+        buffer[i] = create_random_scalar();
+    }
+}
+
+Math::MatrixRef<double, 4> MatrixRefTest::block()
+{
+    return Math::MatrixRef<double, 4>(buffer, 6);
+}
+
+Math::Matrix4d MatrixRefTest::copy()
+{
+    Math::Matrix4d matrix;
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            matrix(i,j) = buffer[6*i + j];
+        }
+    }
+    return matrix;
+}
+
+TEST_F(MatrixRefTest, elements_are_read_and_written_in_place)
+{
+    const auto view = block();
+
+    EXPECT_EQ(&buffer[6*2 + 3], &view(2,3));
+    EXPECT_EQ(&buffer[6*2 + 3], &view[2*4 + 3]);
+    EXPECT_EQ(&buffer[6*1], &view.row(1)[0]);
+    EXPECT_EQ(&buffer[6*3 + 2], &view.column(2)[3]);
+
+    view(1,1) = 5;
+    EXPECT_EQ(5., buffer[7]);
+    EXPECT_EQ(copy(), Math::Matrix4d(view));
+}
+
+TEST_F(MatrixRefTest, assignment_writes_only_the_viewed_block)
+{
+    const Math::Matrix4d identity;
+    const double outside[2] = {buffer[4], buffer[5]};
+
+    block() = identity;
+    EXPECT_EQ(identity, copy());
+    EXPECT_EQ(outside[0], buffer[4]);
+    EXPECT_EQ(outside[1], buffer[5]);
+
+    Math::Matrix4d matrix;
+    const Math::MatrixRef<double, 4> view(matrix);
+    view = block() * 2.;
+    EXPECT_EQ(identity * 2., matrix);
+}
+
+TEST_F(MatrixRefTest, expressions_mix_views_and_matrices)
+{
+    const Math::Matrix4d matrix = copy() * 3.;
+    const Math::MatrixRef<const double, 4> view = block();
+
+    const Math::Matrix4d sum = view + matrix - view / 2.;
+    for (size_t i = 0; i < 16; ++i) {
+        EXPECT_NEAR(copy()[i] + matrix[i] - copy()[i] / 2, sum[i], PRECISION);
+    }
+    EXPECT_TRUE(view * 3. == matrix);
+}
+
+TEST_F(MatrixRefTest, products_and_transpose_match_the_matrix_ones)
+{
+    const Math::Matrix4d matrix = copy();
+    const Math::Matrix4d other = matrix_transpose(matrix) * 2.;
+    const Math::Vec4d vector(1, 2, 3, 4);
+    double vector_elements[8] = {1, 0, 2, 0, 3, 0, 4, 0};
+    const Math::VectorRef<const double, 4> vector_view(vector_elements, 2);
+    const Math::MatrixRef<const double, 4> view = block();
+
+    EXPECT_EQ(matrix * other, view * other);
+    EXPECT_EQ(other * matrix, other * view);
+    EXPECT_EQ(matrix * matrix, view * view);
+    EXPECT_EQ(matrix * vector, view * vector);
+    EXPECT_EQ(matrix * vector, matrix * vector_view);
+    EXPECT_EQ(matrix * vector, view * vector_view);
+    EXPECT_EQ(vector * matrix, vector * view);
+    EXPECT_EQ(vector * matrix, vector_view * view);
+    EXPECT_EQ(Math::matrix_transpose(matrix), Math::matrix_transpose(view));
+    EXPECT_EQ(Math::matrix_trace(matrix), Math::matrix_trace(view));
+}
+
+TEST_F(MatrixRefTest, views_of_rows_and_columns_are_vector_views)
+{
+    const Math::Matrix4d matrix = copy();
+
+    EXPECT_EQ(matrix(2,0) * matrix(0,1) + matrix(2,1) * matrix(1,1) + matrix(2,2) * matrix(2,1) +
+              matrix(2,3) * matrix(3,1), Math::dot_product(block().row(2), block().column(1)));
+
+    block().column(0) = Math::Vec4d(1, 2, 3, 4);
+    EXPECT_EQ(3., buffer[12]);
+}
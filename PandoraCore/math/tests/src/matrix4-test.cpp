@@ -4,6 +4,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "test-helpers.h"
 
 const Math::Matrix4d create_random_matrix4();
@@ -443,6 +445,126 @@ TEST_F(Matrix4Test, matrix_times_inverse_of_matrix_is_identity)
     }
 }
 
+TEST_F(Matrix4Test, inverse_of_given_matrix_gives_correct_result)
+{
+    const Math::Matrix4d matrix({2, 0, 0, 3,
+            0, 4, 0, 5,
+            0, 0, 8, 6,
+            0, 0, 0, 1});
+    const Math::Matrix4d expected({0.5, 0, 0, -1.5,
+            0, 0.25, 0, -1.25,
+            0, 0, 0.125, -0.75,
+            0, 0, 0, 1});
+
+    EXPECT_EQ(expected, matrix_inverse(matrix));
+}
+
+TEST_F(Matrix4Test, inverse_of_float_matrix_times_matrix_is_identity)
+{
+    Math::Matrix4f matrix;
+    for (auto i = 0; i < 16; ++i) {
+        matrix[i] = random_matrix[i];
+    }
+    const auto res = matrix_inverse(matrix) * matrix;
+
+    const Math::Matrix4f identity;
+    for (auto i = 0; i < 16; ++i) {
+        EXPECT_NEAR(identity[i], res[i], 1.0e-3);
+    }
+}
+
+TEST_F(Matrix4Test, inverse_of_singular_matrix_asserts)
+{
+    EXPECT_DEATH(matrix_inverse(zero_matrix), "Can not invert singular matrix");
+}
+
+TEST_F(Matrix4Test, matrix_times_adjugate_is_determinant_times_identity)
+{
+    const auto res = random_matrix * matrix_adjugate(random_matrix);
+    const auto determinant = matrix_determinant(random_matrix);
+
+    const Math::Matrix4d identity;
+    for (auto i = 0; i < 16; ++i) {
+        EXPECT_NEAR(determinant * identity[i], res[i], PRECISION * std::abs(determinant));
+    }
+}
+
+TEST_F(Matrix4Test, solving_matrix_gives_the_same_as_multiplying_with_the_inverse)
+{
+    const auto res = matrix_solve(random_matrix, random_vector);
+    const auto expected = matrix_inverse(random_matrix) * random_vector;
+
+    for (auto i = 0; i < 4; ++i) {
+        EXPECT_NEAR(expected[i], res[i], PRECISION);
+    }
+}
+
+TEST_F(Matrix4Test, rigid_inverse_of_rotation_and_translation_gives_correct_result)
+{
+    // A quarter turn around z, then a translation
+    const Math::Matrix4d matrix({0, -1, 0, 3,
+            1, 0, 0, 5,
+            0, 0, 1, 7,
+            0, 0, 0, 1});
+    const Math::Matrix4d expected({0, 1, 0, -5,
+            -1, 0, 0, 3,
+            0, 0, 1, -7,
+            0, 0, 0, 1});
+
+    EXPECT_EQ(expected, matrix_inverse_rigid(matrix));
+}
+
+TEST_F(Matrix4Test, rigid_inverse_gives_the_same_as_the_general_inverse)
+{
+    const double c = std::cos(0.3);
+    const double s = std::sin(0.3);
+    const Math::Matrix4d matrix({c, 0, s, random_matrix(0,3),
+            0, 1, 0, random_matrix(1,3),
+            -s, 0, c, random_matrix(2,3),
+            0, 0, 0, 1});
+
+    const auto expected = matrix_inverse(matrix);
+    const auto res = matrix_inverse_rigid(matrix);
+    for (auto i = 0; i < 16; ++i) {
+        EXPECT_NEAR(expected[i], res[i], PRECISION);
+    }
+}
+
+TEST_F(Matrix4Test, affine_inverse_gives_the_same_as_the_general_inverse)
+{
+    auto matrix = random_matrix;
+    matrix(3,0) = 0;
+    matrix(3,1) = 0;
+    matrix(3,2) = 0;
+    matrix(3,3) = 1;
+
+    const auto expected = matrix_inverse(matrix);
+    const auto res = matrix_inverse_affine(matrix);
+    for (auto i = 0; i < 16; ++i) {
+        EXPECT_NEAR(expected[i], res[i], PRECISION);
+    }
+}
+
+TEST_F(Matrix4Test, affine_inverse_of_projection_asserts)
+{
+    Math::Matrix4d projection;
+    projection(3,2) = -1;
+    projection(3,3) = 0;
+
+    EXPECT_FALSE(matrix_is_affine(projection));
+    EXPECT_DEATH(matrix_inverse_affine(projection), "Matrix is not an affine transform");
+}
+
+TEST_F(Matrix4Test, rigid_inverse_of_scaling_matrix_asserts)
+{
+    Math::Matrix4d scaling;
+    scaling(1,1) = 2;
+
+    EXPECT_TRUE(matrix_is_affine(scaling));
+    EXPECT_FALSE(matrix_is_rigid(scaling));
+    EXPECT_DEATH(matrix_inverse_rigid(scaling), "Matrix is not a rigid transform");
+}
+
 TEST_F(Matrix4Test, equality_operator_on_same_matrix_returns_true)
 {
     EXPECT_EQ(random_matrix, random_matrix);
@@ -455,6 +577,65 @@ TEST_F(Matrix4Test, equality_operator_on_copy_of_matrix_returns_true)
     EXPECT_EQ(copy, random_matrix);
 }
 
+// Clip coordinates of a point, divided by w
+Math::Vec3d project(const Math::Matrix4d & matrix, const Math::Vec3d & point)
+{
+    const Math::Vec4d clip = matrix * Math::Vec4d(point[0], point[1], point[2], 1.0);
+    return Math::Vec3d(clip[0] / clip[3], clip[1] / clip[3], clip[2] / clip[3]);
+}
+
+TEST_F(Matrix4Test, perspective_maps_the_view_volume_to_the_clip_cube)
+{
+    const double fov_y = 1.0;
+    const double aspect = 1.5;
+    const auto matrix = Math::matrix_perspective(fov_y, aspect, 0.5, 100.0);
+    const double half_height = std::tan(fov_y / 2);
+
+    const auto near_corner = project(matrix, Math::Vec3d(0.5 * half_height * aspect, -0.5 * half_height, -0.5));
+    EXPECT_NEAR(1, near_corner[0], PRECISION);
+    EXPECT_NEAR(-1, near_corner[1], PRECISION);
+    EXPECT_NEAR(-1, near_corner[2], PRECISION);
+
+    const auto far_corner = project(matrix, Math::Vec3d(-100 * half_height * aspect, 100 * half_height, -100));
+    EXPECT_NEAR(-1, far_corner[0], PRECISION);
+    EXPECT_NEAR(1, far_corner[1], PRECISION);
+    EXPECT_NEAR(1, far_corner[2], PRECISION);
+}
+
+TEST_F(Matrix4Test, orthographic_maps_the_box_to_the_clip_cube)
+{
+    const auto matrix = Math::matrix_orthographic(-2.0, 4.0, -1.0, 3.0, 1.0, 11.0);
+
+    EXPECT_TRUE(matrix_is_affine(matrix));
+    const auto low = project(matrix, Math::Vec3d(-2, -1, -1));
+    const auto high = project(matrix, Math::Vec3d(4, 3, -11));
+    const auto center = project(matrix, Math::Vec3d(1, 1, -6));
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(-1, low[i], PRECISION);
+        EXPECT_NEAR(1, high[i], PRECISION);
+        EXPECT_NEAR(0, center[i], PRECISION);
+    }
+}
+
+TEST_F(Matrix4Test, look_at_puts_the_target_in_front_of_the_camera)
+{
+    const Math::Vec3d eye(1, 2, 3);
+    const Math::Vec3d target(4, -2, 3);
+    const auto matrix = Math::matrix_look_at(eye, target, Math::Vec3d(0, 0, 1));
+
+    EXPECT_TRUE(matrix_is_rigid(matrix));
+    const auto view_eye = project(matrix, eye);
+    const auto view_target = project(matrix, target);
+    const auto view_above = project(matrix, Math::Vec3d(1, 2, 4));
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(0, view_eye[i], PRECISION);
+    }
+    EXPECT_NEAR(0, view_target[0], PRECISION);
+    EXPECT_NEAR(0, view_target[1], PRECISION);
+    EXPECT_NEAR(-5, view_target[2], PRECISION);
+    EXPECT_NEAR(1, view_above[1], PRECISION);
+}
+
 TEST_F(Matrix4Test, equality_operator_on_different_matrix_returns_false)
 {
     const auto matrix = create_random_matrix4();
@@ -486,6 +667,23 @@ TEST_F(Matrix4Test, inequality_of_different_matrix_returns_true)
     EXPECT_NE(matrix, other);
 }
 
+TEST_F(Matrix4Test, identity_transpose_and_determinant_can_be_evaluated_in_constant_expressions)
+{
+    constexpr Math::Matrix4d identity;
+    constexpr Math::Matrix4d matrix(2, 0, 0, 1,
+                                    0, 3, 0, 2,
+                                    0, 0, 4, 3,
+                                    0, 0, 0, 1);
+    constexpr auto transposed = matrix_transpose(matrix);
+    constexpr Math::Matrix4d sum = identity + transposed;
+
+    static_assert(identity(2,2) == 1 && identity(2,3) == 0, "Default matrix should be the identity");
+    static_assert(transposed(3,0) == 1 && transposed(0,3) == 0, "Transpose should swap rows and columns");
+    static_assert(sum(1,1) == 4, "Matrix arithmetic should be evaluated at compile time");
+    static_assert(matrix_determinant(matrix) == 24, "Determinant should be evaluated at compile time");
+    EXPECT_EQ(24, matrix_determinant(matrix));
+}
+
 const Math::Matrix4d create_random_matrix4()
 {
     auto array = create_double_array_of_size(16);
@@ -1,5 +1,6 @@
 #include <quaternion.h>
 #include <vector3.h>
+#include <vector4.h>
 #include <gtest/gtest.h>
 #include <cmath>
 
@@ -157,6 +158,19 @@ TEST_F(QuaternionTest, creating_matrix_from_quaternion_gives_correct_matrix)
     }
 }
 
+TEST_F(QuaternionTest, creating_column_major_matrix_from_quaternion_gives_the_same_matrix)
+{
+    const auto quat = create_random_quaternion();
+    const auto res = Math::quaternion_to_matrix<Math::ColumnMajor>(quat);
+    const auto correct = make_matrix_from_quaternion(quat);
+
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ(correct(i,j), res(i,j));
+        }
+    }
+}
+
 TEST_F(QuaternionTest, norm_of_identity_quaternion_is_1)
 {
     const Math::Quaternion<double> quat;
@@ -356,6 +370,28 @@ TEST_F(QuaternionTest, normalizing_quaternion_gives_a_unit_quaternion)
     EXPECT_FLOAT_EQ(1, quaternion_norm(quat));
 }
 
+TEST_F(QuaternionTest, fast_normalizing_quaternion_gives_a_unit_quaternion)
+{
+    auto quat = create_random_quaternion();
+    auto expected = quat;
+    quaternion_normalize_fast(quat);
+    quaternion_normalize(expected);
+
+    EXPECT_DOUBLE_EQ(1, quaternion_norm(quat));
+    EXPECT_DOUBLE_EQ(expected.w(), quat.w());
+    EXPECT_DOUBLE_EQ(expected.x(), quat.x());
+    EXPECT_DOUBLE_EQ(expected.y(), quat.y());
+    EXPECT_DOUBLE_EQ(expected.z(), quat.z());
+}
+
+TEST_F(QuaternionTest, fast_normalizing_float_quaternion_gives_nearly_a_unit_quaternion)
+{
+    Math::Quaternion<float> quat(3.f, -1.5f, 0.25f, 7.f);
+    quaternion_normalize_fast(quat);
+
+    EXPECT_NEAR(1, quaternion_norm(quat), 1e-6);
+}
+
 TEST_F(QuaternionTest, spherical_linear_interpolation_between_from_and_to_with_t_equal_zero_returns_from)
 {
     auto from = create_random_quaternion();
@@ -403,6 +439,163 @@ TEST_F(QuaternionTest, sperical_linear_interpolation_makes_correct_quaternion)
     EXPECT_EQ(correct.z(), res.z());
 }
 
+TEST_F(QuaternionTest, spherical_linear_interpolation_takes_the_shorter_arc)
+{
+    auto from = create_random_quaternion();
+    auto to = create_random_quaternion();
+    quaternion_normalize(from);
+    quaternion_normalize(to);
+
+    const auto t =(rand() % 400) / 400.0;
+    const auto res = quaternion_slerp(from, -1.0 * to, t);
+    const auto correct = slerp(from, to, t);
+
+    EXPECT_NEAR(correct.w(), res.w(), 1e-12);
+    EXPECT_NEAR(correct.x(), res.x(), 1e-12);
+    EXPECT_NEAR(correct.y(), res.y(), 1e-12);
+    EXPECT_NEAR(correct.z(), res.z(), 1e-12);
+}
+
+TEST_F(QuaternionTest, spherical_linear_interpolation_between_equal_quaternions_gives_the_quaternion)
+{
+    auto quat = create_random_quaternion();
+    quaternion_normalize(quat);
+
+    const auto res = quaternion_slerp(quat, quat, 0.25);
+
+    EXPECT_DOUBLE_EQ(quat.w(), res.w());
+    EXPECT_DOUBLE_EQ(quat.x(), res.x());
+    EXPECT_DOUBLE_EQ(quat.y(), res.y());
+    EXPECT_DOUBLE_EQ(quat.z(), res.z());
+}
+
+TEST_F(QuaternionTest, normalized_linear_interpolation_gives_a_unit_quaternion_between_from_and_to)
+{
+    auto from = create_random_quaternion();
+    auto to = create_random_quaternion();
+    quaternion_normalize(from);
+    quaternion_normalize(to);
+
+    const auto res = quaternion_nlerp(from, to, 0.5);
+    const auto halfway = (from + to) / quaternion_norm(from + to);
+
+    EXPECT_DOUBLE_EQ(1, quaternion_norm(res));
+    EXPECT_DOUBLE_EQ(halfway.w(), res.w());
+    EXPECT_DOUBLE_EQ(halfway.x(), res.x());
+    EXPECT_DOUBLE_EQ(halfway.y(), res.y());
+    EXPECT_DOUBLE_EQ(halfway.z(), res.z());
+}
+
+TEST_F(QuaternionTest, normalized_linear_interpolation_takes_the_shorter_arc)
+{
+    auto from = create_random_quaternion();
+    auto to = create_random_quaternion();
+    quaternion_normalize(from);
+    quaternion_normalize(to);
+
+    const auto t =(rand() % 400) / 400.0;
+    const auto res = quaternion_nlerp(from, -1.0 * to, t);
+    const auto correct = quaternion_nlerp(from, to, t);
+
+    EXPECT_NEAR(correct.w(), res.w(), 1e-12);
+    EXPECT_NEAR(correct.x(), res.x(), 1e-12);
+    EXPECT_NEAR(correct.y(), res.y(), 1e-12);
+    EXPECT_NEAR(correct.z(), res.z(), 1e-12);
+}
+
+TEST_F(QuaternionTest, fast_spherical_linear_interpolation_is_close_to_spherical_linear_interpolation)
+{
+    // From a quarter turn to half a turn apart, where the polynomial is the furthest off
+    const Math::Quaternion<double> from;
+    for (auto angle = 0.25; angle <= 1.5; angle += 0.25) {
+        const Math::Quaternion<double> to(std::cos(angle), 0.0, std::sin(angle), 0.0);
+        for (auto t = 0.0; t <= 1.0; t += 0.125) {
+            const auto res = quaternion_fast_slerp(from, to, t);
+            const auto correct = quaternion_slerp(from, to, t);
+
+            EXPECT_NEAR(correct.w(), res.w(), 3e-5);
+            EXPECT_NEAR(correct.y(), res.y(), 3e-5);
+            EXPECT_NEAR(1, quaternion_norm(res), 6e-5);
+        }
+    }
+}
+
+TEST_F(QuaternionTest, fast_spherical_linear_interpolation_takes_the_shorter_arc)
+{
+    auto from = create_random_quaternion();
+    auto to = create_random_quaternion();
+    quaternion_normalize(from);
+    quaternion_normalize(to);
+
+    const auto t =(rand() % 400) / 400.0;
+    const auto res = quaternion_fast_slerp(from, -1.0 * to, t);
+    const auto correct = quaternion_slerp(from, to, t);
+
+    EXPECT_NEAR(correct.w(), res.w(), 3e-5);
+    EXPECT_NEAR(correct.x(), res.x(), 3e-5);
+    EXPECT_NEAR(correct.y(), res.y(), 3e-5);
+    EXPECT_NEAR(correct.z(), res.z(), 3e-5);
+}
+
+TEST_F(QuaternionTest, quaternion_arithmetic_can_be_evaluated_in_constant_expressions)
+{
+    constexpr Math::Quaternion<double> quat(0.5, 0.5, -0.5, 0.5);
+    constexpr auto product = quat * quaternion_conjugate(quat);
+    constexpr auto sum = (quat + quat) / 2.0;
+
+    static_assert(product.w() == 1 && product.x() == 0 && product.y() == 0 && product.z() == 0,
+                  "Quaternion product should be evaluated at compile time");
+    static_assert(sum.w() == quat.w() && sum.z() == quat.z(),
+                  "Quaternion arithmetic should be evaluated at compile time");
+    EXPECT_EQ(1, product.w());
+}
+
+TEST_F(QuaternionTest, rotating_vector_by_identity_quaternion_gives_the_same_vector)
+{
+    const auto vector = create_random_vector3();
+
+    EXPECT_EQ(vector, quaternion_rotate(Math::Quaternion<double>(), vector));
+}
+
+TEST_F(QuaternionTest, rotating_vector_by_unit_quaternion_is_the_same_as_multiplying_by_the_quaternion_and_its_conjugate)
+{
+    auto quat = create_random_quaternion();
+    quaternion_normalize(quat);
+    const auto vector = create_random_vector3();
+
+    const auto rotated = quaternion_rotate(quat, vector);
+    const auto correct = quat * Math::Quaternion<double>(0, vector) * quaternion_conjugate(quat);
+
+    EXPECT_NEAR(correct.x(), rotated[0], 1e-12);
+    EXPECT_NEAR(correct.y(), rotated[1], 1e-12);
+    EXPECT_NEAR(correct.z(), rotated[2], 1e-12);
+}
+
+TEST_F(QuaternionTest, rotating_vector_by_unit_quaternion_is_the_same_as_multiplying_by_its_matrix)
+{
+    auto quat = create_random_quaternion();
+    quaternion_normalize(quat);
+    const auto vector = create_random_vector3();
+
+    const auto rotated = quaternion_rotate(quat, vector);
+    const auto correct = quaternion_to_matrix(quat) * Math::Vec4d(vector[0], vector[1], vector[2], 0.0);
+
+    EXPECT_NEAR(correct[0], rotated[0], 1e-12);
+    EXPECT_NEAR(correct[1], rotated[1], 1e-12);
+    EXPECT_NEAR(correct[2], rotated[2], 1e-12);
+}
+
+TEST_F(QuaternionTest, rotating_vector_can_be_evaluated_in_constant_expressions)
+{
+    // Half a turn around the z axis
+    constexpr Math::Quaternion<double> quat(0.0, 0.0, 0.0, 1.0);
+    constexpr auto rotated = quaternion_rotate(quat, Math::Vec3d(1.0, 2.0, 3.0));
+
+    static_assert(rotated[0] == -1 && rotated[1] == -2 && rotated[2] == 3,
+                  "Quaternion rotation should be evaluated at compile time");
+    EXPECT_EQ(-1, rotated[0]);
+}
+
 // Helper function
 Math::Quaternion<double> create_random_quaternion()
 {
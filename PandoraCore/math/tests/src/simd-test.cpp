@@ -0,0 +1,383 @@
+#include "test-helpers.h"
+
+#include <simd.h>
+#include <vector2.h>
+#include <vector3.h>
+#include <vector4.h>
+#include <matrix3.h>
+#include <matrix4.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+template<typename VectorType>
+VectorType create_random_vector()
+{
+    VectorType vector;
+    for (auto & element : vector) {
+        element = create_random_scalar();
+    }
+    return vector;
+}
+
+template<typename VectorType>
+size_t dimension(const VectorType & vector)
+{
+    return vector.end() - vector.begin();
+}
+
+template<typename VectorType>
+class SimdVectorTest : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        left = create_random_vector<VectorType>();
+        right = create_random_vector<VectorType>();
+        scalar = create_random_scalar() + 1;
+    }
+
+    VectorType left;
+    VectorType right;
+    typename std::remove_reference<decltype(left[0])>::type scalar;
+};
+
+typedef ::testing::Types<Math::Vec3f, Math::Vec4f, Math::Vec2d, Math::Vec3d, Math::Vec4d> SimdVectorTypes;
+TYPED_TEST_CASE(SimdVectorTest, SimdVectorTypes);
+
+TYPED_TEST(SimdVectorTest, iterating_over_a_vector_only_visits_its_dimension)
+{
+    size_t i = 0;
+    for (auto element : this->left) {
+        EXPECT_EQ(this->left[i++], element);
+    }
+    EXPECT_EQ(this->left.end(), this->left.begin() + i);
+}
+
+TYPED_TEST(SimdVectorTest, adding_vectors_gives_the_same_result_as_adding_each_element)
+{
+    auto expected = this->left;
+    for (size_t i = 0; i < dimension(expected); ++i) {
+        expected[i] = this->left[i] + this->right[i];
+    }
+    EXPECT_EQ(expected, this->left + this->right);
+}
+
+TYPED_TEST(SimdVectorTest, subtracting_vectors_gives_the_same_result_as_subtracting_each_element)
+{
+    auto expected = this->left;
+    for (size_t i = 0; i < dimension(expected); ++i) {
+        expected[i] = this->left[i] - this->right[i];
+    }
+    EXPECT_EQ(expected, this->left - this->right);
+}
+
+TYPED_TEST(SimdVectorTest, multiplying_vectors_gives_the_same_result_as_multiplying_each_element)
+{
+    auto expected = this->left;
+    for (size_t i = 0; i < dimension(expected); ++i) {
+        expected[i] = this->left[i] * this->right[i];
+    }
+    EXPECT_EQ(expected, this->left * this->right);
+}
+
+TYPED_TEST(SimdVectorTest, scaling_and_dividing_gives_the_same_result_as_scaling_each_element)
+{
+    auto scaled = this->left;
+    auto divided = this->left;
+    for (size_t i = 0; i < dimension(scaled); ++i) {
+        scaled[i] = this->left[i] * this->scalar;
+        divided[i] = this->left[i] / this->scalar;
+    }
+    EXPECT_EQ(scaled, this->left * this->scalar);
+    EXPECT_EQ(divided, this->left / this->scalar);
+}
+
+TYPED_TEST(SimdVectorTest, dot_product_sums_the_products_in_index_order)
+{
+    auto expected = this->left[0] * this->right[0];
+    for (size_t i = 1; i < dimension(this->left); ++i) {
+        expected += this->left[i] * this->right[i];
+    }
+    EXPECT_EQ(expected, dot_product(this->left, this->right));
+}
+
+TYPED_TEST(SimdVectorTest, padding_does_not_leak_into_the_dot_product_after_dividing)
+{
+    this->left /= this->scalar;
+    this->right /= this->scalar;
+
+    auto expected = this->left[0] * this->right[0];
+    for (size_t i = 1; i < dimension(this->left); ++i) {
+        expected += this->left[i] * this->right[i];
+    }
+    EXPECT_EQ(expected, dot_product(this->left, this->right));
+}
+
+TYPED_TEST(SimdVectorTest, length_and_normalizing_sum_the_squares_in_index_order)
+{
+    auto squared = this->left[0] * this->left[0];
+    for (size_t i = 1; i < dimension(this->left); ++i) {
+        squared += this->left[i] * this->left[i];
+    }
+    const auto length = std::sqrt(squared);
+    EXPECT_EQ(length, vector_length(this->left));
+
+    auto normalized = this->left;
+    normalize_vector(normalized);
+    for (size_t i = 0; i < dimension(this->left); ++i) {
+        EXPECT_EQ(this->left[i] / length, normalized[i]);
+    }
+}
+
+TYPED_TEST(SimdVectorTest, assigning_an_array_clears_the_padding)
+{
+    const size_t storage_size = sizeof(TypeParam) / sizeof(this->scalar);
+    auto vector = this->left;
+    std::fill(vector.begin(), vector.begin() + storage_size, this->scalar);
+
+    decltype(this->scalar) elements[4] = {};
+    std::copy(this->left.begin(), this->left.end(), elements);
+    vector = elements;
+
+    EXPECT_EQ(this->left, vector);
+    for (size_t i = dimension(vector); i < storage_size; ++i) {
+        EXPECT_EQ(0, vector.begin()[i]);
+    }
+}
+
+template<typename Real, size_t dim>
+struct MatrixCase
+{
+    typedef Math::Matrix<Real, dim> matrix_type;
+    typedef Math::Vector<Real, dim> vector_type;
+    static const size_t dimension = dim;
+};
+
+template<typename Case>
+class SimdMatrixTest : public ::testing::Test
+{
+protected:
+    typedef typename Case::matrix_type matrix_type;
+    static const size_t dim = Case::dimension;
+
+    void SetUp()
+    {
+        left = create_random_vector<matrix_type>();
+        right = create_random_vector<matrix_type>();
+        vector = create_random_vector<typename Case::vector_type>();
+    }
+
+    matrix_type left;
+    matrix_type right;
+    typename Case::vector_type vector;
+};
+
+typedef ::testing::Types<MatrixCase<float, 3>, MatrixCase<float, 4>,
+                         MatrixCase<double, 3>, MatrixCase<double, 4> > SimdMatrixTypes;
+TYPED_TEST_CASE(SimdMatrixTest, SimdMatrixTypes);
+
+TYPED_TEST(SimdMatrixTest, matrix_product_sums_the_products_in_index_order)
+{
+    const size_t dim = TestFixture::dim;
+    const auto result = this->left * this->right;
+
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t j = 0; j < dim; ++j) {
+            auto expected = this->left(i,0) * this->right(0,j);
+            for (size_t k = 1; k < dim; ++k) {
+                expected += this->left(i,k) * this->right(k,j);
+            }
+            EXPECT_EQ(expected, result(i,j));
+        }
+    }
+}
+
+TYPED_TEST(SimdMatrixTest, vector_times_matrix_gives_the_same_as_transposed_matrix_times_vector)
+{
+    EXPECT_EQ(matrix_transpose(this->left) * this->vector, this->vector * this->left);
+}
+
+#ifdef MATH_USE_SSE2
+TEST(SimdRegisterTest, loading_and_storing_a_register_round_trips_the_scalars)
+{
+    typedef Math::Simd::Register<double, 4> reg;
+    const double source[4] = {1.5, -2.5, 3.25, 8};
+    double destination[4];
+
+    reg::loadu(source).storeu(destination);
+
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(source[i], destination[i]);
+    }
+}
+
+TEST(SimdRegisterTest, register_arithmetic_is_lane_wise)
+{
+    typedef Math::Simd::Register<float, 4> reg;
+    const float left[4] = {1, 2, 3, 4};
+    const float right[4] = {8, 6, 4, 2};
+    float sum[4];
+    float quotient[4];
+
+    (reg::loadu(left) + reg::loadu(right)).storeu(sum);
+    (reg::loadu(left) / reg::loadu(right)).storeu(quotient);
+
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(left[i] + right[i], sum[i]);
+        EXPECT_EQ(left[i] / right[i], quotient[i]);
+    }
+}
+
+TEST(SimdRegisterTest, shuffling_a_register_reorders_its_lanes)
+{
+    typedef Math::Simd::Register<float, 4> float_reg;
+    typedef Math::Simd::Register<double, 4> double_reg;
+    const float float_source[4] = {1, 2, 3, 4};
+    const double double_source[4] = {1, 2, 3, 4};
+    float float_result[4];
+    double double_result[4];
+
+    Math::Simd::shuffle<3, 0, 2, 2>(float_reg::loadu(float_source)).storeu(float_result);
+    Math::Simd::shuffle<3, 0, 2, 2>(double_reg::loadu(double_source)).storeu(double_result);
+
+    const double expected[4] = {4, 1, 3, 3};
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(expected[i], float_result[i]);
+        EXPECT_EQ(expected[i], double_result[i]);
+    }
+}
+
+TEST(SimdRegisterTest, horizontal_sum_adds_the_lanes_in_order)
+{
+    float floats[8];
+    double doubles[4];
+    for (size_t i = 0; i < 8; ++i) {
+        floats[i] = float(create_random_scalar()) / (i + 3);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        doubles[i] = create_random_scalar() / (i + 3);
+    }
+
+    float float_sum = floats[0];
+    for (size_t i = 1; i < 4; ++i) {
+        float_sum += floats[i];
+    }
+    EXPECT_EQ(float_sum, Math::Simd::horizontal_sum(Math::Simd::Register<float, 4>::loadu(floats)));
+    EXPECT_EQ(doubles[0] + doubles[1], Math::Simd::horizontal_sum(Math::Simd::Register<double, 2>::loadu(doubles)));
+    EXPECT_EQ(((doubles[0] + doubles[1]) + doubles[2]) + doubles[3],
+              Math::Simd::horizontal_sum(Math::Simd::Register<double, 4>::loadu(doubles)));
+
+    typedef Math::Simd::Native<float>::type native;
+    float native_sum = floats[0];
+    for (size_t i = 1; i < native::size; ++i) {
+        native_sum += floats[i];
+    }
+    EXPECT_EQ(native_sum, Math::Simd::horizontal_sum(native::loadu(floats)));
+}
+#endif
+
+TYPED_TEST(SimdVectorTest, fast_normalizing_a_vector_gives_nearly_unit_length_in_the_same_direction)
+{
+    auto expected = this->left;
+    auto normalized = this->left;
+    normalize_vector(expected);
+    normalize_vector_fast(normalized);
+
+    EXPECT_NEAR(1, vector_length(normalized), 1e-6);
+    for (size_t i = 0; i < dimension(expected); ++i) {
+        EXPECT_NEAR(expected[i], normalized[i], 1e-6);
+    }
+}
+
+TEST(SimdRegisterTest, reciprocal_square_root_is_within_its_error_bound)
+{
+    typedef Math::Simd::Native<float>::type float_reg;
+    typedef Math::Simd::Native<double>::type double_reg;
+    float float_values[float_reg::size];
+    double double_values[double_reg::size];
+
+    for (auto value = 1e-6; value < 1e6; value *= 1.37) {
+        Math::Simd::rsqrt(float_reg::broadcast(float(value))).storeu(float_values);
+        Math::Simd::rsqrt(double_reg::broadcast(value)).storeu(double_values);
+
+        const auto expected = 1 / std::sqrt(value);
+        EXPECT_NEAR(expected, float_values[0], 5e-7 * expected);
+        EXPECT_DOUBLE_EQ(expected, double_values[0]);
+        EXPECT_EQ(Math::Simd::rsqrt(Math::Simd::Register<float, 1>(float(value))).value, float_values[0]);
+    }
+}
+
+template<typename Real>
+void expect_sign_operations_work_lane_by_lane()
+{
+    typedef typename Math::Simd::Native<Real>::type reg;
+    Real magnitudes[reg::size];
+    Real signs[reg::size];
+    for (size_t i = 0; i < reg::size; ++i) {
+        magnitudes[i] = (i % 2 ? -1 : 1) * Real(i + 1);
+        signs[i] = i % 3 ? Real(-0.) : Real(2);
+    }
+
+    Real absolute[reg::size];
+    Real copied[reg::size];
+    abs(reg::loadu(magnitudes)).storeu(absolute);
+    copysign(reg::loadu(magnitudes), reg::loadu(signs)).storeu(copied);
+
+    for (size_t i = 0; i < reg::size; ++i) {
+        EXPECT_EQ(std::abs(magnitudes[i]), absolute[i]);
+        EXPECT_EQ(std::copysign(magnitudes[i], signs[i]), copied[i]);
+    }
+}
+
+TEST(SimdRegisterTest, abs_and_copysign_work_lane_by_lane)
+{
+    expect_sign_operations_work_lane_by_lane<float>();
+    expect_sign_operations_work_lane_by_lane<double>();
+}
+
+template<typename Real>
+void expect_min_and_max_match_the_scalar_registers()
+{
+    typedef typename Math::Simd::Native<Real>::type reg;
+    typedef Math::Simd::Register<Real, 1> scalar;
+    Real left[reg::size];
+    Real right[reg::size];
+    for (size_t i = 0; i < reg::size; ++i) {
+        left[i] = (i % 2 ? -1 : 1) * Real(i + 1);
+        right[i] = Real(i % 3);
+    }
+    left[0] = std::numeric_limits<Real>::quiet_NaN();
+    right[reg::size - 1] = std::numeric_limits<Real>::quiet_NaN();
+
+    Real smallest[reg::size];
+    Real largest[reg::size];
+    min(reg::loadu(left), reg::loadu(right)).storeu(smallest);
+    max(reg::loadu(left), reg::loadu(right)).storeu(largest);
+
+    for (size_t i = 0; i < reg::size; ++i) {
+        const Real expected_min = min(scalar(left[i]), scalar(right[i])).value;
+        const Real expected_max = max(scalar(left[i]), scalar(right[i])).value;
+        EXPECT_EQ(std::isnan(expected_min), std::isnan(smallest[i]));
+        EXPECT_EQ(std::isnan(expected_max), std::isnan(largest[i]));
+        if (!std::isnan(expected_min)) {
+            EXPECT_EQ(expected_min, smallest[i]);
+        }
+        if (!std::isnan(expected_max)) {
+            EXPECT_EQ(expected_max, largest[i]);
+        }
+    }
+    EXPECT_TRUE(std::isnan(largest[reg::size - 1]));
+    if (reg::size > 1) {
+        EXPECT_EQ(right[0], smallest[0]);
+    }
+}
+
+TEST(SimdRegisterTest, min_and_max_take_the_right_lane_when_either_is_nan)
+{
+    expect_min_and_max_match_the_scalar_registers<float>();
+    expect_min_and_max_match_the_scalar_registers<double>();
+}
@@ -0,0 +1,139 @@
+#include <transform.h>
+#include <vector3.h>
+#include <vector4.h>
+#include <gtest/gtest.h>
+
+#include "test-helpers.h"
+
+const Math::Vec3d create_random_vector3();
+Math::Quaternion<double> create_random_rotation();
+
+Math::Transformd create_random_trs();
+
+class TransformTest : public ::testing::Test
+{
+protected:
+    void expect_near(const Math::Vec3d & expected, const Math::Vec3d & actual)
+    {
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_NEAR(expected[i], actual[i], 1e-8);
+        }
+    }
+
+    void expect_near(const Math::Matrix4d & expected, const Math::Matrix4d & actual)
+    {
+        for (size_t i = 0; i < 16; ++i) {
+            EXPECT_NEAR(expected[i], actual[i], 1e-8);
+        }
+    }
+};
+
+TEST_F(TransformTest, default_transform_is_the_identity)
+{
+    const Math::Transformd transform;
+    const auto point = create_random_vector3();
+
+    EXPECT_EQ(Math::Vec3d(), transform.get_translation());
+    EXPECT_EQ(1, transform.get_rotation().w());
+    EXPECT_EQ(1, transform.get_scale());
+    EXPECT_EQ(Math::Matrix4d(), transform.get_matrix());
+    EXPECT_EQ(point, transform_point(transform, point));
+}
+
+TEST_F(TransformTest, transforming_point_scales_rotates_and_then_translates_it)
+{
+    const auto translation = create_random_vector3();
+    const auto rotation = create_random_rotation();
+    const Math::Transformd transform(translation, rotation, 3.0);
+    const auto point = create_random_vector3();
+
+    const Math::Vec3d correct = quaternion_rotate(rotation, Math::Vec3d(point * 3.0)) + translation;
+
+    expect_near(correct, transform_point(transform, point));
+    expect_near(correct - translation, transform_direction(transform, point));
+}
+
+TEST_F(TransformTest, transforming_point_is_the_same_as_multiplying_by_the_matrix)
+{
+    const auto transform = create_random_trs();
+    const auto point = create_random_vector3();
+
+    const auto correct = transform.get_matrix() * Math::Vec4d(point[0], point[1], point[2], 1.0);
+
+    expect_near(Math::Vec3d(correct[0], correct[1], correct[2]), transform_point(transform, point));
+}
+
+TEST_F(TransformTest, composition_is_the_same_as_multiplying_the_matrices)
+{
+    const auto first = create_random_trs();
+    const auto second = create_random_trs();
+
+    expect_near(second.get_matrix() * first.get_matrix(), (second * first).get_matrix());
+}
+
+TEST_F(TransformTest, transform_times_its_inverse_is_the_identity)
+{
+    const auto transform = create_random_trs();
+    const auto identity = transform * transform_inverse(transform);
+
+    expect_near(Math::Vec3d(), identity.get_translation());
+    EXPECT_NEAR(1, std::abs(identity.get_rotation().w()), 1e-12);
+    EXPECT_NEAR(1, identity.get_scale(), 1e-12);
+}
+
+TEST_F(TransformTest, inverse_takes_transformed_point_back)
+{
+    const auto transform = create_random_trs();
+    const auto point = create_random_vector3();
+
+    expect_near(point, transform_point(transform_inverse(transform), transform_point(transform, point)));
+}
+
+TEST_F(TransformTest, matrix_is_kept_until_a_part_changes)
+{
+    Math::Transformd transform = create_random_trs();
+    const auto & matrix = transform.get_matrix();
+    const auto first = matrix;
+
+    EXPECT_EQ(&matrix, &transform.get_matrix());
+    EXPECT_EQ(first, transform.get_matrix());
+
+    const auto translation = create_random_vector3();
+    transform.set_translation(translation);
+    EXPECT_EQ(translation[0], transform.get_matrix()(0,3));
+
+    transform.set_scale(2 * transform.get_scale());
+    EXPECT_NEAR(2 * first(1,1), transform.get_matrix()(1,1), 1e-12);
+
+    transform.set_rotation(Math::Quaternion<double>());
+    expect_near(Math::Matrix4d(transform.get_scale(), 0, 0, translation[0],
+                               0, transform.get_scale(), 0, translation[1],
+                               0, 0, transform.get_scale(), translation[2],
+                               0, 0, 0, 1),
+                transform.get_matrix());
+}
+
+TEST_F(TransformTest, copied_transform_keeps_its_own_matrix)
+{
+    Math::Transformd transform = create_random_trs();
+    const auto matrix = transform.get_matrix();
+    auto copy = transform;
+
+    copy.set_scale(5.0);
+
+    EXPECT_EQ(matrix, transform.get_matrix());
+    EXPECT_NE(matrix, copy.get_matrix());
+}
+
+TEST_F(TransformTest, inverting_transform_with_zero_scale_dies)
+{
+    const Math::Transformd transform(create_random_vector3(), create_random_rotation(), 0.0);
+
+    EXPECT_DEATH(transform_inverse(transform), "Can not invert transform with zero scale");
+}
+
+// Helper function
+Math::Transformd create_random_trs()
+{
+    return Math::Transformd(create_random_vector3(), create_random_rotation(), 0.5 + create_random_scalar() / 100);
+}
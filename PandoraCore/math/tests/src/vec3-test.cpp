@@ -415,3 +415,14 @@ TEST_F(Vector3Test, ortonormalizing_with_equal_vectors_asserts)
     EXPECT_DEATH(generate_orthonormal_basis(random_vector, random_vector, random_vector2),
             "Can not make orthonormal basis with equal vectors");
 }
+
+TEST_F(Vector3Test, vectors_can_be_created_and_combined_in_constant_expressions)
+{
+    constexpr Math::Vec3d left(1.0, 2.0, 3.0);
+    constexpr Math::Vec3d right(0.5, 0.25, 0.125);
+    constexpr Math::Vec3d result = left + right * 2.0 - -left;
+
+    static_assert(result[0] == 3.0 && result[1] == 4.5 && result[2] == 6.25,
+                  "Vector arithmetic should be evaluated at compile time");
+    EXPECT_EQ(Math::Vec3d({3.0, 4.5, 6.25}), result);
+}
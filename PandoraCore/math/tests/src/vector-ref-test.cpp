@@ -0,0 +1,148 @@
+#include "test-helpers.h"
+
+#include <vector_ref.h>
+#include <vector3.h>
+#include <vector4.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+// Three interleaved vectors, as a file loader would hand them over:
+// x0 x1 x2 y0 y1 y2 z0 z1 z2 w0 w1 w2, and a padding element
+class VectorRefTest : public ::testing::Test
+{
+protected:
+    void SetUp();
+
+    Math::VectorRef<float, 4> strided(const size_t & i);
+
+    float buffer[13];
+};
+
+void VectorRefTest::SetUp()
+{
+    for (size_t i = 0; i < 13; ++i) {
+        buffer[i] = float(create_random_scalar());
+    }
+}
+
+Math::VectorRef<float, 4> VectorRefTest::strided(const size_t & i)
+{
+    return Math::VectorRef<float, 4>(buffer + i, 3);
+}
+
+TEST_F(VectorRefTest, elements_are_read_and_written_in_place)
+{
+    const auto view = strided(1);
+
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(&buffer[1 + 3*i], &view[i]);
+    }
+
+    view[2] = 5;
+    EXPECT_EQ(5.f, buffer[7]);
+    EXPECT_EQ(buffer, strided(0).get_data());
+    EXPECT_EQ(3u, strided(0).get_stride());
+}
+
+TEST_F(VectorRefTest, assignment_writes_through_the_view)
+{
+    const Math::Vec4f vector(1, 2, 3, 4);
+    const float padding = buffer[12];
+
+    strided(2) = vector;
+    EXPECT_EQ(1.f, buffer[2]);
+    EXPECT_EQ(2.f, buffer[5]);
+    EXPECT_EQ(3.f, buffer[8]);
+    EXPECT_EQ(4.f, buffer[11]);
+    EXPECT_EQ(padding, buffer[12]);
+
+    strided(0) = strided(2);
+    EXPECT_EQ(vector, strided(0));
+
+    // Copying a view copies the view, not the elements
+    auto copy = strided(1);
+    copy = strided(2);
+    EXPECT_EQ(buffer + 1, copy.get_data());
+    EXPECT_EQ(vector, strided(1));
+}
+
+TEST_F(VectorRefTest, views_of_vectors_see_their_elements)
+{
+    Math::Vec3f vector(1, 2, 3);
+    const Math::Vec3f & constant = vector;
+
+    const Math::VectorRef<float, 3> view(vector);
+    const Math::VectorRef<const float, 3> read_only(constant);
+    const Math::VectorRef<const float, 3> converted = view;
+
+    view[0] = 7;
+    EXPECT_EQ(7.f, vector[0]);
+    EXPECT_EQ(7.f, read_only[0]);
+    EXPECT_EQ(vector.begin(), converted.get_data());
+    EXPECT_EQ(vector, Math::Vec3f(read_only));
+}
+
+TEST_F(VectorRefTest, expressions_mix_views_and_vectors)
+{
+    const Math::Vec4f vector(1, 2, 3, 4);
+    const Math::VectorRef<const float, 4> left(buffer, 3);
+    const auto right = strided(1);
+
+    const Math::Vec4f sum = left + right * 2.f - vector;
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_FLOAT_EQ(buffer[3*i] + buffer[1 + 3*i] * 2 - vector[i], sum[i]);
+    }
+
+    const float padding = buffer[12];
+    strided(2) = left * right + vector / 2.f;
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_FLOAT_EQ(buffer[3*i] * buffer[1 + 3*i] + vector[i] / 2, buffer[2 + 3*i]);
+    }
+    EXPECT_EQ(padding, buffer[12]);
+
+    strided(0) += vector;
+    strided(0) *= 2.f;
+    Math::Vec4f accumulated = vector;
+    accumulated -= strided(0);
+    EXPECT_FLOAT_EQ(vector[3] - buffer[9], accumulated[3]);
+}
+
+TEST_F(VectorRefTest, vector_functions_take_views)
+{
+    const Math::Vec3d left(1, 2, 3);
+    double right_elements[6] = {4, 0, 5, 0, 6, 0};
+    const Math::VectorRef<const double, 3> right(right_elements, 2);
+
+    EXPECT_EQ(32., Math::dot_product(left, right));
+    EXPECT_EQ(32., Math::dot_product(right, left));
+    EXPECT_EQ(Math::cross_product(left, Math::Vec3d(right)), Math::cross_product(left, right));
+    EXPECT_EQ(Math::cross_product(Math::Vec3d(right), left), Math::cross_product(right, left));
+    EXPECT_EQ(77., Math::vector_length_squared(right));
+    EXPECT_DOUBLE_EQ(std::sqrt(77.), Math::vector_length(right));
+
+    const Math::VectorRef<double, 3> view(right_elements, 2);
+    Math::normalize_vector(view);
+    EXPECT_NEAR(1, Math::vector_length(right), PRECISION);
+    EXPECT_EQ(0., right_elements[1]);
+}
+
+TEST_F(VectorRefTest, views_work_over_a_buffer_of_vectors)
+{
+    // Positions and normals of three vertices, one after the other
+    std::vector<double> vertices(18);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i] = create_random_scalar();
+    }
+
+    for (size_t vertex = 0; vertex < 3; ++vertex) {
+        const Math::VectorRef<double, 3> position(&vertices[6*vertex]);
+        const Math::VectorRef<const double, 3> normal(&vertices[6*vertex + 3]);
+        const Math::Vec3d expected = Math::Vec3d(position) + Math::Vec3d(normal) * 0.5;
+
+        position += normal * 0.5;
+        EXPECT_EQ(expected, position);
+    }
+}
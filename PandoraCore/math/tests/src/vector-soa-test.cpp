@@ -0,0 +1,199 @@
+#include "test-helpers.h"
+
+#include <vector_soa.h>
+#include <vector3.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+class VectorSoATest : public ::testing::Test
+{
+protected:
+    void SetUp();
+
+    Math::Vec3d create_random_vector();
+
+    // Not a multiple of any register width, so the scalar tail is exercised
+    static const size_t count = 37;
+
+    std::vector<Math::Vec3d> left_vectors;
+    std::vector<Math::Vec3d> right_vectors;
+    Math::VectorSoA<double, 3> left;
+    Math::VectorSoA<double, 3> right;
+    double scalar;
+};
+
+const size_t VectorSoATest::count;
+
+void VectorSoATest::SetUp()
+{
+    for (size_t i = 0; i < count; ++i) {
+        left_vectors.push_back(create_random_vector());
+        right_vectors.push_back(create_random_vector());
+    }
+    aos_to_soa(left_vectors.data(), count, left);
+    aos_to_soa(right_vectors.data(), count, right);
+    scalar = create_random_scalar();
+}
+
+Math::Vec3d VectorSoATest::create_random_vector()
+{
+    auto array = create_double_array_of_size(3);
+    Math::Vec3d vector(array);
+    delete[] array;
+    return vector;
+}
+
+TEST_F(VectorSoATest, default_constructed_batch_is_empty)
+{
+    const Math::VectorSoA<double, 3> soa;
+    EXPECT_EQ((size_t) 0, soa.size());
+}
+
+TEST_F(VectorSoATest, converting_from_array_of_vectors_stores_each_component_contiguously)
+{
+    ASSERT_EQ(count, left.size());
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(left_vectors[i][0], left.component(0)[i]);
+        EXPECT_EQ(left_vectors[i][1], left.component(1)[i]);
+        EXPECT_EQ(left_vectors[i][2], left.component(2)[i]);
+    }
+}
+
+TEST_F(VectorSoATest, components_are_aligned_for_simd_loads)
+{
+    for (size_t c = 0; c < 3; ++c) {
+        EXPECT_EQ((size_t) 0, reinterpret_cast<uintptr_t>(left.component(c)) % Math::Simd::batch_alignment);
+    }
+}
+
+TEST_F(VectorSoATest, converting_back_to_array_of_vectors_gives_the_original_vectors)
+{
+    std::vector<Math::Vec3d> result(count);
+    soa_to_aos(left, result.data());
+
+    EXPECT_EQ(left_vectors, result);
+}
+
+TEST_F(VectorSoATest, element_proxy_reads_and_writes_whole_vectors)
+{
+    const Math::Vec3d vector = left[4];
+    EXPECT_EQ(left_vectors[4], vector);
+
+    left[4] = right_vectors[0];
+    EXPECT_EQ(right_vectors[0], left.get(4));
+
+    left[4][1] = 2.5;
+    EXPECT_EQ(2.5, left.component(1)[4]);
+}
+
+TEST_F(VectorSoATest, gather_and_scatter_move_the_indexed_vectors)
+{
+    const size_t indices[] = {3, 0, 11};
+    Math::Vec3d gathered[3];
+    left.gather(indices, 3, gathered);
+
+    EXPECT_EQ(left_vectors[3], gathered[0]);
+    EXPECT_EQ(left_vectors[0], gathered[1]);
+    EXPECT_EQ(left_vectors[11], gathered[2]);
+
+    right.scatter(indices, 3, gathered);
+    EXPECT_EQ(left_vectors[3], right.get(3));
+    EXPECT_EQ(left_vectors[11], right.get(11));
+    EXPECT_EQ(right_vectors[1], right.get(1));
+}
+
+TEST_F(VectorSoATest, push_back_appends_a_vector)
+{
+    left.push_back(right_vectors[2]);
+
+    EXPECT_EQ(count + 1, left.size());
+    EXPECT_EQ(right_vectors[2], left.get(count));
+}
+
+TEST_F(VectorSoATest, adding_batches_adds_each_vector)
+{
+    left += right;
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(left_vectors[i] + right_vectors[i], left.get(i));
+    }
+}
+
+TEST_F(VectorSoATest, scaling_batch_scales_each_vector)
+{
+    left *= scalar;
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(left_vectors[i] * scalar, left.get(i));
+    }
+}
+
+TEST_F(VectorSoATest, axpy_adds_the_scaled_batch)
+{
+    axpy(left, scalar, right);
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto expected = left_vectors[i] + scalar * right_vectors[i];
+        const auto result = left.get(i);
+        EXPECT_DOUBLE_EQ(expected[0], result[0]);
+        EXPECT_DOUBLE_EQ(expected[1], result[1]);
+        EXPECT_DOUBLE_EQ(expected[2], result[2]);
+    }
+}
+
+TEST_F(VectorSoATest, dot_product_of_batches_gives_the_dot_product_of_each_pair)
+{
+    std::vector<double> result(count);
+    dot_product(left, right, result.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_DOUBLE_EQ(dot_product(left_vectors[i], right_vectors[i]), result[i]);
+    }
+}
+
+TEST_F(VectorSoATest, cross_product_of_batches_gives_the_cross_product_of_each_pair)
+{
+    Math::VectorSoA<double, 3> result;
+    cross_product(left, right, result);
+
+    ASSERT_EQ(count, result.size());
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(cross_product(left_vectors[i], right_vectors[i]), result.get(i));
+    }
+}
+
+TEST_F(VectorSoATest, length_of_batch_gives_the_length_of_each_vector)
+{
+    std::vector<double> result(count);
+    vector_length(left, result.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_DOUBLE_EQ(vector_length(left_vectors[i]), result[i]);
+    }
+}
+
+TEST_F(VectorSoATest, normalizing_batch_gives_vectors_of_length_1)
+{
+    normalize_vector(left);
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_FLOAT_EQ(1, vector_length(left.get(i)));
+    }
+}
+
+TEST_F(VectorSoATest, fast_normalizing_batch_gives_the_same_as_fast_normalizing_each_vector)
+{
+    normalize_vector_fast(left);
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(normalize_vector_fast(left_vectors[i]), left.get(i));
+    }
+}
+
+TEST_F(VectorSoATest, accessing_element_outside_batch_asserts)
+{
+    EXPECT_DEATH(left.get(count), "Index operator out of range");
+}
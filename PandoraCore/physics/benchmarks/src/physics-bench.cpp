@@ -0,0 +1,182 @@
+#include "benchmark.h"
+
+#include <forceaccumulator.h>
+#include <particle.h>
+#include <particleforce.h>
+#include <particleforceregistry.h>
+#include <particleintegrator.h>
+#include <particleworld.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Times a step of many particles, one particle per operation, through the
+// Particle objects and through the arrays of ParticleWorld, and the forces
+// added up from several threads and through the force registry.
+//
+//   physicsbench --filter ParticleWorld --json results.json
+
+namespace
+{
+
+const size_t count = 4096;
+const real dt = 0.01;
+
+real create_random_scalar()
+{
+    return 1 + rand() / (real) RAND_MAX;
+}
+
+Physics::Vector3 create_random_vector()
+{
+    return Physics::Vector3(create_random_scalar(), create_random_scalar(), create_random_scalar());
+}
+
+// The same particles, with a few dampings between them, in both layouts
+void create_particles(std::vector<Physics::ParticlePtr> & particles, Physics::ParticleWorld & world)
+{
+    for (size_t i = 0; i < count; ++i) {
+        auto particle = std::make_shared<Physics::Particle>(create_random_vector(), create_random_vector());
+        particle->set_inverse_mass(i % 16 ? create_random_scalar() : 0);
+        particle->damping = i % 3 ? 0.99 : 0.95;
+
+        world.add(particle->get_position(), particle->get_velocity(), particle->get_inverse_mass(), particle->damping);
+        particles.push_back(particle);
+    }
+}
+
+// Pushes a particle by a fixed force
+class PushForce : public Physics::ParticleForce
+{
+public:
+    explicit PushForce(const Physics::Vector3 & push)
+        : push(push)
+    {}
+
+    virtual void update_force(std::shared_ptr<Physics::Particle> particle, real)
+    {
+        particle->add_force(push);
+    }
+
+    Physics::Vector3 push;
+};
+
+// Four forces on every particle, on one thread and on one per hardware thread
+void run_registry(Benchmark::Runner & runner, const std::vector<Physics::ParticlePtr> & particles)
+{
+    Physics::ParticleForceRegistry registry;
+    for (size_t i = 0; i < 4; ++i) {
+        const auto force = std::make_shared<PushForce>(create_random_vector());
+        for (const auto & particle : particles) {
+            registry.add(force, particle);
+        }
+    }
+
+    runner.run("update(one thread)", "Registry", 4 * count, 4 * count * sizeof(Physics::Particle), [&]() {
+        registry.update_particles_with_forces(dt);
+        Benchmark::keep(particles[0]->get_accumulated_force()[0]);
+    });
+    registry.set_thread_count(0);
+    runner.run("update(all threads)", "Registry", 4 * count, 4 * count * sizeof(Physics::Particle), [&]() {
+        registry.update_particles_with_forces(dt);
+        Benchmark::keep(particles[0]->get_accumulated_force()[0]);
+    });
+
+    // A force for every particle of a frame, added and removed again
+    const auto transient = std::make_shared<PushForce>(create_random_vector());
+    runner.run("add_many+remove_many", "Registry", count, 0, [&]() {
+        const auto handles = registry.add_many(transient, particles);
+        registry.remove_many(handles);
+        Benchmark::keep(registry.size());
+    });
+}
+
+template<typename Real>
+void run_integrator(Benchmark::Runner & runner, const std::string & type)
+{
+    std::vector<Real> arrays[14];
+    for (auto & array : arrays) {
+        array.resize(count);
+        for (auto & value : array) {
+            value = Real(create_random_scalar());
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        arrays[13][i] = Real(0.99);
+    }
+
+    Physics::ParticleArrays<Real> particles;
+    for (size_t c = 0; c < 3; ++c) {
+        particles.position[c] = arrays[c].data();
+        particles.velocity[c] = arrays[3 + c].data();
+        particles.acceleration[c] = arrays[6 + c].data();
+        particles.force[c] = arrays[9 + c].data();
+    }
+    particles.inverse_mass = arrays[12].data();
+    particles.damping = arrays[13].data();
+    const Math::Vector<Real, 3> gravity(0, Real(-9.8), 0);
+
+    runner.run("integrate_particles", type, count, count * 14 * sizeof(Real), [&]() {
+        Physics::integrate_particles(particles, count, gravity, Real(dt));
+        Benchmark::keep(arrays[0][0]);
+    });
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    Benchmark::Runner runner(Benchmark::parse_options(argc, argv));
+#ifdef MATH_USE_FMA
+    runner.add_context("simd", "avx+fma");
+#elif defined(MATH_USE_AVX)
+    runner.add_context("simd", "avx");
+#elif defined(MATH_USE_SSE2)
+    runner.add_context("simd", "sse2");
+#else
+    runner.add_context("simd", "generic");
+#endif
+
+    std::vector<Physics::ParticlePtr> particles;
+    Physics::ParticleWorld world;
+    create_particles(particles, world);
+    const size_t bytes = count * 14 * sizeof(real);
+
+    runner.run("Particle::update", "Particles", count, count * sizeof(Physics::Particle), [&]() {
+        for (const auto & particle : particles) {
+            particle->update(dt);
+        }
+        Benchmark::keep(particles[0]->get_position()[0]);
+    });
+    runner.run("step", "ParticleWorld", count, bytes, [&]() {
+        world.step(dt);
+        Benchmark::keep(world.get_positions().component(0)[0]);
+    });
+    world.group_by_damping();
+    runner.run("step(grouped)", "ParticleWorld", count, bytes, [&]() {
+        world.step(dt);
+        Benchmark::keep(world.get_positions().component(0)[0]);
+    });
+
+    // A force on every particle from each of four threads' buffers
+    Physics::ForceAccumulator accumulator(4, world.size());
+    const Physics::Vector3 force(1, 2, 3);
+    runner.run("accumulate_forces+add_forces", "Forces", count, 4 * count * 3 * sizeof(real), [&]() {
+        Physics::accumulate_forces(accumulator, count, [&](const size_t & begin, const size_t & end,
+                                                           const size_t & buffer) {
+            for (size_t i = begin; i < end; ++i) {
+                accumulator.add(buffer, i, force);
+            }
+        });
+        world.add_forces(accumulator);
+        Benchmark::keep(world.get_forces().component(0)[0]);
+    });
+
+    run_registry(runner, particles);
+    run_integrator<float>(runner, "Integratorf");
+    run_integrator<double>(runner, "Integratord");
+
+    return runner.finish();
+}
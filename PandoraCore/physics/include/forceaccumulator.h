@@ -0,0 +1,58 @@
+#ifndef FORCEACCUMULATOR_PHYSICS_H_INCLUDED
+#define FORCEACCUMULATOR_PHYSICS_H_INCLUDED
+
+#include <config.h>
+#include <parallel.h>
+#include <vector_soa.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Physics
+{
+
+// Forces on the particles of a world, added up by several threads at once
+// without atomics or locks. Every thread adds into a buffer of its own, one
+// force per particle, and reduce() adds the buffers together in buffer
+// order. Each particle then gets the same sum whichever thread finished
+// first, as long as every buffer is given the same forces.
+//
+// A buffer has room for every particle, so a reduction reads all of them,
+// however few forces were added.
+class ForceAccumulator
+{
+public:
+    explicit ForceAccumulator(const size_t & buffers, const size_t & particles = 0);
+
+    size_t buffer_count() const;
+    size_t size() const;
+
+    // Sets the number of particles, and zeroes every buffer
+    void resize(const size_t & particles);
+
+    void add(const size_t & buffer, const size_t & particle, const Vector3 & force);
+    Vector3 get(const size_t & buffer, const size_t & particle) const;
+
+    // Adds the buffers, first to last, to forces, which holds a force for
+    // each particle, and zeroes them. The particles are split over the
+    // given number of threads, zero being one per hardware thread.
+    void reduce(Math::VectorSoA<real, 3> & forces, const size_t & threads = 1);
+
+private:
+    std::vector<Math::VectorSoA<real, 3> > buffers;
+};
+
+// Splits count items into one range per buffer of the accumulator, and calls
+// function(begin, end, buffer) for each on a thread of its own, see
+// parallel_tasks. The ranges only depend on count and the number of
+// buffers, so the same forces end up in the same buffers on every run.
+template<typename Function>
+void accumulate_forces(ForceAccumulator & accumulator, const size_t & count, const Function & function);
+
+#define INCLUDED_FROM_FORCEACCUMULATOR_H
+#include "forceaccumulator_tmpl.h"
+#undef INCLUDED_FROM_FORCEACCUMULATOR_H
+
+}
+
+#endif // FORCEACCUMULATOR_PHYSICS_H_INCLUDED
@@ -0,0 +1,17 @@
+#ifndef INCLUDED_FROM_FORCEACCUMULATOR_H
+#error "forceaccumulator_tmpl.h can only be included from forceaccumulator.h"
+#else
+
+template<typename Function>
+void accumulate_forces(ForceAccumulator & accumulator, const size_t & count, const Function & function)
+{
+    const size_t buffers = accumulator.buffer_count();
+    const size_t range = (count + buffers - 1) / buffers;
+
+    Math::parallel_tasks(buffers, [&](const size_t & buffer) {
+        const size_t begin = std::min(buffer * range, count);
+        function(begin, std::min(begin + range, count), buffer);
+    });
+}
+
+#endif
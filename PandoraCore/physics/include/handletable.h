@@ -0,0 +1,64 @@
+#ifndef HANDLETABLE_PHYSICS_H_INCLUDED
+#define HANDLETABLE_PHYSICS_H_INCLUDED
+
+#include <config.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Physics
+{
+
+// Handles naming the elements of an array kept without holes, where an
+// element may move to another index while its handle stays the same. The
+// owner of the array keeps it in step with the table: add() names the
+// element appended at index size(), and remove() says where the last
+// element has to move.
+//
+// A handle holds a slot, given out again after its element is removed, and
+// the generation of that slot, counted up at every removal. A handle kept
+// after its element was removed therefore never names the element that
+// later got its slot.
+class HandleTable
+{
+public:
+    typedef uint64_t Handle;
+
+    static const size_t no_index;
+
+    Handle add();
+
+    // Frees the handle, and gives the index its element had, where the owner
+    // moves the last element before dropping the last index. Gives no_index,
+    // and changes nothing, for a handle not in the table.
+    size_t remove(const Handle & handle);
+
+    bool contains(const Handle & handle) const;
+    size_t index_of(const Handle & handle) const;
+    Handle handle_at(const size_t & index) const;
+
+    size_t size() const;
+    void reserve(const size_t & count);
+
+    // Removes every handle
+    void clear();
+
+    // Moves the handle at index order[i] to index i, as the owner does with
+    // the elements
+    void reorder(const std::vector<size_t> & order);
+
+private:
+    static size_t slot_of(const Handle & handle);
+    Handle handle_of(const size_t & slot) const;
+
+    // Index of the element of each slot, the generation of each slot, and
+    // the slot of each index
+    std::vector<size_t> indices;
+    std::vector<uint32_t> generations;
+    std::vector<size_t> slots;
+    std::vector<size_t> free_slots;
+};
+
+}
+
+#endif // HANDLETABLE_PHYSICS_H_INCLUDED
@@ -8,7 +8,7 @@
 namespace Physics
 {
 
-static const Vector3 default_gravity({0, -9.8, 0});
+constexpr Vector3 default_gravity(0, -9.8, 0);
 
 class Particle
 {
@@ -31,6 +31,11 @@ public:
 
     void set_gravity(const real & new_gravity);
     const Vector3 & get_gravity() const;
+
+    // Forces added until the next update, which applies and clears them
+    void add_force(const Vector3 & force);
+    const Vector3 & get_accumulated_force() const;
+    void clear_accumulator();
 public:
     real damping;
 
@@ -42,6 +47,7 @@ protected:
     Vector3 acceleration;
 
     Vector3 gravity;
+    Vector3 force_accumulator;
 };
 
 typedef std::shared_ptr<Particle> ParticlePtr;
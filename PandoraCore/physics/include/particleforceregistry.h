@@ -2,8 +2,9 @@
 #define PARTICLE_FORCE_REGISTRY_H_INCLUDED
 
 #include "config.h"
-#include <forward_list>
+#include "handletable.h"
 #include <memory>
+#include <vector>
 
 namespace Physics
 {
@@ -11,15 +12,46 @@ namespace Physics
 class ParticleForce;
 class Particle;
 
+// The pairs are kept one after the other in a vector and named by handles,
+// which stay valid until the pair is removed, and never name another pair
+// after that, see HandleTable. The pairs are updated last added first.
+// Removing a pair moves the last pair into its place, so that order only
+// holds until the first removal.
 class ParticleForceRegistry
 {
 public:
-    void add(std::shared_ptr<ParticleForce> force, std::shared_ptr<Particle> particle);
+    typedef HandleTable::Handle Handle;
 
+    Handle add(std::shared_ptr<ParticleForce> force, std::shared_ptr<Particle> particle);
+
+    // Adds the force to every particle, and gives the handles of the pairs
+    // in the order of the particles
+    std::vector<Handle> add_many(std::shared_ptr<ParticleForce> force,
+                                 const std::vector<std::shared_ptr<Particle> > & particles);
+
+    void remove(const Handle & pair);
+    void remove_many(const std::vector<Handle> & pairs);
+
+    // Removes every pair of the force and the particle, looking through all
+    // the pairs
     void remove(std::shared_ptr<ParticleForce> force, std::shared_ptr<Particle> particle);
 
+    bool contains(const Handle & pair) const;
+    size_t size() const;
+    void reserve(const size_t & count);
+
     void clear();
 
+    // The number of threads update_particles_with_forces runs on, one by
+    // default, and zero for one per hardware thread. They are taken from
+    // the shared pool of the math library, which is started here.
+    void set_thread_count(const size_t & threads);
+    size_t get_thread_count() const;
+
+    // With more than one thread, the pairs of each particle are updated by
+    // one thread, in the same order as with one. Every particle then gets
+    // the same forces in the same order, so the result is identical, as long
+    // as the forces only write to the particle they are given.
     void update_particles_with_forces(const real & timestep);
 
 private:
@@ -32,12 +64,26 @@ private:
 
         bool operator==(const ForceParticlePair& other);
 
+        const Particle * get_particle() const;
+
     private:
         std::shared_ptr<ParticleForce> force;
         std::shared_ptr<Particle> particle;
     };
 
-    std::forward_list<ForceParticlePair> particleforcepairs;
+    void partition_by_particle();
+
+    std::vector<ForceParticlePair> particleforcepairs;
+    size_t threads = 1;
+
+    // Index of the pair of each handle, and the handle of each pair
+    HandleTable handles;
+
+    // Indices of the pairs ordered by particle, and where the pairs of each
+    // particle begin, rebuilt when the pairs change
+    std::vector<size_t> pairs_by_particle;
+    std::vector<size_t> particle_begin;
+    bool partitioned = false;
 };
 
 }
@@ -0,0 +1,53 @@
+#ifndef PARTICLEINTEGRATOR_PHYSICS_H_INCLUDED
+#define PARTICLEINTEGRATOR_PHYSICS_H_INCLUDED
+
+#include <simd.h>
+#include <vector.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+namespace Physics
+{
+
+// Where the properties of a batch of particles are, one array per property
+// and per component of the vectors
+template<typename Real>
+struct ParticleArrays
+{
+    Real * position[3];
+    Real * velocity[3];
+    Real * acceleration[3];
+    Real * force[3];
+    const Real * inverse_mass;
+    const Real * damping;
+};
+
+// Moves count particles by dt, as Particle::update does one, a register of
+// particles at a time:
+//
+//   position += velocity * dt
+//   acceleration = inverse_mass * (gravity + force)
+//   velocity = velocity * pow(damping, dt) + acceleration * dt
+//   force = 0
+//
+// where force is what has been accumulated since the last step.
+// pow is called once per damping, as long as only a few are mixed
+// together, and registers of particles with one damping take the fastest
+// path, so particles of equal damping are best kept next to each other.
+// Particles of zero inverse mass, which nothing can push, get no
+// acceleration, but still move and are damped, as in Particle::update. The
+// sums are fused multiply-adds where the target has them, which round
+// differently from Particle::update.
+template<typename Real>
+void integrate_particles(const ParticleArrays<Real> & particles, const size_t & count,
+                         const Math::Vector<Real, 3> & gravity, const Real & dt);
+
+#define INCLUDED_FROM_PARTICLEINTEGRATOR_H
+#include "particleintegrator_tmpl.h"
+#undef INCLUDED_FROM_PARTICLEINTEGRATOR_H
+
+}
+
+#endif // PARTICLEINTEGRATOR_PHYSICS_H_INCLUDED
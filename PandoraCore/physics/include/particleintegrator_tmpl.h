@@ -0,0 +1,104 @@
+#ifndef INCLUDED_FROM_PARTICLEINTEGRATOR_H
+#error "particleintegrator_tmpl.h can only be included from particleintegrator.h"
+#else
+
+// pow(damping, dt), remembering the last few dampings asked for, so a few
+// dampings mixed together also call pow once each. The last one asked for
+// is the first entry, which whole registers are checked against.
+template<typename Real>
+struct DampingPower
+{
+public:
+    static const size_t entries = 4;
+
+    explicit DampingPower(const Real & dt)
+        : dt(dt), next(1)
+    {
+        for (size_t i = 0; i < entries; ++i) {
+            damping[i] = 1;
+            power[i] = 1;
+        }
+    }
+
+    Real operator()(const Real & new_damping)
+    {
+        for (size_t i = 0; i < entries; ++i) {
+            if (damping[i] == new_damping) {
+                std::swap(damping[0], damping[i]);
+                std::swap(power[0], power[i]);
+                return power[0];
+            }
+        }
+
+        std::swap(damping[0], damping[next]);
+        std::swap(power[0], power[next]);
+        damping[0] = new_damping;
+        power[0] = std::pow(new_damping, dt);
+        next = next % (entries - 1) + 1;
+        return power[0];
+    }
+
+    Real dt;
+    Real damping[entries];
+    Real power[entries];
+    size_t next;
+};
+
+template<typename Register, typename Real>
+inline void integrate_block(const ParticleArrays<Real> & particles, const size_t & i,
+                            const Register * gravity, const Register & step, DampingPower<Real> & power)
+{
+    const Register zero = Register::broadcast(0);
+    const Register inverse_mass = Register::loadu(particles.inverse_mass + i);
+    const Register damping = Register::loadu(particles.damping + i);
+
+    auto factor = Register::broadcast(power.power[0]);
+    if (!all_of(equal(damping, Register::broadcast(power.damping[0])))) {
+        Real lanes[Register::size];
+        for (size_t j = 0; j < Register::size; ++j) {
+            lanes[j] = power(particles.damping[i + j]);
+        }
+        factor = Register::loadu(lanes);
+    }
+
+    for (size_t c = 0; c < 3; ++c) {
+        Real * position = particles.position[c] + i;
+        Real * velocity = particles.velocity[c] + i;
+        Real * force = particles.force[c] + i;
+        const auto old_velocity = Register::loadu(velocity);
+        const auto acceleration = inverse_mass * (gravity[c] + Register::loadu(force));
+
+        multiply_add(old_velocity, step, Register::loadu(position)).storeu(position);
+        acceleration.storeu(particles.acceleration[c] + i);
+        multiply_add(acceleration, step, old_velocity * factor).storeu(velocity);
+        zero.storeu(force);
+    }
+}
+
+// The arguments are copied, as the compiler can not tell that the stores
+// into the arrays leave them alone
+template<typename Real>
+void integrate_particles(const ParticleArrays<Real> & particles, const size_t & count,
+                         const Math::Vector<Real, 3> & gravity, const Real & dt)
+{
+    typedef typename Math::Simd::Native<Real>::type reg;
+    typedef Math::Simd::Register<Real, 1> lane;
+    assert(particles.inverse_mass && particles.damping && "Can not integrate particles without masses");
+
+    const ParticleArrays<Real> arrays = particles;
+    const size_t end = count;
+    const Real step = dt;
+    DampingPower<Real> power(step);
+    const reg pull[3] = {reg::broadcast(gravity[0]), reg::broadcast(gravity[1]), reg::broadcast(gravity[2])};
+    const lane lane_pull[3] = {lane(gravity[0]), lane(gravity[1]), lane(gravity[2])};
+
+    size_t i = 0;
+    for (; i + reg::size <= end; i += reg::size) {
+        integrate_block(arrays, i, pull, reg::broadcast(step), power);
+    }
+    for (; i < end; ++i) {
+        integrate_block(arrays, i, lane_pull, lane(step), power);
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef PARTICLEWORLD_PHYSICS_H_INCLUDED
+#define PARTICLEWORLD_PHYSICS_H_INCLUDED
+
+#include <config.h>
+#include <particle.h>
+#include <particleintegrator.h>
+#include <forceaccumulator.h>
+#include <handletable.h>
+#include <aligned_allocator.h>
+#include <vector_soa.h>
+
+#include <vector>
+
+namespace Physics
+{
+
+// All the particles of a simulation, stored as one contiguous, aligned array
+// per property instead of one heap object per particle, so step() streams
+// through memory instead of chasing pointers.
+//
+// Particles are named by handles, which stay valid until the particle is
+// removed, while the particle itself may move within the arrays. The handle
+// of a removed particle never names another particle, see HandleTable.
+class ParticleWorld
+{
+public:
+    typedef HandleTable::Handle Handle;
+    typedef std::vector<real, Math::AlignedAllocator<real, Math::Simd::batch_alignment> > Scalars;
+
+    explicit ParticleWorld(const Vector3 & gravity = default_gravity);
+
+    Handle add(const Vector3 & position, const Vector3 & velocity = Vector3(),
+               const real & inverse_mass = 0, const real & damping = 1);
+    void remove(const Handle & particle);
+    bool contains(const Handle & particle) const;
+
+    size_t size() const;
+    void reserve(const size_t & count);
+    void clear();
+
+    // Moves every particle with integrate_particles
+    void step(const real & dt);
+
+    // Orders the arrays so particles of equal damping are next to each
+    // other, and step() computes each power of the damping once. The handles
+    // stay the same.
+    void group_by_damping();
+
+    Vector3 get_position(const Handle & particle) const;
+    void set_position(const Handle & particle, const Vector3 & position);
+
+    Vector3 get_velocity(const Handle & particle) const;
+    void set_velocity(const Handle & particle, const Vector3 & velocity);
+
+    Vector3 get_acceleration(const Handle & particle) const;
+
+    // Forces added until the next step, which applies and clears them
+    void add_force(const Handle & particle, const Vector3 & force);
+    Vector3 get_accumulated_force(const Handle & particle) const;
+
+    // Adds the forces threads have put in the accumulator, which has a
+    // force for every particle, in the order of the arrays
+    void add_forces(ForceAccumulator & accumulator, const size_t & threads = 1);
+
+    void set_mass(const Handle & particle, const real & mass);
+    real get_mass(const Handle & particle) const;
+
+    void set_inverse_mass(const Handle & particle, const real & inverse);
+    real get_inverse_mass(const Handle & particle) const;
+
+    void set_damping(const Handle & particle, const real & damping);
+    real get_damping(const Handle & particle) const;
+
+    void set_gravity(const Vector3 & new_gravity);
+    const Vector3 & get_gravity() const;
+
+    // The arrays themselves, for batch code. Particle i of the arrays is
+    // the one index_of gives for its handle, until a particle is removed.
+    size_t index_of(const Handle & particle) const;
+    Handle handle_at(const size_t & index) const;
+
+    Math::VectorSoA<real, 3> & get_positions();
+    const Math::VectorSoA<real, 3> & get_positions() const;
+    Math::VectorSoA<real, 3> & get_velocities();
+    const Math::VectorSoA<real, 3> & get_velocities() const;
+    const Math::VectorSoA<real, 3> & get_accelerations() const;
+    Math::VectorSoA<real, 3> & get_forces();
+    const Math::VectorSoA<real, 3> & get_forces() const;
+    Scalars & get_inverse_masses();
+    const Scalars & get_inverse_masses() const;
+    Scalars & get_dampings();
+    const Scalars & get_dampings() const;
+
+private:
+    Math::VectorSoA<real, 3> positions;
+    Math::VectorSoA<real, 3> velocities;
+    Math::VectorSoA<real, 3> accelerations;
+    Math::VectorSoA<real, 3> forces;
+    Scalars inverse_masses;
+    Scalars dampings;
+
+    // Index in the arrays of each handle, and the handle of each index
+    HandleTable handles;
+
+    Vector3 gravity;
+};
+
+}
+
+#endif // PARTICLEWORLD_PHYSICS_H_INCLUDED
@@ -0,0 +1,77 @@
+#include "forceaccumulator.h"
+
+#include <parallel.h>
+#include <simd.h>
+
+#include <assert.h>
+
+namespace Physics
+{
+
+ForceAccumulator::ForceAccumulator(const size_t & buffers, const size_t & particles)
+    : buffers(buffers)
+{
+    assert(buffers > 0 && "Can not accumulate forces without buffers");
+    resize(particles);
+}
+
+size_t ForceAccumulator::buffer_count() const
+{
+    return buffers.size();
+}
+
+size_t ForceAccumulator::size() const
+{
+    return buffers[0].size();
+}
+
+void ForceAccumulator::resize(const size_t & particles)
+{
+    for (auto & buffer : buffers) {
+        buffer.clear();
+        buffer.resize(particles);
+    }
+}
+
+void ForceAccumulator::add(const size_t & buffer, const size_t & particle, const Vector3 & force)
+{
+    assert(buffer < buffers.size() && particle < size() && "Index operator out of range");
+    for (size_t c = 0; c < 3; ++c) {
+        buffers[buffer].component(c)[particle] += force[c];
+    }
+}
+
+Vector3 ForceAccumulator::get(const size_t & buffer, const size_t & particle) const
+{
+    assert(buffer < buffers.size() && particle < size() && "Index operator out of range");
+    return buffers[buffer].get(particle);
+}
+
+void ForceAccumulator::reduce(Math::VectorSoA<real, 3> & forces, const size_t & threads)
+{
+    typedef Math::Simd::Native<real>::type reg;
+    assert(forces.size() == size() && "Can not reduce forces of a different number of particles");
+
+    const reg zero = reg::broadcast(0);
+    Math::parallel_for(size(), threads, [&](const size_t & begin, const size_t & end) {
+        for (size_t c = 0; c < 3; ++c) {
+            real * force = forces.component(c);
+
+            for (auto & buffer : buffers) {
+                real * added = buffer.component(c);
+
+                size_t i = begin;
+                for (; i + reg::size <= end; i += reg::size) {
+                    (reg::load(force + i) + reg::load(added + i)).store(force + i);
+                    zero.store(added + i);
+                }
+                for (; i < end; ++i) {
+                    force[i] += added[i];
+                    added[i] = 0;
+                }
+            }
+        }
+    });
+}
+
+}
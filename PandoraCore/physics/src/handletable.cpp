@@ -0,0 +1,113 @@
+#include "handletable.h"
+
+#include <assert.h>
+#include <limits>
+
+namespace Physics
+{
+
+const size_t HandleTable::no_index = std::numeric_limits<size_t>::max();
+
+HandleTable::Handle HandleTable::add()
+{
+    size_t slot;
+    if (free_slots.empty()) {
+        slot = indices.size();
+        indices.push_back(size());
+        generations.push_back(0);
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        indices[slot] = size();
+    }
+    slots.push_back(slot);
+    return handle_of(slot);
+}
+
+// The last element moves into the place of the removed one, so the array
+// stays without holes
+size_t HandleTable::remove(const Handle & handle)
+{
+    if (!contains(handle)) {
+        return no_index;
+    }
+
+    const size_t slot = slot_of(handle);
+    const size_t index = indices[slot];
+    const size_t last = size() - 1;
+    if (index != last) {
+        slots[index] = slots[last];
+        indices[slots[index]] = index;
+    }
+    slots.pop_back();
+
+    indices[slot] = no_index;
+    ++generations[slot];
+    free_slots.push_back(slot);
+    return index;
+}
+
+bool HandleTable::contains(const Handle & handle) const
+{
+    const size_t slot = slot_of(handle);
+    return slot < indices.size() && indices[slot] != no_index && handle_of(slot) == handle;
+}
+
+size_t HandleTable::index_of(const Handle & handle) const
+{
+    assert(contains(handle) && "Can not find handle not in the table");
+    return indices[slot_of(handle)];
+}
+
+HandleTable::Handle HandleTable::handle_at(const size_t & index) const
+{
+    assert(index < size() && "Index operator out of range");
+    return handle_of(slots[index]);
+}
+
+size_t HandleTable::size() const
+{
+    return slots.size();
+}
+
+void HandleTable::reserve(const size_t & count)
+{
+    indices.reserve(count);
+    generations.reserve(count);
+    slots.reserve(count);
+}
+
+// The generations are kept, so the handles given out before stay invalid
+void HandleTable::clear()
+{
+    for (const auto & slot : slots) {
+        indices[slot] = no_index;
+        ++generations[slot];
+        free_slots.push_back(slot);
+    }
+    slots.clear();
+}
+
+void HandleTable::reorder(const std::vector<size_t> & order)
+{
+    assert(order.size() == size() && "Can not reorder with an order of another size");
+
+    std::vector<size_t> sorted_slots(size());
+    for (size_t i = 0; i < size(); ++i) {
+        sorted_slots[i] = slots[order[i]];
+        indices[sorted_slots[i]] = i;
+    }
+    slots = std::move(sorted_slots);
+}
+
+size_t HandleTable::slot_of(const Handle & handle)
+{
+    return size_t(handle & 0xffffffff);
+}
+
+HandleTable::Handle HandleTable::handle_of(const size_t & slot) const
+{
+    return Handle(generations[slot]) << 32 | slot;
+}
+
+}
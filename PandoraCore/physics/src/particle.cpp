@@ -29,9 +29,11 @@ void Particle::update(const real & dt)
 {
     position += dt * velocity;
 
-    acceleration = inverse_mass * gravity;
+    acceleration = inverse_mass * (gravity + force_accumulator);
     velocity *= std::pow(damping, dt);
     velocity += acceleration * dt;
+
+    clear_accumulator();
 }
 
 const Vector3 & Particle::get_position() const
@@ -79,4 +81,19 @@ const Vector3 & Particle::get_gravity() const
     return gravity;
 }
 
+void Particle::add_force(const Vector3 & force)
+{
+    force_accumulator += force;
+}
+
+const Vector3 & Particle::get_accumulated_force() const
+{
+    return force_accumulator;
+}
+
+void Particle::clear_accumulator()
+{
+    force_accumulator = Vector3();
+}
+
 }
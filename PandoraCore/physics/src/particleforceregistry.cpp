@@ -2,26 +2,111 @@
 #include "particleforce.h"
 #include "particle.h"
 
+#include <parallel.h>
+
 #include <algorithm>
+#include <cassert>
+#include <functional>
 
 namespace Physics
 {
 
-void ParticleForceRegistry::add(Physics::ParticleForcePtr force, Physics::ParticlePtr particle)
+ParticleForceRegistry::Handle ParticleForceRegistry::add(Physics::ParticleForcePtr force, Physics::ParticlePtr particle)
 {
-    ForceParticlePair pair{force, particle};
-    particleforcepairs.push_front(pair);
+    particleforcepairs.emplace_back(force, particle);
+    partitioned = false;
+    return handles.add();
+}
+
+std::vector<ParticleForceRegistry::Handle> ParticleForceRegistry::add_many(Physics::ParticleForcePtr force,
+                                                                          const std::vector<Physics::ParticlePtr> & particles)
+{
+    reserve(size() + particles.size());
+
+    std::vector<Handle> added;
+    added.reserve(particles.size());
+    for (const auto & particle : particles) {
+        added.push_back(add(force, particle));
+    }
+    return added;
+}
+
+void ParticleForceRegistry::remove(const Handle & pair)
+{
+    assert(contains(pair) && "Can not remove pair not in the registry");
+
+    const size_t index = handles.remove(pair);
+    if (index == HandleTable::no_index) {
+        return;
+    }
+
+    // The last pair moves into the place of the removed one, so the pairs
+    // stay without holes
+    const size_t last = handles.size();
+    if (index != last) {
+        particleforcepairs[index] = std::move(particleforcepairs[last]);
+    }
+    particleforcepairs.pop_back();
+    partitioned = false;
+}
+
+void ParticleForceRegistry::remove_many(const std::vector<Handle> & pairs)
+{
+    for (const auto & pair : pairs) {
+        remove(pair);
+    }
 }
 
 void ParticleForceRegistry::remove(Physics::ParticleForcePtr force, Physics::ParticlePtr particle)
 {
-    ForceParticlePair pair{force, particle};
-    particleforcepairs.remove(pair);
+    const ForceParticlePair removed{force, particle};
+    size_t i = 0;
+    while (i < size()) {
+        if (particleforcepairs[i] == removed) {
+            // The last pair takes its place, and is looked at next
+            remove(handles.handle_at(i));
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool ParticleForceRegistry::contains(const Handle & pair) const
+{
+    return handles.contains(pair);
+}
+
+size_t ParticleForceRegistry::size() const
+{
+    return particleforcepairs.size();
+}
+
+void ParticleForceRegistry::reserve(const size_t & count)
+{
+    particleforcepairs.reserve(count);
+    handles.reserve(count);
 }
 
 void ParticleForceRegistry::clear()
 {
     particleforcepairs.clear();
+    handles.clear();
+    partitioned = false;
+}
+
+void ParticleForceRegistry::set_thread_count(const size_t & threads)
+{
+    this->threads = threads;
+
+    // Starts the threads of the pool now rather than in the first update
+    if (threads != 1) {
+        Math::ThreadPool::shared().reserve(threads);
+    }
+}
+
+size_t ParticleForceRegistry::get_thread_count() const
+{
+    return threads;
 }
 
 void ParticleForceRegistry::update_particles_with_forces(const real & timestep)
@@ -30,8 +115,51 @@ void ParticleForceRegistry::update_particles_with_forces(const real & timestep)
         return;
     }
 
-    auto update_force = [&timestep](ForceParticlePair & pair) { pair.update_force(timestep); };
-    std::for_each(particleforcepairs.begin(), particleforcepairs.end(), update_force);
+    // Last pair first, the order the pairs were updated in when they were
+    // kept in a list that was added to at the front
+    if (threads == 1) {
+        std::for_each(particleforcepairs.rbegin(), particleforcepairs.rend(), [&](ForceParticlePair & pair) {
+            pair.update_force(timestep);
+        });
+        return;
+    }
+
+    if (!partitioned) {
+        partition_by_particle();
+    }
+    Math::parallel_for(particle_begin.size() - 1, threads, [&](const size_t & begin, const size_t & end) {
+        for (size_t i = particle_begin[end]; i-- > particle_begin[begin];) {
+            particleforcepairs[pairs_by_particle[i]].update_force(timestep);
+        }
+    });
+}
+
+// A stable sort keeps the pairs of each particle in the order of the vector,
+// and walking the partition backwards updates them in the same order as with
+// one thread
+void ParticleForceRegistry::partition_by_particle()
+{
+    pairs_by_particle.resize(size());
+    for (size_t i = 0; i < size(); ++i) {
+        pairs_by_particle[i] = i;
+    }
+    std::stable_sort(pairs_by_particle.begin(), pairs_by_particle.end(),
+                     [this](const size_t & left, const size_t & right) {
+                         return std::less<const Particle *>()(particleforcepairs[left].get_particle(),
+                                                              particleforcepairs[right].get_particle());
+                     });
+
+    const auto particle_of = [this](const size_t & i) {
+        return particleforcepairs[pairs_by_particle[i]].get_particle();
+    };
+    particle_begin.clear();
+    for (size_t i = 0; i < pairs_by_particle.size(); ++i) {
+        if (i == 0 || particle_of(i) != particle_of(i - 1)) {
+            particle_begin.push_back(i);
+        }
+    }
+    particle_begin.push_back(pairs_by_particle.size());
+    partitioned = true;
 }
 
 ParticleForceRegistry::ForceParticlePair::ForceParticlePair(std::shared_ptr<ParticleForce> force, std::shared_ptr<Particle> particle)
@@ -48,4 +176,9 @@ bool ParticleForceRegistry::ForceParticlePair::operator==(const ParticleForceReg
     return (this->force == other.force && this->particle == other.particle);
 }
 
+const Particle * ParticleForceRegistry::ForceParticlePair::get_particle() const
+{
+    return particle.get();
+}
+
 }
@@ -0,0 +1,285 @@
+#include "particleworld.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace Physics
+{
+
+ParticleWorld::ParticleWorld(const Vector3 & gravity)
+    : gravity(gravity)
+{}
+
+ParticleWorld::Handle ParticleWorld::add(const Vector3 & position, const Vector3 & velocity,
+                                         const real & inverse_mass, const real & damping)
+{
+    positions.push_back(position);
+    velocities.push_back(velocity);
+    accelerations.push_back(Vector3());
+    forces.push_back(Vector3());
+    inverse_masses.push_back(inverse_mass);
+    dampings.push_back(damping);
+
+    return handles.add();
+}
+
+void ParticleWorld::remove(const Handle & particle)
+{
+    assert(contains(particle) && "Can not remove particle not in the world");
+
+    const size_t index = handles.remove(particle);
+    if (index == HandleTable::no_index) {
+        return;
+    }
+
+    // The last particle moves into the place of the removed one, so the
+    // arrays stay without holes
+    const size_t last = handles.size();
+    if (index != last) {
+        positions.set(index, positions.get(last));
+        velocities.set(index, velocities.get(last));
+        accelerations.set(index, accelerations.get(last));
+        forces.set(index, forces.get(last));
+        inverse_masses[index] = inverse_masses[last];
+        dampings[index] = dampings[last];
+    }
+
+    positions.resize(last);
+    velocities.resize(last);
+    accelerations.resize(last);
+    forces.resize(last);
+    inverse_masses.pop_back();
+    dampings.pop_back();
+}
+
+bool ParticleWorld::contains(const Handle & particle) const
+{
+    return handles.contains(particle);
+}
+
+size_t ParticleWorld::size() const
+{
+    return handles.size();
+}
+
+void ParticleWorld::reserve(const size_t & count)
+{
+    positions.reserve(count);
+    velocities.reserve(count);
+    accelerations.reserve(count);
+    forces.reserve(count);
+    inverse_masses.reserve(count);
+    dampings.reserve(count);
+    handles.reserve(count);
+}
+
+void ParticleWorld::clear()
+{
+    positions.clear();
+    velocities.clear();
+    accelerations.clear();
+    forces.clear();
+    inverse_masses.clear();
+    dampings.clear();
+    handles.clear();
+}
+
+void ParticleWorld::step(const real & dt)
+{
+    ParticleArrays<real> particles;
+    for (size_t c = 0; c < 3; ++c) {
+        particles.position[c] = positions.component(c);
+        particles.velocity[c] = velocities.component(c);
+        particles.acceleration[c] = accelerations.component(c);
+        particles.force[c] = forces.component(c);
+    }
+    particles.inverse_mass = inverse_masses.data();
+    particles.damping = dampings.data();
+
+    integrate_particles(particles, size(), gravity, dt);
+}
+
+void ParticleWorld::group_by_damping()
+{
+    const size_t count = size();
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](const size_t & left, const size_t & right) {
+        return dampings[left] < dampings[right];
+    });
+
+    Math::VectorSoA<real, 3> sorted_positions(count);
+    Math::VectorSoA<real, 3> sorted_velocities(count);
+    Math::VectorSoA<real, 3> sorted_accelerations(count);
+    Math::VectorSoA<real, 3> sorted_forces(count);
+    Scalars sorted_inverse_masses(count);
+    Scalars sorted_dampings(count);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t from = order[i];
+        sorted_positions.set(i, positions.get(from));
+        sorted_velocities.set(i, velocities.get(from));
+        sorted_accelerations.set(i, accelerations.get(from));
+        sorted_forces.set(i, forces.get(from));
+        sorted_inverse_masses[i] = inverse_masses[from];
+        sorted_dampings[i] = dampings[from];
+    }
+
+    positions = std::move(sorted_positions);
+    velocities = std::move(sorted_velocities);
+    accelerations = std::move(sorted_accelerations);
+    forces = std::move(sorted_forces);
+    inverse_masses = std::move(sorted_inverse_masses);
+    dampings = std::move(sorted_dampings);
+    handles.reorder(order);
+}
+
+Vector3 ParticleWorld::get_position(const Handle & particle) const
+{
+    return positions.get(index_of(particle));
+}
+
+void ParticleWorld::set_position(const Handle & particle, const Vector3 & position)
+{
+    positions.set(index_of(particle), position);
+}
+
+Vector3 ParticleWorld::get_velocity(const Handle & particle) const
+{
+    return velocities.get(index_of(particle));
+}
+
+void ParticleWorld::set_velocity(const Handle & particle, const Vector3 & velocity)
+{
+    velocities.set(index_of(particle), velocity);
+}
+
+Vector3 ParticleWorld::get_acceleration(const Handle & particle) const
+{
+    return accelerations.get(index_of(particle));
+}
+
+void ParticleWorld::add_force(const Handle & particle, const Vector3 & force)
+{
+    const size_t index = index_of(particle);
+    forces.set(index, Vector3(forces.get(index) + force));
+}
+
+Vector3 ParticleWorld::get_accumulated_force(const Handle & particle) const
+{
+    return forces.get(index_of(particle));
+}
+
+void ParticleWorld::add_forces(ForceAccumulator & accumulator, const size_t & threads)
+{
+    accumulator.reduce(forces, threads);
+}
+
+void ParticleWorld::set_mass(const Handle & particle, const real & mass)
+{
+    inverse_masses[index_of(particle)] = 1/mass;
+}
+
+real ParticleWorld::get_mass(const Handle & particle) const
+{
+    return 1/inverse_masses[index_of(particle)];
+}
+
+void ParticleWorld::set_inverse_mass(const Handle & particle, const real & inverse)
+{
+    inverse_masses[index_of(particle)] = inverse;
+}
+
+real ParticleWorld::get_inverse_mass(const Handle & particle) const
+{
+    return inverse_masses[index_of(particle)];
+}
+
+void ParticleWorld::set_damping(const Handle & particle, const real & damping)
+{
+    dampings[index_of(particle)] = damping;
+}
+
+real ParticleWorld::get_damping(const Handle & particle) const
+{
+    return dampings[index_of(particle)];
+}
+
+void ParticleWorld::set_gravity(const Vector3 & new_gravity)
+{
+    gravity = new_gravity;
+}
+
+const Vector3 & ParticleWorld::get_gravity() const
+{
+    return gravity;
+}
+
+size_t ParticleWorld::index_of(const Handle & particle) const
+{
+    assert(contains(particle) && "Can not find particle not in the world");
+    return handles.index_of(particle);
+}
+
+ParticleWorld::Handle ParticleWorld::handle_at(const size_t & index) const
+{
+    return handles.handle_at(index);
+}
+
+Math::VectorSoA<real, 3> & ParticleWorld::get_positions()
+{
+    return positions;
+}
+
+const Math::VectorSoA<real, 3> & ParticleWorld::get_positions() const
+{
+    return positions;
+}
+
+Math::VectorSoA<real, 3> & ParticleWorld::get_velocities()
+{
+    return velocities;
+}
+
+const Math::VectorSoA<real, 3> & ParticleWorld::get_velocities() const
+{
+    return velocities;
+}
+
+const Math::VectorSoA<real, 3> & ParticleWorld::get_accelerations() const
+{
+    return accelerations;
+}
+
+Math::VectorSoA<real, 3> & ParticleWorld::get_forces()
+{
+    return forces;
+}
+
+const Math::VectorSoA<real, 3> & ParticleWorld::get_forces() const
+{
+    return forces;
+}
+
+ParticleWorld::Scalars & ParticleWorld::get_inverse_masses()
+{
+    return inverse_masses;
+}
+
+const ParticleWorld::Scalars & ParticleWorld::get_inverse_masses() const
+{
+    return inverse_masses;
+}
+
+ParticleWorld::Scalars & ParticleWorld::get_dampings()
+{
+    return dampings;
+}
+
+const ParticleWorld::Scalars & ParticleWorld::get_dampings() const
+{
+    return dampings;
+}
+
+}
@@ -1,11 +1,14 @@
 #ifndef PARTICLEFORCETEST_H_INCLUDED
 #define PARTICLEFORCETEST_H_INCLUDED
 
+#include <particle.h>
 #include <particleforce.h>
 #include <particleforceregistry.h>
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 class SimpleForce : public Physics::ParticleForce
 {
 public:
@@ -25,6 +28,38 @@ public:
 
 typedef std::shared_ptr<SimpleForce> SimpleForcePtr;
 
+// Pushes the particle by a force of its own, scaled by the timestep
+class PushForce : public Physics::ParticleForce
+{
+public:
+    explicit PushForce(const Physics::Vector3 & push)
+        : push(push)
+    {}
+
+    virtual void update_force(std::shared_ptr<Physics::Particle> particle, real duration)
+    {
+        particle->add_force(Physics::Vector3(push * duration));
+    }
+
+    Physics::Vector3 push;
+};
+
+// Appends itself to a list shared with other forces when it is updated
+class OrderForce : public Physics::ParticleForce
+{
+public:
+    explicit OrderForce(std::vector<const OrderForce *> & updated)
+        : updated(updated)
+    {}
+
+    virtual void update_force(std::shared_ptr<Physics::Particle> /* particle */, real /* duration */)
+    {
+        updated.push_back(this);
+    }
+
+    std::vector<const OrderForce *> & updated;
+};
+
 class ParticleForceTest : public ::testing::Test
 {
 protected:
@@ -0,0 +1,23 @@
+#ifndef PARTICLEWORLDTEST_H_INCLUDED
+#define PARTICLEWORLDTEST_H_INCLUDED
+
+#include <particleworld.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+class ParticleWorldTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp();
+    void add_random_particles(const size_t & count);
+    void expect_near(const Physics::Vector3 & expected, const Physics::Vector3 & vector);
+
+    Physics::ParticleWorld world;
+    std::vector<Physics::ParticleWorld::Handle> handles;
+    std::vector<Physics::Particle> particles;
+    real timestep;
+};
+
+#endif // PARTICLEWORLDTEST_H_INCLUDED
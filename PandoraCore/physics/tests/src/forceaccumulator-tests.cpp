@@ -0,0 +1,133 @@
+#include "test-helpers.h"
+
+#include <forceaccumulator.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+TEST(ForceAccumulatorTest, a_new_accumulator_holds_zero_forces)
+{
+    Physics::ForceAccumulator accumulator(3, 10);
+
+    EXPECT_EQ(3u, accumulator.buffer_count());
+    EXPECT_EQ(10u, accumulator.size());
+    EXPECT_EQ(Physics::Vector3(), accumulator.get(2, 9));
+}
+
+TEST(ForceAccumulatorTest, forces_add_up_in_their_own_buffer)
+{
+    Physics::ForceAccumulator accumulator(2, 4);
+    const auto force = create_random_vector3();
+
+    accumulator.add(1, 3, force);
+    accumulator.add(1, 3, force);
+
+    EXPECT_EQ(Physics::Vector3(force + force), accumulator.get(1, 3));
+    EXPECT_EQ(Physics::Vector3(), accumulator.get(0, 3));
+}
+
+TEST(ForceAccumulatorTest, reducing_adds_the_buffers_in_order_and_zeroes_them)
+{
+    const size_t count = 203;
+    Physics::ForceAccumulator accumulator(3, count);
+    Math::VectorSoA<real, 3> forces(count);
+    std::vector<Physics::Vector3> added(3 * count);
+
+    for (size_t buffer = 0; buffer < 3; ++buffer) {
+        for (size_t i = 0; i < count; ++i) {
+            added[buffer * count + i] = create_random_vector3();
+            accumulator.add(buffer, i, added[buffer * count + i]);
+        }
+    }
+    forces.set(7, Physics::Vector3(1, 2, 3));
+
+    accumulator.reduce(forces, 4);
+
+    for (size_t i = 0; i < count; ++i) {
+        Physics::Vector3 expected = i == 7 ? Physics::Vector3(1, 2, 3) : Physics::Vector3();
+        for (size_t buffer = 0; buffer < 3; ++buffer) {
+            expected += added[buffer * count + i];
+        }
+        EXPECT_EQ(expected, forces.get(i));
+        EXPECT_EQ(Physics::Vector3(), accumulator.get(1, i));
+    }
+}
+
+TEST(ForceAccumulatorTest, accumulating_forces_gives_every_item_to_one_buffer_the_same_on_every_run)
+{
+    const size_t count = 1000;
+    const size_t particles = 17;
+    std::vector<Physics::Vector3> items(count);
+    for (auto & item : items) {
+        item = create_random_vector3();
+    }
+
+    // Every item pushes on a particle shared with many other items
+    auto run = [&]() {
+        Physics::ForceAccumulator accumulator(4, particles);
+        Math::VectorSoA<real, 3> forces(particles);
+        Physics::accumulate_forces(accumulator, count, [&](const size_t & begin, const size_t & end,
+                                                           const size_t & buffer) {
+            for (size_t i = begin; i < end; ++i) {
+                accumulator.add(buffer, i % particles, items[i]);
+            }
+        });
+        accumulator.reduce(forces);
+        return forces;
+    };
+
+    const auto first = run();
+    for (size_t repeat = 0; repeat < 10; ++repeat) {
+        const auto forces = run();
+        for (size_t i = 0; i < particles; ++i) {
+            EXPECT_EQ(first.get(i), forces.get(i));
+        }
+    }
+
+    Physics::Vector3 total;
+    Physics::Vector3 expected;
+    for (size_t i = 0; i < particles; ++i) {
+        total += first.get(i);
+    }
+    for (const auto & item : items) {
+        expected += item;
+    }
+    for (size_t c = 0; c < 3; ++c) {
+        EXPECT_NEAR(expected[c], total[c], 1e-9 * expected[c]);
+    }
+}
+
+TEST(ForceAccumulatorTest, accumulating_fewer_items_than_buffers_leaves_some_ranges_empty)
+{
+    Physics::ForceAccumulator accumulator(8, 3);
+    std::vector<size_t> calls(8);
+
+    Physics::accumulate_forces(accumulator, 3, [&](const size_t & begin, const size_t & end, const size_t & buffer) {
+        calls[buffer] = end - begin;
+    });
+
+    EXPECT_EQ(1u, calls[0]);
+    EXPECT_EQ(1u, calls[2]);
+    EXPECT_EQ(0u, calls[7]);
+}
+
+TEST(ForceAccumulatorTest, exception_on_the_calling_thread_waits_for_the_other_buffers)
+{
+    Physics::ForceAccumulator accumulator(4, 100);
+    std::vector<size_t> calls(4);
+
+    EXPECT_THROW(Physics::accumulate_forces(accumulator, 100,
+                                            [&](const size_t & begin, const size_t & end, const size_t & buffer) {
+        if (buffer == 0) {
+            throw std::runtime_error("first buffer");
+        }
+        calls[buffer] = end - begin;
+    }), std::runtime_error);
+
+    EXPECT_EQ(0u, calls[0]);
+    for (size_t buffer = 1; buffer < 4; ++buffer) {
+        EXPECT_EQ(25u, calls[buffer]);
+    }
+}
@@ -0,0 +1,96 @@
+#include <handletable.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(HandleTableTest, handles_name_the_index_they_were_added_at)
+{
+    Physics::HandleTable table;
+    std::vector<Physics::HandleTable::Handle> handles;
+    for (size_t i = 0; i < 4; ++i) {
+        handles.push_back(table.add());
+    }
+
+    EXPECT_EQ(4u, table.size());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        EXPECT_TRUE(table.contains(handles[i]));
+        EXPECT_EQ(i, table.index_of(handles[i]));
+        EXPECT_EQ(handles[i], table.handle_at(i));
+    }
+}
+
+TEST(HandleTableTest, removing_moves_the_last_handle_into_the_place_of_the_removed_one)
+{
+    Physics::HandleTable table;
+    const auto first = table.add();
+    const auto second = table.add();
+    const auto third = table.add();
+
+    EXPECT_EQ(0u, table.remove(first));
+    EXPECT_EQ(2u, table.size());
+    EXPECT_FALSE(table.contains(first));
+    EXPECT_EQ(0u, table.index_of(third));
+    EXPECT_EQ(1u, table.index_of(second));
+}
+
+TEST(HandleTableTest, handles_of_removed_elements_never_name_the_element_given_their_slot)
+{
+    Physics::HandleTable table;
+    const auto removed = table.add();
+    table.remove(removed);
+    const auto added = table.add();
+
+    EXPECT_NE(removed, added);
+    EXPECT_FALSE(table.contains(removed));
+    EXPECT_TRUE(table.contains(added));
+}
+
+TEST(HandleTableTest, removing_a_stale_or_duplicate_handle_changes_nothing)
+{
+    Physics::HandleTable table;
+    const auto removed = table.add();
+    const auto kept = table.add();
+    table.remove(removed);
+    const auto added = table.add();
+
+    EXPECT_EQ(Physics::HandleTable::no_index, table.remove(removed));
+    EXPECT_EQ(2u, table.size());
+    EXPECT_TRUE(table.contains(kept));
+    EXPECT_TRUE(table.contains(added));
+
+    table.remove(kept);
+    EXPECT_EQ(Physics::HandleTable::no_index, table.remove(kept));
+    EXPECT_EQ(1u, table.size());
+    EXPECT_EQ(0u, table.index_of(added));
+}
+
+TEST(HandleTableTest, clearing_invalidates_the_handles_given_out_before)
+{
+    Physics::HandleTable table;
+    const auto cleared = table.add();
+    table.clear();
+    const auto added = table.add();
+
+    EXPECT_EQ(1u, table.size());
+    EXPECT_FALSE(table.contains(cleared));
+    EXPECT_TRUE(table.contains(added));
+}
+
+TEST(HandleTableTest, reordering_keeps_every_handle_with_its_element)
+{
+    Physics::HandleTable table;
+    std::vector<Physics::HandleTable::Handle> handles;
+    for (size_t i = 0; i < 4; ++i) {
+        handles.push_back(table.add());
+    }
+
+    table.reorder({2, 0, 3, 1});
+    EXPECT_EQ(handles[2], table.handle_at(0));
+    EXPECT_EQ(handles[0], table.handle_at(1));
+    EXPECT_EQ(handles[3], table.handle_at(2));
+    EXPECT_EQ(handles[1], table.handle_at(3));
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(i, table.index_of(table.handle_at(i)));
+    }
+}
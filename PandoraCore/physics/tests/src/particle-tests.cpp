@@ -114,6 +114,30 @@ TEST_F(ParticleTest, particle_with_zero_inverse_mass_will_never_change_velocity)
     }
 }
 
+TEST_F(ParticleTest, added_forces_accumulate_until_the_next_update)
+{
+    const auto force = create_random_vector3();
+    random_particle.add_force(force);
+    random_particle.add_force(force);
+
+    EXPECT_EQ(force + force, random_particle.get_accumulated_force());
+
+    random_particle.clear_accumulator();
+    EXPECT_EQ(zero_vector, random_particle.get_accumulated_force());
+}
+
+TEST_F(ParticleTest, updating_particle_applies_the_accumulated_force_and_clears_it)
+{
+    const auto force = create_random_vector3();
+    set_mass_gravity(2, 0);
+    random_particle.add_force(force);
+    random_particle.update(1);
+
+    EXPECT_EQ(0.5 * force, random_particle.get_acceleration());
+    EXPECT_EQ(initial_velocity + 0.5 * force, random_particle.get_velocity());
+    EXPECT_EQ(zero_vector, random_particle.get_accumulated_force());
+}
+
 TEST_F(ParticleTest, y_component_of_velocity_of_particle_with_positive_mass_and_gravity_will_decrease_for_each_update)
 {
     default_particle.set_inverse_mass(3.4);
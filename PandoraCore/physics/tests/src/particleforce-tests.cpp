@@ -1,6 +1,9 @@
 #include "particleforcetest.h"
+#include "test-helpers.h"
 #include <particle.h>
 
+#include <vector>
+
 void ParticleForceTest::SetUp()
 {
     particle = std::make_shared<Physics::Particle>();
@@ -111,3 +114,163 @@ TEST_F(ParticleForceTest, adding_the_same_force_pair_twice_and_removing_it_remov
     EXPECT_FALSE(force1->called);
     EXPECT_TRUE(force2->called);
 }
+
+TEST_F(ParticleForceTest, registry_updates_on_one_thread_by_default)
+{
+    EXPECT_EQ(1u, registry.get_thread_count());
+
+    registry.set_thread_count(4);
+    EXPECT_EQ(4u, registry.get_thread_count());
+}
+
+TEST_F(ParticleForceTest, pairs_are_updated_last_added_first_on_any_number_of_threads)
+{
+    std::vector<const OrderForce *> updated;
+    std::vector<std::shared_ptr<OrderForce> > forces;
+    for (size_t i = 0; i < 3; ++i) {
+        forces.push_back(std::make_shared<OrderForce>(updated));
+        registry.add(forces.back(), particle);
+    }
+
+    registry.update_particles_with_forces(timestep);
+    registry.set_thread_count(2);
+    registry.update_particles_with_forces(timestep);
+
+    const std::vector<const OrderForce *> expected{forces[2].get(), forces[1].get(), forces[0].get(),
+                                                   forces[2].get(), forces[1].get(), forces[0].get()};
+    EXPECT_EQ(expected, updated);
+}
+
+TEST_F(ParticleForceTest, updating_on_many_threads_gives_every_particle_the_same_forces_as_one_thread)
+{
+    Physics::ParticleForceRegistry parallel;
+    parallel.set_thread_count(4);
+    std::vector<Physics::ParticlePtr> particles;
+    std::vector<Physics::ParticlePtr> parallel_particles;
+    for (size_t i = 0; i < 300; ++i) {
+        particles.push_back(std::make_shared<Physics::Particle>());
+        parallel_particles.push_back(std::make_shared<Physics::Particle>());
+    }
+
+    // Forces of very different sizes on each particle, so a different order
+    // would round differently
+    for (size_t i = 0; i < 5000; ++i) {
+        const size_t particle = (i * 7919) % particles.size();
+        auto force = std::make_shared<PushForce>(create_random_vector3() * double(1 << (i % 40)));
+        registry.add(force, particles[particle]);
+        parallel.add(force, parallel_particles[particle]);
+    }
+    registry.update_particles_with_forces(timestep);
+    parallel.update_particles_with_forces(timestep);
+
+    for (size_t i = 0; i < particles.size(); ++i) {
+        EXPECT_EQ(particles[i]->get_accumulated_force(), parallel_particles[i]->get_accumulated_force());
+    }
+}
+
+TEST_F(ParticleForceTest, updating_on_many_threads_skips_pairs_removed_since_the_last_update)
+{
+    registry.set_thread_count(2);
+    add_both_forces();
+    registry.update_particles_with_forces(timestep);
+
+    force1->called = false;
+    force2->called = false;
+    registry.remove(force1, particle);
+    registry.update_particles_with_forces(timestep);
+
+    EXPECT_FALSE(force1->called);
+    EXPECT_TRUE(force2->called);
+    EXPECT_EQ(timestep, force2->step_recieved);
+}
+
+TEST_F(ParticleForceTest, removing_a_pair_by_its_handle_keeps_the_other_pairs)
+{
+    const auto first = registry.add(force1, particle);
+    const auto second = registry.add(force2, particle);
+    EXPECT_EQ(2u, registry.size());
+    EXPECT_TRUE(registry.contains(first));
+
+    registry.remove(first);
+    EXPECT_FALSE(registry.contains(first));
+    EXPECT_TRUE(registry.contains(second));
+    EXPECT_EQ(1u, registry.size());
+
+    registry.update_particles_with_forces(timestep);
+    EXPECT_FALSE(force1->called);
+    EXPECT_TRUE(force2->called);
+}
+
+TEST_F(ParticleForceTest, removing_a_pair_by_handle_removes_only_that_occurence)
+{
+    const auto first = registry.add(force1, particle);
+    registry.add(force1, particle);
+    registry.remove(first);
+    registry.update_particles_with_forces(timestep);
+
+    EXPECT_EQ(1u, registry.size());
+    EXPECT_TRUE(force1->called);
+}
+
+TEST_F(ParticleForceTest, handles_stay_valid_when_other_pairs_are_removed_and_never_name_new_pairs)
+{
+    std::vector<Physics::ParticlePtr> particles;
+    for (size_t i = 0; i < 10; ++i) {
+        particles.push_back(std::make_shared<Physics::Particle>());
+    }
+    auto push = std::make_shared<PushForce>(Physics::Vector3(1, 2, 3));
+    const auto handles = registry.add_many(push, particles);
+    ASSERT_EQ(particles.size(), handles.size());
+
+    registry.remove_many({handles[0], handles[4], handles[9]});
+    EXPECT_EQ(7u, registry.size());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        EXPECT_EQ(i != 0 && i != 4 && i != 9, registry.contains(handles[i])) << i;
+    }
+
+    // The new pair gets the slot of a removed one, but not its handle
+    const auto added = registry.add(force1, particle);
+    EXPECT_TRUE(registry.contains(added));
+    EXPECT_FALSE(registry.contains(handles[0]) || registry.contains(handles[4]) || registry.contains(handles[9]));
+    EXPECT_EQ(8u, registry.size());
+
+    registry.update_particles_with_forces(1);
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const Physics::Vector3 expected = (i != 0 && i != 4 && i != 9) ? push->push : Physics::Vector3();
+        EXPECT_EQ(expected, particles[i]->get_accumulated_force()) << i;
+    }
+    EXPECT_TRUE(force1->called);
+}
+
+TEST_F(ParticleForceTest, clearing_registry_invalidates_all_handles)
+{
+    const auto first = registry.add(force1, particle);
+    registry.clear();
+
+    EXPECT_FALSE(registry.contains(first));
+    EXPECT_EQ(0u, registry.size());
+}
+
+TEST_F(ParticleForceTest, updating_on_many_threads_skips_pairs_removed_by_handle)
+{
+    std::vector<Physics::ParticlePtr> particles;
+    for (size_t i = 0; i < 200; ++i) {
+        particles.push_back(std::make_shared<Physics::Particle>());
+    }
+    registry.set_thread_count(4);
+    auto push = std::make_shared<PushForce>(Physics::Vector3(1, 0, 0));
+    const auto handles = registry.add_many(push, particles);
+    registry.update_particles_with_forces(1);
+
+    std::vector<Physics::ParticleForceRegistry::Handle> removed;
+    for (size_t i = 0; i < handles.size(); i += 3) {
+        removed.push_back(handles[i]);
+    }
+    registry.remove_many(removed);
+    registry.update_particles_with_forces(1);
+
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const real expected = i % 3 == 0 ? 1 : 2;
+        EXPECT_EQ(Physics::Vector3(expected, 0, 0), particles[i]->get_accumulated_force()) << i;
+    }
+}
@@ -0,0 +1,107 @@
+#include "test-helpers.h"
+
+#include <particleintegrator.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+// Nineteen particles, so the registers of every width leave some for the
+// lane by lane tail
+const size_t count = 19;
+
+template<typename Real>
+class ParticleIntegratorTest : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        for (size_t c = 0; c < 3; ++c) {
+            position[c].resize(count);
+            velocity[c].resize(count);
+            acceleration[c].resize(count);
+            force[c].resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                position[c][i] = Real(create_random_scalar() / 1000);
+                velocity[c][i] = Real(create_random_scalar() / 1000);
+                force[c][i] = Real(create_random_scalar() / 1000);
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            inverse_mass.push_back(Real(i % 5 ? create_random_scalar() / 1000 : 0));
+            damping.push_back(Real(i < 10 ? 0.5 : (i % 2 ? 0.25 : 0.75)));
+        }
+    }
+
+    Physics::ParticleArrays<Real> arrays()
+    {
+        Physics::ParticleArrays<Real> particles;
+        for (size_t c = 0; c < 3; ++c) {
+            particles.position[c] = position[c].data();
+            particles.velocity[c] = velocity[c].data();
+            particles.acceleration[c] = acceleration[c].data();
+            particles.force[c] = force[c].data();
+        }
+        particles.inverse_mass = inverse_mass.data();
+        particles.damping = damping.data();
+        return particles;
+    }
+
+    std::vector<Real> position[3];
+    std::vector<Real> velocity[3];
+    std::vector<Real> acceleration[3];
+    std::vector<Real> force[3];
+    std::vector<Real> inverse_mass;
+    std::vector<Real> damping;
+};
+
+typedef ::testing::Types<float, double> ParticleIntegratorTypes;
+TYPED_TEST_CASE(ParticleIntegratorTest, ParticleIntegratorTypes);
+
+TYPED_TEST(ParticleIntegratorTest, integrating_moves_every_particle_by_its_velocity_damping_gravity_and_forces)
+{
+    typedef TypeParam Real;
+    const Math::Vector<Real, 3> gravity(1, -9.8f, 0.5f);
+    const Real dt = Real(0.45);
+    const Real tolerance = std::is_same<Real, float>::value ? Real(1e-4) : Real(1e-10);
+
+    std::vector<Real> position[3];
+    std::vector<Real> velocity[3];
+    std::vector<Real> force[3];
+    for (size_t c = 0; c < 3; ++c) {
+        position[c] = this->position[c];
+        velocity[c] = this->velocity[c];
+        force[c] = this->force[c];
+    }
+
+    Physics::integrate_particles(this->arrays(), count, gravity, dt);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Real factor = Real(std::pow(this->damping[i], dt));
+        for (size_t c = 0; c < 3; ++c) {
+            const Real expected_acceleration = this->inverse_mass[i] * (gravity[c] + force[c][i]);
+            const Real expected_velocity = velocity[c][i] * factor + expected_acceleration * dt;
+            const Real expected_position = position[c][i] + velocity[c][i] * dt;
+
+            EXPECT_EQ(expected_acceleration, this->acceleration[c][i]);
+            EXPECT_EQ(Real(0), this->force[c][i]);
+            EXPECT_NEAR(expected_position, this->position[c][i], tolerance * std::max(Real(1), expected_position));
+            EXPECT_NEAR(expected_velocity, this->velocity[c][i], tolerance * std::max(Real(1), std::abs(expected_velocity)));
+        }
+    }
+}
+
+TYPED_TEST(ParticleIntegratorTest, particles_of_zero_inverse_mass_are_only_damped)
+{
+    typedef TypeParam Real;
+    const auto velocity = this->velocity[1];
+    const Real dt = Real(0.1);
+
+    Physics::integrate_particles(this->arrays(), count, Math::Vector<Real, 3>(0, -10, 0), dt);
+
+    for (size_t i = 0; i < count; i += 5) {
+        EXPECT_EQ(velocity[i] * Real(std::pow(this->damping[i], dt)), this->velocity[1][i]);
+        EXPECT_EQ(Real(0), this->acceleration[1][i]);
+    }
+}
@@ -0,0 +1,197 @@
+#include "particleworldtest.h"
+#include "test-helpers.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ParticleWorldTest::SetUp()
+{
+    timestep = 0.45;
+}
+
+// Every particle is added both to the world and as a Particle, to compare with
+void ParticleWorldTest::add_random_particles(const size_t & count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        Physics::Particle particle(create_random_vector3(), create_random_vector3());
+        particle.set_inverse_mass(create_random_scalar());
+        particle.damping = create_random_scalar() / 200000;
+
+        handles.push_back(world.add(particle.get_position(), particle.get_velocity(),
+                                    particle.get_inverse_mass(), particle.damping));
+        particles.push_back(particle);
+    }
+}
+
+// The world may use fused multiply-adds where Particle does not. The error
+// is relative to the largest component, as a small one may be what is left
+// of large ones cancelling.
+void ParticleWorldTest::expect_near(const Physics::Vector3 & expected, const Physics::Vector3 & vector)
+{
+    real largest = 1;
+    for (size_t i = 0; i < 3; ++i) {
+        largest = std::max(largest, std::abs(expected[i]));
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(expected[i], vector[i], 1e-12 * largest);
+    }
+}
+
+TEST_F(ParticleWorldTest, a_new_world_has_no_particles_and_default_gravity)
+{
+    EXPECT_EQ(0u, world.size());
+    EXPECT_EQ(Physics::default_gravity, world.get_gravity());
+}
+
+TEST_F(ParticleWorldTest, added_particles_keep_their_properties)
+{
+    const auto position = create_random_vector3();
+    const auto velocity = create_random_vector3();
+    const auto particle = world.add(position, velocity, 2, 0.5);
+    const auto other = world.add(position);
+
+    EXPECT_NE(particle, other);
+    EXPECT_EQ(2u, world.size());
+    EXPECT_EQ(position, world.get_position(particle));
+    EXPECT_EQ(velocity, world.get_velocity(particle));
+    EXPECT_EQ(Physics::Vector3(), world.get_acceleration(particle));
+    EXPECT_EQ(2, world.get_inverse_mass(particle));
+    EXPECT_EQ(0.5, world.get_mass(particle));
+    EXPECT_EQ(0.5, world.get_damping(particle));
+
+    EXPECT_EQ(Physics::Vector3(), world.get_velocity(other));
+    EXPECT_EQ(0, world.get_inverse_mass(other));
+    EXPECT_EQ(1, world.get_damping(other));
+}
+
+TEST_F(ParticleWorldTest, stepping_the_world_moves_the_particles_as_updating_them_does)
+{
+    add_random_particles(37);
+
+    for (size_t step = 0; step < 20; ++step) {
+        world.step(timestep);
+        for (size_t i = 0; i < particles.size(); ++i) {
+            particles[i].update(timestep);
+
+            expect_near(particles[i].get_position(), world.get_position(handles[i]));
+            expect_near(particles[i].get_velocity(), world.get_velocity(handles[i]));
+            expect_near(particles[i].get_acceleration(), world.get_acceleration(handles[i]));
+        }
+    }
+}
+
+TEST_F(ParticleWorldTest, stepping_the_world_applies_and_clears_the_accumulated_forces)
+{
+    add_random_particles(11);
+    const auto force = create_random_vector3();
+
+    for (size_t i = 0; i < particles.size(); i += 2) {
+        particles[i].add_force(force);
+        world.add_force(handles[i], force);
+    }
+    EXPECT_EQ(force, world.get_accumulated_force(handles[2]));
+
+    world.step(timestep);
+    for (size_t i = 0; i < particles.size(); ++i) {
+        particles[i].update(timestep);
+
+        expect_near(particles[i].get_velocity(), world.get_velocity(handles[i]));
+        expect_near(particles[i].get_acceleration(), world.get_acceleration(handles[i]));
+        EXPECT_EQ(Physics::Vector3(), world.get_accumulated_force(handles[i]));
+    }
+}
+
+TEST_F(ParticleWorldTest, forces_from_an_accumulator_are_added_to_the_particles)
+{
+    add_random_particles(5);
+    Physics::ForceAccumulator accumulator(2, world.size());
+    const auto force = create_random_vector3();
+
+    world.add_force(handles[3], force);
+    accumulator.add(0, world.index_of(handles[3]), force);
+    accumulator.add(1, world.index_of(handles[3]), force);
+    world.add_forces(accumulator);
+
+    EXPECT_EQ(Physics::Vector3(force + force + force), world.get_accumulated_force(handles[3]));
+    EXPECT_EQ(Physics::Vector3(), world.get_accumulated_force(handles[0]));
+}
+
+TEST_F(ParticleWorldTest, particles_with_zero_inverse_mass_are_only_damped_like_a_particle)
+{
+    const auto velocity = create_random_vector3();
+    const auto particle = world.add(create_random_vector3(), velocity);
+    Physics::Particle damped_particle(create_random_vector3(), velocity);
+    damped_particle.damping = 0.5;
+    const auto damped = world.add(damped_particle.get_position(), velocity, 0, damped_particle.damping);
+
+    for (size_t i = 0; i < 400; ++i) {
+        world.step(timestep);
+        damped_particle.update(timestep);
+        EXPECT_EQ(velocity, world.get_velocity(particle));
+        expect_near(damped_particle.get_velocity(), world.get_velocity(damped));
+        expect_near(damped_particle.get_position(), world.get_position(damped));
+    }
+}
+
+TEST_F(ParticleWorldTest, removing_a_particle_keeps_the_handles_of_the_others)
+{
+    add_random_particles(5);
+
+    world.remove(handles[1]);
+    EXPECT_EQ(4u, world.size());
+    EXPECT_FALSE(world.contains(handles[1]));
+
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (i != 1) {
+            EXPECT_TRUE(world.contains(handles[i]));
+            EXPECT_EQ(particles[i].get_position(), world.get_position(handles[i]));
+            EXPECT_EQ(handles[i], world.handle_at(world.index_of(handles[i])));
+        }
+    }
+}
+
+TEST_F(ParticleWorldTest, handles_of_removed_particles_never_name_new_particles)
+{
+    add_random_particles(3);
+
+    world.remove(handles[0]);
+    const auto particle = world.add(Physics::Vector3());
+
+    EXPECT_NE(handles[0], particle);
+    EXPECT_FALSE(world.contains(handles[0]));
+    EXPECT_EQ(Physics::Vector3(), world.get_position(particle));
+    EXPECT_EQ(particles[2].get_position(), world.get_position(handles[2]));
+
+    world.clear();
+    EXPECT_EQ(0u, world.size());
+    EXPECT_FALSE(world.contains(handles[1]));
+}
+
+TEST_F(ParticleWorldTest, the_arrays_hold_the_particles_at_their_index)
+{
+    add_random_particles(9);
+    world.remove(handles[4]);
+
+    const auto & positions = world.get_positions();
+    for (size_t i = 0; i < world.size(); ++i) {
+        const auto particle = world.handle_at(i);
+        EXPECT_EQ(world.get_position(particle), positions.get(i));
+        EXPECT_EQ(world.get_inverse_mass(particle), world.get_inverse_masses()[i]);
+    }
+}
+
+TEST_F(ParticleWorldTest, grouping_by_damping_keeps_the_handles_and_puts_equal_damping_together)
+{
+    for (size_t i = 0; i < 20; ++i) {
+        handles.push_back(world.add(create_random_vector3(), create_random_vector3(), 1, i % 2 ? 0.5 : 0.25));
+    }
+    const auto position = world.get_position(handles[7]);
+
+    world.group_by_damping();
+    for (size_t i = 0; i < world.size(); ++i) {
+        EXPECT_EQ(i < 10 ? 0.25 : 0.5, world.get_dampings()[i]);
+        EXPECT_EQ(i, world.index_of(world.handle_at(i)));
+    }
+    EXPECT_EQ(position, world.get_position(handles[7]));
+    EXPECT_EQ(0.5, world.get_damping(handles[7]));
+}